@@ -220,6 +220,11 @@ CSoundInterface* CApplication::GetSound()
     return m_sound.get();
 }
 
+CSystemUtils* CApplication::GetSystemUtils()
+{
+    return m_systemUtils;
+}
+
 ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
 {
     enum OptionType
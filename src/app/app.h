@@ -162,6 +162,8 @@ public:
     CEventQueue* GetEventQueue();
     //! Returns the sound subsystem
     CSoundInterface* GetSound();
+    //! Returns the system utils, e.g. for measuring time
+    CSystemUtils* GetSystemUtils();
 
 public:
     //! Parses commandline arguments
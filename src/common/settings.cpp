@@ -27,6 +27,7 @@
 
 #include "graphics/engine/camera.h"
 #include "graphics/engine/engine.h"
+#include "graphics/engine/terrain.h"
 
 #include "level/robotmain.h"
 
@@ -112,6 +113,10 @@ void CSettings::SaveSettings()
 
     // Experimental settings
     GetConfigFile().SetBoolProperty("Experimental", "TerrainShadows", engine->GetTerrainShadows());
+    GetConfigFile().SetBoolProperty("Experimental", "TerrainStreaming", engine->GetTerrain()->GetStreaming());
+    GetConfigFile().SetBoolProperty("Experimental", "ReleaseVertexCopies", engine->GetReleaseVertexCopies());
+    GetConfigFile().SetBoolProperty("Experimental", "PhasedObjectUpdate", main->GetPhasedObjectUpdate());
+    GetConfigFile().SetFloatProperty("Experimental", "ConditionCheckPeriod", main->GetConditionCheckPeriod());
 
     CInput::GetInstancePointer()->SaveKeyBindings();
 
@@ -275,6 +280,18 @@ void CSettings::LoadSettings()
     if (GetConfigFile().GetBoolProperty("Experimental", "TerrainShadows", bValue))
         engine->SetTerrainShadows(bValue);
 
+    if (GetConfigFile().GetBoolProperty("Experimental", "TerrainStreaming", bValue))
+        engine->GetTerrain()->SetStreaming(bValue);
+
+    if (GetConfigFile().GetBoolProperty("Experimental", "ReleaseVertexCopies", bValue))
+        engine->SetReleaseVertexCopies(bValue);
+
+    if (GetConfigFile().GetBoolProperty("Experimental", "PhasedObjectUpdate", bValue))
+        main->SetPhasedObjectUpdate(bValue);
+
+    if (GetConfigFile().GetFloatProperty("Experimental", "ConditionCheckPeriod", fValue))
+        main->SetConditionCheckPeriod(fValue);
+
     CInput::GetInstancePointer()->LoadKeyBindings();
 
 
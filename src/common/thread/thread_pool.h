@@ -0,0 +1,178 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include "common/make_unique.h"
+
+#include "common/thread/sdl_cond_wrapper.h"
+#include "common/thread/sdl_mutex_wrapper.h"
+#include "common/thread/thread.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \class CThreadPool
+ * \brief Fixed set of worker threads running data-parallel loops
+ *
+ * The calling thread always takes part in the work, so a pool created
+ * with zero worker threads simply runs everything inline. This makes
+ * it easy to compare against the single-threaded behaviour.
+ *
+ * Threads grab the next free chunk as soon as they are done with the
+ * previous one.
+ */
+class CThreadPool
+{
+public:
+    //! Function processing elements in range [begin; end)
+    using RangeFunction = std::function<void(int begin, int end)>;
+
+public:
+    explicit CThreadPool(int threadCount, std::string name = "")
+        : m_threadCount(threadCount > 0 ? threadCount : 0)
+    {
+        for (int i = 0; i < m_threadCount; ++i)
+        {
+            m_threads.push_back(MakeUnique<CThread>(std::bind(&CThreadPool::Run, this), name));
+            m_threads.back()->Start();
+        }
+    }
+
+    ~CThreadPool()
+    {
+        m_mutex.Lock();
+        m_running = false;
+        m_cond.Broadcast();
+        m_mutex.Unlock();
+
+        for (auto& thread : m_threads)
+            thread->Join();
+    }
+
+    CThreadPool(const CThreadPool&) = delete;
+    CThreadPool& operator=(const CThreadPool&) = delete;
+
+    //! Returns number of worker threads (not counting the calling thread)
+    int GetThreadCount() const
+    {
+        return m_threadCount;
+    }
+
+    /**
+     * \brief Runs \a func over [0; count) split into chunks of \a chunkSize elements
+     *
+     * Blocks until all chunks are processed. Must not be called concurrently
+     * or from inside \a func.
+     */
+    void ParallelFor(int count, int chunkSize, RangeFunction func)
+    {
+        if (count <= 0) return;
+        if (chunkSize < 1) chunkSize = 1;
+
+        int chunkCount = (count + chunkSize - 1) / chunkSize;
+        if (m_threadCount == 0 || chunkCount == 1)
+        {
+            func(0, count);
+            return;
+        }
+
+        m_mutex.Lock();
+        m_func = std::move(func);
+        m_count = count;
+        m_chunkSize = chunkSize;
+        m_chunkCount = chunkCount;
+        m_nextChunk = 0;
+        m_busyThreads = m_threadCount;
+        ++m_generation;
+        m_cond.Broadcast();
+        m_mutex.Unlock();
+
+        RunChunks();
+
+        m_mutex.Lock();
+        while (m_busyThreads > 0)
+        {
+            m_doneCond.Wait(*m_mutex);
+        }
+        m_func = nullptr;
+        m_mutex.Unlock();
+    }
+
+private:
+    void Run()
+    {
+        unsigned int generation = 0;
+
+        m_mutex.Lock();
+        while (true)
+        {
+            while (m_running && m_generation == generation)
+            {
+                m_cond.Wait(*m_mutex);
+            }
+            if (!m_running) break;
+
+            generation = m_generation;
+            m_mutex.Unlock();
+
+            RunChunks();
+
+            m_mutex.Lock();
+            if (--m_busyThreads == 0)
+                m_doneCond.Signal();
+        }
+        m_mutex.Unlock();
+    }
+
+    void RunChunks()
+    {
+        int chunk = 0;
+        while ((chunk = m_nextChunk++) < m_chunkCount)
+            RunChunk(chunk);
+    }
+
+    void RunChunk(int chunk)
+    {
+        int begin = chunk * m_chunkSize;
+        int end = begin + m_chunkSize;
+        if (end > m_count) end = m_count;
+        m_func(begin, end);
+    }
+
+private:
+    const int m_threadCount;
+    std::vector<std::unique_ptr<CThread>> m_threads;
+    CSDLMutexWrapper m_mutex;
+    CSDLCondWrapper m_cond;
+    CSDLCondWrapper m_doneCond;
+    bool m_running = true;
+
+    unsigned int m_generation = 0;
+    int m_busyThreads = 0;
+    RangeFunction m_func;
+    int m_count = 0;
+    int m_chunkSize = 1;
+    int m_chunkCount = 0;
+    std::atomic<int> m_nextChunk{0};
+};
@@ -466,6 +466,13 @@ public:
     //! Draws a static buffer
     virtual void DrawStaticBuffer(unsigned int bufferId) = 0;
 
+    /**
+     * \brief Draws a static buffer once for each world matrix in \a transforms
+     *
+     * The current world transform is not used and may be changed by this call.
+     */
+    virtual void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount) = 0;
+
     //! Deletes a static buffer
     virtual void DestroyStaticBuffer(unsigned int bufferId) = 0;
 
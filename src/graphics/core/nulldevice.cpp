@@ -77,10 +77,12 @@ void CNullDevice::SetRenderMode(RenderMode mode)
 
 void CNullDevice::SetTransform(TransformType type, const Math::Matrix &matrix)
 {
+    m_callCounts.transforms++;
 }
 
 void CNullDevice::SetMaterial(const Material &material)
 {
+    m_callCounts.materials++;
 }
 
 int CNullDevice::GetMaxLightCount()
@@ -136,10 +138,12 @@ int CNullDevice::GetMaxTextureStageCount()
 
 void CNullDevice::SetTexture(int index, const Texture &texture)
 {
+    m_callCounts.textures++;
 }
 
 void CNullDevice::SetTexture(int index, unsigned int textureId)
 {
+    m_callCounts.textures++;
 }
 
 void CNullDevice::SetTextureEnabled(int index, bool enabled)
@@ -157,40 +161,48 @@ void CNullDevice::SetTextureStageWrap(int index, TexWrapMode wrapS, TexWrapMode
 void CNullDevice::DrawPrimitive(PrimitiveType type, const Vertex *vertices, int vertexCount,
                               Color color)
 {
+    m_callCounts.drawCalls++;
 }
 
 void CNullDevice::DrawPrimitive(PrimitiveType type, const VertexTex2 *vertices, int vertexCount,
                               Color color)
 {
+    m_callCounts.drawCalls++;
 }
 
 void CNullDevice::DrawPrimitive(PrimitiveType type, const VertexCol *vertices, int vertexCount)
 {
+    m_callCounts.drawCalls++;
 }
 
 void CNullDevice::DrawPrimitive(PrimitiveType type, const void *vertices,
     int size, const VertexFormat &format, int vertexCount)
 {
+    m_callCounts.drawCalls++;
 }
 
 void CNullDevice::DrawPrimitives(PrimitiveType type, const void *vertices,
     int size, const VertexFormat &format, int first[], int count[], int drawCount)
 {
+    m_callCounts.drawCalls++;
 }
 
 void CNullDevice::DrawPrimitives(PrimitiveType type, const Vertex *vertices,
     int first[], int count[], int drawCount, Color color)
 {
+    m_callCounts.drawCalls++;
 }
 
 void CNullDevice::DrawPrimitives(PrimitiveType type, const VertexTex2 *vertices,
     int first[], int count[], int drawCount, Color color)
 {
+    m_callCounts.drawCalls++;
 }
 
 void CNullDevice::DrawPrimitives(PrimitiveType type, const VertexCol *vertices,
     int first[], int count[], int drawCount)
 {
+    m_callCounts.drawCalls++;
 }
 
 unsigned int CNullDevice::CreateStaticBuffer(PrimitiveType primitiveType, const Vertex* vertices, int vertexCount)
@@ -222,6 +234,13 @@ void CNullDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
 
 void CNullDevice::DrawStaticBuffer(unsigned int bufferId)
 {
+    m_callCounts.drawCalls++;
+}
+
+void CNullDevice::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    m_callCounts.drawCalls++;
+    m_callCounts.instances += instanceCount;
 }
 
 void CNullDevice::DestroyStaticBuffer(unsigned int bufferId)
@@ -342,4 +361,15 @@ bool CNullDevice::IsFramebufferSupported()
     return false;
 }
 
+const NullDeviceCallCounts& CNullDevice::GetCallCounts() const
+{
+    return m_callCounts;
+}
+
+void CNullDevice::ResetCallCounts()
+{
+    m_callCounts = NullDeviceCallCounts();
+}
+
+
 } // namespace Gfx
@@ -30,9 +30,26 @@
 namespace Gfx
 {
 
+/**
+ * \struct NullDeviceCallCounts
+ * \brief Number of state changes and draw calls received by CNullDevice
+ */
+struct NullDeviceCallCounts
+{
+    int transforms = 0;
+    int materials = 0;
+    int textures = 0;
+    int drawCalls = 0;
+    //! Instances drawn by DrawStaticBufferInstanced()
+    int instances = 0;
+};
+
 /**
  * \class CNullDevice
  * \brief Device implementation that doesn't render anything
+ *
+ * It counts the state changes and draw calls it receives, which allows
+ * measuring how much work a rendering path would issue to a real device.
  */
 class CNullDevice : public CDevice
 {
@@ -106,6 +123,7 @@ public:
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
@@ -158,6 +176,14 @@ public:
     int GetMaxTextureSize() override;
 
     bool IsFramebufferSupported() override;
+
+    //! Returns the calls counted since creation or the last reset
+    const NullDeviceCallCounts& GetCallCounts() const;
+    //! Resets call counters
+    void ResetCallCounts();
+
+private:
+    NullDeviceCallCounts m_callCounts;
 };
 
 
@@ -36,6 +36,7 @@
 
 #include "object/object.h"
 #include "object/object_manager.h"
+#include "object/world_query.h"
 
 #include "object/interface/carrier_object.h"
 #include "object/interface/controllable_object.h"
@@ -45,6 +46,8 @@
 
 #include "physics/physics.h"
 
+#include <algorithm>
+
 
 // Graphics module namespace
 namespace Gfx
@@ -833,12 +836,32 @@ void CCamera::IsCollisionBack()
     max.y = Math::Max(m_actualEye.y, m_actualLookat.y);
     max.z = Math::Max(m_actualEye.z, m_actualLookat.z);
 
-    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    // Objects made transparent by the previous frame become opaque again,
+    // except the ones being transported, which follow their carrier
+    CObjectManager* objMan = CObjectManager::GetInstancePointer();
+    std::vector<int> transparent;
+    transparent.swap(m_transparentObjects);
+    for (int id : transparent)
     {
+        CObject* obj = objMan->GetObjectById(id);
+        if (obj == nullptr) continue;
+
         if (IsObjectBeingTransported(obj))
+        {
+            m_transparentObjects.push_back(id);
             continue;
+        }
 
         SetTransparency(obj, 0.0f);  // opaque object
+    }
+
+    // Only objects whose collision sphere is crossed by the line of sight
+    objMan->GetWorldQuery()->GetSegmentHits(m_actualEye, m_actualLookat, WorldQuerySpheres::Camera, m_queryHits);
+    for (const WorldQueryHit& hit : m_queryHits)
+    {
+        CObject* obj = hit.object;
+        if (IsObjectBeingTransported(obj))
+            continue;
 
         if (obj == m_cameraObj) continue;
 
@@ -899,46 +922,59 @@ void CCamera::IsCollisionBack()
         if (len > del) continue;
 
         SetTransparency(obj, 1.0f);  // transparent object
+
+        m_transparentObjects.push_back(obj->GetID());
+        if (obj->Implements(ObjectInterfaceType::Carrier))
+        {
+            CObject* cargo = dynamic_cast<CCarrierObject*>(obj)->GetCargo();
+            if (cargo != nullptr)
+                m_transparentObjects.push_back(cargo->GetID());
+        }
+        if (obj->Implements(ObjectInterfaceType::Powered))
+        {
+            CObject* power = dynamic_cast<CPoweredObject*>(obj)->GetPower();
+            if (power != nullptr)
+                m_transparentObjects.push_back(power->GetID());
+        }
     }
+
+    std::sort(m_transparentObjects.begin(), m_transparentObjects.end());
+    m_transparentObjects.erase(std::unique(m_transparentObjects.begin(), m_transparentObjects.end()), m_transparentObjects.end());
 }
 
 void CCamera::IsCollisionFix(Math::Vector &eye, Math::Vector lookat)
 {
-    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    // First object whose collision sphere contains the eye
+    auto filter = [this](CObject* obj)
     {
-        if (obj == m_cameraObj) continue;
+        if (obj == m_cameraObj) return false;
 
         ObjectType type = obj->GetType();
-        if ( type == OBJECT_TOTO    ||
-             type == OBJECT_STONE   ||
-             type == OBJECT_URANIUM ||
-             type == OBJECT_METAL   ||
-             type == OBJECT_POWER   ||
-             type == OBJECT_ATOMIC  ||
-             type == OBJECT_BULLET  ||
-             type == OBJECT_BBOX    ||
-             type == OBJECT_KEYa    ||
-             type == OBJECT_KEYb    ||
-             type == OBJECT_KEYc    ||
-             type == OBJECT_KEYd    ||
-             type == OBJECT_ANT     ||
-             type == OBJECT_SPIDER  ||
-             type == OBJECT_BEE     ||
-             type == OBJECT_WORM )  continue;
-
-        Math::Sphere objSphere = obj->GetCameraCollisionSphere();
-        Math::Vector objPos = objSphere.pos;
-        float objRadius = objSphere.radius;
-        if (objRadius == 0.0f) continue;
-
-        float dist = Math::Distance(eye, objPos);
-        if (dist < objRadius)
-        {
-            dist = Math::Distance(eye, lookat);
-            Math::Vector proj = Projection(eye, lookat, objPos);
-            eye = (lookat - eye) * objRadius / dist + proj;
-            return;
-        }
+        return !( type == OBJECT_TOTO    ||
+                  type == OBJECT_STONE   ||
+                  type == OBJECT_URANIUM ||
+                  type == OBJECT_METAL   ||
+                  type == OBJECT_POWER   ||
+                  type == OBJECT_ATOMIC  ||
+                  type == OBJECT_BULLET  ||
+                  type == OBJECT_BBOX    ||
+                  type == OBJECT_KEYa    ||
+                  type == OBJECT_KEYb    ||
+                  type == OBJECT_KEYc    ||
+                  type == OBJECT_KEYd    ||
+                  type == OBJECT_ANT     ||
+                  type == OBJECT_SPIDER  ||
+                  type == OBJECT_BEE     ||
+                  type == OBJECT_WORM );
+    };
+
+    WorldQueryHit hit;
+    CWorldQuery* query = CObjectManager::GetInstancePointer()->GetWorldQuery();
+    if (query->IntersectSegment(eye, lookat, WorldQuerySpheres::Camera, hit, filter) && hit.distance == 0.0f)
+    {
+        float dist = Math::Distance(eye, lookat);
+        Math::Vector proj = Projection(eye, lookat, hit.sphere.pos);
+        eye = (lookat - eye) * hit.sphere.radius / dist + proj;
     }
 }
 
@@ -1416,6 +1452,22 @@ Math::Vector CCamera::ExcludeTerrain(Math::Vector eye, Math::Vector lookat,
             eye = RotateView(lookat, angleH, angleV, dist);
         }
     }
+
+    // Raises the eye above a hill hiding the object
+    Math::Vector hit;
+    if (CObjectManager::GetInstancePointer()->GetWorldQuery()->IntersectTerrain(lookat, eye, hit))
+    {
+        float hitDist = Math::DistanceProjected(lookat, hit);
+        if (hitDist > 0.0f)
+        {
+            float v = -atan2f(hit.y+2.0f-lookat.y, hitDist);
+            if (v < angleV)
+            {
+                angleV = v;
+                eye = RotateView(lookat, angleH, angleV, Math::DistanceProjected(lookat, eye));
+            }
+        }
+    }
     return eye;
 }
 
@@ -26,6 +26,8 @@
 
 #include "graphics/engine/engine.h"
 
+#include "object/world_query.h"
+
 
 class CObject;
 class CRobotMain;
@@ -301,6 +303,10 @@ protected:
     CameraSmooth m_smooth;
     //! Object linked to the camera
     CObject*     m_cameraObj;
+    //! IDs of objects made transparent by IsCollisionBack()
+    std::vector<int> m_transparentObjects;
+    //! Objects returned by CWorldQuery, kept to reuse the memory
+    std::vector<WorldQueryHit> m_queryHits;
 
     //! Remaining time of initial camera entry animation
     float        m_initDelay;
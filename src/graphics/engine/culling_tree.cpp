@@ -0,0 +1,250 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/culling_tree.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+//! Maximum number of items in a leaf node
+const int LEAF_SIZE = 4;
+
+float GetAxis(const Math::Vector& vec, int axis)
+{
+    if (axis == 0)
+        return vec.x;
+    if (axis == 1)
+        return vec.y;
+    return vec.z;
+}
+
+Math::Sphere MergeSpheres(const Math::Sphere& a, const Math::Sphere& b)
+{
+    Math::Vector diff = b.pos - a.pos;
+    float dist = diff.Length();
+
+    if (dist + b.radius <= a.radius)
+        return a;
+    if (dist + a.radius <= b.radius)
+        return b;
+
+    float radius = (dist + a.radius + b.radius) * 0.5f;
+    Math::Vector pos = a.pos + diff * ((radius - a.radius) / dist);
+    return Math::Sphere(pos, radius);
+}
+
+} // anonymous namespace
+
+
+void CCullingTree::Clear()
+{
+    m_nodes.clear();
+    m_items.clear();
+    m_itemIndex.clear();
+}
+
+void CCullingTree::Build(std::vector<CullingItem> items)
+{
+    Clear();
+
+    m_items = std::move(items);
+    if (m_items.empty())
+        return;
+
+    m_nodes.reserve(2 * m_items.size() / LEAF_SIZE + 1);
+    BuildNode(0, m_items.size());
+
+    for (int i = 0; i < static_cast<int>( m_items.size() ); i++)
+    {
+        int id = m_items[i].id;
+        assert(id >= 0);
+
+        if (id >= static_cast<int>( m_itemIndex.size() ))
+            m_itemIndex.resize(id + 1, -1);
+
+        m_itemIndex[id] = i;
+    }
+}
+
+int CCullingTree::BuildNode(int first, int count)
+{
+    int nodeIndex = m_nodes.size();
+    m_nodes.push_back(Node());
+
+    if (count <= LEAF_SIZE)
+    {
+        m_nodes[nodeIndex].first = first;
+        m_nodes[nodeIndex].count = count;
+        m_nodes[nodeIndex].bounds = ComputeLeafBounds(m_nodes[nodeIndex]);
+        return nodeIndex;
+    }
+
+    Math::Vector min = m_items[first].sphere.pos;
+    Math::Vector max = min;
+    for (int i = first + 1; i < first + count; i++)
+    {
+        const Math::Vector& pos = m_items[i].sphere.pos;
+        min = Math::Vector(std::min(min.x, pos.x), std::min(min.y, pos.y), std::min(min.z, pos.z));
+        max = Math::Vector(std::max(max.x, pos.x), std::max(max.y, pos.y), std::max(max.z, pos.z));
+    }
+
+    Math::Vector extent = max - min;
+    int axis = 0;
+    if (extent.y > extent.x && extent.y >= extent.z)
+        axis = 1;
+    else if (extent.z > extent.x && extent.z > extent.y)
+        axis = 2;
+
+    int half = count / 2;
+    std::nth_element(m_items.begin() + first, m_items.begin() + first + half, m_items.begin() + first + count,
+                     [axis](const CullingItem& a, const CullingItem& b)
+    {
+        return GetAxis(a.sphere.pos, axis) < GetAxis(b.sphere.pos, axis);
+    });
+
+    // Children are always stored after their parent, which Refit() relies on
+    int left = BuildNode(first, half);
+    int right = BuildNode(first + half, count - half);
+
+    m_nodes[nodeIndex].left = left;
+    m_nodes[nodeIndex].right = right;
+    m_nodes[nodeIndex].bounds = MergeSpheres(m_nodes[left].bounds, m_nodes[right].bounds);
+
+    return nodeIndex;
+}
+
+Math::Sphere CCullingTree::ComputeLeafBounds(const Node& node) const
+{
+    Math::Sphere bounds = m_items[node.first].sphere;
+    for (int i = node.first + 1; i < node.first + node.count; i++)
+        bounds = MergeSpheres(bounds, m_items[i].sphere);
+
+    return bounds;
+}
+
+bool CCullingTree::Contains(int id) const
+{
+    return id >= 0 && id < static_cast<int>( m_itemIndex.size() ) && m_itemIndex[id] != -1;
+}
+
+int CCullingTree::GetItemCount() const
+{
+    return m_items.size();
+}
+
+void CCullingTree::Update(int id, const Math::Sphere& sphere)
+{
+    assert(Contains(id));
+
+    m_items[m_itemIndex[id]].sphere = sphere;
+}
+
+void CCullingTree::Refit()
+{
+    for (int i = static_cast<int>( m_nodes.size() ) - 1; i >= 0; i--)
+    {
+        Node& node = m_nodes[i];
+
+        if (node.left == -1)
+            node.bounds = ComputeLeafBounds(node);
+        else
+            node.bounds = MergeSpheres(m_nodes[node.left].bounds, m_nodes[node.right].bounds);
+    }
+}
+
+void CCullingTree::Cull(const Math::Frustum* frusta, int frustumCount, std::vector<int>* visible) const
+{
+    assert(frustumCount > 0 && frustumCount <= MAX_FRUSTA);
+
+    if (m_nodes.empty())
+        return;
+
+    struct StackEntry
+    {
+        int node;
+        //! Frusta partially intersecting the parent node
+        int testMask;
+        //! Frusta fully containing the parent node
+        int insideMask;
+    };
+
+    std::vector<StackEntry> stack;
+    stack.push_back({ 0, (1 << frustumCount) - 1, 0 });
+
+    while (! stack.empty())
+    {
+        StackEntry entry = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[entry.node];
+
+        for (int f = 0; f < frustumCount; f++)
+        {
+            if ((entry.testMask & (1 << f)) == 0)
+                continue;
+
+            Math::FrustumTest test = Math::TestSphereInFrustum(frusta[f], node.bounds);
+            if (test == Math::FRUSTUM_OUTSIDE)
+            {
+                entry.testMask &= ~(1 << f);
+            }
+            else if (test == Math::FRUSTUM_INSIDE)
+            {
+                entry.testMask &= ~(1 << f);
+                entry.insideMask |= 1 << f;
+            }
+        }
+
+        if (entry.testMask == 0 && entry.insideMask == 0)
+            continue;
+
+        if (node.left != -1)
+        {
+            stack.push_back({ node.right, entry.testMask, entry.insideMask });
+            stack.push_back({ node.left, entry.testMask, entry.insideMask });
+            continue;
+        }
+
+        for (int i = node.first; i < node.first + node.count; i++)
+        {
+            const CullingItem& item = m_items[i];
+
+            for (int f = 0; f < frustumCount; f++)
+            {
+                bool inside = (entry.insideMask & (1 << f)) != 0;
+                if (! inside && (entry.testMask & (1 << f)) != 0)
+                    inside = Math::TestSphereInFrustum(frusta[f], item.sphere) != Math::FRUSTUM_OUTSIDE;
+
+                if (inside)
+                    visible[f].push_back(item.id);
+            }
+        }
+    }
+}
+
+
+} // namespace Gfx
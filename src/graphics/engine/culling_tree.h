@@ -0,0 +1,107 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/culling_tree.h
+ * \brief Bounding volume hierarchy for frustum culling - CCullingTree class
+ */
+
+#pragma once
+
+#include "math/frustum.h"
+#include "math/sphere.h"
+
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct CullingItem
+ * \brief Item of culling tree: bounding sphere in world coordinates with user-defined id
+ */
+struct CullingItem
+{
+    //! Id returned by culling queries (engine object rank)
+    int          id = -1;
+    //! Bounding sphere in world coordinates
+    Math::Sphere sphere;
+};
+
+/**
+ * \class CCullingTree
+ * \brief Bounding sphere hierarchy used to find visible objects
+ *
+ * The tree is built over item spheres by splitting at the median along the longest axis.
+ * Moving items only updates their spheres; Refit() recomputes the node bounds
+ * without changing the tree structure. Adding or removing items requires Build().
+ *
+ * Cull() tests several frusta in one traversal, e.g. camera and shadow map.
+ * Subtrees fully inside a frustum are accepted without further tests.
+ */
+class CCullingTree
+{
+public:
+    //! Maximum number of frusta tested by Cull()
+    static const int MAX_FRUSTA = 4;
+
+    //! Removes all items
+    void        Clear();
+    //! Rebuilds the tree from given items
+    void        Build(std::vector<CullingItem> items);
+
+    //! Returns whether item with given id is in the tree
+    bool        Contains(int id) const;
+    //! Returns number of items in the tree
+    int         GetItemCount() const;
+
+    //! Changes the sphere of an item; Refit() must be called before next Cull()
+    void        Update(int id, const Math::Sphere& sphere);
+    //! Recomputes node bounds after items were updated
+    void        Refit();
+
+    //! Finds items visible in each frustum; ids visible in frusta[i] are appended to visible[i]
+    void        Cull(const Math::Frustum* frusta, int frustumCount, std::vector<int>* visible) const;
+
+private:
+    struct Node
+    {
+        Math::Sphere bounds;
+        //! Child nodes, -1 for leaves
+        int          left = -1;
+        int          right = -1;
+        //! Range of items in leaves
+        int          first = 0;
+        int          count = 0;
+    };
+
+    int         BuildNode(int first, int count);
+    Math::Sphere ComputeLeafBounds(const Node& node) const;
+
+private:
+    std::vector<Node>        m_nodes;
+    std::vector<CullingItem> m_items;
+    //! Map of id -> index in m_items, -1 if absent
+    std::vector<int>         m_itemIndex;
+};
+
+
+} // namespace Gfx
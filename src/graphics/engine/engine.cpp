@@ -39,12 +39,14 @@
 
 #include "graphics/engine/camera.h"
 #include "graphics/engine/cloud.h"
+#include "graphics/engine/culling_tree.h"
 #include "graphics/engine/lightman.h"
 #include "graphics/engine/lightning.h"
 #include "graphics/engine/oldmodelmanager.h"
 #include "graphics/engine/particle.h"
 #include "graphics/engine/planet.h"
 #include "graphics/engine/pyro_manager.h"
+#include "graphics/engine/render_queue.h"
 #include "graphics/engine/terrain.h"
 #include "graphics/engine/text.h"
 #include "graphics/engine/water.h"
@@ -54,13 +56,17 @@
 
 #include "level/robotmain.h"
 
+#include "math/frustum.h"
 #include "math/geometry.h"
 
 #include "sound/sound.h"
 
 #include "ui/controls/interface.h"
 
+#include <cstring>
 #include <iomanip>
+#include <limits>
+#include <map>
 #include <SDL_surface.h>
 #include <SDL_thread.h>
 
@@ -122,6 +128,72 @@ const std::map<EngineMouseType, EngineMouse> MOUSE_TYPES = {
     {{ENG_MOUSE_SCROLLD}, {EngineMouse(30, 31, 46, ENG_RSTATE_TTEXTURE_BLACK, ENG_RSTATE_TTEXTURE_WHITE, Math::IntPoint( 9, 17))}},
 };
 
+bool ReleaseVertices(EngineBaseObjDataTier& p4)
+{
+    if (p4.keepVertices || p4.vertices.empty())
+        return false;
+
+    struct VertexLess
+    {
+        bool operator()(const VertexTex2& a, const VertexTex2& b) const
+        {
+            return std::memcmp(&a, &b, sizeof(VertexTex2)) < 0;
+        }
+    };
+
+    std::map<VertexTex2, unsigned short, VertexLess> unique;
+    std::vector<VertexTex2> coldVertices;
+    std::vector<unsigned short> coldIndices;
+    coldIndices.reserve(p4.vertices.size());
+
+    for (const VertexTex2& vertex : p4.vertices)
+    {
+        auto it = unique.find(vertex);
+        if (it == unique.end())
+        {
+            // Too many unique vertices for 16-bit indices
+            if (coldVertices.size() > std::numeric_limits<unsigned short>::max())
+            {
+                p4.keepVertices = true;
+                return false;
+            }
+
+            it = unique.insert({ vertex, static_cast<unsigned short>(coldVertices.size()) }).first;
+            coldVertices.push_back(vertex);
+        }
+
+        coldIndices.push_back(it->second);
+    }
+
+    std::size_t hotSize = p4.vertices.size() * sizeof(VertexTex2);
+    std::size_t coldSize = coldVertices.size() * sizeof(VertexTex2) + coldIndices.size() * sizeof(unsigned short);
+    if (coldSize >= hotSize)
+    {
+        // Nothing to gain, e.g. triangle strips of terrain
+        p4.keepVertices = true;
+        return false;
+    }
+
+    coldVertices.shrink_to_fit();
+    p4.coldVertices.swap(coldVertices);
+    p4.coldIndices.swap(coldIndices);
+    std::vector<VertexTex2>().swap(p4.vertices);
+    return true;
+}
+
+void RestoreVertices(EngineBaseObjDataTier& p4)
+{
+    if (! p4.vertices.empty() || p4.coldIndices.empty())
+        return;
+
+    p4.vertices.reserve(p4.coldIndices.size());
+    for (unsigned short index : p4.coldIndices)
+        p4.vertices.push_back(p4.coldVertices[index]);
+
+    std::vector<VertexTex2>().swap(p4.coldVertices);
+    std::vector<unsigned short>().swap(p4.coldIndices);
+}
+
 CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
     : m_app(app),
       m_systemUtils(systemUtils),
@@ -195,6 +267,7 @@ CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
     m_offscreenShadowRenderingResolution = 1024;
     m_qualityShadows = true;
     m_terrainShadows = false;
+    m_releaseVertexCopies = false;
     m_shadowRange = 0.0f;
     m_multisample = 2;
 
@@ -236,6 +309,7 @@ CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
 
     m_lastState = -1;
     m_statisticTriangle = 0;
+    m_statisticParticleDraws = 0;
     m_fps = 0.0f;
     m_firstGroundSpot = false;
 }
@@ -333,6 +407,9 @@ bool CEngine::Create()
     m_cloud      = MakeUnique<CCloud>(this);
     m_lightning  = MakeUnique<CLightning>(this);
     m_planet     = MakeUnique<CPlanet>(this);
+    m_opaqueQueue      = MakeUnique<CRenderQueue>();
+    m_transparentQueue = MakeUnique<CRenderQueue>();
+    m_cullingTree      = MakeUnique<CCullingTree>();
 
     m_lightMan->SetDevice(m_device);
     m_particle->SetDevice(m_device);
@@ -452,6 +529,9 @@ void CEngine::FrameUpdate()
     m_particle->FrameParticle(rTime);
     CProfiler::StopPerformanceCounter(PCNT_UPDATE_PARTICLE);
 
+    if (m_terrain != nullptr)
+        m_terrain->UpdateChunks(m_eyePt);
+
     ComputeDistance();
     UpdateGeometry();
     UpdateStaticBuffers();
@@ -602,11 +682,33 @@ int CEngine::GetStatisticTriangle()
     return m_statisticTriangle;
 }
 
+void CEngine::AddStatisticParticleDraws(int count)
+{
+    m_statisticParticleDraws += count;
+}
+
+int CEngine::GetStatisticParticleDraws()
+{
+    return m_statisticParticleDraws;
+}
+
 void CEngine::SetStatisticPos(Math::Vector pos)
 {
     m_statisticPos = pos;
 }
 
+void CEngine::SetStatisticLine(const std::string& name, const std::string& value, const std::string& value2)
+{
+    for (auto& line : m_statisticLines)
+    {
+        if (line[0] != name) continue;
+        line[1] = value;
+        line[2] = value2;
+        return;
+    }
+    m_statisticLines.push_back({ name, value, value2 });
+}
+
 void CEngine::SetTimerDisplay(const std::string& text)
 {
     m_timerText = text;
@@ -690,6 +792,7 @@ void CEngine::DeleteBaseObject(int baseObjRank)
     p1.next.clear();
 
     p1.used = false;
+    m_cullingTreeDirty = true;
 }
 
 void CEngine::DeleteAllBaseObjects()
@@ -714,6 +817,7 @@ void CEngine::DeleteAllBaseObjects()
     }
 
     m_baseObjects.clear();
+    m_cullingTreeDirty = true;
 }
 
 void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
@@ -722,6 +826,7 @@ void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
     assert(destBaseObjRank >= 0 && destBaseObjRank < static_cast<int>( m_baseObjects.size() ));
 
     m_baseObjects[destBaseObjRank] = m_baseObjects[sourceBaseObjRank];
+    m_cullingTreeDirty = true;
 
     EngineBaseObject& p1 = m_baseObjects[destBaseObjRank];
 
@@ -736,8 +841,11 @@ void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
         {
             EngineBaseObjDataTier& p3 = p2.next[l3];
             p3.staticBufferId = 0;
+            p3.updateStaticBuffer = true;
         }
     }
+
+    m_updateStaticBuffers = true;
 }
 
 void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>& vertices,
@@ -750,6 +858,7 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>
     EngineBaseObjTexTier&  p2 = AddLevel2(p1, tex1Name, tex2Name);
     EngineBaseObjDataTier& p3 = AddLevel3(p2, ENG_TRIANGLE_TYPE_TRIANGLES, material, state);
 
+    RestoreVertices(p3);
     p3.vertices.insert(p3.vertices.end(), vertices.begin(), vertices.end());
 
     p3.updateStaticBuffer = true;
@@ -766,6 +875,7 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>
     }
 
     p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
+    m_cullingTreeDirty = true;
 
     p1.totalTriangles += vertices.size() / 3;
 }
@@ -791,23 +901,93 @@ void CEngine::AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buff
     }
     else
     {
-        for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i++)
+        // p3 may have released its vertices already, the buffer still has them
+        for (int i = 0; i < static_cast<int>( buffer.vertices.size() ); i++)
         {
-            p1.bboxMin.x = Math::Min(p3.vertices[i].coord.x, p1.bboxMin.x);
-            p1.bboxMin.y = Math::Min(p3.vertices[i].coord.y, p1.bboxMin.y);
-            p1.bboxMin.z = Math::Min(p3.vertices[i].coord.z, p1.bboxMin.z);
-            p1.bboxMax.x = Math::Max(p3.vertices[i].coord.x, p1.bboxMax.x);
-            p1.bboxMax.y = Math::Max(p3.vertices[i].coord.y, p1.bboxMax.y);
-            p1.bboxMax.z = Math::Max(p3.vertices[i].coord.z, p1.bboxMax.z);
+            p1.bboxMin.x = Math::Min(buffer.vertices[i].coord.x, p1.bboxMin.x);
+            p1.bboxMin.y = Math::Min(buffer.vertices[i].coord.y, p1.bboxMin.y);
+            p1.bboxMin.z = Math::Min(buffer.vertices[i].coord.z, p1.bboxMin.z);
+            p1.bboxMax.x = Math::Max(buffer.vertices[i].coord.x, p1.bboxMax.x);
+            p1.bboxMax.y = Math::Max(buffer.vertices[i].coord.y, p1.bboxMax.y);
+            p1.bboxMax.z = Math::Max(buffer.vertices[i].coord.z, p1.bboxMax.z);
         }
 
         p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
+        m_cullingTreeDirty = true;
     }
 
     if (p3.type == ENG_TRIANGLE_TYPE_TRIANGLES)
-        p1.totalTriangles += p3.vertices.size() / 3;
+        p1.totalTriangles += p3.GetVertexCount() / 3;
     else if (p3.type == ENG_TRIANGLE_TYPE_SURFACE)
-        p1.totalTriangles += p3.vertices.size() - 2;
+        p1.totalTriangles += p3.GetVertexCount() - 2;
+}
+
+bool CEngine::UpdateBaseObjQuick(int baseObjRank, int index, const std::vector<VertexTex2>& vertices,
+                                 const std::string& tex1Name, const std::string& tex2Name)
+{
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+
+    for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
+    {
+        EngineBaseObjTexTier& p2 = p1.next[l2];
+        if (p2.tex1Name != tex1Name || p2.tex2Name != tex2Name)
+            continue;
+
+        if (index < 0 || index >= static_cast<int>( p2.next.size() ))
+            return false;
+
+        EngineBaseObjDataTier& p3 = p2.next[index];
+        if (p3.GetVertexCount() != static_cast<int>( vertices.size() ))
+            return false;
+
+        // Geometry which is rebuilt is kept in memory for the next rebuild
+        p3.vertices = vertices;
+        p3.coldVertices.clear();
+        p3.coldIndices.clear();
+        p3.keepVertices = true;
+        UpdateStaticBuffer(p3);
+        return true;
+    }
+
+    return false;
+}
+
+void CEngine::UpdateBaseObjBBox(int baseObjRank)
+{
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+
+    p1.bboxMin.LoadZero();
+    p1.bboxMax.LoadZero();
+
+    for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
+    {
+        EngineBaseObjTexTier& p2 = p1.next[l2];
+
+        for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
+        {
+            EngineBaseObjDataTier& p3 = p2.next[l3];
+
+            // Compact copy has all the unique vertices, enough for the box
+            const std::vector<VertexTex2>& vertices = p3.vertices.empty() ? p3.coldVertices : p3.vertices;
+
+            for (int i = 0; i < static_cast<int>( vertices.size() ); i++)
+            {
+                p1.bboxMin.x = Math::Min(vertices[i].coord.x, p1.bboxMin.x);
+                p1.bboxMin.y = Math::Min(vertices[i].coord.y, p1.bboxMin.y);
+                p1.bboxMin.z = Math::Min(vertices[i].coord.z, p1.bboxMin.z);
+                p1.bboxMax.x = Math::Max(vertices[i].coord.x, p1.bboxMax.x);
+                p1.bboxMax.y = Math::Max(vertices[i].coord.y, p1.bboxMax.y);
+                p1.bboxMax.z = Math::Max(vertices[i].coord.z, p1.bboxMax.z);
+            }
+        }
+    }
+
+    p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
+    m_cullingTreeDirty = true;
 }
 
 void CEngine::DebugObject(int objRank)
@@ -911,8 +1091,17 @@ int CEngine::CreateObject()
 
 void CEngine::DeleteAllObjects()
 {
+    for (int objRank = 0; objRank < static_cast<int>( m_objects.size() ); objRank++)
+    {
+        if (m_objects[objRank].used && m_objects[objRank].ownsBaseObj)
+            DeleteBaseObject(m_objects[objRank].baseObjRank);
+    }
+
     m_objects.clear();
     m_shadowSpots.clear();
+    m_visibleObjects.clear();
+    m_shadowObjects.clear();
+    m_cullingTreeDirty = true;
 
     DeleteAllGroundSpots();
 }
@@ -921,8 +1110,16 @@ void CEngine::DeleteObject(int objRank)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
+    // Private copy of the base object is not referenced by anything else
+    if (m_objects[objRank].ownsBaseObj)
+        DeleteBaseObject(m_objects[objRank].baseObjRank);
+
     // Mark object as deleted
     m_objects[objRank].used = false;
+    m_objects[objRank].visible = false;
+    m_objects[objRank].copyOnWrite = false;
+    m_objects[objRank].ownsBaseObj = false;
+    m_cullingTreeDirty = true;
 
     // Delete associated shadows
     DeleteShadowSpot(objRank);
@@ -932,7 +1129,15 @@ void CEngine::SetObjectBaseRank(int objRank, int baseObjRank)
 {
     assert(objRank == -1 || (objRank >= 0 && objRank < static_cast<int>( m_objects.size() )));
 
-    m_objects[objRank].baseObjRank = baseObjRank;
+    EngineObject& obj = m_objects[objRank];
+
+    if (obj.ownsBaseObj && obj.baseObjRank != baseObjRank)
+        DeleteBaseObject(obj.baseObjRank);
+
+    obj.baseObjRank = baseObjRank;
+    obj.copyOnWrite = false;
+    obj.ownsBaseObj = false;
+    m_cullingTreeDirty = true;
 }
 
 int CEngine::GetObjectBaseRank(int objRank)
@@ -942,6 +1147,35 @@ int CEngine::GetObjectBaseRank(int objRank)
     return m_objects[objRank].baseObjRank;
 }
 
+void CEngine::SetObjectCopyOnWrite(int objRank, bool copyOnWrite)
+{
+    assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
+
+    // Object which already has its private copy has nothing to share
+    if (m_objects[objRank].ownsBaseObj)
+        return;
+
+    m_objects[objRank].copyOnWrite = copyOnWrite;
+}
+
+void CEngine::MakeObjectBaseUnique(int objRank)
+{
+    assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
+
+    EngineObject& obj = m_objects[objRank];
+    if (! obj.copyOnWrite || obj.baseObjRank == -1)
+        return;
+
+    int sourceBaseObjRank = obj.baseObjRank;
+    int copyBaseObjRank = CreateBaseObject();
+    CopyBaseObject(sourceBaseObjRank, copyBaseObjRank);
+
+    obj.baseObjRank = copyBaseObjRank;
+    obj.copyOnWrite = false;
+    obj.ownsBaseObj = true;
+    m_cullingTreeDirty = true;
+}
+
 void CEngine::SetObjectType(int objRank, EngineObjectType type)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
@@ -962,6 +1196,16 @@ void CEngine::SetObjectTransform(int objRank, const Math::Matrix& transform)
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
     m_objects[objRank].transform = transform;
+
+    // Too many pending updates, the whole tree will be rebuilt anyway
+    if (m_movedObjects.size() > m_objects.size())
+    {
+        m_movedObjects.clear();
+        m_cullingTreeDirty = true;
+    }
+
+    if (! m_cullingTreeDirty)
+        m_movedObjects.push_back(objRank);
 }
 
 void CEngine::GetObjectTransform(int objRank, Math::Matrix& transform)
@@ -1081,11 +1325,12 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
 
         for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
         {
-            EngineBaseObjDataTier& p3 = p2.next[l3];
+            const EngineBaseObjDataTier& p3 = p2.next[l3];
+            int vertexCount = p3.GetVertexCount();
 
             if (p3.type == ENG_TRIANGLE_TYPE_TRIANGLES)
             {
-                for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i += 3)
+                for (int i = 0; i < vertexCount; i += 3)
                 {
                     if (static_cast<float>(actualCount) / total >= percent)
                         break;
@@ -1094,9 +1339,9 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
                         break;
 
                     EngineTriangle t;
-                    t.triangle[0] = p3.vertices[i];
-                    t.triangle[1] = p3.vertices[i+1];
-                    t.triangle[2] = p3.vertices[i+2];
+                    t.triangle[0] = p3.GetVertex(i);
+                    t.triangle[1] = p3.GetVertex(i+1);
+                    t.triangle[2] = p3.GetVertex(i+2);
                     t.material = p3.material;
                     t.state = p3.state;
                     t.tex1Name = p2.tex1Name;
@@ -1109,7 +1354,7 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
             }
             else if (p3.type == ENG_TRIANGLE_TYPE_SURFACE)
             {
-                for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i += 1)
+                for (int i = 0; i < vertexCount - 2; i += 1)
                 {
                     if (static_cast<float>(actualCount) / total >= percent)
                         break;
@@ -1118,9 +1363,9 @@ int CEngine::GetPartialTriangles(int objRank, float percent, int maxCount,
                         break;
 
                     EngineTriangle t;
-                    t.triangle[0] = p3.vertices[i];
-                    t.triangle[1] = p3.vertices[i+1];
-                    t.triangle[2] = p3.vertices[i+2];
+                    t.triangle[0] = p3.GetVertex(i);
+                    t.triangle[1] = p3.GetVertex(i+1);
+                    t.triangle[2] = p3.GetVertex(i+2);
                     t.material = p3.material;
                     t.state = p3.state;
                     t.tex1Name = p2.tex1Name;
@@ -1141,6 +1386,8 @@ void CEngine::ChangeSecondTexture(int objRank, const std::string& tex2Name)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
+    MakeObjectBaseUnique(objRank);
+
     int baseObjRank = m_objects[objRank].baseObjRank;
     if (baseObjRank == -1)
         return;
@@ -1174,10 +1421,16 @@ void CEngine::ChangeTextureMapping(int objRank, const Material& mat, int state,
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
+    MakeObjectBaseUnique(objRank);
+
     EngineBaseObjDataTier* p4 = FindTriangles(objRank, mat, state, tex1Name, tex2Name);
     if (p4 == nullptr)
         return;
 
+    // Mapping is usually animated, so the vertices stay in memory
+    RestoreVertices(*p4);
+    p4->keepVertices = true;
+
     int nb = p4->vertices.size();
 
     if (mode == ENG_TEX_MAPPING_X)
@@ -1236,10 +1489,16 @@ void CEngine::TrackTextureMapping(int objRank, const Material& mat, int state,
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
+    MakeObjectBaseUnique(objRank);
+
     EngineBaseObjDataTier* p4 = FindTriangles(objRank, mat, state, tex1Name, tex2Name);
     if (p4 == nullptr)
         return;
 
+    // Mapping is usually animated, so the vertices stay in memory
+    RestoreVertices(*p4);
+    p4->keepVertices = true;
+
     int tNum = p4->vertices.size();
     if (tNum < 12 || tNum % 6 != 0)
         return;
@@ -1653,34 +1912,10 @@ void CEngine::UpdateGeometry()
 
     for (int baseObjRank = 0; baseObjRank < static_cast<int>( m_baseObjects.size() ); baseObjRank++)
     {
-        EngineBaseObject &p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
+        if (! m_baseObjects[baseObjRank].used)
             continue;
 
-        p1.bboxMin.LoadZero();
-        p1.bboxMax.LoadZero();
-
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i++)
-                {
-                        p1.bboxMin.x = Math::Min(p3.vertices[i].coord.x, p1.bboxMin.x);
-                        p1.bboxMin.y = Math::Min(p3.vertices[i].coord.y, p1.bboxMin.y);
-                        p1.bboxMin.z = Math::Min(p3.vertices[i].coord.z, p1.bboxMin.z);
-                        p1.bboxMax.x = Math::Max(p3.vertices[i].coord.x, p1.bboxMax.x);
-                        p1.bboxMax.y = Math::Max(p3.vertices[i].coord.y, p1.bboxMax.y);
-                        p1.bboxMax.z = Math::Max(p3.vertices[i].coord.z, p1.bboxMax.z);
-                }
-            }
-        }
-
-        p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
+        UpdateBaseObjBBox(baseObjRank);
     }
 
     m_updateGeometry = false;
@@ -1694,12 +1929,17 @@ void CEngine::UpdateStaticBuffer(EngineBaseObjDataTier& p4)
     else
         type = PRIMITIVE_TRIANGLE_STRIP;
 
+    RestoreVertices(p4);
+
     if (p4.staticBufferId == 0)
         p4.staticBufferId = m_device->CreateStaticBuffer(type, &p4.vertices[0], p4.vertices.size());
     else
         m_device->UpdateStaticBuffer(p4.staticBufferId, type, &p4.vertices[0], p4.vertices.size());
 
     p4.updateStaticBuffer = false;
+
+    if (m_releaseVertexCopies && p4.staticBufferId != 0)
+        ReleaseVertices(p4);
 }
 
 void CEngine::UpdateStaticBuffers()
@@ -1817,14 +2057,20 @@ int CEngine::DetectObject(Math::Point mouse, Math::Vector& targetPos, bool terra
 
             for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
             {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
+                const EngineBaseObjDataTier& p3 = p2.next[l3];
+                int vertexCount = p3.GetVertexCount();
+                VertexTex2 triangle[3];
 
                 if (p3.type == ENG_TRIANGLE_TYPE_TRIANGLES)
                 {
-                    for (int i = 0; i < static_cast<int>( p3.vertices.size() ); i += 3)
+                    for (int i = 0; i < vertexCount; i += 3)
                     {
+                        triangle[0] = p3.GetVertex(i);
+                        triangle[1] = p3.GetVertex(i+1);
+                        triangle[2] = p3.GetVertex(i+2);
+
                         float dist = 0.0f;
-                        if (DetectTriangle(mouse, &p3.vertices[i], objRank, dist, pos) && dist < min)
+                        if (DetectTriangle(mouse, triangle, objRank, dist, pos) && dist < min)
                         {
                             min = dist;
                             nearest = objRank;
@@ -1834,10 +2080,14 @@ int CEngine::DetectObject(Math::Point mouse, Math::Vector& targetPos, bool terra
                 }
                 else if (p3.type == ENG_TRIANGLE_TYPE_SURFACE)
                 {
-                    for (int i = 0; i < static_cast<int>( p3.vertices.size() ) - 2; i += 1)
+                    for (int i = 0; i < vertexCount - 2; i += 1)
                     {
+                        triangle[0] = p3.GetVertex(i);
+                        triangle[1] = p3.GetVertex(i+1);
+                        triangle[2] = p3.GetVertex(i+2);
+
                         float dist = 0.0f;
-                        if (DetectTriangle(mouse, &p3.vertices[i], objRank, dist, pos) && dist < min)
+                        if (DetectTriangle(mouse, triangle, objRank, dist, pos) && dist < min)
                         {
                             min = dist;
                             nearest = objRank;
@@ -1852,7 +2102,7 @@ int CEngine::DetectObject(Math::Point mouse, Math::Vector& targetPos, bool terra
     return nearest;
 }
 
-bool CEngine::DetectTriangle(Math::Point mouse, VertexTex2* triangle, int objRank, float& dist, Math::Vector& pos)
+bool CEngine::DetectTriangle(Math::Point mouse, const VertexTex2* triangle, int objRank, float& dist, Math::Vector& pos)
 {
     assert(objRank >= 0 && objRank < static_cast<int>(m_objects.size()));
 
@@ -2333,48 +2583,60 @@ bool CEngine::LoadAllTextures()
 
     for (int objRank = 0; objRank < static_cast<int>( m_objects.size() ); objRank++)
     {
-        if (! m_objects[objRank].used)
-            continue;
+        if (! LoadObjectTextures(objRank))
+            ok = false;
+    }
 
-        bool terrain = false;
-        if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
-            terrain = true;
+    return ok;
+}
 
-        int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
+bool CEngine::LoadObjectTextures(int objRank)
+{
+    assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
-        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+    if (! m_objects[objRank].used)
+        return true;
 
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
-            continue;
+    bool terrain = false;
+    if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
+        terrain = true;
 
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
+    int baseObjRank = m_objects[objRank].baseObjRank;
+    if (baseObjRank == -1)
+        return true;
 
-            if (! p2.tex1Name.empty())
-            {
-                if (terrain)
-                    p2.tex1 = LoadTexture("textures/"+p2.tex1Name, m_terrainTexParams);
-                else
-                    p2.tex1 = LoadTexture("textures/"+p2.tex1Name);
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
 
-                if (! p2.tex1.Valid())
-                    ok = false;
-            }
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+    if (! p1.used)
+        return true;
 
-            if (! p2.tex2Name.empty())
-            {
-                if (terrain)
-                    p2.tex2 = LoadTexture("textures/"+p2.tex2Name, m_terrainTexParams);
-                else
-                    p2.tex2 = LoadTexture("textures/"+p2.tex2Name);
+    bool ok = true;
 
-                if (! p2.tex2.Valid())
-                    ok = false;
-            }
+    for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
+    {
+        EngineBaseObjTexTier& p2 = p1.next[l2];
+
+        if (! p2.tex1Name.empty())
+        {
+            if (terrain)
+                p2.tex1 = LoadTexture("textures/"+p2.tex1Name, m_terrainTexParams);
+            else
+                p2.tex1 = LoadTexture("textures/"+p2.tex1Name);
+
+            if (! p2.tex1.Valid())
+                ok = false;
+        }
+
+        if (! p2.tex2Name.empty())
+        {
+            if (terrain)
+                p2.tex2 = LoadTexture("textures/"+p2.tex2Name, m_terrainTexParams);
+            else
+                p2.tex2 = LoadTexture("textures/"+p2.tex2Name);
+
+            if (! p2.tex2.Valid())
+                ok = false;
         }
     }
 
@@ -3023,6 +3285,16 @@ bool CEngine::GetTerrainShadows()
     return m_terrainShadows;
 }
 
+void CEngine::SetReleaseVertexCopies(bool value)
+{
+    m_releaseVertexCopies = value;
+}
+
+bool CEngine::GetReleaseVertexCopies()
+{
+    return m_releaseVertexCopies;
+}
+
 void CEngine::SetBackForce(bool present)
 {
     m_backForce = present;
@@ -3172,9 +3444,11 @@ void CEngine::Render()
         return;
 
     m_statisticTriangle = 0;
+    m_statisticParticleDraws = 0;
     m_lastState = -1;
     m_lastColor = Color(-1.0f);
     m_lastMaterial = Material();
+    m_objectsCulled = false;
 
     m_lightMan->UpdateLights();
 
@@ -3271,51 +3545,25 @@ void CEngine::Draw3DScene()
 
     UseShadowMapping(true);
 
-    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-    {
-        if (! m_objects[objRank].used)
-            continue;
+    if (! m_objectsCulled)
+        CullObjects(false);
+
+    m_opaqueQueue->Clear();
 
+    for (int objRank : m_visibleObjects)
+    {
         if (m_objects[objRank].type != ENG_OBJTYPE_TERRAIN)
             continue;
 
         if (! m_objects[objRank].drawWorld)
             continue;
 
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-        if (! IsVisible(objRank))
-            continue;
-
-        int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
-
-        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
-
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
-            continue;
-
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            SetTexture(p2.tex1, 0);
-            SetTexture(p2.tex2, 1);
-
-            for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                SetMaterial(p3.material);
-                SetState(p3.state);
-
-                DrawObject(p3);
-            }
-        }
+        QueueObject(objRank, *m_opaqueQueue);
     }
 
+    m_opaqueQueue->SortByState();
+    DrawRenderQueue(*m_opaqueQueue);
+
     if (!m_qualityShadows)
         UseShadowMapping(false);
 
@@ -3329,119 +3577,36 @@ void CEngine::Draw3DScene()
 
     CProfiler::StartPerformanceCounter(PCNT_RENDER_OBJECTS);
 
-    bool transparent = false;
+    m_opaqueQueue->Clear();
+    m_transparentQueue->Clear();
 
-    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
+    for (int objRank : m_visibleObjects)
     {
-        if (! m_objects[objRank].used)
-            continue;
-
         if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
             continue;
 
         if (! m_objects[objRank].drawWorld)
             continue;
 
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-        if (! IsVisible(objRank))
-            continue;
-
-        int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
-
-        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
-
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
-            continue;
-
-        m_lightMan->UpdateDeviceLights(m_objects[objRank].type);
-
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            SetTexture(p2.tex1, 0);
-            SetTexture(p2.tex2, 1);
-
-            for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                if (m_objects[objRank].transparency != 0.0f)  // transparent ?
-                {
-                    transparent = true;
-                    continue;
-                }
-
-                SetMaterial(p3.material);
-                SetState(p3.state);
-
-                DrawObject(p3);
-            }
-        }
+        if (m_objects[objRank].transparency != 0.0f)  // transparent ?
+            QueueObject(objRank, *m_transparentQueue);
+        else
+            QueueObject(objRank, *m_opaqueQueue);
     }
 
+    m_opaqueQueue->SortByState();
+    DrawRenderQueue(*m_opaqueQueue);
+
     UseShadowMapping(false);
 
     // Draw transparent objects
 
-    if (transparent)
+    if (! m_transparentQueue->IsEmpty())
     {
-        int tState = ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_2FACE;
         Color tColor = Color(68.0f / 255.0f, 68.0f / 255.0f, 68.0f / 255.0f, 68.0f / 255.0f);
 
-        for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-        {
-            if (! m_objects[objRank].used)
-                continue;
-
-            if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
-                continue;
-
-            if (! m_objects[objRank].drawWorld)
-                continue;
-
-            m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-            if (! IsVisible(objRank))
-                continue;
-
-            int baseObjRank = m_objects[objRank].baseObjRank;
-            if (baseObjRank == -1)
-                continue;
-
-            assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
-
-            EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-            if (! p1.used)
-                continue;
-
-            m_lightMan->UpdateDeviceLights(m_objects[objRank].type);
-
-            for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-            {
-                EngineBaseObjTexTier& p2 = p1.next[l2];
-
-                SetTexture(p2.tex1, 0);
-                SetTexture(p2.tex2, 1);
-
-                for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-                {
-                    EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                    if (m_objects[objRank].transparency == 0.0f)
-                        continue;
-
-                    SetMaterial(p3.material);
-                    SetState(tState, tColor);
-
-                    DrawObject(p3);
-                }
-            }
-        }
+        m_transparentQueue->SortBackToFront();
+        DrawRenderQueue(*m_transparentQueue, tColor);
     }
 
     CProfiler::StopPerformanceCounter(PCNT_RENDER_OBJECTS);
@@ -3900,24 +4065,21 @@ void CEngine::RenderShadowMap()
     m_device->SetTexture(1, 0);
     m_device->SetTexture(2, 0);
 
-    // render objects into shadow map
-    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-    {
-        if (!m_objects[objRank].used)
-            continue;
+    CullObjects(true);
 
-        bool terrain = (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN);
+    // render objects into shadow map, terrain first
+    for (int pass = 0; pass < 2; pass++)
+    {
+        bool terrainPass = (pass == 0);
 
-        if (terrain)
+        if (terrainPass)
         {
-            if (m_terrainShadows)
-            {
-                m_device->SetRenderState(RENDER_STATE_ALPHA_TEST, false);
-                m_device->SetRenderState(RENDER_STATE_CULLING, true);
-                m_device->SetCullMode(CULL_CCW);
-            }
-            else
+            if (!m_terrainShadows)
                 continue;
+
+            m_device->SetRenderState(RENDER_STATE_ALPHA_TEST, false);
+            m_device->SetRenderState(RENDER_STATE_CULLING, true);
+            m_device->SetCullMode(CULL_CCW);
         }
         else
         {
@@ -3925,32 +4087,28 @@ void CEngine::RenderShadowMap()
             m_device->SetRenderState(RENDER_STATE_CULLING, false);
         }
 
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-        if (!IsVisible(objRank))
-            continue;
-
-        int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
+        for (int objRank : m_shadowObjects)
+        {
+            bool terrain = (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN);
+            if (terrain != terrainPass)
+                continue;
 
-        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
+            EngineBaseObject& p1 = m_baseObjects[m_objects[objRank].baseObjRank];
 
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (!p1.used)
-            continue;
+            m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
 
-        for (int l2 = 0; l2 < static_cast<int>(p1.next.size()); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
+            for (int l2 = 0; l2 < static_cast<int>(p1.next.size()); l2++)
+            {
+                EngineBaseObjTexTier& p2 = p1.next[l2];
 
-            SetTexture(p2.tex1, 0);
+                SetTexture(p2.tex1, 0);
 
-            for (int l3 = 0; l3 < static_cast<int>(p2.next.size()); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
+                for (int l3 = 0; l3 < static_cast<int>(p2.next.size()); l3++)
+                {
+                    EngineBaseObjDataTier& p3 = p2.next[l3];
 
-                DrawObject(p3);
+                    DrawObject(p3);
+                }
             }
         }
     }
@@ -4064,9 +4222,9 @@ void CEngine::DrawObject(const EngineBaseObjDataTier& p4)
         m_device->DrawStaticBuffer(p4.staticBufferId);
 
         if (p4.type == ENG_TRIANGLE_TYPE_TRIANGLES)
-            m_statisticTriangle += p4.vertices.size() / 3;
+            m_statisticTriangle += p4.GetVertexCount() / 3;
         else
-            m_statisticTriangle += p4.vertices.size() - 2;
+            m_statisticTriangle += p4.GetVertexCount() - 2;
     }
     else
     {
@@ -4083,6 +4241,207 @@ void CEngine::DrawObject(const EngineBaseObjDataTier& p4)
     }
 }
 
+void CEngine::DrawObjectInstanced(const EngineBaseObjDataTier& p4)
+{
+    int count = static_cast<int>(m_instanceTransforms.size());
+    m_device->DrawStaticBufferInstanced(p4.staticBufferId, m_instanceTransforms.data(), count);
+
+    if (p4.type == ENG_TRIANGLE_TYPE_TRIANGLES)
+        m_statisticTriangle += count * (p4.GetVertexCount() / 3);
+    else
+        m_statisticTriangle += count * (p4.GetVertexCount() - 2);
+}
+
+bool CEngine::GetObjectWorldSphere(int objRank, Math::Sphere& sphere)
+{
+    const EngineObject& object = m_objects[objRank];
+    if (! object.used)
+        return false;
+
+    if (object.baseObjRank == -1)
+        return false;
+
+    assert(object.baseObjRank >= 0 && object.baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    const EngineBaseObject& p1 = m_baseObjects[object.baseObjRank];
+    if (! p1.used)
+        return false;
+
+    // Largest scale along any axis keeps the sphere conservative for non-uniform scaling
+    const float* m = object.transform.m;
+    float scale = 0.0f;
+    for (int col = 0; col < 3; col++)
+    {
+        Math::Vector axis(m[col * 4 + 0], m[col * 4 + 1], m[col * 4 + 2]);
+        scale = Math::Max(scale, axis.Length());
+    }
+
+    sphere.pos = Math::Transform(object.transform, p1.boundingSphere.pos);
+    sphere.radius = p1.boundingSphere.radius * scale;
+    return true;
+}
+
+void CEngine::UpdateCullingTree()
+{
+    bool refit = false;
+
+    if (! m_cullingTreeDirty)
+    {
+        for (int objRank : m_movedObjects)
+        {
+            Math::Sphere sphere;
+            bool hasSphere = GetObjectWorldSphere(objRank, sphere);
+
+            if (hasSphere != m_cullingTree->Contains(objRank))
+            {
+                m_cullingTreeDirty = true;
+                break;
+            }
+
+            if (hasSphere)
+            {
+                m_cullingTree->Update(objRank, sphere);
+                refit = true;
+            }
+        }
+
+        // Refitting spreads the nodes when many objects move, rebuild instead
+        if (static_cast<int>( m_movedObjects.size() ) > m_cullingTree->GetItemCount() / 4 + 16)
+            m_cullingTreeDirty = true;
+    }
+
+    m_movedObjects.clear();
+
+    if (m_cullingTreeDirty)
+    {
+        std::vector<CullingItem> items;
+        items.reserve(m_objects.size());
+
+        for (int objRank = 0; objRank < static_cast<int>( m_objects.size() ); objRank++)
+        {
+            CullingItem item;
+            item.id = objRank;
+            if (GetObjectWorldSphere(objRank, item.sphere))
+                items.push_back(item);
+        }
+
+        m_cullingTree->Build(std::move(items));
+        m_cullingTreeDirty = false;
+    }
+    else if (refit)
+    {
+        m_cullingTree->Refit();
+    }
+}
+
+void CEngine::CullObjects(bool shadows)
+{
+    UpdateCullingTree();
+
+    for (int objRank : m_visibleObjects)
+    {
+        if (objRank < static_cast<int>( m_objects.size() ))
+            m_objects[objRank].visible = false;
+    }
+
+    // Devices flip the Z axis of view matrix, same has to be done here to get matching planes
+    Math::Matrix flipZ;
+    Math::LoadScaleMatrix(flipZ, Math::Vector(1.0f, 1.0f, -1.0f));
+
+    Math::Frustum frusta[2];
+    frusta[0] = Math::ExtractFrustum(Math::MultiplyMatrices(m_matProj, Math::MultiplyMatrices(flipZ, m_matView)));
+    if (shadows)
+        frusta[1] = Math::ExtractFrustum(Math::MultiplyMatrices(m_shadowProjMat, Math::MultiplyMatrices(flipZ, m_shadowViewMat)));
+
+    std::vector<int> visible[2];
+    visible[0].swap(m_visibleObjects);
+    visible[1].swap(m_shadowObjects);
+    visible[0].clear();
+    visible[1].clear();
+
+    m_cullingTree->Cull(frusta, shadows ? 2 : 1, visible);
+
+    m_visibleObjects.swap(visible[0]);
+    m_shadowObjects.swap(visible[1]);
+
+    for (int objRank : m_visibleObjects)
+        m_objects[objRank].visible = true;
+
+    m_objectsCulled = true;
+}
+
+void CEngine::QueueObject(int objRank, CRenderQueue& queue)
+{
+    int baseObjRank = m_objects[objRank].baseObjRank;
+    if (baseObjRank == -1)
+        return;
+
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+    if (! p1.used)
+        return;
+
+    RenderItem item;
+    item.objRank = objRank;
+    item.objType = m_objects[objRank].type;
+    item.transform = &m_objects[objRank].transform;
+
+    bool transparent = m_objects[objRank].transparency != 0.0f;
+    if (transparent)
+    {
+        Math::Vector center = Math::Transform(m_objects[objRank].transform, p1.boundingSphere.pos);
+        item.depth = Math::Distance(center, m_eyePt);
+    }
+
+    for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
+    {
+        EngineBaseObjTexTier& p2 = p1.next[l2];
+
+        item.tex1 = p2.tex1;
+        item.tex2 = p2.tex2;
+
+        for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
+        {
+            EngineBaseObjDataTier& p3 = p2.next[l3];
+
+            item.state = transparent ? (ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_2FACE) : p3.state;
+            item.data = &p3;
+
+            queue.Add(item);
+        }
+    }
+}
+
+void CEngine::DrawRenderQueue(const CRenderQueue& queue, const Color& color)
+{
+    int lightType = -1;
+
+    // Copies of one model drawn with the same state are sent as a single instanced draw
+    queue.SubmitInstanced(m_device, [&](const RenderItem* items, int count)
+    {
+        if (items[0].objType != lightType)
+        {
+            m_lightMan->UpdateDeviceLights(items[0].objType);
+            lightType = items[0].objType;
+        }
+
+        SetState(items[0].state, color);
+
+        if (count == 1)
+        {
+            DrawObject(*items[0].data);
+            return;
+        }
+
+        m_instanceTransforms.clear();
+        for (int i = 0; i < count; i++)
+            m_instanceTransforms.push_back(*items[i].transform);
+
+        DrawObjectInstanced(*items[0].data);
+    });
+}
+
 void CEngine::DrawInterface()
 {
     m_device->SetRenderMode(RENDER_MODE_INTERFACE);
@@ -5119,7 +5478,7 @@ void CEngine::DrawStats()
 
     float height = m_text->GetAscent(FONT_COLOBOT, 13.0f);
     float width = 0.4f;
-    const int TOTAL_LINES = 22;
+    const int TOTAL_LINES = 24 + static_cast<int>(m_statisticLines.size());
 
     Math::Point pos(0.05f * m_size.x/m_size.y, 0.05f + TOTAL_LINES * height);
 
@@ -5207,11 +5566,37 @@ void CEngine::DrawStats()
     drawStatsCounter("Swap buffers & VSync",  PCNT_SWAP_BUFFERS);
     drawStatsLine(   "", "", "");
     drawStatsLine(   "Triangles",         StrUtils::ToString<int>(m_statisticTriangle), "");
+    drawStatsLine(   "Particle draws",    StrUtils::ToString<int>(m_statisticParticleDraws), "");
+
+    // CPU memory held by vertices of base objects, full copies and compact copies of released ones
+    std::size_t hotVertexBytes = 0;
+    std::size_t coldVertexBytes = 0;
+    for (const EngineBaseObject& p1 : m_baseObjects)
+    {
+        if (! p1.used)
+            continue;
+
+        for (const EngineBaseObjTexTier& p2 : p1.next)
+        {
+            for (const EngineBaseObjDataTier& p3 : p2.next)
+            {
+                hotVertexBytes += p3.vertices.capacity() * sizeof(VertexTex2);
+                coldVertexBytes += p3.coldVertices.capacity() * sizeof(VertexTex2) +
+                                   p3.coldIndices.capacity() * sizeof(unsigned short);
+            }
+        }
+    }
+    drawStatsLine(   "Vertex memory",     StrUtils::Format("%d KB", static_cast<int>(hotVertexBytes / 1024)),
+                                          StrUtils::Format("%d KB", static_cast<int>(coldVertexBytes / 1024)));
     drawStatsLine(   "FPS",               StrUtils::Format("%.3f", m_fps), "");
     drawStatsLine(   "", "", "");
     std::stringstream str;
     str << std::fixed << std::setprecision(2) << m_statisticPos.x << "; " << m_statisticPos.z;
     drawStatsLine(   "Position",          str.str(), "");
+    for (const auto& line : m_statisticLines)
+    {
+        drawStatsLine(line[0], line[1], line[2]);
+    }
 }
 
 void CEngine::DrawTimer()
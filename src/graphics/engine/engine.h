@@ -71,6 +71,8 @@ class CPlanet;
 class CTerrain;
 class CPyroManager;
 class CModelMesh;
+class CRenderQueue;
+class CCullingTree;
 struct ModelShadowSpot;
 struct ModelTriangle;
 
@@ -197,8 +199,13 @@ struct EngineBaseObjDataTier
     Material                material;
     int                     state;
     std::vector<VertexTex2> vertices;
+    //! Compact copy of released vertices: unique vertices and indices into them
+    std::vector<VertexTex2> coldVertices;
+    std::vector<unsigned short> coldIndices;
     unsigned int            staticBufferId;
     bool                    updateStaticBuffer;
+    //! If true, vertices are not released after upload (they are changed often or don't compact)
+    bool                    keepVertices;
 
     inline EngineBaseObjDataTier(EngineTriangleType type = ENG_TRIANGLE_TYPE_TRIANGLES,
                                  const Material& material = Material(),
@@ -208,9 +215,39 @@ struct EngineBaseObjDataTier
      , state(state)
      , staticBufferId(0)
      , updateStaticBuffer(false)
+     , keepVertices(false)
     {}
+
+    //! Returns the number of vertices, also when they are released
+    inline int GetVertexCount() const
+    {
+        if (vertices.empty())
+            return coldIndices.size();
+
+        return vertices.size();
+    }
+
+    //! Returns vertex \a index, reading the cold copy when vertices are released
+    inline const VertexTex2& GetVertex(int index) const
+    {
+        if (vertices.empty())
+            return coldVertices[coldIndices[index]];
+
+        return vertices[index];
+    }
 };
 
+//! Replaces vertices of \a p4 with a compact copy if that saves memory
+/**
+ * The copy has the unique vertices and 16-bit indices into them.
+ * When the vertices don't fit in it or it would not be smaller,
+ * p4.keepVertices is set and the vertices are kept.
+ * \return true if the vertices were released
+ */
+bool ReleaseVertices(EngineBaseObjDataTier& p4);
+//! Rebuilds vertices released with ReleaseVertices()
+void RestoreVertices(EngineBaseObjDataTier& p4);
+
 /**
  * \struct EngineBaseObjTexTier
  * \brief Tier 2 of base object tree (textures)
@@ -267,6 +304,10 @@ struct EngineObject
     bool                   used = false;
     //! Rank of associated base engine object
     int                    baseObjRank = -1;
+    //! If true, the base object is shared and is copied before it is first changed through this object
+    bool                   copyOnWrite = false;
+    //! If true, the base object is a private copy deleted together with this object
+    bool                   ownsBaseObj = false;
     //! If true, the object is drawn
     bool                   visible = false;
     //! If true, object is behind the 2D interface
@@ -683,9 +724,15 @@ public:
     void            AddStatisticTriangle(int count);
     //! Returns the number of triangles in current frame
     int             GetStatisticTriangle();
+    //! Increments the particle draw call counter for the current frame
+    void            AddStatisticParticleDraws(int count);
+    //! Returns the number of draw calls issued for particles in current frame
+    int             GetStatisticParticleDraws();
 
     //! Sets the coordinates to display in stats window
     void            SetStatisticPos(Math::Vector pos);
+    //! Sets a line of game statistics to display in stats window, replacing the line with the same name
+    void            SetStatisticLine(const std::string& name, const std::string& value, const std::string& value2 = "");
 
     //! Sets text to display as mission timer
     void            SetTimerDisplay(const std::string& text);
@@ -737,6 +784,17 @@ public:
     void            AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buffer,
                                     std::string tex1Name, std::string tex2Name,
                                     bool globalUpdate);
+    /**
+     * \brief Replaces the vertices of a tier 4 object added with AddBaseObjQuick()
+     *
+     * The static buffer is updated in place and the bounding box of the base object is recomputed.
+     * \param index index of the tier among the ones with the same textures, in order of addition
+     * \return false if there is no such tier
+     */
+    bool            UpdateBaseObjQuick(int baseObjRank, int index, const std::vector<VertexTex2>& vertices,
+                                       const std::string& tex1Name, const std::string& tex2Name);
+    //! Recomputes the bounding box of the base object
+    void            UpdateBaseObjBBox(int baseObjRank);
 
     // Objects
 
@@ -756,6 +814,15 @@ public:
     int             GetObjectBaseRank(int objRank);
     //@}
 
+    /**
+     * \brief Marks the base object of given object as copy-on-write
+     *
+     * The object keeps referencing the shared base object until its geometry is changed
+     * with ChangeSecondTexture(), ChangeTextureMapping() or TrackTextureMapping().
+     * Only then it gets a private copy, which is deleted together with the object.
+     */
+    void            SetObjectCopyOnWrite(int objRank, bool copyOnWrite);
+
     //@{
     //! Management of engine object type
     void            SetObjectType(int objRank, EngineObjectType type);
@@ -786,6 +853,9 @@ public:
     EngineBaseObjDataTier* FindTriangles(int objRank, const Material& material,
                                          int state, std::string tex1Name, std::string tex2Name);
 
+    //! Gives the object a private copy of its base object if it is marked as copy-on-write
+    void            MakeObjectBaseUnique(int objRank);
+
     //! Returns a partial list of triangles for given object
     int             GetPartialTriangles(int objRank, float percent, int maxCount,
                                         std::vector<EngineTriangle>& triangles);
@@ -880,6 +950,8 @@ public:
     Texture         LoadTexture(const std::string& name, const TextureCreateParams& params);
     //! Loads all necessary textures
     bool            LoadAllTextures();
+    //! Loads the textures of a single object, leaving the rest of the scene untouched
+    bool            LoadObjectTextures(int objRank);
 
     //! Changes colors in a texture
     //@{
@@ -1072,6 +1144,13 @@ public:
     bool            GetTerrainShadows();
     //@}
 
+    //@{
+    //! Management of releasing CPU copies of vertices after they are uploaded to static buffers
+    // NOTE: This is a setting configurable only in INI file
+    void            SetReleaseVertexCopies(bool value);
+    bool            GetReleaseVertexCopies();
+    //@}
+
     //@{
     //! Management of shadow color
     // NOTE: This is a setting configurable only in INI file
@@ -1201,6 +1280,18 @@ protected:
     void        UseMSAA(bool enable);
     //! Draw 3D object
     void        DrawObject(const EngineBaseObjDataTier& p4);
+    //! Draw 3D object once for each world matrix in m_instanceTransforms
+    void        DrawObjectInstanced(const EngineBaseObjDataTier& p4);
+    //! Computes bounding sphere of object in world coordinates; returns false if the object has no geometry
+    bool        GetObjectWorldSphere(int objRank, Math::Sphere& sphere);
+    //! Rebuilds or refits the culling tree after objects were changed
+    void        UpdateCullingTree();
+    //! Finds objects visible from the camera and, if \a shadows is set, objects visible in the shadow map
+    void        CullObjects(bool shadows);
+    //! Adds the draw items of a visible object to the queue
+    void        QueueObject(int objRank, CRenderQueue& queue);
+    //! Draws the items of a sorted queue with the given state color
+    void        DrawRenderQueue(const CRenderQueue& queue, const Color& color = Color(1.0f, 1.0f, 1.0f, 1.0f));
     //! Draws the user interface over the scene
     void        DrawInterface();
 
@@ -1249,7 +1340,7 @@ protected:
     bool        GetBBox2D(int objRank, Math::Point& min, Math::Point& max);
 
     //! Detects whether the mouse is in a triangle.
-    bool        DetectTriangle(Math::Point mouse, VertexTex2* triangle, int objRank, float& dist, Math::Vector& pos);
+    bool        DetectTriangle(Math::Point mouse, const VertexTex2* triangle, int objRank, float& dist, Math::Vector& pos);
 
     //! Transforms a 3D point (x, y, z) in 2D space (x, y, -) of the window
     /** The coordinated p2D.z gives the distance. */
@@ -1299,6 +1390,9 @@ protected:
     std::unique_ptr<CLightning>       m_lightning;
     std::unique_ptr<CPlanet>          m_planet;
     std::unique_ptr<CPyroManager> m_pyroManager;
+    std::unique_ptr<CRenderQueue>     m_opaqueQueue;
+    std::unique_ptr<CRenderQueue>     m_transparentQueue;
+    std::unique_ptr<CCullingTree>     m_cullingTree;
 
     //! Last encountered error
     std::string     m_error;
@@ -1371,7 +1465,10 @@ protected:
     float           m_fogStart[2];
     Color           m_waterAddColor;
     int             m_statisticTriangle;
+    int             m_statisticParticleDraws;
     Math::Vector    m_statisticPos;
+    //! Game statistics: name, value, value2
+    std::vector<std::vector<std::string>> m_statisticLines;
     bool            m_updateGeometry;
     bool            m_updateStaticBuffers;
     bool            m_firstGroundSpot;
@@ -1444,6 +1541,8 @@ protected:
     bool m_qualityShadows;
     //! true enables casting shadows by terrain
     bool m_terrainShadows;
+    //! true releases CPU copies of vertices after upload to static buffers
+    bool m_releaseVertexCopies;
     //! Shadow color
     float m_shadowColor;
     //! Shadow range
@@ -1499,6 +1598,19 @@ protected:
     bool            m_captureWorld = false;
     //! Texture with captured 3D world
     Texture         m_capturedWorldTexture;
+
+    //! Culling tree must be rebuilt (objects added, removed or changed geometry)
+    bool            m_cullingTreeDirty = true;
+    //! Objects whose transform changed since the last culling
+    std::vector<int> m_movedObjects;
+    //! Objects visible from the camera in current frame
+    std::vector<int> m_visibleObjects;
+    //! Objects visible in the shadow map in current frame
+    std::vector<int> m_shadowObjects;
+    //! Whether visible objects were already found in current frame
+    bool            m_objectsCulled = false;
+    //! World matrices of the instances drawn by DrawObjectInstanced()
+    std::vector<Math::Matrix> m_instanceTransforms;
 };
 
 
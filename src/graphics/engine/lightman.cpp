@@ -78,6 +78,7 @@ CLightManager::CLightManager(CEngine* engine)
     m_engine = engine;
 
     m_time = 0.0f;
+    m_deviceLightsValid = false;
 }
 
 CLightManager::~CLightManager()
@@ -90,6 +91,7 @@ void CLightManager::SetDevice(CDevice* device)
 {
     m_device = device;
     m_lightMap = std::vector<int>(m_device->GetMaxLightCount(), -1);
+    InvalidateLights();
 }
 
 void CLightManager::DebugDumpLights()
@@ -150,6 +152,7 @@ void CLightManager::DebugDumpLights()
 void CLightManager::FlushLights()
 {
     m_dynLights.clear();
+    InvalidateLights();
 }
 
 /** Returns the index of light created. */
@@ -185,6 +188,8 @@ int CLightManager::CreateLight(LightPriority priority)
     m_dynLights[index].colorGreen.Init(0.5f);
     m_dynLights[index].colorBlue.Init(0.5f);  // gray
 
+    InvalidateLights();
+
     return index;
 }
 
@@ -194,6 +199,7 @@ bool CLightManager::DeleteLight(int lightRank)
         return false;
 
     m_dynLights[lightRank].used = false;
+    InvalidateLights();
     return true;
 }
 
@@ -208,6 +214,7 @@ bool CLightManager::SetLight(int lightRank, const Light &light)
     m_dynLights[lightRank].colorGreen.Init(m_dynLights[lightRank].light.diffuse.g);
     m_dynLights[lightRank].colorBlue.Init(m_dynLights[lightRank].light.diffuse.b);
 
+    InvalidateLights();
     return true;
 }
 
@@ -226,6 +233,7 @@ bool CLightManager::SetLightEnabled(int lightRank, bool enabled)
         return false;
 
     m_dynLights[lightRank].enabled = enabled;
+    InvalidateLights();
     return true;
 }
 
@@ -235,6 +243,7 @@ bool CLightManager::SetLightPriority(int lightRank, LightPriority priority)
         return false;
 
     m_dynLights[lightRank].priority = priority;
+    InvalidateLights();
     return true;
 }
 
@@ -244,6 +253,7 @@ bool CLightManager::SetLightIncludeType(int lightRank, EngineObjectType type)
         return false;
 
     m_dynLights[lightRank].includeType = type;
+    InvalidateLights();
     return true;
 }
 
@@ -253,6 +263,7 @@ bool CLightManager::SetLightExcludeType(int lightRank, EngineObjectType type)
         return false;
 
     m_dynLights[lightRank].excludeType = type;
+    InvalidateLights();
     return true;
 }
 
@@ -262,6 +273,7 @@ bool CLightManager::SetLightPos(int lightRank, const Math::Vector &pos)
         return false;
 
     m_dynLights[lightRank].light.position = pos;
+    InvalidateLights();
     return true;
 }
 
@@ -279,6 +291,7 @@ bool CLightManager::SetLightDir(int lightRank, const Math::Vector &dir)
         return false;
 
     m_dynLights[lightRank].light.direction = dir;
+    InvalidateLights();
     return true;
 }
 
@@ -305,6 +318,7 @@ bool CLightManager::SetLightIntensity(int lightRank, float value)
         return false;
 
     m_dynLights[lightRank].intensity.SetTarget(value);
+    InvalidateLights();
     return true;
 }
 
@@ -336,6 +350,7 @@ bool CLightManager::SetLightColor(int lightRank, const Color &color)
     m_dynLights[lightRank].colorRed.SetTarget(color.r);
     m_dynLights[lightRank].colorGreen.SetTarget(color.g);
     m_dynLights[lightRank].colorBlue.SetTarget(color.b);
+    InvalidateLights();
     return true;
 }
 
@@ -408,6 +423,8 @@ void CLightManager::UpdateProgression(float rTime)
             m_dynLights[i].light.direction.z = cosf(2.0f * angle);
         }
     }
+
+    InvalidateLights();
 }
 
 void CLightManager::UpdateLights()
@@ -440,43 +457,29 @@ void CLightManager::UpdateLights()
             m_dynLights[i].light.diffuse.b = 0.0f;
         }
     }
+
+    InvalidateLights();
 }
 
 void CLightManager::UpdateDeviceLights(EngineObjectType type)
 {
-    for (int i = 0; i < static_cast<int>( m_lightMap.size() ); ++i)
-        m_lightMap[i] = -1;
-
-    std::vector<DynamicLight> sortedLights = m_dynLights;
-    CLightsComparator lightsComparator(m_engine->GetEyePt(), type);
-    std::sort(sortedLights.begin(), sortedLights.end(), lightsComparator);
-
-    int lightMapIndex = 0;
-    for (int i = 0; i < static_cast<int>( sortedLights.size() ); i++)
+    Math::Vector eyePt = m_engine->GetEyePt();
+    if (! Math::VectorsEqual(eyePt, m_selectionEyePt))
     {
-        if (! sortedLights[i].used)
-            continue;
-        if (! sortedLights[i].enabled)
-            continue;
-        if (sortedLights[i].intensity.current == 0.0f)
-            continue;
-
-        bool enabled = true;
-        if (sortedLights[i].includeType != ENG_OBJTYPE_NULL)
-            enabled = (sortedLights[i].includeType == type);
+        m_lightSelection.clear();
+        m_selectionEyePt = eyePt;
+    }
 
-        if (sortedLights[i].excludeType != ENG_OBJTYPE_NULL)
-            enabled = (sortedLights[i].excludeType != type);
+    auto it = m_lightSelection.find(type);
+    if (it == m_lightSelection.end())
+        it = m_lightSelection.insert(std::make_pair(type, SelectLights(type))).first;
 
-        if (enabled)
-        {
-            m_lightMap[lightMapIndex] = sortedLights[i].rank;
-            ++lightMapIndex;
-        }
+    // Device already has these lights with current parameters
+    if (m_deviceLightsValid && it->second == m_lightMap)
+        return;
 
-        if (lightMapIndex >= static_cast<int>( m_lightMap.size() ))
-            break;
-    }
+    m_lightMap = it->second;
+    m_deviceLightsValid = true;
 
     for (int i = 0; i < static_cast<int>( m_lightMap.size() ); ++i)
     {
@@ -494,6 +497,59 @@ void CLightManager::UpdateDeviceLights(EngineObjectType type)
     }
 }
 
+std::vector<int> CLightManager::SelectLights(EngineObjectType type)
+{
+    std::vector<int> lightMap(m_lightMap.size(), -1);
+
+    std::vector<int> sortedRanks;
+    sortedRanks.reserve(m_dynLights.size());
+    for (int i = 0; i < static_cast<int>( m_dynLights.size() ); i++)
+        sortedRanks.push_back(i);
+
+    CLightsComparator lightsComparator(m_selectionEyePt, type);
+    std::sort(sortedRanks.begin(), sortedRanks.end(), [&](int left, int right)
+    {
+        return lightsComparator(m_dynLights[left], m_dynLights[right]);
+    });
+
+    int lightMapIndex = 0;
+    for (int i = 0; i < static_cast<int>( sortedRanks.size() ); i++)
+    {
+        const DynamicLight& dynLight = m_dynLights[sortedRanks[i]];
+
+        if (lightMapIndex >= static_cast<int>( lightMap.size() ))
+            break;
+
+        if (! dynLight.used)
+            continue;
+        if (! dynLight.enabled)
+            continue;
+        if (dynLight.intensity.current == 0.0f)
+            continue;
+
+        bool enabled = true;
+        if (dynLight.includeType != ENG_OBJTYPE_NULL)
+            enabled = (dynLight.includeType == type);
+
+        if (dynLight.excludeType != ENG_OBJTYPE_NULL)
+            enabled = (dynLight.excludeType != type);
+
+        if (enabled)
+        {
+            lightMap[lightMapIndex] = dynLight.rank;
+            ++lightMapIndex;
+        }
+    }
+
+    return lightMap;
+}
+
+void CLightManager::InvalidateLights()
+{
+    m_lightSelection.clear();
+    m_deviceLightsValid = false;
+}
+
 // -----------
 
 CLightManager::CLightsComparator::CLightsComparator(Math::Vector eyePos, EngineObjectType objectType)
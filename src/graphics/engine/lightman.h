@@ -30,6 +30,9 @@
 
 #include "math/vector.h"
 
+#include <map>
+#include <vector>
+
 
 // Graphics module namespace
 namespace Gfx
@@ -142,6 +145,10 @@ struct DynamicLight
  * updating the models with new values, while only one function, UpdateDeviceLights(), performs the actual
  * synchronization to the device. It allocates device's light slots as necessary, with two priority levels
  * for lights.
+ *
+ * The selection of lights for each object type is cached until any light changes or the camera moves,
+ * which normally means once per frame. Lights are sent to the device only when the selection
+ * or light parameters differ from what the device already has.
  */
 class CLightManager
 {
@@ -211,6 +218,12 @@ public:
     //! Enables or disables dynamic lights affecting the given object type
     void            UpdateDeviceLights(EngineObjectType type);
 
+protected:
+    //! Returns the device light allocation for the given object type
+    std::vector<int> SelectLights(EngineObjectType type);
+    //! Discards cached light selections and forces sending lights to the device again
+    void            InvalidateLights();
+
 protected:
     class CLightsComparator
     {
@@ -236,6 +249,12 @@ protected:
     std::vector<DynamicLight> m_dynLights;
     //! Map of current light allocation: graphics light -> dynamic light
     std::vector<int>  m_lightMap;
+    //! Whether the device lights match m_lightMap and current light parameters
+    bool              m_deviceLightsValid;
+    //! Cached light allocations per object type
+    std::map<EngineObjectType, std::vector<int>> m_lightSelection;
+    //! Camera position used for cached light allocations
+    Math::Vector      m_selectionEyePt;
 };
 
 } // namespace Gfx
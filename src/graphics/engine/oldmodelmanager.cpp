@@ -24,11 +24,9 @@
 #include "common/logger.h"
 #include "common/stringutils.h"
 
-#include "common/resources/inputstream.h"
-
 #include "graphics/engine/engine.h"
 
-#include "graphics/model/model_input.h"
+#include "graphics/model/model_cache.h"
 #include "graphics/model/model_io_exception.h"
 
 #include <cstdio>
@@ -52,12 +50,7 @@ bool COldModelManager::LoadModel(const std::string& fileName, bool mirrored, int
     CModel model;
     try
     {
-        CInputStream stream;
-        stream.open("models/" + fileName);
-        if (!stream.is_open())
-            throw CModelIOException(std::string("Could not open file '") + fileName + "'");
-
-        model = ModelInput::Read(stream, ModelFormat::Old);
+        model = ModelCache::Load("models/" + fileName, ModelFormat::Old);
     }
     catch (const CModelIOException& e)
     {
@@ -68,20 +61,23 @@ bool COldModelManager::LoadModel(const std::string& fileName, bool mirrored, int
     CModelMesh* mesh = model.GetMesh("main");
     assert(mesh != nullptr);
 
-    ModelInfo modelInfo;
-    modelInfo.baseObjRank = m_engine->CreateBaseObject();
-    modelInfo.triangles = mesh->GetTriangles();
+    std::vector<ModelTriangle> triangles = mesh->GetTriangles();
 
     if (mirrored)
-        Mirror(modelInfo.triangles);
+        Mirror(triangles);
 
     if (variant != 0)
-        ChangeVariant(modelInfo.triangles, variant);
+        ChangeVariant(triangles, variant);
+
+    // The triangles are only needed to build the shared base object,
+    // all instances of the model reference that instead of keeping a copy
+    ModelInfo modelInfo;
+    modelInfo.baseObjRank = m_engine->CreateBaseObject();
 
     FileInfo fileInfo(fileName, mirrored, variant);
     m_models[fileInfo] = modelInfo;
 
-    m_engine->AddBaseObjTriangles(modelInfo.baseObjRank, modelInfo.triangles);
+    m_engine->AddBaseObjTriangles(modelInfo.baseObjRank, triangles);
 
     return true;
 }
@@ -113,11 +109,9 @@ bool COldModelManager::AddModelCopy(const std::string& fileName, bool mirrored,
         it = m_models.find(FileInfo(fileName, mirrored, variant));
     }
 
-    int copyBaseObjRank = m_engine->CreateBaseObject();
-    m_engine->CopyBaseObject((*it).second.baseObjRank, copyBaseObjRank);
-    m_engine->SetObjectBaseRank(objRank, copyBaseObjRank);
-
-    m_copiesBaseRanks.push_back(copyBaseObjRank);
+    // The copy is made by the engine only when the geometry is actually changed
+    m_engine->SetObjectBaseRank(objRank, (*it).second.baseObjRank);
+    m_engine->SetObjectCopyOnWrite(objRank, true);
 
     return true;
 }
@@ -136,16 +130,6 @@ int COldModelManager::GetModelBaseObjRank(const std::string& fileName, bool mirr
     return (*it).second.baseObjRank;
 }
 
-void COldModelManager::DeleteAllModelCopies()
-{
-    for (int baseObjRank : m_copiesBaseRanks)
-    {
-        m_engine->DeleteBaseObject(baseObjRank);
-    }
-
-    m_copiesBaseRanks.clear();
-}
-
 void COldModelManager::UnloadModel(const std::string& fileName, bool mirrored, int variant)
 {
     auto it = m_models.find(FileInfo(fileName, mirrored, variant));
@@ -49,7 +49,9 @@ class CEngine;
  *
  * There is also a possibility of creating a copy of model so it has
  * its own and unique base engine object. This is especially useful
- * for models where the geometry must be altered.
+ * for models where the geometry must be altered. The copy is deferred:
+ * the instance references the shared base object until its geometry
+ * is first changed, and the private copy is deleted with the instance.
  */
 class COldModelManager
 {
@@ -63,7 +65,7 @@ public:
     //! Adds an instance of model to the given object rank as a reference to base object
     bool AddModelReference(const std::string& fileName, bool mirrored, int objRank, int variant = 0);
 
-    //! Adds an instance of model to the given object rank as a copy (copied base object)
+    //! Adds an instance of model to the given object rank as a copy-on-write reference to base object
     bool AddModelCopy(const std::string& fileName, bool mirrored, int objRank, int variant = 0);
 
     //! Returns true if given model is loaded
@@ -72,9 +74,6 @@ public:
     //! Returns the rank of base engine object of given loaded model
     int GetModelBaseObjRank(const std::string& fileName, bool mirrored, int variant = 0);
 
-    //! Deletes all copied objects
-    void DeleteAllModelCopies();
-
     //! Unloads the given model
     void UnloadModel(const std::string& fileName, bool mirrored, int variant = 0);
     //! Unloads all models
@@ -89,7 +88,6 @@ protected:
 private:
     struct ModelInfo
     {
-        std::vector<ModelTriangle> triangles;
         int baseObjRank = -1;
     };
     struct FileInfo
@@ -112,14 +110,13 @@ private:
             if (compare > 0)
                 return false;
 
-            if (variant < other.variant)
-                return true;
+            if (variant != other.variant)
+                return variant < other.variant;
 
-            return !mirrored && mirrored != other.mirrored;
+            return !mirrored && other.mirrored;
         }
     };
     std::map<FileInfo, ModelInfo> m_models;
-    std::vector<int> m_copiesBaseRanks;
     CEngine* m_engine;
 };
 
@@ -24,6 +24,8 @@
 
 #include "common/logger.h"
 
+#include "common/thread/thread_pool.h"
+
 #include "graphics/core/device.h"
 
 #include "graphics/engine/engine.h"
@@ -37,13 +39,17 @@
 
 #include "object/object.h"
 #include "object/object_manager.h"
+#include "object/world_query.h"
 
 #include "object/interface/damageable_object.h"
 
 #include "object/subclass/shielder.h"
 
+#include "object/task/taskshield.h"
+
 #include "sound/sound.h"
 
+#include <algorithm>
 #include <cstring>
 
 
@@ -55,6 +61,9 @@ namespace Gfx
 const float FOG_HSUP    = 10.0f;
 const float FOG_HINF    = 100.0f;
 
+//! Particles integrated by one task of the thread pool
+const int PARTICLE_CHUNK_SIZE = 256;
+
 
 //! Check if an object is a destroyable enemy
 static bool IsAlien(ObjectType type)
@@ -89,8 +98,13 @@ void CParticle::SetDevice(CDevice* device)
 
 void CParticle::FlushParticle()
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
-        m_particle[i].used = false;
+    m_particle.clear();
+    m_motion.Clear();
+    m_freeParticles.clear();
+    m_triangle.clear();
+
+    for (int i = 0; i < MAXPARTITYPE; i++)
+        m_liveParticles[i].clear();
 
     for (int i = 0; i < MAXPARTITYPE; i++)
     {
@@ -100,8 +114,7 @@ void CParticle::FlushParticle()
         }
     }
 
-    for (int i = 0; i < MAXTRACK; i++)
-        m_track[i].used = false;
+    m_track.clear();
 
     m_wheelTraceTotal = 0;
     m_wheelTraceIndex = 0;
@@ -109,25 +122,29 @@ void CParticle::FlushParticle()
     for (int i = 0; i < SH_MAX; i++)
         m_frameUpdate[i] = true;
 
-    m_fogTotal = 0;
+    m_fog.clear();
     m_exploGunCounter = 0;
 }
 
 void CParticle::FlushParticle(int sheet)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    for (int t = 0; t < MAXPARTITYPE; t++)
     {
-        if (!m_particle[i].used) continue;
-        if (m_particle[i].sheet != sheet) continue;
+        // Backwards, since deleting moves the last particle of the list
+        for (int k = static_cast<int>(m_liveParticles[t].size())-1; k >= 0; k--)
+        {
+            int i = m_liveParticles[t][k];
+            if (m_particle[i].sheet != sheet) continue;
 
-        m_particle[i].used = false;
+            DeleteRank(i);
+        }
     }
 
     for (int i = 0; i < MAXPARTITYPE; i++)
         m_totalInterface[i][sheet] = 0;
 
-    for (int i = 0; i < MAXTRACK; i++)
-        m_track[i].used = false;
+    for (Track& track : m_track)
+        track.used = false;
 
     if (sheet == SH_WORLD)
     {
@@ -288,71 +305,59 @@ int CParticle::CreateParticle(Math::Vector pos, Math::Vector speed, Math::Point
     if (t >= MAXPARTITYPE) return -1;
     if (t == -1) return -1;
 
-    for (int j = 0; j < MAXPARTICULE; j++)
+    int i = AllocateParticle(t, sheet);
+    if (i == -1) return -1;
+
+    m_particle[i].ray       = false;
+    m_particle[i].goal      = pos;
+    m_particle[i].windSensitivity = windSensitivity;
+    m_particle[i].dim       = dim;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].objLink   = ObjectHandle();
+    m_particle[i].objFather = ObjectHandle();
+    m_particle[i].trackRank = -1;
+
+    m_motion.mass[i]      = mass;
+    m_motion.duration[i]  = duration;
+    m_motion.SetPos(i, pos);
+    m_motion.SetSpeed(i, speed);
+    m_motion.zoom[i]      = 1.0f;
+    m_motion.intensity[i] = 1.0f;
+    m_motion.time[i]      = 0.0f;
+    m_motion.phaseTime[i] = 0.0f;
+    SetMotionBehavior(i, type);
+
+    if ( type == PARTIEXPLOT ||
+         type == PARTIEXPLOO )
     {
-        int i = MAXPARTICULE*t+j;
-
-        if (! m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = false;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = mass;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
-            m_particle[i].windSensitivity = windSensitivity;
-            m_particle[i].dim       = dim;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].objLink   = nullptr;
-            m_particle[i].objFather = nullptr;
-            m_particle[i].trackRank = -1;
-
-            m_totalInterface[t][sheet] ++;
-
-            if ( type == PARTIEXPLOT ||
-                 type == PARTIEXPLOO )
-            {
-                m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
-            }
-
-            if ( type == PARTIGUN1 ||
-                 type == PARTIGUN4 )
-            {
-                m_particle[i].testTime = 1.0f;  // impact immediately
-            }
+        m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
+    }
 
-            if ( type == PARTIVIRUS )
-            {
-                m_particle[i].text = RandomLetter();
-            }
+    if ( type == PARTIGUN1 ||
+         type == PARTIGUN4 )
+    {
+        m_particle[i].testTime = 1.0f;  // impact immediately
+    }
 
-            if ( type >= PARTIFOG0 &&
-                 type <= PARTIFOG7 )
-            {
-                if (m_fogTotal < MAXPARTIFOG)
-                m_fog[m_fogTotal++] = i;
-            }
+    if ( type == PARTIVIRUS )
+    {
+        m_particle[i].text = RandomLetter();
+    }
 
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
+    if ( type >= PARTIFOG0 &&
+         type <= PARTIFOG7 )
+    {
+        m_fog.push_back(i);
     }
 
-    return -1;
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 /** Returns the channel of the particle created or -1 on error */
@@ -363,100 +368,92 @@ int CParticle::CreateFrag(Math::Vector pos, Math::Vector speed,
                           float windSensitivity, int sheet)
 {
     int t = 0;
-    for (int j = 0; j < MAXPARTICULE; j++)
-    {
-        int i = MAXPARTICULE*t+j;
-
-        if (!m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = false;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = mass;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
-            m_particle[i].windSensitivity = windSensitivity;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].objLink   = nullptr;
-            m_particle[i].objFather = nullptr;
-            m_particle[i].trackRank = -1;
-            m_triangle[i] = *triangle;
-
-            m_totalInterface[t][sheet] ++;
-
-            Math::Vector    p1;
-            p1.x = m_triangle[i].triangle[0].coord.x;
-            p1.y = m_triangle[i].triangle[0].coord.y;
-            p1.z = m_triangle[i].triangle[0].coord.z;
-
-            Math::Vector p2;
-            p2.x = m_triangle[i].triangle[1].coord.x;
-            p2.y = m_triangle[i].triangle[1].coord.y;
-            p2.z = m_triangle[i].triangle[1].coord.z;
-
-            Math::Vector p3;
-            p3.x = m_triangle[i].triangle[2].coord.x;
-            p3.y = m_triangle[i].triangle[2].coord.y;
-            p3.z = m_triangle[i].triangle[2].coord.z;
-
-            float l1 = Math::Distance(p1, p2);
-            float l2 = Math::Distance(p2, p3);
-            float l3 = Math::Distance(p3, p1);
-            float dx = fabs(Math::Min(l1, l2, l3))*0.5f;
-            float dy = fabs(Math::Max(l1, l2, l3))*0.5f;
-            p1 = Math::Vector(-dx,  dy, 0.0f);
-            p2 = Math::Vector( dx,  dy, 0.0f);
-            p3 = Math::Vector(-dx, -dy, 0.0f);
-
-            m_triangle[i].triangle[0].coord.x = p1.x;
-            m_triangle[i].triangle[0].coord.y = p1.y;
-            m_triangle[i].triangle[0].coord.z = p1.z;
-
-            m_triangle[i].triangle[1].coord.x = p2.x;
-            m_triangle[i].triangle[1].coord.y = p2.y;
-            m_triangle[i].triangle[1].coord.z = p2.z;
-
-            m_triangle[i].triangle[2].coord.x = p3.x;
-            m_triangle[i].triangle[2].coord.y = p3.y;
-            m_triangle[i].triangle[2].coord.z = p3.z;
-
-            Math::Vector n(0.0f, 0.0f, -1.0f);
-
-            m_triangle[i].triangle[0].normal.x = n.x;
-            m_triangle[i].triangle[0].normal.y = n.y;
-            m_triangle[i].triangle[0].normal.z = n.z;
-
-            m_triangle[i].triangle[1].normal.x = n.x;
-            m_triangle[i].triangle[1].normal.y = n.y;
-            m_triangle[i].triangle[1].normal.z = n.z;
-
-            m_triangle[i].triangle[2].normal.x = n.x;
-            m_triangle[i].triangle[2].normal.y = n.y;
-            m_triangle[i].triangle[2].normal.z = n.z;
-
-            if (type == PARTIFRAG)
-                m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
-
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
-    }
-
-    return -1;
+    int i = AllocateParticle(t, sheet);
+    if (i == -1) return -1;
+
+    m_particle[i].ray       = false;
+    m_particle[i].goal      = pos;
+    m_particle[i].windSensitivity = windSensitivity;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].objLink   = ObjectHandle();
+    m_particle[i].objFather = ObjectHandle();
+    m_particle[i].trackRank = -1;
+
+    m_motion.mass[i]      = mass;
+    m_motion.duration[i]  = duration;
+    m_motion.SetPos(i, pos);
+    m_motion.SetSpeed(i, speed);
+    m_motion.zoom[i]      = 1.0f;
+    m_motion.intensity[i] = 1.0f;
+    m_motion.time[i]      = 0.0f;
+    m_motion.phaseTime[i] = 0.0f;
+    SetMotionBehavior(i, type);
+
+    if (static_cast<int>(m_triangle.size()) <= i)
+        m_triangle.resize(i+1);
+    m_triangle[i] = *triangle;
+
+    Math::Vector    p1;
+    p1.x = m_triangle[i].triangle[0].coord.x;
+    p1.y = m_triangle[i].triangle[0].coord.y;
+    p1.z = m_triangle[i].triangle[0].coord.z;
+
+    Math::Vector p2;
+    p2.x = m_triangle[i].triangle[1].coord.x;
+    p2.y = m_triangle[i].triangle[1].coord.y;
+    p2.z = m_triangle[i].triangle[1].coord.z;
+
+    Math::Vector p3;
+    p3.x = m_triangle[i].triangle[2].coord.x;
+    p3.y = m_triangle[i].triangle[2].coord.y;
+    p3.z = m_triangle[i].triangle[2].coord.z;
+
+    float l1 = Math::Distance(p1, p2);
+    float l2 = Math::Distance(p2, p3);
+    float l3 = Math::Distance(p3, p1);
+    float dx = fabs(Math::Min(l1, l2, l3))*0.5f;
+    float dy = fabs(Math::Max(l1, l2, l3))*0.5f;
+    p1 = Math::Vector(-dx,  dy, 0.0f);
+    p2 = Math::Vector( dx,  dy, 0.0f);
+    p3 = Math::Vector(-dx, -dy, 0.0f);
+
+    m_triangle[i].triangle[0].coord.x = p1.x;
+    m_triangle[i].triangle[0].coord.y = p1.y;
+    m_triangle[i].triangle[0].coord.z = p1.z;
+
+    m_triangle[i].triangle[1].coord.x = p2.x;
+    m_triangle[i].triangle[1].coord.y = p2.y;
+    m_triangle[i].triangle[1].coord.z = p2.z;
+
+    m_triangle[i].triangle[2].coord.x = p3.x;
+    m_triangle[i].triangle[2].coord.y = p3.y;
+    m_triangle[i].triangle[2].coord.z = p3.z;
+
+    Math::Vector n(0.0f, 0.0f, -1.0f);
+
+    m_triangle[i].triangle[0].normal.x = n.x;
+    m_triangle[i].triangle[0].normal.y = n.y;
+    m_triangle[i].triangle[0].normal.z = n.z;
+
+    m_triangle[i].triangle[1].normal.x = n.x;
+    m_triangle[i].triangle[1].normal.y = n.y;
+    m_triangle[i].triangle[1].normal.z = n.z;
+
+    m_triangle[i].triangle[2].normal.x = n.x;
+    m_triangle[i].triangle[2].normal.y = n.y;
+    m_triangle[i].triangle[2].normal.z = n.z;
+
+    if (type == PARTIFRAG)
+        m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
+
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 
@@ -467,45 +464,34 @@ int CParticle::CreatePart(Math::Vector pos, Math::Vector speed,
                           float windSensitivity, int sheet)
 {
     int t = 0;
-    for (int j = 0; j < MAXPARTICULE; j++)
-    {
-        int i = MAXPARTICULE*t+j;
-
-        if (!m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = false;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = mass;
-            m_particle[i].weight    = weight;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
-            m_particle[i].windSensitivity = windSensitivity;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].trackRank = -1;
-
-            m_totalInterface[t][sheet] ++;
-
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
-    }
-
-    return -1;
+    int i = AllocateParticle(t, sheet);
+    if (i == -1) return -1;
+
+    m_particle[i].ray       = false;
+    m_particle[i].weight    = weight;
+    m_particle[i].goal      = pos;
+    m_particle[i].windSensitivity = windSensitivity;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].trackRank = -1;
+
+    m_motion.mass[i]      = mass;
+    m_motion.duration[i]  = duration;
+    m_motion.SetPos(i, pos);
+    m_motion.SetSpeed(i, speed);
+    m_motion.zoom[i]      = 1.0f;
+    m_motion.intensity[i] = 1.0f;
+    m_motion.time[i]      = 0.0f;
+    m_motion.phaseTime[i] = 0.0f;
+    SetMotionBehavior(i, type);
+
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 /** Returns the channel of the particle created or -1 on error */
@@ -523,47 +509,36 @@ int CParticle::CreateRay(Math::Vector pos, Math::Vector goal,
     if (t >= MAXPARTITYPE) return -1;
     if (t == -1) return -1;
 
-    for (int j = 0; j < MAXPARTICULE; j++)
-    {
-        int i = MAXPARTICULE*t+j;
-
-        if (!m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = true;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = 0.0f;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = goal;
-            m_particle[i].speed     = Math::Vector(0.0f, 0.0f, 0.0f);
-            m_particle[i].windSensitivity = 0.0f;
-            m_particle[i].dim       = dim;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].objLink   = nullptr;
-            m_particle[i].objFather = nullptr;
-            m_particle[i].trackRank = -1;
-
-            m_totalInterface[t][sheet] ++;
-
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
-    }
-
-    return -1;
+    int i = AllocateParticle(t, sheet);
+    if (i == -1) return -1;
+
+    m_particle[i].ray       = true;
+    m_particle[i].goal      = goal;
+    m_particle[i].windSensitivity = 0.0f;
+    m_particle[i].dim       = dim;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].objLink   = ObjectHandle();
+    m_particle[i].objFather = ObjectHandle();
+    m_particle[i].trackRank = -1;
+
+    m_motion.mass[i]      = 0.0f;
+    m_motion.duration[i]  = duration;
+    m_motion.SetPos(i, pos);
+    m_motion.SetSpeed(i, Math::Vector(0.0f, 0.0f, 0.0f));
+    m_motion.zoom[i]      = 1.0f;
+    m_motion.intensity[i] = 1.0f;
+    m_motion.time[i]      = 0.0f;
+    m_motion.phaseTime[i] = 0.0f;
+    SetMotionBehavior(i, type);
+
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 /** "length" is the length of the tail of drag (in seconds)! */
@@ -575,26 +550,26 @@ int CParticle::CreateTrack(Math::Vector pos, Math::Vector speed, Math::Point dim
     int channel = CreateParticle(pos, speed, dim, type, duration, mass, 0.0f, 0);
     if (channel == -1) return -1;
 
-    // Seeks a streak free.
-    for (int i = 0; i < MAXTRACK; i++)
-    {
-        if (!m_track[i].used)  // free?
-        {
-            int rank = channel;
-            if (!CheckChannel(rank)) return -1;
-            m_particle[rank].trackRank = i;
+    int rank = channel;
+    if (!CheckChannel(rank)) return -1;
 
-            m_track[i].used = true;
-            m_track[i].step = (length/duration) / MAXTRACKLEN;
-            m_track[i].last = 0.0f;
-            m_track[i].intensity = 1.0f;
-            m_track[i].width = width;
-            m_track[i].posUsed = 1;
-            m_track[i].head = 0;
-            m_track[i].pos[0] = pos;
-            break;
-        }
-    }
+    // Seeks a streak free, or adds one.
+    int i = 0;
+    while (i < static_cast<int>(m_track.size()) && m_track[i].used)
+        i++;
+    if (i == static_cast<int>(m_track.size()))
+        m_track.push_back(Track());
+
+    m_particle[rank].trackRank = i;
+
+    m_track[i].used = true;
+    m_track[i].step = (length/duration) / MAXTRACKLEN;
+    m_track[i].last = 0.0f;
+    m_track[i].intensity = 1.0f;
+    m_track[i].width = width;
+    m_track[i].posUsed = 1;
+    m_track[i].head = 0;
+    m_track[i].pos[0] = pos;
 
     return channel;
 }
@@ -643,7 +618,7 @@ bool CParticle::CheckChannel(int &channel)
     channel &= 0xffff;
 
     if (channel < 0)  return false;
-    if (channel >= MAXPARTICULE*MAXPARTITYPE) return false;
+    if (channel >= static_cast<int>(m_particle.size())) return false;
 
     if (!m_particle[channel].used)
     {
@@ -660,26 +635,77 @@ bool CParticle::CheckChannel(int &channel)
     return true;
 }
 
+int CParticle::AllocateParticle(int t, int sheet)
+{
+    int i;
+    if (!m_freeParticles.empty())
+    {
+        i = m_freeParticles.back();
+        m_freeParticles.pop_back();
+    }
+    else
+    {
+        if (static_cast<int>(m_particle.size()) >= MAXPARTICULE) return -1;
+
+        i = static_cast<int>(m_particle.size());
+        m_particle.push_back(Particle());
+        m_motion.Add();
+    }
+
+    m_particle[i] = Particle();
+    m_motion.Reset(i);
+    m_particle[i].used        = true;
+    m_particle[i].uniqueStamp = m_uniqueStamp++;
+    m_particle[i].sheet       = sheet;
+    m_particle[i].group       = t;
+    m_particle[i].liveIndex   = static_cast<int>(m_liveParticles[t].size());
+    m_liveParticles[t].push_back(i);
+
+    m_totalInterface[t][sheet] ++;
+
+    return i;
+}
+
 void CParticle::DeleteRank(int rank)
 {
-    if (m_totalInterface[rank/MAXPARTICULE][m_particle[rank].sheet] > 0)
-        m_totalInterface[rank/MAXPARTICULE][m_particle[rank].sheet]--;
+    int t = m_particle[rank].group;
+
+    if (m_totalInterface[t][m_particle[rank].sheet] > 0)
+        m_totalInterface[t][m_particle[rank].sheet]--;
 
     int i = m_particle[rank].trackRank;
     if (i != -1)  // drag associated?
         m_track[i].used = false;  // frees the drag
 
+    if ( m_particle[rank].type >= PARTIFOG0 &&
+         m_particle[rank].type <= PARTIFOG7 )
+    {
+        m_fog.erase(std::remove(m_fog.begin(), m_fog.end(), rank), m_fog.end());
+    }
+
+    // Moves the last live particle of the group into the freed place
+    std::vector<int>& live = m_liveParticles[t];
+    int last = live.back();
+    live[m_particle[rank].liveIndex] = last;
+    m_particle[last].liveIndex = m_particle[rank].liveIndex;
+    live.pop_back();
+
     m_particle[rank].used = false;
+    m_freeParticles.push_back(rank);
 }
 
 void CParticle::DeleteParticle(ParticleType type)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    for (int t = 0; t < MAXPARTITYPE; t++)
     {
-        if (!m_particle[i].used) continue;
-        if (m_particle[i].type != type) continue;
+        // Backwards, since deleting moves the last particle of the list
+        for (int k = static_cast<int>(m_liveParticles[t].size())-1; k >= 0; k--)
+        {
+            int i = m_liveParticles[t][k];
+            if (m_particle[i].type != type) continue;
 
-        DeleteRank(i);
+            DeleteRank(i);
+        }
     }
 }
 
@@ -687,32 +713,25 @@ void CParticle::DeleteParticle(int channel)
 {
     if (!CheckChannel(channel)) return;
 
-    if (m_totalInterface[channel/MAXPARTICULE][m_particle[channel].sheet] > 0 )
-        m_totalInterface[channel/MAXPARTICULE][m_particle[channel].sheet]--;
-
-    int i = m_particle[channel].trackRank;
-    if (i != -1)  // drag associated?
-        m_track[i].used = false;  // frees the drag
-
-    m_particle[channel].used = false;
+    DeleteRank(channel);
 }
 
 void CParticle::SetObjectLink(int channel, CObject *object)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].objLink = object;
+    m_particle[channel].objLink = CObjectManager::GetInstancePointer()->GetHandle(object);
 }
 
 void CParticle::SetObjectFather(int channel, CObject *object)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].objFather = object;
+    m_particle[channel].objFather = CObjectManager::GetInstancePointer()->GetHandle(object);
 }
 
 void CParticle::SetPosition(int channel, Math::Vector pos)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].pos = pos;
+    m_motion.SetPos(channel, pos);
 }
 
 void CParticle::SetDimension(int channel, Math::Point dim)
@@ -724,7 +743,7 @@ void CParticle::SetDimension(int channel, Math::Point dim)
 void CParticle::SetZoom(int channel, float zoom)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].zoom = zoom;
+    m_motion.zoom[channel] = zoom;
 }
 
 void CParticle::SetAngle(int channel, float angle)
@@ -736,32 +755,32 @@ void CParticle::SetAngle(int channel, float angle)
 void CParticle::SetIntensity(int channel, float intensity)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].intensity = intensity;
+    m_motion.intensity[channel] = intensity;
 }
 
 void CParticle::SetParam(int channel, Math::Vector pos, Math::Point dim, float zoom,
                           float angle, float intensity)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].pos       = pos;
+    m_motion.SetPos(channel, pos);
     m_particle[channel].dim       = dim;
-    m_particle[channel].zoom      = zoom;
+    m_motion.zoom[channel]      = zoom;
     m_particle[channel].angle     = angle;
-    m_particle[channel].intensity = intensity;
+    m_motion.intensity[channel] = intensity;
 }
 
 void CParticle::SetPhase(int channel, ParticlePhase phase, float duration)
 {
     if (!CheckChannel(channel))  return;
     m_particle[channel].phase = phase;
-    m_particle[channel].duration = duration;
-    m_particle[channel].phaseTime = m_particle[channel].time;
+    m_motion.duration[channel] = duration;
+    m_motion.phaseTime[channel] = m_motion.time[channel];
 }
 
 bool CParticle::GetPosition(int channel, Math::Vector &pos)
 {
     if (!CheckChannel(channel))  return false;
-    pos = m_particle[channel].pos;
+    pos = m_motion.GetPos(channel);
     return true;
 }
 
@@ -795,41 +814,93 @@ void CParticle::FrameParticle(float rTime)
     Math::Point ts, ti;
     Math::Vector pos;
 
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    // Selects the particles to update. This touches objects and Math::Rand(),
+    // so it stays on this thread.
+    m_frameParticles.clear();
+    std::fill(m_motion.update.begin(), m_motion.update.end(), 0.0f);
+    for (int t = 0; t < MAXPARTITYPE; t++)
     {
-        if (!m_particle[i].used) continue;
-        if (!m_frameUpdate[m_particle[i].sheet]) continue;
-
-        if (m_particle[i].type != PARTISHOW)
+        // Backwards, since deleting moves the last particle of the list
+        for (int k = static_cast<int>(m_liveParticles[t].size())-1; k >= 0; k--)
         {
-            if (pause && m_particle[i].sheet != SH_INTERFACE) continue;
+            int i = m_liveParticles[t][k];
+
+            // The object this particle's coordinates are linked to doesn't exist anymore
+            if (IsObjectLinkLost(i))
+            {
+                DeleteRank(i);
+                continue;
+            }
+
+            if (!m_frameUpdate[m_particle[i].sheet]) continue;
+
+            if (m_particle[i].type != PARTISHOW)
+            {
+                if (pause && m_particle[i].sheet != SH_INTERFACE) continue;
+            }
+
+            if (m_particle[i].sheet == SH_WORLD)
+            {
+                float h = rTime*m_particle[i].windSensitivity*Math::Rand()*2.0f;
+                m_motion.SetPos(i, m_motion.GetPos(i)+wind*h);
+            }
+
+            FrameParticleEntry entry;
+            entry.rank = i;
+            entry.uniqueStamp = m_particle[i].uniqueStamp;
+            m_frameParticles.push_back(entry);
+            m_motion.update[i] = 1.0f;
         }
+    }
 
-        if (m_particle[i].type != PARTIQUARTZ)
-            m_particle[i].pos += m_particle[i].speed*rTime;
+    // Moves the particles selected, over the whole arrays of m_motion,
+    // then finds the ground below them, each particle on its own
+    int size = m_motion.GetSize();
+    int count = static_cast<int>(m_frameParticles.size());
+    m_frameFloor.resize(count);
 
-        if (m_particle[i].sheet == SH_WORLD)
+    CThreadPool* threadPool = m_main->GetThreadPool();
+    if (threadPool != nullptr && size >= PARTICLE_CHUNK_SIZE*2)
+    {
+        threadPool->ParallelFor(size, PARTICLE_CHUNK_SIZE, [this, rTime](int begin, int end)
         {
-            float h = rTime*m_particle[i].windSensitivity*Math::Rand()*2.0f;
-            m_particle[i].pos += wind*h;
-        }
+            m_motion.Integrate(rTime, begin, end);
+        });
+    }
+    else
+    {
+        m_motion.Integrate(rTime, 0, size);
+    }
+
+    if (threadPool != nullptr && count >= PARTICLE_CHUNK_SIZE*2)
+    {
+        threadPool->ParallelFor(count, PARTICLE_CHUNK_SIZE, [this](int begin, int end)
+        {
+            FindParticleFloors(begin, end);
+        });
+    }
+    else
+    {
+        FindParticleFloors(0, count);
+    }
 
-        float progress = (m_particle[i].time-m_particle[i].phaseTime)/m_particle[i].duration;
+    // Applies the rest in order: bounces, drags, hit tests, sounds and new particles
+    for (int k = 0; k < count; k++)
+    {
+        int i = m_frameParticles[k].rank;
+        // Deleted by a particle updated before, maybe replaced by a new one
+        if (!m_particle[i].used || m_particle[i].uniqueStamp != m_frameParticles[k].uniqueStamp) continue;
+
+        float progress = (m_motion.time[i]-m_motion.phaseTime[i])/m_motion.duration[i];
 
         // Manages the particles with mass that bounce.
-        if ( m_particle[i].mass != 0.0f        &&
+        if ( m_motion.mass[i] != 0.0f        &&
              m_particle[i].type != PARTIQUARTZ )
         {
-            m_particle[i].speed.y -= m_particle[i].mass*rTime;
-
-            float h;
-            if (m_particle[i].sheet == SH_INTERFACE)
-                h = 0.0f;
-            else
-                h = m_terrain->GetFloorLevel(m_particle[i].pos, true);
+            float h = m_frameFloor[k];
 
             h += m_particle[i].dim.y*0.75f;
-            if (m_particle[i].pos.y < h)  // impact with the ground?
+            if (m_motion.posY[i] < h)  // impact with the ground?
             {
                 if ( m_particle[i].type == PARTIPART &&
                      m_particle[i].weight > 3.0f &&  // heavy enough?
@@ -840,22 +911,22 @@ void CParticle::FrameParticle(float rTime)
                     if (amplitude > 1.0f)  amplitude = 1.0f;
                     if (amplitude > 0.0f)
                     {
-                        Play(SOUND_BOUM, m_particle[i].pos, amplitude);
+                        Play(SOUND_BOUM, m_motion.GetPos(i), amplitude);
                     }
                 }
 
                 if (m_particle[i].bounce < 3)
                 {
-                    m_particle[i].pos.y = h;
-                    m_particle[i].speed.y *= -0.4f;
-                    m_particle[i].speed.x *=  0.4f;
-                    m_particle[i].speed.z *=  0.4f;
+                    m_motion.posY[i] = h;
+                    m_motion.speedY[i] *= -0.4f;
+                    m_motion.speedX[i] *=  0.4f;
+                    m_motion.speedZ[i] *=  0.4f;
                     m_particle[i].bounce ++;  // more impact
                 }
                 else    // disappears after 3 bounces?
                 {
-                    if ( m_particle[i].pos.y < h-10.0f ||
-                         m_particle[i].time >= 20.0f   )
+                    if ( m_motion.posY[i] < h-10.0f ||
+                         m_motion.time[i] >= 20.0f   )
                     {
                         DeleteRank(i);
                         continue;
@@ -868,7 +939,7 @@ void CParticle::FrameParticle(float rTime)
         int r = m_particle[i].trackRank;
         if (r != -1)  // drag exists?
         {
-            if (TrackMove(r, m_particle[i].pos, progress))
+            if (TrackMove(r, m_motion.GetPos(i), progress))
             {
                 DeleteRank(i);
                 continue;
@@ -879,7 +950,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK1)  // explosion technique?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.375f;
             ts.y = 0.000f;
@@ -889,7 +960,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK2)  // spray blue?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.500f;
             ts.y = 0.000f;
@@ -899,7 +970,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK3)  // spider?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.500f;
             ts.y = 0.750f;
@@ -909,7 +980,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK4)  // insect explosion?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.625f;
             ts.y = 0.000f;
@@ -919,7 +990,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK5)  // derrick?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.750f;
             ts.y = 0.000f;
@@ -940,7 +1011,7 @@ void CParticle::FrameParticle(float rTime)
              m_particle[i].type == PARTITRACK9  ||  // win-3 ?
              m_particle[i].type == PARTITRACK10 )   // win-4 ?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.25f*(m_particle[i].type-PARTITRACK7);
             ts.y = 0.25f;
@@ -950,14 +1021,14 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK11)  // phazer shot?
         {
-            CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-            m_particle[i].goal = m_particle[i].pos;
+            CObject* object = SearchObjectGun(m_particle[i].goal, m_motion.GetPos(i), m_particle[i].type, GetObjectFather(i));
+            m_particle[i].goal = m_motion.GetPos(i);
             if (object != nullptr && object->Implements(ObjectInterfaceType::Damageable))
             {
-                dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Phazer, 0.002f, m_particle[i].objFather);
+                dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Phazer, 0.002f, GetObjectFather(i));
             }
 
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.375f;
             ts.y = 0.000f;
@@ -967,7 +1038,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK12)  // drag reactor?
         {
-            m_particle[i].zoom = 1.0f;
+            m_motion.zoom[i] = 1.0f;
 
             ts.x = 0.375f;
             ts.y = 0.000f;
@@ -983,9 +1054,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress;
-            m_particle[i].intensity = 1.0f-progress;
-
             ts.x = 0.000f;
             ts.y = 0.750f;
             ti.x = ts.x+0.125f;
@@ -1000,7 +1068,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress;
             m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
 
             ts.x = 0.125f;
@@ -1018,9 +1085,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress < 0.25f)
-                m_particle[i].zoom = progress/0.25f;
+                m_motion.zoom[i] = progress/0.25f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.25f)/0.75f;
+                m_motion.intensity[i] = 1.0f-(progress-0.25f)/0.75f;
 
             ts.x = 0.000f;
             ts.y = 0.750f;
@@ -1036,9 +1103,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].intensity = 1.0f-progress;
-            m_particle[i].zoom = 1.0f+progress*3.0f;
-
             ts.x = 0.000f;
             ts.y = 0.750f;
             ti.x = ts.x+0.125f;
@@ -1053,8 +1117,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress;
-
             ts.x = 0.375f;
             ts.y = 0.750f;
             ti.x = ts.x+0.125f;
@@ -1069,8 +1131,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f+progress*7.0f;
-            m_particle[i].intensity = powf(1.0f-progress, 3.0f);
+            m_motion.zoom[i] = 1.0f+progress*7.0f;
+            m_motion.intensity[i] = powf(1.0f-progress, 3.0f);
 
             ts.x = 0.375f;
             ts.y = 0.750f;
@@ -1087,11 +1149,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            if (m_particle[i].type == PARTIFIRE)
-                m_particle[i].zoom = 1.0f-progress;
-            else
-                m_particle[i].zoom = progress;
-
             ts.x = 0.500f;
             ts.y = 0.750f;
             ti.x = ts.x+0.125f;
@@ -1110,7 +1167,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                if (m_terrain->GetHeightToFloor(m_particle[i].pos, true) < -2.0f)
+                if (m_terrain->GetHeightToFloor(m_motion.GetPos(i), true) < -2.0f)
                 {
                     m_exploGunCounter++;
 
@@ -1151,20 +1208,20 @@ void CParticle::FrameParticle(float rTime)
                     continue;
                 }
 
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_motion.GetPos(i), m_particle[i].type, GetObjectFather(i));
+                m_particle[i].goal = m_motion.GetPos(i);
                 if (object != nullptr)
                 {
                     if (object->Implements(ObjectInterfaceType::Damageable))
                     {
-                        dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Fire, 0.001f, m_particle[i].objFather);
+                        dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Fire, 0.001f, GetObjectFather(i));
                     }
 
                     m_exploGunCounter++;
 
                     if (m_exploGunCounter % 2 == 0)
                     {
-                        pos = m_particle[i].pos;
+                        pos = m_motion.GetPos(i);
                         Math::Vector speed;
                         speed.x = 0.0f;
                         speed.z = 0.0f;
@@ -1200,7 +1257,7 @@ void CParticle::FrameParticle(float rTime)
             }
 
             m_particle[i].angle -= rTime*Math::PI*8.0f;
-            m_particle[i].zoom = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress;
 
             ts.x = 0.00f;
             ts.y = 0.50f;
@@ -1219,17 +1276,17 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.1f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_motion.GetPos(i), m_particle[i].type, GetObjectFather(i));
+                m_particle[i].goal = m_motion.GetPos(i);
                 if (object != nullptr)
                 {
                     if (object->GetType() == OBJECT_MOBILErs && dynamic_cast<CShielder*>(object)->GetActiveShieldRadius() > 0.0f)  // protected by shield?
                     {
-                        CreateParticle(m_particle[i].pos, Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
+                        CreateParticle(m_motion.GetPos(i), Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
                         if (m_lastTimeGunDel > 0.2f)
                         {
                             m_lastTimeGunDel = 0.0f;
-                            Play(SOUND_GUNDEL, m_particle[i].pos, 1.0f);
+                            Play(SOUND_GUNDEL, m_motion.GetPos(i), 1.0f);
                         }
                         DeleteRank(i);
                         continue;
@@ -1237,18 +1294,18 @@ void CParticle::FrameParticle(float rTime)
                     else
                     {
                         if (object->GetType() != OBJECT_HUMAN)
-                            Play(SOUND_TOUCH, m_particle[i].pos, 1.0f);
+                            Play(SOUND_TOUCH, m_motion.GetPos(i), 1.0f);
 
                         if (object->Implements(ObjectInterfaceType::Damageable))
                         {
-                            dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Organic, 0.1f, m_particle[i].objFather);  // starts explosion
+                            dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Organic, 0.1f, GetObjectFather(i));  // starts explosion
                         }
                     }
                 }
             }
 
             m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
-            m_particle[i].zoom = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress;
 
             ts.x = 0.125f;
             ts.y = 0.875f;
@@ -1267,17 +1324,17 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.1f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_motion.GetPos(i), m_particle[i].type, GetObjectFather(i));
+                m_particle[i].goal = m_motion.GetPos(i);
                 if (object != nullptr)
                 {
                     if (object->GetType() == OBJECT_MOBILErs && dynamic_cast<CShielder*>(object)->GetActiveShieldRadius() > 0.0f)
                     {
-                        CreateParticle(m_particle[i].pos, Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
+                        CreateParticle(m_motion.GetPos(i), Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
                         if (m_lastTimeGunDel > 0.2f)
                         {
                             m_lastTimeGunDel = 0.0f;
-                            Play(SOUND_GUNDEL, m_particle[i].pos, 1.0f);
+                            Play(SOUND_GUNDEL, m_motion.GetPos(i), 1.0f);
                         }
                         DeleteRank(i);
                         continue;
@@ -1286,7 +1343,7 @@ void CParticle::FrameParticle(float rTime)
                     {
                         if (object->Implements(ObjectInterfaceType::Damageable))
                         {
-                            dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Fire, std::numeric_limits<float>::infinity(), m_particle[i].objFather);  // starts explosion
+                            dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Fire, std::numeric_limits<float>::infinity(), GetObjectFather(i));  // starts explosion
                         }
                     }
                 }
@@ -1310,7 +1367,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                if (m_terrain->GetHeightToFloor(m_particle[i].pos, true) < -2.0f)
+                if (m_terrain->GetHeightToFloor(m_motion.GetPos(i), true) < -2.0f)
                 {
                     m_exploGunCounter ++;
 
@@ -1339,20 +1396,20 @@ void CParticle::FrameParticle(float rTime)
                     continue;
                 }
 
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_motion.GetPos(i), m_particle[i].type, GetObjectFather(i));
+                m_particle[i].goal = m_motion.GetPos(i);
                 if (object != nullptr)
                 {
                     if (object->Implements(ObjectInterfaceType::Damageable))
                     {
-                        dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Organic, 0.001f, m_particle[i].objFather);
+                        dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Organic, 0.001f, GetObjectFather(i));
                     }
 
                     m_exploGunCounter ++;
 
                     if (m_exploGunCounter % 2 == 0)
                     {
-                        pos = m_particle[i].pos;
+                        pos = m_motion.GetPos(i);
                         Math::Vector speed;
                         speed.x = 0.0f;
                         speed.z = 0.0f;
@@ -1374,7 +1431,7 @@ void CParticle::FrameParticle(float rTime)
             }
 
             m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
-            m_particle[i].zoom = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress;
 
             ts.x = 0.125f;
             ts.y = 0.875f;
@@ -1390,9 +1447,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 0.1f+progress;
-            m_particle[i].intensity = 1.0f-progress;
-
             ts.x = 0.00f;
             ts.y = 0.75f;
             ti.x = ts.x+0.25f;
@@ -1407,9 +1461,9 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            if (progress < 0.5f) m_particle[i].intensity = progress/0.5f;
-            else                 m_particle[i].intensity = 2.0f-progress/0.5f;
-            m_particle[i].zoom = 1.0f-progress*0.8f;
+            if (progress < 0.5f) m_motion.intensity[i] = progress/0.5f;
+            else                 m_motion.intensity[i] = 2.0f-progress/0.5f;
+            m_motion.zoom[i] = 1.0f-progress*0.8f;
             m_particle[i].angle -= rTime*Math::PI*0.5f;
 
             ts.x = 0.50f;
@@ -1426,9 +1480,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 0.1f+progress;
-            m_particle[i].intensity = 1.0f-progress;
-
             ts.x = 0.50f;
             ts.y = 0.50f;
             ti.x = ts.x+0.25f;
@@ -1443,8 +1494,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 0.1f+progress;
-            m_particle[i].intensity = 1.0f-progress;
             m_particle[i].angle -= rTime*Math::PI*2.0f;
 
             ts.x = 0.00f;
@@ -1461,8 +1510,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f;
-            m_particle[i].intensity = 1.0f;
+            m_motion.zoom[i] = 1.0f;
+            m_motion.intensity[i] = 1.0f;
 
             ts.x = 0.000f;
             ts.y = 0.125f;
@@ -1477,8 +1526,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f;
-            m_particle[i].intensity = 1.0f;
+            m_motion.zoom[i] = 1.0f;
+            m_motion.intensity[i] = 1.0f;
 
             ts.x = 0.375f;
             ts.y = 0.125f;
@@ -1493,8 +1542,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f;
-            m_particle[i].intensity = 1.0f;
+            m_motion.zoom[i] = 1.0f;
+            m_motion.intensity[i] = 1.0f;
 
             ts.x = 0.500f;
             ts.y = 0.125f;
@@ -1504,8 +1553,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTIFOG0)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.3f+sinf(progress)*0.15f;
+            m_motion.intensity[i] = 0.3f+sinf(progress)*0.15f;
             m_particle[i].angle += rTime*0.05f;
 
             ts.x = 0.25f;
@@ -1515,8 +1563,7 @@ void CParticle::FrameParticle(float rTime)
         }
         if (m_particle[i].type == PARTIFOG1)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.3f+sinf(progress)*0.15f;
+            m_motion.intensity[i] = 0.3f+sinf(progress)*0.15f;
             m_particle[i].angle -= rTime*0.07f;
 
             ts.x = 0.25f;
@@ -1527,8 +1574,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTIFOG2)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.6f+sinf(progress)*0.15f;
+            m_motion.intensity[i] = 0.6f+sinf(progress)*0.15f;
             m_particle[i].angle += rTime*0.05f;
 
             ts.x = 0.75f;
@@ -1538,8 +1584,7 @@ void CParticle::FrameParticle(float rTime)
         }
         if (m_particle[i].type == PARTIFOG3)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.6f+sinf(progress)*0.15f;
+            m_motion.intensity[i] = 0.6f+sinf(progress)*0.15f;
             m_particle[i].angle -= rTime*0.07f;
 
             ts.x = 0.75f;
@@ -1550,8 +1595,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTIFOG4)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.5f+sinf(progress)*0.2f;
+            m_motion.intensity[i] = 0.5f+sinf(progress)*0.2f;
             m_particle[i].angle += rTime*0.05f;
 
             ts.x = 0.00f;
@@ -1561,8 +1605,7 @@ void CParticle::FrameParticle(float rTime)
         }
         if (m_particle[i].type == PARTIFOG5)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.5f+sinf(progress)*0.2f;
+            m_motion.intensity[i] = 0.5f+sinf(progress)*0.2f;
             m_particle[i].angle -= rTime*0.07f;
 
             ts.x = 0.00f;
@@ -1573,8 +1616,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTIFOG6)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.5f+sinf(progress)*0.2f;
+            m_motion.intensity[i] = 0.5f+sinf(progress)*0.2f;
             m_particle[i].angle += rTime*0.05f;
 
             ts.x = 0.50f;
@@ -1584,8 +1626,7 @@ void CParticle::FrameParticle(float rTime)
         }
         if (m_particle[i].type == PARTIFOG7)
         {
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 0.5f+sinf(progress)*0.2f;
+            m_motion.intensity[i] = 0.5f+sinf(progress)*0.2f;
             m_particle[i].angle -= rTime*0.07f;
 
             ts.x = 0.50f;
@@ -1601,15 +1642,15 @@ void CParticle::FrameParticle(float rTime)
         {
             float h = 10.0f;
 
-            if ( m_particle[i].pos.y >= eye.y   &&
-                 m_particle[i].pos.y <  eye.y+h )
+            if ( m_motion.posY[i] >= eye.y   &&
+                 m_motion.posY[i] <  eye.y+h )
             {
-                m_particle[i].intensity *= (m_particle[i].pos.y-eye.y)/h;
+                m_motion.intensity[i] *= (m_motion.posY[i]-eye.y)/h;
             }
-            if ( m_particle[i].pos.y >  eye.y-h &&
-                 m_particle[i].pos.y <  eye.y   )
+            if ( m_motion.posY[i] >  eye.y-h &&
+                 m_motion.posY[i] <  eye.y   )
             {
-                m_particle[i].intensity *= (eye.y-m_particle[i].pos.y)/h;
+                m_motion.intensity[i] *= (eye.y-m_motion.posY[i])/h;
             }
         }
 
@@ -1622,9 +1663,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress/2.0f;
-            m_particle[i].intensity = 1.0f-progress;
-
             if (m_particle[i].type == PARTIEXPLOT)  ts.x = 0.750f;
             else                                    ts.x = 0.875f;
             ts.y = 0.750f;
@@ -1640,8 +1678,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].intensity = 1.0f-progress;
-
             ts.x = 0.375f;
             ts.y = 0.000f;
             ti.x = ts.x+0.125f;
@@ -1655,8 +1691,6 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].intensity = 1.0f-progress;
-
             ts.x = 0.625f;
             ts.y = 0.000f;
             ti.x = ts.x+0.125f;
@@ -1671,14 +1705,14 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress/2.0f;
+            m_motion.zoom[i] = 1.0f-progress/2.0f;
             if (progress < 0.5f)
             {
-                m_particle[i].intensity = progress/0.5f;
+                m_motion.intensity[i] = progress/0.5f;
             }
             else
             {
-                m_particle[i].intensity = 2.0f-progress/0.5f;
+                m_motion.intensity[i] = 2.0f-progress/0.5f;
             }
 
             ts.x = 0.750f;
@@ -1690,14 +1724,14 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIBUBBLE)
         {
             if ( progress >= 1.0f ||
-                 m_particle[i].pos.y >= m_water->GetLevel() )
+                 m_motion.posY[i] >= m_water->GetLevel() )
             {
                 DeleteRank(i);
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress/2.0f;
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress/2.0f;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.250f;
             ts.y = 0.875f;
@@ -1717,11 +1751,11 @@ void CParticle::FrameParticle(float rTime)
 
             if (progress < 0.25f)
             {
-                m_particle[i].zoom = progress/0.25f;
+                m_motion.zoom[i] = progress/0.25f;
             }
             else
             {
-                m_particle[i].intensity = 1.0f-(progress-0.25f)/0.75f;
+                m_motion.intensity[i] = 1.0f-(progress-0.25f)/0.75f;
             }
 
             ts.x = 0.500f+0.125f*(m_particle[i].type-PARTISMOKE1);
@@ -1738,7 +1772,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.750f+(rand()%2)*0.125f;
             ts.y = 0.875f;
@@ -1754,7 +1788,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.875f;
             ts.y = 0.750f;
@@ -1771,9 +1805,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress < 0.25f)
-                m_particle[i].zoom = progress/0.25f;
+                m_motion.zoom[i] = progress/0.25f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.25f)/0.75f;
+                m_motion.intensity[i] = 1.0f-(progress-0.25f)/0.75f;
 
             m_particle[i].angle += rTime*Math::PI*1.0f;
         }
@@ -1786,7 +1820,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress;
 
             ts.x = 0.625f;
             ts.y = 0.750f;
@@ -1804,11 +1838,11 @@ void CParticle::FrameParticle(float rTime)
 
             if (progress < 0.25f)
             {
-                m_particle[i].zoom = progress/0.25f;
+                m_motion.zoom[i] = progress/0.25f;
             }
             else
             {
-                m_particle[i].intensity = 1.0f-(progress-0.25f)/0.75f;
+                m_motion.intensity[i] = 1.0f-(progress-0.25f)/0.75f;
             }
 
             ts.x = 0.000f;
@@ -1827,11 +1861,11 @@ void CParticle::FrameParticle(float rTime)
 
             if (progress < 0.25f)
             {
-                m_particle[i].zoom = progress/0.25f;
+                m_motion.zoom[i] = progress/0.25f;
             }
             else
             {
-                m_particle[i].intensity = 1.0f-(progress-0.25f)/0.75f;
+                m_motion.intensity[i] = 1.0f-(progress-0.25f)/0.75f;
             }
 
             ts.x = 0.875f;
@@ -1848,8 +1882,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f+powf(progress, 2.0f)*5.0f;
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f+powf(progress, 2.0f)*5.0f;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.625f;
             ts.y = 0.875f;
@@ -1865,7 +1899,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress;
 
             ts.x = 0.625f;
             ts.y = 0.875f;
@@ -1897,7 +1931,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                pos = m_particle[i].pos;
+                pos = m_motion.GetPos(i);
                 Math::Vector speed = Math::Vector(0.0f, 0.0f, 0.0f);
                 Math::Point dim;
                 dim.x = 1.0f*(Math::Rand()*0.8f+0.6f);
@@ -1917,12 +1951,12 @@ void CParticle::FrameParticle(float rTime)
             {
                 DeleteRank(i);
 
-                pos = m_particle[i].pos;
+                pos = m_motion.GetPos(i);
                 Math::Point dim;
                 dim.x    = m_particle[i].dim.x/4.0f;
                 dim.y    = dim.x;
-                float duration = m_particle[i].duration;
-                float mass     = m_particle[i].mass;
+                float duration = m_motion.duration[i];
+                float mass     = m_motion.mass[i];
                 int total = static_cast<int>((10.0f*m_engine->GetParticleDensity()));
                 for (int j = 0; j < total; j++)
                 {
@@ -1945,7 +1979,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = (m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = (m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.125f;
             ts.y = 0.875f;
@@ -1961,7 +1995,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]);
 
             ts.x = 0.125f;
             ts.y = 0.875f;
@@ -1978,9 +2012,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress > 0.5f)
-                m_particle[i].zoom = 1.0f-(progress-0.5f)*2.0f;
+                m_motion.zoom[i] = 1.0f-(progress-0.5f)*2.0f;
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_motion.time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.25f;
@@ -1997,9 +2031,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress > 0.5f)
-                m_particle[i].zoom = 1.0f-(progress-0.5f)*2.0f;
+                m_motion.zoom[i] = 1.0f-(progress-0.5f)*2.0f;
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_motion.time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.50f;
@@ -2016,9 +2050,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress > 0.5f)
-                m_particle[i].zoom = 1.0f-(progress-0.5f)*2.0f;
+                m_motion.zoom[i] = 1.0f-(progress-0.5f)*2.0f;
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_motion.time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.00f;
@@ -2036,9 +2070,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress < 0.5f)
-                m_particle[i].zoom = progress*2.0f;
+                m_motion.zoom[i] = progress*2.0f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.5f)*2.0f;
+                m_motion.intensity[i] = 1.0f-(progress-0.5f)*2.0f;
 
             ts.x = 0.25f*(m_particle[i].type-PARTILENS1);
             ts.y = 0.25f;
@@ -2056,12 +2090,12 @@ void CParticle::FrameParticle(float rTime)
 
             if (progress < 0.3f)
             {
-                m_particle[i].zoom = progress/0.3f;
+                m_motion.zoom[i] = progress/0.3f;
             }
             else
             {
-                m_particle[i].zoom = 1.0f;
-                m_particle[i].intensity = 1.0f-(progress-0.3f)/0.7f;
+                m_motion.zoom[i] = 1.0f;
+                m_motion.intensity[i] = 1.0f-(progress-0.3f)/0.7f;
             }
 
             ts.x = 0.00f;
@@ -2079,9 +2113,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress > 0.5f)
-                m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration/2.0f);
+                m_motion.zoom[i] = 1.0f-(m_motion.time[i]-m_motion.duration[i]/2.0f);
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_motion.time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.50f;
@@ -2093,11 +2127,11 @@ void CParticle::FrameParticle(float rTime)
         {
             if (progress >= 1.0f)
             {
-                m_particle[i].time = 0.0f;
-                m_particle[i].duration = 0.5f+Math::Rand()*2.0f;
-                m_particle[i].pos.x = m_particle[i].speed.x + (Math::Rand()-0.5f)*m_particle[i].mass;
-                m_particle[i].pos.y = m_particle[i].speed.y + (Math::Rand()-0.5f)*m_particle[i].mass;
-                m_particle[i].pos.z = m_particle[i].speed.z + (Math::Rand()-0.5f)*m_particle[i].mass;
+                m_motion.time[i] = 0.0f;
+                m_motion.duration[i] = 0.5f+Math::Rand()*2.0f;
+                m_motion.posX[i] = m_motion.speedX[i] + (Math::Rand()-0.5f)*m_motion.mass[i];
+                m_motion.posY[i] = m_motion.speedY[i] + (Math::Rand()-0.5f)*m_motion.mass[i];
+                m_motion.posZ[i] = m_motion.speedZ[i] + (Math::Rand()-0.5f)*m_motion.mass[i];
                 m_particle[i].dim.x = 0.5f+Math::Rand()*1.5f;
                 m_particle[i].dim.y = m_particle[i].dim.x;
                 progress = 0.0f;
@@ -2105,13 +2139,13 @@ void CParticle::FrameParticle(float rTime)
 
             if (progress < 0.2f)
             {
-                m_particle[i].zoom = progress/0.2f;
-                m_particle[i].intensity = 1.0f;
+                m_motion.zoom[i] = progress/0.2f;
+                m_motion.intensity[i] = 1.0f;
             }
             else
             {
-                m_particle[i].zoom = 1.0f;
-                m_particle[i].intensity = 1.0f-(progress-0.2f)/0.8f;
+                m_motion.zoom[i] = 1.0f;
+                m_motion.intensity[i] = 1.0f-(progress-0.2f)/0.8f;
             }
 
             ts.x = 0.25f;
@@ -2128,13 +2162,13 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress;
             if (progress < 0.15f)
-                m_particle[i].intensity = progress/0.15f;
+                m_motion.intensity[i] = progress/0.15f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.15f)/0.85f;
+                m_motion.intensity[i] = 1.0f-(progress-0.15f)/0.85f;
 
-            m_particle[i].intensity *= 0.5f;
+            m_motion.intensity[i] *= 0.5f;
 
             ts.x = 0.25f;
             ts.y = 0.50f;
@@ -2150,8 +2184,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = progress*1.0f;
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.zoom[i] = progress*1.0f;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.500f;
             ts.y = 0.875f;
@@ -2167,8 +2201,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = progress*1.0f;
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.zoom[i] = progress*1.0f;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.875f;
             ts.y = 0.875f;
@@ -2184,8 +2218,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = progress*1.0f;
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.zoom[i] = progress*1.0f;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.750f;
             ts.y = 0.875f;
@@ -2216,14 +2250,14 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = progress*m_particle[i].dim.x;
+            m_motion.zoom[i] = progress*m_particle[i].dim.x;
 
             if (progress < 0.65f)
-                m_particle[i].intensity = progress/0.65f;
+                m_motion.intensity[i] = progress/0.65f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.65f)/0.35f;
+                m_motion.intensity[i] = 1.0f-(progress-0.65f)/0.35f;
 
-            m_particle[i].intensity *= 0.5f;
+            m_motion.intensity[i] *= 0.5f;
 
             ts.x = 0.50f;
             ts.y = 0.75f;
@@ -2240,12 +2274,12 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress < 0.30f)
-                m_particle[i].intensity = progress/0.30f;
+                m_motion.intensity[i] = progress/0.30f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.30f)/0.70f;
+                m_motion.intensity[i] = 1.0f-(progress-0.30f)/0.70f;
 
-            m_particle[i].zoom = progress*m_particle[i].dim.x;
-            m_particle[i].angle = m_particle[i].time*Math::PI*2.0f;
+            m_motion.zoom[i] = progress*m_particle[i].dim.x;
+            m_particle[i].angle = m_motion.time[i]*Math::PI*2.0f;
 
             ts.x = 0.000f;
             ts.y = 0.000f;
@@ -2262,12 +2296,12 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress < 0.20f)
-                m_particle[i].intensity = 1.0f;
+                m_motion.intensity[i] = 1.0f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.20f)/0.80f;
+                m_motion.intensity[i] = 1.0f-(progress-0.20f)/0.80f;
 
-            m_particle[i].zoom = progress*m_particle[i].dim.x;
-            m_particle[i].angle = m_particle[i].time*Math::PI*2.0f;
+            m_motion.zoom[i] = progress*m_particle[i].dim.x;
+            m_particle[i].angle = m_motion.time[i]*Math::PI*2.0f;
 
             ts.x = 0.125f;
             ts.y = 0.000f;
@@ -2286,16 +2320,16 @@ void CParticle::FrameParticle(float rTime)
 
             if (m_particle[i].phase == PARPHSTART)
             {
-                m_particle[i].intensity = progress;
-                if (m_particle[i].intensity > 1.0f)
-                    m_particle[i].intensity = 1.0f;
+                m_motion.intensity[i] = progress;
+                if (m_motion.intensity[i] > 1.0f)
+                    m_motion.intensity[i] = 1.0f;
             }
 
             if (m_particle[i].phase == PARPHEND)
-                m_particle[i].intensity = 1.0f-progress;
+                m_motion.intensity[i] = 1.0f-progress;
 
-            m_particle[i].zoom = m_particle[i].dim.x;
-            m_particle[i].angle = m_particle[i].time*Math::PI*0.2f;
+            m_motion.zoom[i] = m_particle[i].dim.x;
+            m_particle[i].angle = m_motion.time[i]*Math::PI*0.2f;
 
             ts.x = 0.25f;
             ts.y = 0.75f;
@@ -2311,14 +2345,14 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = progress*m_particle[i].dim.x;
+            m_motion.zoom[i] = progress*m_particle[i].dim.x;
 
             if (progress < 0.65 )
-                m_particle[i].intensity = progress/0.65f;
+                m_motion.intensity[i] = progress/0.65f;
             else
-                m_particle[i].intensity = 1.0f-(progress-0.65f)/0.35f;
+                m_motion.intensity[i] = 1.0f-(progress-0.65f)/0.35f;
 
-            m_particle[i].intensity *= 0.5f;
+            m_motion.intensity[i] *= 0.5f;
 
             ts.x = 0.125f;
             ts.y = 0.000f;
@@ -2328,9 +2362,9 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTISPHERE5)
         {
-            m_particle[i].intensity = 0.7f+sinf(progress)*0.3f;
-            m_particle[i].zoom = m_particle[i].dim.x*(1.0f+sinf(progress*0.7f)*0.01f);
-            m_particle[i].angle = m_particle[i].time*Math::PI*0.2f;
+            m_motion.intensity[i] = 0.7f+sinf(progress)*0.3f;
+            m_motion.zoom[i] = m_particle[i].dim.x*(1.0f+sinf(progress*0.7f)*0.01f);
+            m_particle[i].angle = m_motion.time[i]*Math::PI*0.2f;
 
             ts.x = 0.25f;
             ts.y = 0.50f;
@@ -2346,8 +2380,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = (1.0f-progress)*m_particle[i].dim.x;
-            m_particle[i].intensity = progress*0.5f;
+            m_motion.zoom[i] = (1.0f-progress)*m_particle[i].dim.x;
+            m_motion.intensity[i] = progress*0.5f;
 
             ts.x = 0.125f;
             ts.y = 0.000f;
@@ -2363,8 +2397,8 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = progress;
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.zoom[i] = progress;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.50f;
             ts.y = 0.50f;
@@ -2375,14 +2409,14 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIDROP)
         {
             if (progress >= 1.0f ||
-                m_particle[i].pos.y < m_water->GetLevel())
+                m_motion.posY[i] < m_water->GetLevel())
             {
                 DeleteRank(i);
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-progress;
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.zoom[i] = 1.0f-progress;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.750f;
             ts.y = 0.500f;
@@ -2393,13 +2427,13 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIWATER)
         {
             if (progress >= 1.0f ||
-                m_particle[i].pos.y < m_water->GetLevel())
+                m_motion.posY[i] < m_water->GetLevel())
             {
                 DeleteRank(i);
                 continue;
             }
 
-            m_particle[i].intensity = 1.0f-progress;
+            m_motion.intensity[i] = 1.0f-progress;
 
             ts.x = 0.125f;
             ts.y = 0.125f;
@@ -2418,12 +2452,12 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.2f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectRay(m_particle[i].pos, m_particle[i].goal,
-                                         m_particle[i].type, m_particle[i].objFather);
+                CObject* object = SearchObjectRay(m_motion.GetPos(i), m_particle[i].goal,
+                                         m_particle[i].type, GetObjectFather(i));
                 if (object != nullptr)
                 {
                     assert(object->Implements(ObjectInterfaceType::Damageable));
-                    dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Tower, std::numeric_limits<float>::infinity(), m_particle[i].objFather);
+                    dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Tower, std::numeric_limits<float>::infinity(), GetObjectFather(i));
                 }
             }
 
@@ -2453,14 +2487,14 @@ void CParticle::FrameParticle(float rTime)
         m_particle[i].texSup.y = ts.y+dp;
         m_particle[i].texInf.x = ti.x-dp;
         m_particle[i].texInf.y = ti.y-dp;
-        m_particle[i].time     += rTime;
+        m_motion.time[i]     += rTime;
         m_particle[i].testTime += rTime;
     }
 }
 
 bool CParticle::TrackMove(int i, Math::Vector pos, float progress)
 {
-    if (i < 0 || i >= MAXTRACK)  return true;
+    if (i < 0 || i >= static_cast<int>(m_track.size()))  return true;
     if (! m_track[i].used) return true;
 
     if (progress < 1.0f)  // particle exists?
@@ -2499,6 +2533,80 @@ bool CParticle::TrackMove(int i, Math::Vector pos, float progress)
     return (m_track[i].intensity <= 0.0f);
 }
 
+void CParticle::SetMotionBehavior(int i, ParticleType type)
+{
+    // Zoom and intensity given by a ramp are no longer computed in FrameParticle()
+    switch (type)
+    {
+        case PARTIQUARTZ:
+            m_motion.SetFixed(i, true);
+            break;
+
+        case PARTIMOTOR:
+            m_motion.SetZoomRamp(i, 1.0f, -1.0f);
+            m_motion.SetIntensityRamp(i, 1.0f, -1.0f);
+            break;
+
+        case PARTIBLITZ:
+        case PARTIGAS:
+        case PARTIFIRE:
+            m_motion.SetZoomRamp(i, 1.0f, -1.0f);
+            break;
+
+        case PARTIFIREZ:
+        case PARTIFOG0:
+        case PARTIFOG1:
+        case PARTIFOG2:
+        case PARTIFOG3:
+        case PARTIFOG4:
+        case PARTIFOG5:
+        case PARTIFOG6:
+        case PARTIFOG7:
+            m_motion.SetZoomRamp(i, 0.0f, 1.0f);
+            break;
+
+        case PARTIVAPOR:
+            m_motion.SetZoomRamp(i, 1.0f, 3.0f);
+            m_motion.SetIntensityRamp(i, 1.0f, -1.0f);
+            break;
+
+        case PARTIFLIC:
+        case PARTICHOC:
+        case PARTIGFLAT:
+            m_motion.SetZoomRamp(i, 0.1f, 1.0f);
+            m_motion.SetIntensityRamp(i, 1.0f, -1.0f);
+            break;
+
+        case PARTIEXPLOT:
+        case PARTIEXPLOO:
+            m_motion.SetZoomRamp(i, 1.0f, -0.5f);
+            m_motion.SetIntensityRamp(i, 1.0f, -1.0f);
+            break;
+
+        case PARTIEXPLOG1:
+        case PARTIEXPLOG2:
+            m_motion.SetIntensityRamp(i, 1.0f, -1.0f);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void CParticle::FindParticleFloors(int begin, int end)
+{
+    for (int k = begin; k < end; k++)
+    {
+        int i = m_frameParticles[k].rank;
+
+        m_frameFloor[k] = 0.0f;
+        if (m_motion.mass[i] == 0.0f || m_particle[i].type == PARTIQUARTZ) continue;
+
+        if (m_particle[i].sheet != SH_INTERFACE)
+            m_frameFloor[k] = m_terrain->GetFloorLevel(m_motion.GetPos(i), true);
+    }
+}
+
 void CParticle::TrackDraw(int i, ParticleType type)
 {
     // Calculates the total length memorized.
@@ -2666,6 +2774,7 @@ void CParticle::TrackDraw(int i, ParticleType type)
 
         m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
         m_engine->AddStatisticTriangle(2);
+        m_engine->AddStatisticParticleDraws(1);
 
         if (f2 < 0.0f) break;
         f1 = f2;
@@ -2675,12 +2784,12 @@ void CParticle::TrackDraw(int i, ParticleType type)
 
 void CParticle::DrawParticleTriangle(int i)
 {
-    if (m_particle[i].zoom == 0.0f)  return;
+    if (m_motion.zoom[i] == 0.0f)  return;
 
     Math::Vector eye = m_engine->GetEyePt();
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_motion.GetPos(i);
 
-    CObject* object = m_particle[i].objLink;
+    CObject* object = GetObjectLink(i);
     if (object != nullptr)
         pos += object->GetPosition();
 
@@ -2698,14 +2807,15 @@ void CParticle::DrawParticleTriangle(int i)
 
     m_device->DrawPrimitive(PRIMITIVE_TRIANGLES, m_triangle[i].triangle, 3);
     m_engine->AddStatisticTriangle(1);
+    m_engine->AddStatisticParticleDraws(1);
 }
 
-void CParticle::DrawParticleNorm(int i)
+void CParticle::DrawParticleNorm(int i, bool batch)
 {
-    float zoom = m_particle[i].zoom;
+    float zoom = m_motion.zoom[i];
 
     if (zoom == 0.0f) return;
-    if (m_particle[i].intensity == 0.0f) return;
+    if (m_motion.intensity[i] == 0.0f) return;
 
 
     Math::Vector corner[4];
@@ -2713,7 +2823,7 @@ void CParticle::DrawParticleNorm(int i)
 
     if (m_particle[i].sheet == SH_INTERFACE)
     {
-        Math::Vector pos = m_particle[i].pos;
+        Math::Vector pos = m_motion.GetPos(i);
 
         Math::Vector n(0.0f, 0.0f, -1.0f);
 
@@ -2742,15 +2852,14 @@ void CParticle::DrawParticleNorm(int i)
         vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
         vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-        m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
-        m_engine->AddStatisticTriangle(2);
+        AddParticleQuad(i, vertex, nullptr, Color(1.0f, 1.0f, 1.0f, 1.0f), batch);
     }
     else
     {
         Math::Vector eye = m_engine->GetEyePt();
-        Math::Vector pos = m_particle[i].pos;
+        Math::Vector pos = m_motion.GetPos(i);
 
-        CObject* object = m_particle[i].objLink;
+        CObject* object = GetObjectLink(i);
         if (object != nullptr)
             pos += object->GetPosition();
 
@@ -2764,7 +2873,6 @@ void CParticle::DrawParticleNorm(int i)
         mat.Set(1, 4, pos.x);
         mat.Set(2, 4, pos.y);
         mat.Set(3, 4, pos.z);
-        m_device->SetTransform(TRANSFORM_WORLD, mat);
 
         Math::Vector n(0.0f, 0.0f, -1.0f);
 
@@ -2793,19 +2901,18 @@ void CParticle::DrawParticleNorm(int i)
         vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
         vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-        m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4, m_particle[i].color);
-        m_engine->AddStatisticTriangle(2);
+        AddParticleQuad(i, vertex, &mat, m_particle[i].color, batch);
     }
 }
 
 void CParticle::DrawParticleFlat(int i)
 {
-    if (m_particle[i].zoom == 0.0f) return;
-    if (m_particle[i].intensity == 0.0f) return;
+    if (m_motion.zoom[i] == 0.0f) return;
+    if (m_motion.intensity[i] == 0.0f) return;
 
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_motion.GetPos(i);
 
-    CObject* object = m_particle[i].objLink;
+    CObject* object = GetObjectLink(i);
     if (object != nullptr)
         pos += object->GetPosition();
 
@@ -2826,13 +2933,12 @@ void CParticle::DrawParticleFlat(int i)
     mat.Set(1, 4, pos.x);
     mat.Set(2, 4, pos.y);
     mat.Set(3, 4, pos.z);
-    m_device->SetTransform(TRANSFORM_WORLD, mat);
 
     Math::Vector n(0.0f, 0.0f, -1.0f);
 
     Math::Point dim;
-    dim.x = m_particle[i].dim.x * m_particle[i].zoom;
-    dim.y = m_particle[i].dim.y * m_particle[i].zoom;
+    dim.x = m_particle[i].dim.x * m_motion.zoom[i];
+    dim.y = m_particle[i].dim.y * m_motion.zoom[i];
 
     Math::Vector corner[4];
     corner[0].x =  dim.x;
@@ -2857,16 +2963,15 @@ void CParticle::DrawParticleFlat(int i)
     vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
     vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-    m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
-    m_engine->AddStatisticTriangle(2);
+    AddParticleQuad(i, vertex, &mat, Color(1.0f, 1.0f, 1.0f, 1.0f));
 }
 
 void CParticle::DrawParticleFog(int i)
 {
     if (!m_engine->GetFog()) return;
-    if (m_particle[i].intensity == 0.0f) return;
+    if (m_motion.intensity[i] == 0.0f) return;
 
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_motion.GetPos(i);
 
     Math::Point dim;
     dim.x = m_particle[i].dim.x;
@@ -2879,22 +2984,22 @@ void CParticle::DrawParticleFog(int i)
          m_particle[i].type == PARTIFOG4 ||
          m_particle[i].type == PARTIFOG6 )
     {
-        zoom.x = 1.0f+sinf(m_particle[i].zoom*2.0f)/6.0f;
-        zoom.y = 1.0f+cosf(m_particle[i].zoom*2.7f)/6.0f;
+        zoom.x = 1.0f+sinf(m_motion.zoom[i]*2.0f)/6.0f;
+        zoom.y = 1.0f+cosf(m_motion.zoom[i]*2.7f)/6.0f;
     }
     if ( m_particle[i].type == PARTIFOG1 ||
          m_particle[i].type == PARTIFOG3 ||
          m_particle[i].type == PARTIFOG5 ||
          m_particle[i].type == PARTIFOG7 )
     {
-        zoom.x = 1.0f+sinf(m_particle[i].zoom*3.0f)/6.0f;
-        zoom.y = 1.0f+cosf(m_particle[i].zoom*3.7f)/6.0f;
+        zoom.x = 1.0f+sinf(m_motion.zoom[i]*3.0f)/6.0f;
+        zoom.y = 1.0f+cosf(m_motion.zoom[i]*3.7f)/6.0f;
     }
 
     dim.x *= zoom.x;
     dim.y *= zoom.y;
 
-    CObject* object = m_particle[i].objLink;
+    CObject* object = GetObjectLink(i);
     if (object != nullptr)
         pos += object->GetPosition();
 
@@ -2915,7 +3020,6 @@ void CParticle::DrawParticleFog(int i)
     mat.Set(1, 4, pos.x);
     mat.Set(2, 4, pos.y);
     mat.Set(3, 4, pos.z);
-    m_device->SetTransform(TRANSFORM_WORLD, mat);
 
     Math::Vector n(0.0f, 0.0f, -1.0f);
 
@@ -2944,20 +3048,19 @@ void CParticle::DrawParticleFog(int i)
     vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
     vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-    m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
-    m_engine->AddStatisticTriangle(2);
+    AddParticleQuad(i, vertex, &mat, Color(1.0f, 1.0f, 1.0f, 1.0f));
 }
 
 void CParticle::DrawParticleRay(int i)
 {
-    if (m_particle[i].zoom == 0.0f)  return;
-    if (m_particle[i].intensity == 0.0f)  return;
+    if (m_motion.zoom[i] == 0.0f)  return;
+    if (m_motion.intensity[i] == 0.0f)  return;
 
     Math::Vector eye = m_engine->GetEyePt();
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_motion.GetPos(i);
     Math::Vector goal = m_particle[i].goal;
 
-    CObject* object = m_particle[i].objLink;
+    CObject* object = GetObjectLink(i);
     if (object != nullptr)
         pos += object->GetPosition();
 
@@ -2976,13 +3079,12 @@ void CParticle::DrawParticleRay(int i)
     mat.Set(1, 4, pos.x);
     mat.Set(2, 4, pos.y);
     mat.Set(3, 4, pos.z);
-    m_device->SetTransform(TRANSFORM_WORLD, mat);
 
     Math::Vector n(0.0f, 0.0f, left ? 1.0f : -1.0f);
 
     Math::Point dim;
-    dim.x = m_particle[i].dim.x * m_particle[i].zoom;
-    dim.y = m_particle[i].dim.y * m_particle[i].zoom;
+    dim.x = m_particle[i].dim.x * m_motion.zoom[i];
+    dim.y = m_particle[i].dim.y * m_motion.zoom[i];
 
     if (left) dim.y = -dim.y;
 
@@ -3015,40 +3117,40 @@ void CParticle::DrawParticleRay(int i)
     }
     else if (m_particle[i].type == PARTIRAY3)
     {
-        if (m_particle[i].time < m_particle[i].duration*0.40f)
+        if (m_motion.time[i] < m_motion.duration[i]*0.40f)
         {
-            float prop = m_particle[i].time / (m_particle[i].duration*0.40f);
+            float prop = m_motion.time[i] / (m_motion.duration[i]*0.40f);
             first = 0;
             last  = static_cast<int>(prop*step);
         }
-        else if (m_particle[i].time < m_particle[i].duration*0.60f)
+        else if (m_motion.time[i] < m_motion.duration[i]*0.60f)
         {
             first = 0;
             last  = step;
         }
         else
         {
-            float prop = (m_particle[i].time-m_particle[i].duration*0.60f) / (m_particle[i].duration*0.40f);
+            float prop = (m_motion.time[i]-m_motion.duration[i]*0.60f) / (m_motion.duration[i]*0.40f);
             first = static_cast<int>(prop*step);
             last  = step;
         }
     }
     else
     {
-        if (m_particle[i].time < m_particle[i].duration*0.50f)
+        if (m_motion.time[i] < m_motion.duration[i]*0.50f)
         {
-            float prop = m_particle[i].time / (m_particle[i].duration*0.50f);
+            float prop = m_motion.time[i] / (m_motion.duration[i]*0.50f);
             first = 0;
             last  = static_cast<int>(prop*step);
         }
-        else if (m_particle[i].time < m_particle[i].duration*0.75f)
+        else if (m_motion.time[i] < m_motion.duration[i]*0.75f)
         {
             first = 0;
             last  = step;
         }
         else
         {
-            float prop = (m_particle[i].time-m_particle[i].duration*0.75f) / (m_particle[i].duration*0.25f);
+            float prop = (m_motion.time[i]-m_motion.duration[i]*0.75f) / (m_motion.duration[i]*0.25f);
             first = static_cast<int>(prop*step);
             last  = step;
         }
@@ -3098,8 +3200,7 @@ void CParticle::DrawParticleRay(int i)
             vertex[2] = Vertex(corner[3], n, Math::Point(texSup.x, texInf.y));
             vertex[3] = Vertex(corner[2], n, Math::Point(texInf.x, texInf.y));
 
-            m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
-            m_engine->AddStatisticTriangle(2);
+            AddParticleQuad(i, vertex, &mat, Color(1.0f, 1.0f, 1.0f, 1.0f));
         }
         adv += dim.x*2.0f;
     }
@@ -3107,21 +3208,21 @@ void CParticle::DrawParticleRay(int i)
 
 void CParticle::DrawParticleSphere(int i)
 {
-    float zoom = m_particle[i].zoom;
+    float zoom = m_motion.zoom[i];
 
     if (zoom == 0.0f) return;
 
     m_engine->SetState(ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_2FACE | ENG_RSTATE_WRAP,
-                       IntensityToColor(m_particle[i].intensity));
+                       IntensityToColor(m_motion.intensity[i]));
 
     Math::Matrix mat;
     mat.LoadIdentity();
     mat.Set(1, 1, zoom);
     mat.Set(2, 2, zoom);
     mat.Set(3, 3, zoom);
-    mat.Set(1, 4, m_particle[i].pos.x);
-    mat.Set(2, 4, m_particle[i].pos.y);
-    mat.Set(3, 4, m_particle[i].pos.z);
+    mat.Set(1, 4, m_motion.posX[i]);
+    mat.Set(2, 4, m_motion.posY[i]);
+    mat.Set(3, 4, m_motion.posZ[i]);
 
     if (m_particle[i].angle != 0.0f)
     {
@@ -3200,8 +3301,9 @@ void CParticle::DrawParticleSphere(int i)
 
     m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, j);
     m_engine->AddStatisticTriangle(j);
+    m_engine->AddStatisticParticleDraws(1);
 
-    m_engine->SetState(ENG_RSTATE_TTEXTURE_BLACK, IntensityToColor(m_particle[i].intensity));
+    m_engine->SetState(ENG_RSTATE_TTEXTURE_BLACK, IntensityToColor(m_motion.intensity[i]));
 }
 
 //! Returns the height depending on the progress
@@ -3215,22 +3317,22 @@ static float ProgressCylinder(float progress)
 
 void CParticle::DrawParticleCylinder(int i)
 {
-    float progress = m_particle[i].zoom;
+    float progress = m_motion.zoom[i];
     float zoom = m_particle[i].dim.x;
     float diam = m_particle[i].dim.y;
     if (progress >= 1.0f || zoom == 0.0f)  return;
 
     m_engine->SetState(ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_2FACE | ENG_RSTATE_WRAP,
-                       IntensityToColor(m_particle[i].intensity));
+                       IntensityToColor(m_motion.intensity[i]));
 
     Math::Matrix mat;
     mat.LoadIdentity();
     mat.Set(1, 1, zoom);
     mat.Set(2, 2, zoom);
     mat.Set(3, 3, zoom);
-    mat.Set(1, 4, m_particle[i].pos.x);
-    mat.Set(2, 4, m_particle[i].pos.y);
-    mat.Set(3, 4, m_particle[i].pos.z);
+    mat.Set(1, 4, m_motion.posX[i]);
+    mat.Set(2, 4, m_motion.posY[i]);
+    mat.Set(3, 4, m_motion.posZ[i]);
     m_device->SetTransform(TRANSFORM_WORLD, mat);
 
     Math::Point ts, ti;
@@ -3295,8 +3397,9 @@ void CParticle::DrawParticleCylinder(int i)
 
     m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, j);
     m_engine->AddStatisticTriangle(j);
+    m_engine->AddStatisticParticleDraws(1);
 
-    m_engine->SetState(ENG_RSTATE_TTEXTURE_BLACK, IntensityToColor(m_particle[i].intensity));
+    m_engine->SetState(ENG_RSTATE_TTEXTURE_BLACK, IntensityToColor(m_motion.intensity[i]));
 }
 
 void CParticle::DrawParticleText(int i)
@@ -3305,7 +3408,7 @@ void CParticle::DrawParticleText(int i)
     if (tex.id == 0) return;
 
     m_device->SetTexture(0, tex.id);
-    m_engine->SetState(ENG_RSTATE_TTEXTURE_ALPHA, IntensityToColor(m_particle[i].intensity));
+    m_engine->SetState(ENG_RSTATE_TTEXTURE_ALPHA, IntensityToColor(m_motion.intensity[i]));
 
     Math::IntPoint fontTextureSize = m_engine->GetText()->GetFontTextureSize();
     m_particle[i].texSup.x = static_cast<float>(tex.charPos.x) / fontTextureSize.x;
@@ -3314,7 +3417,7 @@ void CParticle::DrawParticleText(int i)
     m_particle[i].texInf.y = static_cast<float>(tex.charPos.y + tex.charSize.y) / fontTextureSize.y;
     m_particle[i].color = Color(0.0f, 0.0f, 0.0f);
 
-    DrawParticleNorm(i);
+    DrawParticleNorm(i, false);
 }
 
 void CParticle::DrawParticleWheel(int i)
@@ -3352,6 +3455,7 @@ void CParticle::DrawParticleWheel(int i)
 
         m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4, TraceColorColor(m_wheelTrace[i].color));
         m_engine->AddStatisticTriangle(2);
+        m_engine->AddStatisticParticleDraws(1);
 
         m_engine->SetState(ENG_RSTATE_OPAQUE_COLOR);
     }
@@ -3373,17 +3477,120 @@ void CParticle::DrawParticleWheel(int i)
 
         m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4, TraceColorColor(m_wheelTrace[i].color));
         m_engine->AddStatisticTriangle(2);
+        m_engine->AddStatisticParticleDraws(1);
     }
 }
 
+namespace
+{
+
+//! Orders colors component by component, used to group quads drawn with the same colors
+bool ColorLess(const Color& a, const Color& b)
+{
+    if (a.r != b.r) return a.r < b.r;
+    if (a.g != b.g) return a.g < b.g;
+    if (a.b != b.b) return a.b < b.b;
+    return a.a < b.a;
+}
+
+} // anonymous namespace
+
+void CParticle::AddParticleQuad(int i, const Vertex vertex[4], const Math::Matrix* world,
+                                const Color& color, bool batch)
+{
+    if (!batch)
+    {
+        if (world != nullptr)
+            m_device->SetTransform(TRANSFORM_WORLD, *world);
+
+        m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4, color);
+        m_engine->AddStatisticTriangle(2);
+        m_engine->AddStatisticParticleDraws(1);
+        return;
+    }
+
+    ParticleQuad quad;
+    quad.stateColor = IntensityToColor(m_motion.intensity[i]);
+    quad.color = color;
+    quad.world = (world != nullptr);
+
+    for (int j = 0; j < 4; j++)
+    {
+        quad.vertex[j] = vertex[j];
+        if (world == nullptr) continue;
+
+        // Billboards are only rotated and translated, so the normal just needs the rotation
+        quad.vertex[j].coord  = Math::Transform(*world, vertex[j].coord);
+        quad.vertex[j].normal = Math::Transform(*world, vertex[j].normal) - Math::Transform(*world, Math::Vector());
+    }
+
+    m_quads.push_back(quad);
+}
+
+void CParticle::FlushParticleQuads(int state, const std::string& texName)
+{
+    if (m_quads.empty()) return;
+
+    // Both TTEXTURE_BLACK and TTEXTURE_WHITE blend commutatively without writing
+    // depth, so reordering quads of one type does not change the image
+    std::stable_sort(m_quads.begin(), m_quads.end(), [](const ParticleQuad& a, const ParticleQuad& b)
+    {
+        if (a.world != b.world) return a.world < b.world;
+        if (ColorLess(a.stateColor, b.stateColor)) return true;
+        if (ColorLess(b.stateColor, a.stateColor)) return false;
+        return ColorLess(a.color, b.color);
+    });
+
+    if (!texName.empty())
+        m_engine->SetTexture("textures/"+texName);
+
+    Math::Matrix identity;
+    identity.LoadIdentity();
+
+    std::size_t first = 0;
+    while (first < m_quads.size())
+    {
+        const ParticleQuad& key = m_quads[first];
+
+        m_batchVertices.clear();
+        std::size_t last = first;
+        for (; last < m_quads.size(); last++)
+        {
+            const ParticleQuad& quad = m_quads[last];
+            if (quad.world != key.world) break;
+            if (ColorLess(key.stateColor, quad.stateColor) || ColorLess(key.color, quad.color)) break;
+
+            // Triangle strip 0-1-2-3 as a list of two triangles
+            m_batchVertices.push_back(quad.vertex[0]);
+            m_batchVertices.push_back(quad.vertex[1]);
+            m_batchVertices.push_back(quad.vertex[2]);
+            m_batchVertices.push_back(quad.vertex[2]);
+            m_batchVertices.push_back(quad.vertex[1]);
+            m_batchVertices.push_back(quad.vertex[3]);
+        }
+
+        if (key.world)
+            m_device->SetTransform(TRANSFORM_WORLD, identity);
+
+        m_engine->SetState(state, key.stateColor);
+        m_device->DrawPrimitive(PRIMITIVE_TRIANGLES, m_batchVertices.data(),
+                                static_cast<int>(m_batchVertices.size()), key.color);
+        m_engine->AddStatisticTriangle(static_cast<int>(2 * (last - first)));
+        m_engine->AddStatisticParticleDraws(1);
+
+        first = last;
+    }
+
+    m_quads.clear();
+}
+
 void CParticle::DrawParticle(int sheet)
 {
     // Draw the basic particles of triangles.
     if (m_totalInterface[0][sheet] > 0)
     {
-        for (int i = 0; i < MAXPARTICULE; i++)
+        for (int i : m_liveParticles[0])
         {
-            if (!m_particle[i].used)  continue;
             if (m_particle[i].sheet != sheet)  continue;
             if (m_particle[i].type == PARTIPART)  continue;
 
@@ -3420,21 +3627,22 @@ void CParticle::DrawParticle(int sheet)
         if (m_totalInterface[t][sheet] == 0)  continue;
 
         bool loadTexture = false;
+        std::string name;
 
         int state;
         if (t == 4) state = ENG_RSTATE_TTEXTURE_WHITE;  // effect03.png
         else        state = ENG_RSTATE_TTEXTURE_BLACK;  // effect[00..02].png
         m_engine->SetState(state);
 
-        for (int j = 0; j < MAXPARTICULE; j++)
+        // Billboards (normal, flat, fog and ray) are queued in m_quads and drawn
+        // together at the end; the other shapes are drawn immediately
+        for (int i : m_liveParticles[t])
         {
-            int i = MAXPARTICULE*t+j;
-            if (!m_particle[i].used)  continue;
             if (m_particle[i].sheet != sheet)  continue;
+            if (IsObjectLinkLost(i))  continue;  // deleted by the next FrameParticle()
 
             if (!loadTexture && t != 5)
             {
-                std::string name;
                 NameParticle(name, t);
                 m_engine->SetTexture("textures/"+name);
                 loadTexture = true;
@@ -3448,8 +3656,6 @@ void CParticle::DrawParticle(int sheet)
                 if (!m_track[r].drawParticle)  continue;
             }
 
-            m_engine->SetState(state, IntensityToColor(m_particle[i].intensity));
-
             if (m_particle[i].ray)  // ray?
             {
                 DrawParticleRay(i);
@@ -3484,6 +3690,8 @@ void CParticle::DrawParticle(int sheet)
                 DrawParticleNorm(i);
             }
         }
+
+        FlushParticleQuads(state, name);
     }
 }
 
@@ -3508,10 +3716,17 @@ CObject* CParticle::SearchObjectGun(Math::Vector old, Math::Vector pos,
     box2.y += min;
     box2.z += min;
 
+    // Objects which can be hit: crash spheres in the box, center near the end
+    // of the segment or a shield around it
+    float margin = min+4.0f;
+    if (type == PARTIGUN2 || type == PARTIGUN3)
+        margin = Math::Max(margin, RADIUS_SHIELD_MAX);
+    CObjectManager::GetInstancePointer()->GetWorldQuery()->GetObjectsNearSegment(old, pos, margin, m_queryObjects);
+
     CObject* best = nullptr;
     float best_dist = std::numeric_limits<float>::infinity();
     bool shield = false;
-    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    for (CObject* obj : m_queryObjects)
     {
         if (!obj->GetDetectable()) continue;  // inactive?
         if (obj == father) continue;
@@ -3620,7 +3835,8 @@ CObject* CParticle::SearchObjectRay(Math::Vector pos, Math::Vector goal,
     box2.y += min;
     box2.z += min;
 
-    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    CObjectManager::GetInstancePointer()->GetWorldQuery()->GetObjectsInBox(box1, box2, m_queryObjects);
+    for (CObject* obj : m_queryObjects)
     {
         if (!obj->GetDetectable()) continue;  // inactive?
         if (obj == father) continue;
@@ -3670,24 +3886,23 @@ Color CParticle::GetFogColor(Math::Vector pos)
     result.b = 0.0f;
     result.a = 0.0f;
 
-    for (int fog = 0; fog < m_fogTotal; fog++)
+    for (int i : m_fog)  // i = rank of the particle
     {
-        int i = m_fog[fog];  // i = rank of the particle
 
-        if (pos.y >= m_particle[i].pos.y+FOG_HSUP)  continue;
-        if (pos.y <= m_particle[i].pos.y-FOG_HINF)  continue;
+        if (pos.y >= m_motion.posY[i]+FOG_HSUP)  continue;
+        if (pos.y <= m_motion.posY[i]-FOG_HINF)  continue;
 
-        float dist = Math::DistanceProjected(pos, m_particle[i].pos);
+        float dist = Math::DistanceProjected(pos, m_motion.GetPos(i));
         if (dist >= m_particle[i].dim.x*1.5f)  continue;
 
         // Calculates the horizontal distance.
         float factor = 1.0f-powf(dist/(m_particle[i].dim.x*1.5f), 4.0f);
 
         // Calculates the vertical distance.
-        if (pos.y > m_particle[i].pos.y)
-            factor *= 1.0f-(pos.y-m_particle[i].pos.y)/FOG_HSUP;
+        if (pos.y > m_motion.posY[i])
+            factor *= 1.0f-(pos.y-m_motion.posY[i])/FOG_HSUP;
         else
-            factor *= 1.0f-(m_particle[i].pos.y-pos.y)/FOG_HINF;
+            factor *= 1.0f-(m_motion.posY[i]-pos.y)/FOG_HINF;
 
         factor *= 0.3f;
 
@@ -3740,24 +3955,21 @@ Color CParticle::GetFogColor(Math::Vector pos)
     return result;
 }
 
-void CParticle::CutObjectLink(CObject* obj)
+CObject* CParticle::GetObjectLink(int i)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
-    {
-        if (!m_particle[i].used) continue;
+    if (m_particle[i].objLink.IsNull()) return nullptr;
+    return CObjectManager::GetInstancePointer()->GetObjectByHandle(m_particle[i].objLink);
+}
 
-        if (m_particle[i].objLink == obj)
-        {
-            // If the object this particle's coordinates are linked to doesn't exist anymore, remove the particle
-            DeleteRank(i);
-        }
+CObject* CParticle::GetObjectFather(int i)
+{
+    if (m_particle[i].objFather.IsNull()) return nullptr;
+    return CObjectManager::GetInstancePointer()->GetObjectByHandle(m_particle[i].objFather);
+}
 
-        if (m_particle[i].objFather == obj)
-        {
-            // If the object that spawned this partcle doesn't exist anymore, remove the link
-            m_particle[i].objFather = nullptr;
-        }
-    }
+bool CParticle::IsObjectLinkLost(int i)
+{
+    return !m_particle[i].objLink.IsNull() && GetObjectLink(i) == nullptr;
 }
 
 } // namespace Gfx
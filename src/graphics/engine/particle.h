@@ -26,6 +26,9 @@
 
 
 #include "graphics/engine/engine.h"
+#include "graphics/engine/particle_motion.h"
+
+#include "object/object_handle.h"
 
 #include "object/interface/trace_drawing_object.h"
 
@@ -41,11 +44,10 @@ class CSoundInterface;
 namespace Gfx
 {
 
-const short MAXPARTICULE = 500;
+//! Channels keep the rank of the particle in 16 bits, which limits the particles alive at once
+const int   MAXPARTICULE = 0x10000;
 const short MAXPARTITYPE = 6;
-const short MAXTRACK = 100;
 const short MAXTRACKLEN = 10;
-const short MAXPARTIFOG = 100;
 const short MAXWHEELTRACE = 1000;
 
 const short SH_WORLD = 0;       // particle in the world in the interface
@@ -160,6 +162,7 @@ enum ParticlePhase
     PARPHEND        = 1,
 };
 
+//! Fields of a particle, except the ones in ParticleMotion
 struct Particle
 {
     bool            used = false;      // TRUE -> particle used
@@ -168,27 +171,21 @@ struct Particle
     short           sheet = 0;      // sheet (0..n)
     ParticleType    type = {};       // type PARTI*
     ParticlePhase   phase = {};      // phase PARPH*
-    float           mass = 0.0f;       // mass of the particle (in rebounding)
     float           weight = 0.0f;     // weight of the particle (for noise)
-    float           duration = 0.0f;   // length of life
-    Math::Vector    pos;        // absolute position (relative if object links)
     Math::Vector    goal;       // goal position (if ray)
-    Math::Vector    speed;      // speed of displacement
     float           windSensitivity = 0.0f;
     short           bounce = 0;     // number of rebounds
     Math::Point     dim;        // dimensions of the rectangle
-    float           zoom = 0.0f;       // zoom (0..1)
     float           angle = 0.0f;      // angle of rotation
-    float           intensity = 0.0f;  // intensity
     Math::Point     texSup;     // coordinated upper texture
     Math::Point     texInf;     // coordinated lower texture
-    float           time = 0.0f;       // age of the particle (0..n)
-    float           phaseTime = 0.0f;  // age at the beginning of phase
     float           testTime = 0.0f;   // time since last test
-    CObject*        objLink = nullptr;    // father object (for example reactor)
-    CObject*        objFather = nullptr;  // father object (for example reactor)
+    ObjectHandle    objLink;    // object the position is relative to (the particle dies with it)
+    ObjectHandle    objFather;  // father object (for example reactor)
     short           objRank = 0;    // rank of the object, or -1
     short           trackRank = 0;  // rank of the drag
+    short           group = 0;      // texture group (0..MAXPARTITYPE-1)
+    int             liveIndex = 0;  // index in the list of live particles of the group
     char            text = 0;
     Color           color = Color(1.0f, 1.0f, 1.0f, 1.0f);
 };
@@ -213,6 +210,21 @@ struct WheelTrace
     Math::Vector    pos[4];
 };
 
+//! Particle selected for update by CParticle::FrameParticle()
+struct FrameParticleEntry
+{
+    int             rank = 0;
+    unsigned short  uniqueStamp = 0;    // stamp of the particle when selected
+};
+
+//! Quad of a billboard particle waiting in the batch of its texture and state
+struct ParticleQuad
+{
+    Color           stateColor;     // color given to SetState()
+    Color           color;          // color given to DrawPrimitive()
+    bool            world = true;   // true -> vertices in world coordinates
+    Vertex          vertex[4];      // corners in triangle strip order
+};
 
 /**
  * \class CParticle
@@ -291,10 +303,15 @@ public:
     //! Draws all the particles
     void        DrawParticle(int sheet);
 
-    //! Indicates that the object binds to the particle no longer exists, without deleting it
-    void        CutObjectLink(CObject* obj);
-
 protected:
+    //! Returns the object the particle is linked to, nullptr if none
+    CObject*    GetObjectLink(int i);
+    //! Returns the object which created the particle, nullptr if none or deleted
+    CObject*    GetObjectFather(int i);
+    //! Returns true if the particle was linked to an object which was deleted
+    bool        IsObjectLinkLost(int i);
+    //! Takes a free particle of texture group \a t, growing the pool if needed; returns its rank or -1
+    int         AllocateParticle(int t, int sheet);
     //! Removes a particle of given rank
     void        DeleteRank(int rank);
     /**
@@ -305,8 +322,8 @@ protected:
     bool        CheckChannel(int &channel);
     //! Draws a triangular particle
     void        DrawParticleTriangle(int i);
-    //! Draw a normal particle
-    void        DrawParticleNorm(int i);
+    //! Draw a normal particle, queued in the current batch or drawn immediately
+    void        DrawParticleNorm(int i, bool batch = true);
     //! Draw a particle flat (horizontal)
     void        DrawParticleFlat(int i);
     //! Draw a particle to a flat sheet of fog
@@ -321,12 +338,21 @@ protected:
     void        DrawParticleText(int i);
     //! Draws a tire mark
     void        DrawParticleWheel(int i);
+    //! Queues a quad of particle \a i, transformed by \a world if given, or draws it immediately
+    void        AddParticleQuad(int i, const Vertex vertex[4], const Math::Matrix* world,
+                                const Color& color, bool batch = true);
+    //! Draws the queued quads with the given state and texture, one draw call per color
+    void        FlushParticleQuads(int state, const std::string& texName);
     //! Seeks if an object collided with a bullet
     CObject*    SearchObjectGun(Math::Vector old, Math::Vector pos, ParticleType type, CObject *father);
     //! Seeks if an object collided with a ray
     CObject*    SearchObjectRay(Math::Vector pos, Math::Vector goal, ParticleType type, CObject *father);
     //! Sounded one
     void        Play(SoundType sound, Math::Vector pos, float amplitude);
+    //! Sets the behavior of particle \a i in m_motion, according to its type
+    void        SetMotionBehavior(int i, ParticleType type);
+    //! Finds the ground below particles [begin; end) of m_frameParticles; safe to run in parallel
+    void        FindParticleFloors(int begin, int end);
     //! Moves a drag; returns true if the drag is finished
     bool        TrackMove(int i, Math::Vector pos, float progress);
     //! Draws a drag
@@ -340,20 +366,35 @@ protected:
     CRobotMain*       m_main = nullptr;
     CSoundInterface*  m_sound = nullptr;
 
-    Particle       m_particle[MAXPARTICULE*MAXPARTITYPE];
-    EngineTriangle m_triangle[MAXPARTICULE];  // triangle if PartiType == 0
-    Track          m_track[MAXTRACK];
+    std::vector<Particle> m_particle;
+    //! Fields of m_particle integrated every frame
+    ParticleMotion m_motion;
+    //! Ranks of the unused entries of m_particle
+    std::vector<int> m_freeParticles;
+    //! Ranks of the particles alive, per texture group
+    std::vector<int> m_liveParticles[MAXPARTITYPE];
+    //! Particles updated by the current FrameParticle()
+    std::vector<FrameParticleEntry> m_frameParticles;
+    //! Ground level below each particle of m_frameParticles
+    std::vector<float> m_frameFloor;
+    std::vector<EngineTriangle> m_triangle;  // triangle if PartiType == 0
+    std::vector<Track> m_track;
     int           m_wheelTraceTotal = 0;
     int           m_wheelTraceIndex = 0;
     WheelTrace    m_wheelTrace[MAXWHEELTRACE];
     int           m_totalInterface[MAXPARTITYPE][SH_MAX] = {};
     bool          m_frameUpdate[SH_MAX] = {};
-    int           m_fogTotal = 0;
-    int           m_fog[MAXPARTIFOG] = {};
+    std::vector<int> m_fog;     // ranks of the fog particles
     int           m_uniqueStamp = 0;
     int           m_exploGunCounter = 0;
     float         m_lastTimeGunDel = 0.0f;
     float         m_absTime = 0.0f;
+    //! Candidates returned by CWorldQuery, kept to reuse the memory
+    std::vector<CObject*> m_queryObjects;
+    //! Billboard quads of the particle type being drawn
+    std::vector<ParticleQuad> m_quads;
+    //! Triangle list built from m_quads, kept to reuse the memory
+    std::vector<Vertex> m_batchVertices;
 };
 
 
@@ -0,0 +1,204 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/particle_motion.h"
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+const float PROGRESS_LIMIT = 1e30f;
+
+//! value[k] += factor[k]*step[k]
+void MultiplyAdd(float* value, const float* factor, const float* step, int begin, int end)
+{
+    for (int k = begin; k < end; k++)
+        value[k] += factor[k]*step[k];
+}
+
+//! value[k] -= factor[k]*step[k]
+void MultiplySubtract(float* value, const float* factor, const float* step, int begin, int end)
+{
+    for (int k = begin; k < end; k++)
+        value[k] -= factor[k]*step[k];
+}
+
+//! value[k] = base[k]+slope[k]*progress[k] where ramp[k] and update[k] are 1, unchanged elsewhere
+void Ramp(float* value, const float* ramp, const float* base, const float* slope,
+          const float* update, const float* progress, int begin, int end)
+{
+    for (int k = begin; k < end; k++)
+    {
+        float w = ramp[k]*update[k];
+        value[k] = w*(base[k]+slope[k]*progress[k]) + (1.0f-w)*value[k];
+    }
+}
+
+} // anonymous namespace
+
+
+int ParticleMotion::GetSize() const
+{
+    return static_cast<int>(posX.size());
+}
+
+void ParticleMotion::Add()
+{
+    posX.push_back(0.0f);
+    posY.push_back(0.0f);
+    posZ.push_back(0.0f);
+    speedX.push_back(0.0f);
+    speedY.push_back(0.0f);
+    speedZ.push_back(0.0f);
+    mass.push_back(0.0f);
+    duration.push_back(0.0f);
+    time.push_back(0.0f);
+    phaseTime.push_back(0.0f);
+    zoom.push_back(0.0f);
+    intensity.push_back(0.0f);
+    update.push_back(0.0f);
+    step.push_back(0.0f);
+    progress.push_back(0.0f);
+    move.push_back(1.0f);
+    zoomRamp.push_back(0.0f);
+    zoomBase.push_back(0.0f);
+    zoomSlope.push_back(0.0f);
+    intensityRamp.push_back(0.0f);
+    intensityBase.push_back(0.0f);
+    intensitySlope.push_back(0.0f);
+}
+
+void ParticleMotion::Reset(int rank)
+{
+    SetPos(rank, Math::Vector());
+    SetSpeed(rank, Math::Vector());
+    mass[rank] = 0.0f;
+    duration[rank] = 0.0f;
+    time[rank] = 0.0f;
+    phaseTime[rank] = 0.0f;
+    zoom[rank] = 0.0f;
+    intensity[rank] = 0.0f;
+    update[rank] = 0.0f;
+    move[rank] = 1.0f;
+    zoomRamp[rank] = 0.0f;
+    intensityRamp[rank] = 0.0f;
+}
+
+void ParticleMotion::Clear()
+{
+    posX.clear();
+    posY.clear();
+    posZ.clear();
+    speedX.clear();
+    speedY.clear();
+    speedZ.clear();
+    mass.clear();
+    duration.clear();
+    time.clear();
+    phaseTime.clear();
+    zoom.clear();
+    intensity.clear();
+    update.clear();
+    step.clear();
+    progress.clear();
+    move.clear();
+    zoomRamp.clear();
+    zoomBase.clear();
+    zoomSlope.clear();
+    intensityRamp.clear();
+    intensityBase.clear();
+    intensitySlope.clear();
+}
+
+Math::Vector ParticleMotion::GetPos(int rank) const
+{
+    return Math::Vector(posX[rank], posY[rank], posZ[rank]);
+}
+
+void ParticleMotion::SetPos(int rank, const Math::Vector& pos)
+{
+    posX[rank] = pos.x;
+    posY[rank] = pos.y;
+    posZ[rank] = pos.z;
+}
+
+Math::Vector ParticleMotion::GetSpeed(int rank) const
+{
+    return Math::Vector(speedX[rank], speedY[rank], speedZ[rank]);
+}
+
+void ParticleMotion::SetSpeed(int rank, const Math::Vector& speed)
+{
+    speedX[rank] = speed.x;
+    speedY[rank] = speed.y;
+    speedZ[rank] = speed.z;
+}
+
+void ParticleMotion::SetFixed(int rank, bool fixed)
+{
+    move[rank] = fixed ? 0.0f : 1.0f;
+}
+
+void ParticleMotion::SetZoomRamp(int rank, float base, float slope)
+{
+    zoomRamp[rank] = 1.0f;
+    zoomBase[rank] = base;
+    zoomSlope[rank] = slope;
+}
+
+void ParticleMotion::SetIntensityRamp(int rank, float base, float slope)
+{
+    intensityRamp[rank] = 1.0f;
+    intensityBase[rank] = base;
+    intensitySlope[rank] = slope;
+}
+
+void ParticleMotion::Integrate(float rTime, int begin, int end)
+{
+    // Each loop reads few arrays, so the compiler can check that they don't
+    // overlap and vectorize it
+    float* st = step.data();
+    float* pr = progress.data();
+    for (int k = begin; k < end; k++)
+        st[k] = update[k]*move[k]*rTime;
+
+    MultiplyAdd(posX.data(), speedX.data(), st, begin, end);
+    MultiplyAdd(posY.data(), speedY.data(), st, begin, end);
+    MultiplyAdd(posZ.data(), speedZ.data(), st, begin, end);
+    MultiplySubtract(speedY.data(), mass.data(), st, begin, end);
+
+    // Particles which are not updated may have no duration yet, so the
+    // progress is kept finite, as Ramp() multiplies it by 0 for them
+    for (int k = begin; k < end; k++)
+    {
+        float p = (time[k]-phaseTime[k])/duration[k];
+        p = (-PROGRESS_LIMIT < p) ? p : -PROGRESS_LIMIT;  // also replaces NaN
+        pr[k] = (p < PROGRESS_LIMIT) ? p : PROGRESS_LIMIT;
+    }
+
+    Ramp(zoom.data(), zoomRamp.data(), zoomBase.data(), zoomSlope.data(), update.data(), pr, begin, end);
+    Ramp(intensity.data(), intensityRamp.data(), intensityBase.data(), intensitySlope.data(), update.data(), pr, begin, end);
+}
+
+
+} // namespace Gfx
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/particle_motion.h
+ * \brief Fields of the particles integrated every frame - ParticleMotion struct
+ */
+
+#pragma once
+
+#include "math/vector.h"
+
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct ParticleMotion
+ * \brief Fields of the particles changed every frame, stored as one array per field
+ *
+ * Entries are indexed by the rank of the particle in CParticle. Integrate()
+ * runs over contiguous ranges of ranks without branches, so the compiler can
+ * vectorize it. Instead of the type of the particle, it uses factors set for
+ * each behavior: fixed particles don't move, and the zoom and intensity of
+ * particles with a ramp are a linear function of their progress.
+ */
+struct ParticleMotion
+{
+    std::vector<float> posX;            // absolute position (relative if object links)
+    std::vector<float> posY;
+    std::vector<float> posZ;
+    std::vector<float> speedX;          // speed of displacement
+    std::vector<float> speedY;
+    std::vector<float> speedZ;
+    std::vector<float> mass;            // mass of the particle (in rebounding)
+    std::vector<float> duration;        // length of life
+    std::vector<float> time;            // age of the particle (0..n)
+    std::vector<float> phaseTime;       // age at the beginning of phase
+    std::vector<float> zoom;            // zoom (0..1)
+    std::vector<float> intensity;       // intensity
+
+    std::vector<float> update;          // 1 if updated by the current frame, else 0
+    std::vector<float> move;            // 0 for fixed particles, else 1
+    std::vector<float> zoomRamp;        // 1 if zoom = zoomBase+zoomSlope*progress
+    std::vector<float> zoomBase;
+    std::vector<float> zoomSlope;
+    std::vector<float> intensityRamp;   // 1 if intensity = intensityBase+intensitySlope*progress
+    std::vector<float> intensityBase;
+    std::vector<float> intensitySlope;
+    std::vector<float> step;            // time step of the current frame, used by Integrate()
+    std::vector<float> progress;        // progress of the current frame, used by Integrate()
+
+    //! Returns the number of entries
+    int         GetSize() const;
+    //! Adds an entry at the end, with default values
+    void        Add();
+    //! Sets default values to an entry, for a new particle
+    void        Reset(int rank);
+    //! Removes all entries
+    void        Clear();
+
+    //! Returns the position of a particle
+    Math::Vector GetPos(int rank) const;
+    //! Sets the position of a particle
+    void        SetPos(int rank, const Math::Vector& pos);
+    //! Returns the speed of a particle
+    Math::Vector GetSpeed(int rank) const;
+    //! Sets the speed of a particle
+    void        SetSpeed(int rank, const Math::Vector& speed);
+
+    //! Sets if the particle stays at its position, ignoring speed and mass
+    void        SetFixed(int rank, bool fixed);
+    //! Makes the zoom a linear function of the progress
+    void        SetZoomRamp(int rank, float base, float slope);
+    //! Makes the intensity a linear function of the progress
+    void        SetIntensityRamp(int rank, float base, float slope);
+
+    //! Moves the particles [begin; end) marked in update by speed and gravity, and applies their ramps
+    void        Integrate(float rTime, int begin, int end);
+};
+
+
+} // namespace Gfx
@@ -1563,15 +1563,8 @@ void CPyro::ExploStart()
         if (objRank == -1) continue;
 
         // TODO: refactor later to material change
-        int oldBaseObjRank = m_engine->GetObjectBaseRank(objRank);
-        if (oldBaseObjRank != -1)
-        {
-            int newBaseObjRank = m_engine->CreateBaseObject();
-            m_engine->CopyBaseObject(oldBaseObjRank, newBaseObjRank);
-            m_engine->SetObjectBaseRank(objRank, newBaseObjRank);
-
-            m_engine->ChangeSecondTexture(objRank, "dirty04.png");
-        }
+        m_engine->SetObjectCopyOnWrite(objRank, true);
+        m_engine->ChangeSecondTexture(objRank, "dirty04.png");
 
         // TODO: temporary hack (hopefully)
         assert(m_object->Implements(ObjectInterfaceType::Old));
@@ -1636,15 +1629,8 @@ void CPyro::BurnStart()
         if (objRank == -1) continue;
 
         // TODO: refactor later to material change
-        int oldBaseObjRank = m_engine->GetObjectBaseRank(objRank);
-        if (oldBaseObjRank != -1)
-        {
-            int newBaseObjRank = m_engine->CreateBaseObject();
-            m_engine->CopyBaseObject(oldBaseObjRank, newBaseObjRank);
-            m_engine->SetObjectBaseRank(objRank, newBaseObjRank);
-
-            m_engine->ChangeSecondTexture(objRank, "dirty04.png");
-        }
+        m_engine->SetObjectCopyOnWrite(objRank, true);
+        m_engine->ChangeSecondTexture(objRank, "dirty04.png");
     }
     m_engine->LoadTexture("textures/dirty04.png");
 
@@ -0,0 +1,178 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/render_queue.h"
+
+#include "graphics/core/device.h"
+
+#include <algorithm>
+#include <tuple>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+bool ColorLess(const Color& a, const Color& b)
+{
+    return std::tie(a.r, a.g, a.b, a.a) < std::tie(b.r, b.g, b.b, b.a);
+}
+
+bool MaterialLess(const Material& a, const Material& b)
+{
+    if (a.diffuse != b.diffuse)
+        return ColorLess(a.diffuse, b.diffuse);
+    if (a.ambient != b.ambient)
+        return ColorLess(a.ambient, b.ambient);
+    return ColorLess(a.specular, b.specular);
+}
+
+bool CanInstance(const RenderItem& a, const RenderItem& b)
+{
+    return a.data == b.data &&
+           a.objType == b.objType &&
+           a.state == b.state &&
+           a.tex1 == b.tex1 &&
+           a.tex2 == b.tex2;
+}
+
+} // anonymous namespace
+
+
+void CRenderQueue::Clear()
+{
+    m_items.clear();
+}
+
+void CRenderQueue::Add(const RenderItem& item)
+{
+    m_items.push_back(item);
+}
+
+void CRenderQueue::SortByState()
+{
+    std::stable_sort(m_items.begin(), m_items.end(), [](const RenderItem& a, const RenderItem& b)
+    {
+        if (a.objType != b.objType)
+            return a.objType < b.objType;
+        if (a.state != b.state)
+            return a.state < b.state;
+        if (! (a.tex1 == b.tex1))
+            return a.tex1 < b.tex1;
+        if (! (a.tex2 == b.tex2))
+            return a.tex2 < b.tex2;
+        if (a.data->material != b.data->material)
+            return MaterialLess(a.data->material, b.data->material);
+        if (a.data != b.data)
+            return std::less<const EngineBaseObjDataTier*>()(a.data, b.data);
+        return a.objRank < b.objRank;
+    });
+}
+
+void CRenderQueue::SortBackToFront()
+{
+    std::stable_sort(m_items.begin(), m_items.end(), [](const RenderItem& a, const RenderItem& b)
+    {
+        return a.depth > b.depth;
+    });
+}
+
+bool CRenderQueue::IsEmpty() const
+{
+    return m_items.empty();
+}
+
+const std::vector<RenderItem>& CRenderQueue::GetItems() const
+{
+    return m_items;
+}
+
+void CRenderQueue::Submit(CDevice* device, const std::function<void(const RenderItem&)>& draw) const
+{
+    const RenderItem* last = nullptr;
+
+    for (const RenderItem& item : m_items)
+    {
+        if (last == nullptr || item.objRank != last->objRank)
+            device->SetTransform(TRANSFORM_WORLD, *item.transform);
+
+        if (last == nullptr || ! (item.tex1 == last->tex1))
+            device->SetTexture(0, item.tex1);
+
+        if (last == nullptr || ! (item.tex2 == last->tex2))
+            device->SetTexture(1, item.tex2);
+
+        if (last == nullptr || item.data->material != last->data->material)
+            device->SetMaterial(item.data->material);
+
+        draw(item);
+
+        last = &item;
+    }
+}
+
+void CRenderQueue::SubmitInstanced(CDevice* device, const std::function<void(const RenderItem* items, int count)>& draw) const
+{
+    const RenderItem* last = nullptr;
+    int transformRank = -1;
+
+    std::size_t begin = 0;
+    while (begin < m_items.size())
+    {
+        const RenderItem& item = m_items[begin];
+
+        std::size_t end = begin + 1;
+        if (item.data->staticBufferId != 0)
+        {
+            while (end < m_items.size() && CanInstance(item, m_items[end]))
+                end++;
+        }
+
+        int count = static_cast<int>(end - begin);
+        if (count > 1)
+        {
+            transformRank = -1;  // instanced draws may change the world transform
+        }
+        else if (item.objRank != transformRank)
+        {
+            device->SetTransform(TRANSFORM_WORLD, *item.transform);
+            transformRank = item.objRank;
+        }
+
+        if (last == nullptr || ! (item.tex1 == last->tex1))
+            device->SetTexture(0, item.tex1);
+
+        if (last == nullptr || ! (item.tex2 == last->tex2))
+            device->SetTexture(1, item.tex2);
+
+        if (last == nullptr || item.data->material != last->data->material)
+            device->SetMaterial(item.data->material);
+
+        draw(&item, count);
+
+        last = &m_items[end - 1];
+        begin = end;
+    }
+}
+
+
+} // namespace Gfx
@@ -0,0 +1,115 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/render_queue.h
+ * \brief Sorted queue of draw items - CRenderQueue class
+ */
+
+#pragma once
+
+#include "graphics/core/material.h"
+#include "graphics/core/texture.h"
+
+#include "graphics/engine/engine.h"
+
+#include "math/matrix.h"
+
+#include <functional>
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+class CDevice;
+
+/**
+ * \struct RenderItem
+ * \brief Single draw call collected for the current frame
+ *
+ * Pointers refer to data owned by CEngine and are valid only until
+ * the object tree is modified, i.e. for the duration of one frame.
+ */
+struct RenderItem
+{
+    //! Rank of engine object
+    int                          objRank = -1;
+    //! Type of engine object (selects the set of lights)
+    EngineObjectType             objType = ENG_OBJTYPE_NULL;
+    //! Render state passed to CEngine::SetState()
+    int                          state = 0;
+    //! Texture for stage 0
+    Texture                      tex1;
+    //! Texture for stage 1
+    Texture                      tex2;
+    //! World transform of the object
+    const Math::Matrix*          transform = nullptr;
+    //! Material and geometry to draw
+    const EngineBaseObjDataTier* data = nullptr;
+    //! Distance from the camera, used for transparent items
+    float                        depth = 0.0f;
+};
+
+/**
+ * \class CRenderQueue
+ * \brief Collects visible draw items and submits them with minimal state changes
+ *
+ * Opaque items are sorted by object type, render state, texture pair and material,
+ * so that consecutive items share as much device state as possible.
+ * Transparent items are sorted back to front instead.
+ *
+ * During submission, world transform, textures and material are sent
+ * to the device only when they differ from the previous item.
+ */
+class CRenderQueue
+{
+public:
+    //! Removes all items
+    void        Clear();
+    //! Adds an item to the queue
+    void        Add(const RenderItem& item);
+
+    //! Sorts items to minimize state changes (opaque pass)
+    void        SortByState();
+    //! Sorts items from the farthest to the nearest (transparent pass)
+    void        SortBackToFront();
+
+    //! Returns whether the queue is empty
+    bool        IsEmpty() const;
+    //! Returns the items in current order
+    const std::vector<RenderItem>& GetItems() const;
+
+    //! Sets changed device state for each item in order and calls \a draw
+    void        Submit(CDevice* device, const std::function<void(const RenderItem&)>& draw) const;
+    /**
+     * \brief Like Submit(), but passes runs of items that can be drawn instanced to \a draw at once
+     *
+     * A run shares the static buffer, state, textures and object type; only the
+     * transforms differ. The world transform is set only for runs of one item.
+     */
+    void        SubmitInstanced(CDevice* device, const std::function<void(const RenderItem* items, int count)>& draw) const;
+
+private:
+    std::vector<RenderItem> m_items;
+};
+
+
+} // namespace Gfx
@@ -22,14 +22,18 @@
 
 #include "app/app.h"
 
+#include "common/hash.h"
 #include "common/image.h"
 #include "common/logger.h"
 
+#include "common/system/system.h"
+
 #include "graphics/engine/engine.h"
 #include "graphics/engine/water.h"
 
 #include "math/geometry.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <SDL.h>
@@ -39,9 +43,15 @@
 namespace Gfx
 {
 
+//! Size of the cells of m_buildingLevelIndex and m_flyingLimitIndex (in game units)
+const float AREA_INDEX_CELL_SIZE = 40.0f;
+//! Time (in seconds) that UpdateChunks() may spend changing the resolution of mosaics in one frame
+const float CHUNK_BUILD_TIME = 0.004f;
+
 
-CTerrain::CTerrain()
+CTerrain::CTerrain(CSystemUtils* systemUtils)
 {
+    m_systemUtils = systemUtils;
     m_engine = CEngine::GetInstancePointer();
     m_water  = m_engine->GetWater();
 
@@ -63,13 +73,21 @@ CTerrain::CTerrain()
     m_materialAutoID = 0;
     m_materialPointCount = 0;
 
+    m_reliefRevision = 0;
+    m_reliefChangesStart = 0;
+
     FlushBuildingLevel();
     FlushFlyingLimit();
     FlushMaterials();
+
+    m_chunkTimeStart = m_systemUtils->CreateTimeStamp();
+    m_chunkTimeNow = m_systemUtils->CreateTimeStamp();
 }
 
 CTerrain::~CTerrain()
 {
+    m_systemUtils->DestroyTimeStamp(m_chunkTimeStart);
+    m_systemUtils->DestroyTimeStamp(m_chunkTimeNow);
 }
 
 bool CTerrain::Generate(int mosaicCount, int brickCountPow2, float brickSize,
@@ -99,6 +117,12 @@ bool CTerrain::Generate(int mosaicCount, int brickCountPow2, float brickSize,
 
     dim = m_mosaicCount*m_mosaicCount;
     std::vector<int>(dim, -1).swap(m_objRanks);
+    std::vector<int>(dim, -1).swap(m_objLods);
+    std::vector<int>(dim, 0).swap(m_objVertexCounts);
+
+    ResetReliefChanges();
+    m_buildingLevelIndex.dirty = true;  // size of the terrain changed
+    m_flyingLimitIndex.dirty = true;
 
     return true;
 }
@@ -290,6 +314,11 @@ void CTerrain::FlushRelief()
     }
 
     m_objRanks.clear();
+    m_objLods.clear();
+    m_objVertexCounts.clear();
+    m_chunkBuildTime = 0;
+
+    ResetReliefChanges();
 }
 
 /**
@@ -344,6 +373,8 @@ bool CTerrain::LoadRelief(const std::string &fileName, float scaleRelief,
         }
     }
 
+    ResetReliefChanges();
+
     return true;
 }
 
@@ -398,6 +429,9 @@ bool CTerrain::RandomizeRelief()
             m_relief[x2+y2*size] = value * 255.0f;
         }
     }
+
+    ResetReliefChanges();
+
     return true;
 }
 
@@ -422,15 +456,26 @@ bool CTerrain::AddReliefPoint(Math::Vector pos, float scaleRelief)
 }
 
 void CTerrain::AdjustRelief()
+{
+    AdjustRelief(0, 0, m_mosaicCount*m_brickCount, m_mosaicCount*m_brickCount);
+}
+
+void CTerrain::AdjustRelief(int minX, int minY, int maxX, int maxY)
 {
     if (m_depth == 1) return;
 
     int ii = m_mosaicCount*m_brickCount+1;
     int b = 1 << (m_depth-1);
 
-    for (int y = 0; y < m_mosaicCount*m_brickCount; y += b)
+    // Blocks of b x b points containing the rectangle
+    minX = Math::Max(minX, 0)/b*b;
+    minY = Math::Max(minY, 0)/b*b;
+    maxX = Math::Min(maxX, m_mosaicCount*m_brickCount-1);
+    maxY = Math::Min(maxY, m_mosaicCount*m_brickCount-1);
+
+    for (int y = minY; y <= maxY; y += b)
     {
-        for (int x = 0; x < m_mosaicCount*m_brickCount; x += b)
+        for (int x = minX; x <= maxX; x += b)
         {
             int xx = 0;
             int yy = 0;
@@ -573,11 +618,13 @@ VertexTex2 CTerrain::GetVertex(int x, int y, int step)
   +-------------------> x
 \endverbatim */
 bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
-                            const Material &mat)
+                            const Material &mat, std::map<std::pair<std::string, std::string>, int>* updateTiers)
 {
     int baseObjRank = m_engine->GetObjectBaseRank(objRank);
     if (baseObjRank == -1)
     {
+        if (updateTiers != nullptr) return false;
+
         baseObjRank = m_engine->CreateBaseObject();
         m_engine->SetObjectBaseRank(objRank, baseObjRank);
     }
@@ -585,7 +632,10 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
     std::string texName1;
     std::string texName2;
 
-    if ( step == 1 )
+    // Streamed chunks switch between steps around the camera, so coarse
+    // ones keep the shadow texture, otherwise the shadows would pop
+    bool shadow = (step == 1) || m_streamingActive;
+    if (shadow)
     {
         int i = (ox/5) + (oy/5)*(m_mosaicCount/5);
         std::stringstream s;
@@ -640,7 +690,7 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
                 buffer.state = ENG_RSTATE_WRAP;
 
                 buffer.state |= ENG_RSTATE_SECOND;
-                if (step == 1)
+                if (shadow)
                     buffer.state |= ENG_RSTATE_DUAL_BLACK;
 
                 for (int x = 0; x <= brick; x += step)
@@ -729,7 +779,18 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
                     buffer.vertices.push_back(p2);
                 }
 
-                m_engine->AddBaseObjQuick(baseObjRank, buffer, texName1, texName2, true);
+                if (updateTiers != nullptr)
+                {
+                    int& index = (*updateTiers)[std::make_pair(texName1, texName2)];
+                    if (! m_engine->UpdateBaseObjQuick(baseObjRank, index, buffer.vertices, texName1, texName2))
+                        return false;
+                    index++;
+                }
+                else
+                {
+                    m_mosaicVertexCount += buffer.vertices.size();
+                    m_engine->AddBaseObjQuick(baseObjRank, buffer, texName1, texName2, !m_streamingActive);
+                }
             }
         }
     }
@@ -1248,7 +1309,7 @@ void CTerrain::FlushMaterialPoints()
     m_materialPoints.clear();
 }
 
-bool CTerrain::CreateSquare(int x, int y)
+bool CTerrain::CreateSquare(int x, int y, int lod)
 {
     Material mat;
     mat.diffuse = Color(1.0f, 1.0f, 1.0f);
@@ -1258,18 +1319,65 @@ bool CTerrain::CreateSquare(int x, int y)
     m_engine->SetObjectType(objRank, ENG_OBJTYPE_TERRAIN);
 
     m_objRanks[x+y*m_mosaicCount] = objRank;
+    m_objLods[x+y*m_mosaicCount] = lod;
 
+    m_mosaicVertexCount = 0;
     for (int step = 0; step < m_depth; step++)
     {
+        if (lod != -1 && step != lod) continue;
         CreateMosaic(x, y, 1 << step, objRank, mat);
     }
+    m_objVertexCounts[x+y*m_mosaicCount] = m_mosaicVertexCount;
+
+    return true;
+}
+
+bool CTerrain::UpdateSquare(int x, int y)
+{
+    Material mat;
+    mat.diffuse = Color(1.0f, 1.0f, 1.0f);
+    mat.ambient = Color(0.0f, 0.0f, 0.0f);
+
+    int objRank = m_objRanks[x+y*m_mosaicCount];
+    if (objRank == -1) return false;
+
+    // Tiers are found in the same order as they were added by CreateSquare()
+    int lod = m_objLods[x+y*m_mosaicCount];
+    std::map<std::pair<std::string, std::string>, int> tiers;
+    for (int step = 0; step < m_depth; step++)
+    {
+        if (lod != -1 && step != lod) continue;
+        if (! CreateMosaic(x, y, 1 << step, objRank, mat, &tiers))
+            return false;
+    }
 
+    m_engine->UpdateBaseObjBBox(m_engine->GetObjectBaseRank(objRank));
     return true;
 }
 
+void CTerrain::DeleteSquare(int x, int y)
+{
+    int objRank = m_objRanks[x+y*m_mosaicCount];
+    if (objRank == -1) return;
+
+    int baseObjRank = m_engine->GetObjectBaseRank(objRank);
+    if (baseObjRank != -1)
+        m_engine->DeleteBaseObject(baseObjRank);
+    m_engine->DeleteObject(objRank);
+
+    m_objRanks[x+y*m_mosaicCount] = -1;
+    m_objLods[x+y*m_mosaicCount] = -1;
+    m_objVertexCounts[x+y*m_mosaicCount] = 0;
+}
+
 bool CTerrain::CreateObjects()
 {
     AdjustRelief();
+    ResetReliefChanges();
+
+    m_streamingActive = m_streaming;
+    if (m_streamingActive)
+        return true;  // created around the camera by UpdateChunks()
 
     for (int y = 0; y < m_mosaicCount; y++)
     {
@@ -1340,35 +1448,225 @@ bool CTerrain::Terraform(const Math::Vector &p1, const Math::Vector &p2, float h
             }
         }
     }
-    AdjustRelief();
+    AdjustRelief(tp1.x-2, tp1.y-2, tp2.x+2, tp2.y+2);
+
+    // AdjustRelief() may also move the points next to the modified area
+    Math::Vector min, max;
+    min.x = (tp1.x-2)*m_brickSize-dim;
+    min.z = (tp1.y-2)*m_brickSize-dim;
+    max.x = (tp2.x+2)*m_brickSize-dim;
+    max.z = (tp2.y+2)*m_brickSize-dim;
+    AddReliefChange(min, max);
 
     Math::IntPoint pp1, pp2;
     pp1.x = (tp1.x-2)/m_brickCount;
     pp1.y = (tp1.y-2)/m_brickCount;
-    pp2.x = (tp2.x+1)/m_brickCount;
-    pp2.y = (tp2.y+1)/m_brickCount;
+    pp2.x = (tp2.x+2)/m_brickCount;
+    pp2.y = (tp2.y+2)/m_brickCount;
 
     if (pp1.x <  0            ) pp1.x = 0;
     if (pp1.x >= m_mosaicCount) pp1.x = m_mosaicCount-1;
     if (pp1.y <  0            ) pp1.y = 0;
     if (pp1.y >= m_mosaicCount) pp1.y = m_mosaicCount-1;
+    if (pp2.x >= m_mosaicCount) pp2.x = m_mosaicCount-1;
+    if (pp2.y >= m_mosaicCount) pp2.y = m_mosaicCount-1;
 
+    // The layout of the mosaics doesn't change, so only the vertices are updated
+    bool recreated = false;
     for (int y = pp1.y; y <= pp2.y; y++)
     {
         for (int x = pp1.x; x <= pp2.x; x++)
         {
-            int objRank = m_objRanks[x+y*m_mosaicCount];
-            int baseObjRank = m_engine->GetObjectBaseRank(objRank);
-            m_engine->DeleteBaseObject(baseObjRank);
-            m_engine->DeleteObject(objRank);
-            CreateSquare(x, y);  // recreates the square
+            if (m_objRanks[x+y*m_mosaicCount] == -1) continue;  // not streamed in
+            if (UpdateSquare(x, y)) continue;
+
+            int lod = m_objLods[x+y*m_mosaicCount];
+            DeleteSquare(x, y);
+            CreateSquare(x, y, lod);  // recreates the square
+            recreated = true;
+        }
+    }
+    if (recreated)
+        m_engine->Update();
+
+    return true;
+}
+
+void CTerrain::SetStreaming(bool streaming)
+{
+    m_streaming = streaming;
+}
+
+bool CTerrain::GetStreaming()
+{
+    return m_streaming;
+}
+
+void CTerrain::UpdateChunks(const Math::Vector& eye)
+{
+    if (! m_streamingActive || m_objRanks.empty()) return;
+
+    float mosaicSize = m_brickCount*m_brickSize;
+    float dim = (m_mosaicCount*mosaicSize)/2.0f;
+    float farPlane = m_engine->GetDeepView(0)*m_engine->GetClippingDistance();
+    float margin = mosaicSize/2.0f;  // avoids switching back and forth at the limits
+
+    struct ChunkChange
+    {
+        bool  missing;
+        float dist;
+        int   x, y, lod;
+    };
+    std::vector<ChunkChange> changes;
+
+    for (int y = 0; y < m_mosaicCount; y++)
+    {
+        for (int x = 0; x < m_mosaicCount; x++)
+        {
+            int i = x+y*m_mosaicCount;
+            bool built = m_objRanks[i] != -1;
+            if (built && m_objLods[i] == -1) continue;  // built at all resolutions
+
+            // Distance from the eye to the square
+            float minX = x*mosaicSize-dim;
+            float minZ = y*mosaicSize-dim;
+            float dx = Math::Max(0.0f, Math::Max(minX-eye.x, eye.x-(minX+mosaicSize)));
+            float dz = Math::Max(0.0f, Math::Max(minZ-eye.z, eye.z-(minZ+mosaicSize)));
+            float dist = sqrtf(dx*dx+dz*dz);
+
+            if (dist > farPlane+(built ? margin : 0.0f))
+            {
+                DeleteSquare(x, y);
+                continue;
+            }
+
+            int lod = 0;
+            if (m_vision > 0.0f)
+                lod = Math::Min(static_cast<int>(dist/m_vision), m_depth-1);
+
+            if (built)
+            {
+                int current = m_objLods[i];
+                if (lod == current) continue;
+                if (lod > current && dist < (current+1)*m_vision+margin) continue;
+                if (lod < current && dist > current*m_vision-margin) continue;
+            }
+
+            ChunkChange change;
+            change.missing = !built;
+            change.dist = dist;
+            change.x = x;
+            change.y = y;
+            change.lod = lod;
+            changes.push_back(change);
+        }
+    }
+
+    if (changes.empty()) return;
+
+    // Missing mosaics first, then the nearest ones
+    std::sort(changes.begin(), changes.end(), [](const ChunkChange& a, const ChunkChange& b)
+    {
+        if (a.missing != b.missing) return a.missing;
+        return a.dist < b.dist;
+    });
+
+    long long frameTime = 0;
+    for (const ChunkChange& change : changes)
+    {
+        // Holes in the terrain are built at once, other changes can wait
+        if (! change.missing && frameTime > CHUNK_BUILD_TIME*1e9f) break;
+
+        m_systemUtils->GetCurrentTimeStamp(m_chunkTimeStart);
+        DeleteSquare(change.x, change.y);
+        CreateSquare(change.x, change.y, change.lod);
+        m_systemUtils->GetCurrentTimeStamp(m_chunkTimeNow);
+
+        long long time = m_systemUtils->TimeStampExactDiff(m_chunkTimeStart, m_chunkTimeNow);
+        frameTime += time;
+        m_chunkBuildTime += time;
+    }
+}
+
+bool CTerrain::GetChunkStats(int& built, int& total, long long& memory, long long& buildTime)
+{
+    built = 0;
+    total = m_objRanks.size();
+    memory = 0;
+    buildTime = m_chunkBuildTime;
+
+    for (int i = 0; i < total; i++)
+    {
+        if (m_objRanks[i] == -1) continue;
+        built ++;
+        memory += m_objVertexCounts[i]*sizeof(VertexTex2);
+    }
+
+    return m_streamingActive;
+}
+
+int CTerrain::GetReliefRevision()
+{
+    return m_reliefRevision;
+}
+
+bool CTerrain::GetReliefChanges(int revision, Math::Vector& min, Math::Vector& max)
+{
+    if (revision < m_reliefChangesStart) return false;
+
+    bool found = false;
+    for (const ReliefChange& change : m_reliefChanges)
+    {
+        if (change.revision <= revision) continue;
+
+        if (!found)
+        {
+            min = change.min;
+            max = change.max;
+            found = true;
+        }
+        else
+        {
+            min.x = Math::Min(min.x, change.min.x);
+            min.z = Math::Min(min.z, change.min.z);
+            max.x = Math::Max(max.x, change.max.x);
+            max.z = Math::Max(max.z, change.max.z);
         }
     }
-    m_engine->Update();
 
+    if (!found)
+    {
+        min = max = Math::Vector(0.0f, 0.0f, 0.0f);
+    }
     return true;
 }
 
+void CTerrain::ResetReliefChanges()
+{
+    m_reliefRevision ++;
+    m_reliefChangesStart = m_reliefRevision;
+    m_reliefChanges.clear();
+}
+
+void CTerrain::AddReliefChange(const Math::Vector& min, const Math::Vector& max)
+{
+    const int MAX_RELIEF_CHANGES = 64;
+
+    m_reliefRevision ++;
+
+    ReliefChange change;
+    change.revision = m_reliefRevision;
+    change.min = min;
+    change.max = max;
+    m_reliefChanges.push_back(change);
+
+    if (static_cast<int>(m_reliefChanges.size()) > MAX_RELIEF_CHANGES)
+    {
+        m_reliefChangesStart = m_reliefChanges.front().revision;
+        m_reliefChanges.pop_front();
+    }
+}
+
 void CTerrain::SetWind(Math::Vector speed)
 {
     m_wind = speed;
@@ -1435,6 +1733,64 @@ bool CTerrain::GetNormal(Math::Vector &n, const Math::Vector &p)
     return true;
 }
 
+void CTerrain::SampleRelief(float x0, float z0, float stepX, float stepZ, int countX, int countZ, float* result)
+{
+    if (m_relief.empty())
+    {
+        std::fill(result, result+countX*countZ, 0.0f);
+        return;
+    }
+
+    int size = m_mosaicCount*m_brickCount;
+    float dim = (size*m_brickSize)/2.0f;
+
+    // Columns are the same for all rows, so the inner loop is only arithmetic
+    std::vector<int> columns(countX);
+    std::vector<float> fractions(countX);
+    for (int i = 0; i < countX; i++)
+    {
+        float fx = Math::Clamp((x0+i*stepX+dim)/m_brickSize, 0.0f, static_cast<float>(size));
+        columns[i] = Math::Min(static_cast<int>(fx), size-1);
+        fractions[i] = fx-columns[i];
+    }
+
+    for (int j = 0; j < countZ; j++)
+    {
+        float fz = Math::Clamp((z0+j*stepZ+dim)/m_brickSize, 0.0f, static_cast<float>(size));
+        int row = Math::Min(static_cast<int>(fz), size-1);
+        fz -= row;
+
+        const float* row0 = &m_relief[row*(size+1)];
+        const float* row1 = row0+size+1;
+        float* out = result+j*countX;
+        for (int i = 0; i < countX; i++)
+        {
+            int x = columns[i];
+            float a = row0[x]+(row0[x+1]-row0[x])*fractions[i];
+            float b = row1[x]+(row1[x+1]-row1[x])*fractions[i];
+            out[i] = a+(b-a)*fz;
+        }
+    }
+}
+
+unsigned long long CTerrain::GetReliefHash()
+{
+    if (m_reliefHashRevision == m_reliefRevision)
+        return m_reliefHash;
+
+    // Over the relief and its dimensions
+    unsigned long long hash = HashUtils::FNV1A_OFFSET_BASIS;
+    hash = HashUtils::AddFNV1a(hash, &m_mosaicCount, sizeof(m_mosaicCount));
+    hash = HashUtils::AddFNV1a(hash, &m_brickCount, sizeof(m_brickCount));
+    hash = HashUtils::AddFNV1a(hash, &m_brickSize, sizeof(m_brickSize));
+    if (!m_relief.empty())
+        hash = HashUtils::AddFNV1a(hash, &m_relief[0], m_relief.size()*sizeof(float));
+
+    m_reliefHash = hash;
+    m_reliefHashRevision = m_reliefRevision;
+    return hash;
+}
+
 float CTerrain::GetFloorLevel(const Math::Vector &pos, bool brut, bool water)
 {
     float dim = (m_mosaicCount*m_brickCount*m_brickSize)/2.0f;
@@ -1620,6 +1976,7 @@ bool CTerrain::AdjustToBounds(Math::Vector& pos, float margin)
 void CTerrain::FlushBuildingLevel()
 {
     m_buildingLevels.clear();
+    m_buildingLevelIndex.dirty = true;
 }
 
 bool CTerrain::AddBuildingLevel(Math::Vector center, float min, float max,
@@ -1636,7 +1993,15 @@ bool CTerrain::AddBuildingLevel(Math::Vector center, float min, float max,
     }
 
     if (i == static_cast<int>( m_buildingLevels.size() ))
+    {
         m_buildingLevels.push_back(BuildingLevel());
+        if (! m_buildingLevelIndex.dirty)
+            AddToAreaIndex(m_buildingLevelIndex, i, center, max);
+    }
+    else
+    {
+        m_buildingLevelIndex.dirty = true;  // the radius may have changed
+    }
 
     m_buildingLevels[i].center   = center;
     m_buildingLevels[i].min      = min;
@@ -1678,6 +2043,7 @@ bool CTerrain::DeleteBuildingLevel(Math::Vector center)
                 m_buildingLevels[j-1] = m_buildingLevels[j];
 
             m_buildingLevels.pop_back();
+            m_buildingLevelIndex.dirty = true;
             return true;
         }
     }
@@ -1686,7 +2052,7 @@ bool CTerrain::DeleteBuildingLevel(Math::Vector center)
 
 float CTerrain::GetBuildingFactor(const Math::Vector &pos)
 {
-    for (int i = 0; i < static_cast<int>( m_buildingLevels.size() ); i++)
+    for (int i : GetBuildingLevelCandidates(pos))
     {
         if ( pos.x < m_buildingLevels[i].bboxMinX ||
              pos.x > m_buildingLevels[i].bboxMaxX ||
@@ -1703,7 +2069,7 @@ float CTerrain::GetBuildingFactor(const Math::Vector &pos)
 
 void CTerrain::AdjustBuildingLevel(Math::Vector &p)
 {
-    for (int i = 0; i < static_cast<int>( m_buildingLevels.size() ); i++)
+    for (int i : GetBuildingLevelCandidates(p))
     {
         if ( p.x < m_buildingLevels[i].bboxMinX ||
              p.x > m_buildingLevels[i].bboxMaxX ||
@@ -1737,6 +2103,62 @@ void CTerrain::AdjustBuildingLevel(Math::Vector &p)
     }
 }
 
+void CTerrain::ResetAreaIndex(AreaIndex& index)
+{
+    float dim = (m_mosaicCount*m_brickCount*m_brickSize)/2.0f;
+
+    index.size = static_cast<int>(ceilf(dim*2.0f/AREA_INDEX_CELL_SIZE));
+    if (index.size < 1) index.size = 1;
+    index.origin = -dim;
+    index.cells.assign(index.size*index.size, std::vector<int>());
+    index.dirty = false;
+}
+
+void CTerrain::AddToAreaIndex(AreaIndex& index, int entry, const Math::Vector& center, float radius)
+{
+    int minX = Math::Clamp(static_cast<int>(floorf((center.x-radius-index.origin)/AREA_INDEX_CELL_SIZE)), 0, index.size-1);
+    int minY = Math::Clamp(static_cast<int>(floorf((center.z-radius-index.origin)/AREA_INDEX_CELL_SIZE)), 0, index.size-1);
+    int maxX = Math::Clamp(static_cast<int>(floorf((center.x+radius-index.origin)/AREA_INDEX_CELL_SIZE)), 0, index.size-1);
+    int maxY = Math::Clamp(static_cast<int>(floorf((center.z+radius-index.origin)/AREA_INDEX_CELL_SIZE)), 0, index.size-1);
+
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            index.cells[x+y*index.size].push_back(entry);
+        }
+    }
+}
+
+const std::vector<int>& CTerrain::GetAreaIndexCell(const AreaIndex& index, const Math::Vector& pos)
+{
+    int x = Math::Clamp(static_cast<int>(floorf((pos.x-index.origin)/AREA_INDEX_CELL_SIZE)), 0, index.size-1);
+    int y = Math::Clamp(static_cast<int>(floorf((pos.z-index.origin)/AREA_INDEX_CELL_SIZE)), 0, index.size-1);
+    return index.cells[x+y*index.size];
+}
+
+const std::vector<int>& CTerrain::GetBuildingLevelCandidates(const Math::Vector& pos)
+{
+    if (m_buildingLevelIndex.dirty)
+    {
+        ResetAreaIndex(m_buildingLevelIndex);
+        for (int i = 0; i < static_cast<int>( m_buildingLevels.size() ); i++)
+            AddToAreaIndex(m_buildingLevelIndex, i, m_buildingLevels[i].center, m_buildingLevels[i].max);
+    }
+    return GetAreaIndexCell(m_buildingLevelIndex, pos);
+}
+
+const std::vector<int>& CTerrain::GetFlyingLimitCandidates(const Math::Vector& pos)
+{
+    if (m_flyingLimitIndex.dirty)
+    {
+        ResetAreaIndex(m_flyingLimitIndex);
+        for (int i = 0; i < static_cast<int>( m_flyingLimits.size() ); i++)
+            AddToAreaIndex(m_flyingLimitIndex, i, m_flyingLimits[i].center, m_flyingLimits[i].extRadius);
+    }
+    return GetAreaIndexCell(m_flyingLimitIndex, pos);
+}
+
 float CTerrain::GetHardness(const Math::Vector &pos)
 {
     float factor = GetBuildingFactor(pos);
@@ -1847,6 +2269,7 @@ void CTerrain::FlushFlyingLimit()
 {
     m_flyingMaxHeight = 280.0f;
     m_flyingLimits.clear();
+    m_flyingLimitIndex.dirty = true;
 }
 
 void CTerrain::AddFlyingLimit(Math::Vector center,
@@ -1859,6 +2282,7 @@ void CTerrain::AddFlyingLimit(Math::Vector center,
     fl.intRadius = intRadius;
     fl.maxHeight = maxHeight;
     m_flyingLimits.push_back(fl);
+    m_flyingLimitIndex.dirty = true;
 }
 
 float CTerrain::GetFlyingLimit(Math::Vector pos, bool noLimit)
@@ -1869,7 +2293,7 @@ float CTerrain::GetFlyingLimit(Math::Vector pos, bool noLimit)
     if (m_flyingLimits.empty())
         return m_flyingMaxHeight;
 
-    for (int i = 0; i < static_cast<int>( m_flyingLimits.size() ); i++)
+    for (int i : GetFlyingLimitCandidates(pos))
     {
         float dist = Math::DistanceProjected(pos, m_flyingLimits[i].center);
 
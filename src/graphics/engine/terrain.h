@@ -30,9 +30,14 @@
 #include "math/point.h"
 #include "math/vector.h"
 
+#include <deque>
+#include <map>
 #include <string>
 #include <vector>
 
+class CSystemUtils;
+struct SystemTimeStamp;
+
 
 // Graphics module namespace
 namespace Gfx
@@ -147,7 +152,7 @@ Gfx::IntColor ResourceToColor(TerrainRes res);
 class CTerrain
 {
 public:
-    CTerrain();
+    CTerrain(CSystemUtils* systemUtils);
     ~CTerrain();
 
     //! Generates a new flat terrain
@@ -179,9 +184,40 @@ public:
     //! Creates all objects of the terrain within the 3D engine
     bool        CreateObjects();
 
+    //@{
+    //! Management of terrain streaming
+    /**
+     * When enabled, CreateObjects() doesn't build the mosaics. They are built by
+     * UpdateChunks() when they come within view, at one resolution chosen
+     * by distance, and deleted when they get far out of view. Takes effect
+     * at the next CreateObjects().
+     */
+    void        SetStreaming(bool streaming);
+    bool        GetStreaming();
+    //@}
+    //! Builds, changes resolution of, or deletes the mosaics around the camera, if streaming is active
+    void        UpdateChunks(const Math::Vector& eye);
+    /**
+     * \brief Returns statistics of terrain streaming
+     * \param built number of mosaics built, out of \a total
+     * \param memory size of the vertices of built mosaics (in bytes)
+     * \param buildTime total time spent building mosaics (in ns)
+     * \return false if streaming is not active
+     */
+    bool        GetChunkStats(int& built, int& total, long long& memory, long long& buildTime);
+
     //! Modifies the terrain's relief
     bool        Terraform(const Math::Vector& p1, const Math::Vector& p2, float height);
 
+    //! Returns the relief revision, incremented on every change of the relief
+    int         GetReliefRevision();
+    //! Returns the area (XZ bounding box) of the relief modified since the given revision
+    /**
+     * Returns false if the changes are not known, e.g. because the relief was reloaded
+     * in the meantime. Caches depending on the relief should then be fully rebuilt.
+     */
+    bool        GetReliefChanges(int revision, Math::Vector& min, Math::Vector& max);
+
     //@{
     //! Management of the wind
     void         SetWind(Math::Vector speed);
@@ -194,6 +230,16 @@ public:
     float       GetCoarseSlope(const Math::Vector& pos);
     //! Gives the normal vector at 2D (XZ) position
     bool        GetNormal(Math::Vector& n, const Math::Vector &p);
+    /**
+     * \brief Samples the relief on a regular grid, with bilinear interpolation
+     *
+     * Gives the same levels as GetFloorLevel() with brut=true, up to the interpolation.
+     * Positions outside the terrain are clamped to its border.
+     * \param result receives countX*countZ levels, row by row
+     */
+    void        SampleRelief(float x0, float z0, float stepX, float stepZ, int countX, int countZ, float* result);
+    //! Returns a hash of the relief, for caches stored on disk
+    unsigned long long GetReliefHash();
     //! Returns the height of the ground level at 2D (XZ) position
     float       GetFloorLevel(const Math::Vector& pos, bool brut=false, bool water=false);
     //! Returns the distance to the ground level from 3D position
@@ -251,14 +297,25 @@ protected:
     bool        AddReliefPoint(Math::Vector pos, float scaleRelief);
     //! Adjust the edges of each mosaic to be compatible with all lower resolutions
     void        AdjustRelief();
+    //! Adjust the edges of the mosaics, only around the given rectangle of relief points
+    void        AdjustRelief(int minX, int minY, int maxX, int maxY);
     //! Calculates a vector of the terrain
     Math::Vector GetVector(int x, int y);
     //! Calculates a vertex of the terrain
     VertexTex2  GetVertex(int x, int y, int step);
-    //! Creates all objects of a mosaic
-    bool        CreateMosaic(int ox, int oy, int step, int objRank, const Material& mat);
-    //! Creates all objects in a mesh square ground
-    bool        CreateSquare(int x, int y);
+    /**
+     * \brief Creates all objects of a mosaic
+     * \param updateTiers if not null, replaces the vertices of the existing objects instead,
+     *        counting the tiers already updated for each pair of textures
+     */
+    bool        CreateMosaic(int ox, int oy, int step, int objRank, const Material& mat,
+                             std::map<std::pair<std::string, std::string>, int>* updateTiers = nullptr);
+    //! Creates all objects in a mesh square ground, at all resolutions or only at the given one
+    bool        CreateSquare(int x, int y, int lod = -1);
+    //! Updates the vertices of a mesh square ground after a change of the relief
+    bool        UpdateSquare(int x, int y);
+    //! Deletes the objects of a mesh square ground
+    void        DeleteSquare(int x, int y);
 
     struct TerrainMaterial;
     //! Seeks a material based on its ID
@@ -285,6 +342,23 @@ protected:
     //! Adjusts a position according to a possible rise
     void        AdjustBuildingLevel(Math::Vector &p);
 
+    struct AreaIndex;
+    //! Clears the index, sizing it to the current terrain
+    void        ResetAreaIndex(AreaIndex& index);
+    //! Adds the entry to the cells of the index covered by the circle
+    void        AddToAreaIndex(AreaIndex& index, int entry, const Math::Vector& center, float radius);
+    //! Returns the cell of the index containing the position
+    const std::vector<int>& GetAreaIndexCell(const AreaIndex& index, const Math::Vector& pos);
+    //! Returns the building levels which may cover the position
+    const std::vector<int>& GetBuildingLevelCandidates(const Math::Vector& pos);
+    //! Returns the flying limits which may cover the position
+    const std::vector<int>& GetFlyingLimitCandidates(const Math::Vector& pos);
+
+    //! Records a change of the whole relief, forgetting all recorded changes
+    void        ResetReliefChanges();
+    //! Records a change of the relief in given area
+    void        AddReliefChange(const Math::Vector& min, const Math::Vector& max);
+
 protected:
     CEngine*        m_engine;
     CWater*         m_water;
@@ -297,6 +371,22 @@ protected:
     std::vector<int> m_textures;
     //! Object ranks for mosaic objects
     std::vector<int> m_objRanks;
+    //! Resolution of mosaic objects (step is 1 << lod), -1 if all resolutions are built
+    std::vector<int> m_objLods;
+    //! Number of vertices of mosaic objects
+    std::vector<int> m_objVertexCounts;
+    //! Number of vertices added by the last CreateMosaic()
+    int             m_mosaicVertexCount = 0;
+
+    //! Streaming requested by the settings
+    bool            m_streaming = false;
+    //! Streaming used by the current terrain
+    bool            m_streamingActive = false;
+    //! Total time spent building streamed mosaics (in ns)
+    long long       m_chunkBuildTime = 0;
+    CSystemUtils*   m_systemUtils = nullptr;
+    SystemTimeStamp* m_chunkTimeStart = nullptr;
+    SystemTimeStamp* m_chunkTimeNow = nullptr;
 
     //! Number of mosaics (along one dimension)
     int             m_mosaicCount;
@@ -385,6 +475,27 @@ protected:
     };
     std::vector<BuildingLevel> m_buildingLevels;
 
+    /**
+     * \struct AreaIndex
+     * \brief Coarse grid over the terrain, listing the entries whose area covers each cell
+     *
+     * Entries are kept in ascending order in each cell, so the first entry
+     * matching a position is the same as when searching the whole list.
+     */
+    struct AreaIndex
+    {
+        //! Indexes of the entries touching each cell
+        std::vector<std::vector<int>> cells;
+        //! Number of cells along one side
+        int          size = 0;
+        //! World coordinate of the grid corner
+        float        origin = 0.0f;
+        //! The index must be rebuilt before the next query
+        bool         dirty = true;
+    };
+    //! Index of m_buildingLevels
+    AreaIndex       m_buildingLevelIndex;
+
     //! Wind speed
     Math::Vector    m_wind;
 
@@ -404,6 +515,28 @@ protected:
     };
     //! List of local flight limits
     std::vector<FlyingLimit> m_flyingLimits;
+    //! Index of m_flyingLimits
+    AreaIndex       m_flyingLimitIndex;
+
+    /**
+     * \struct ReliefChange
+     * \brief Area of the relief modified in given revision
+     */
+    struct ReliefChange
+    {
+        int          revision = 0;
+        Math::Vector min;
+        Math::Vector max;
+    };
+    //! Current relief revision
+    int             m_reliefRevision;
+    //! Hash of the relief and the revision for which it was computed
+    unsigned long long m_reliefHash = 0;
+    int             m_reliefHashRevision = -1;
+    //! Oldest revision from which the changes are known
+    int             m_reliefChangesStart;
+    //! Recent relief changes, oldest first
+    std::deque<ReliefChange> m_reliefChanges;
 };
 
 
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "graphics/model/model_cache.h"
+
+#include "common/logger.h"
+#include "common/stringutils.h"
+
+#include "common/resources/inputstream.h"
+#include "common/resources/outputstream.h"
+#include "common/resources/resourcemanager.h"
+
+#include "graphics/model/model_input.h"
+#include "graphics/model/model_io_exception.h"
+#include "graphics/model/model_output.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace Gfx
+{
+
+namespace
+{
+
+const std::string MODEL_CACHE_DIR = "cache/models";
+
+} // anonymous namespace
+
+CModel ModelCache::Load(const std::string& fileName, ModelFormat format)
+{
+    // Compiled file is named after the source, so it can be found and replaced when the source changes
+    std::string prefix = CResourceManager::CleanPath(fileName);
+    for (char& c : prefix)
+    {
+        if (c == '/')
+            c = '-';
+    }
+    prefix += "-";
+
+    long long modTime = CResourceManager::GetLastModificationTime(fileName);
+    std::string cacheName = prefix + StrUtils::Format("%016llx.cbm", modTime);
+    std::string cacheFile = MODEL_CACHE_DIR + "/" + cacheName;
+
+    if (modTime != -1 && CResourceManager::Exists(cacheFile))
+    {
+        try
+        {
+            return ReadMapped(CResourceManager::GetSaveLocation() + "/" + cacheFile);
+        }
+        catch (const CModelIOException& e)
+        {
+            GetLogger()->Warn("Ignoring model cache '%s': %s\n", cacheFile.c_str(), e.what());
+        }
+    }
+
+    CModel model;
+    {
+        CInputStream stream;
+        stream.open(fileName);
+        if (!stream.is_open())
+            throw CModelIOException(std::string("Could not open file '") + fileName + "'");
+
+        model = ModelInput::Read(stream, format);
+    }
+
+    if (modTime == -1)
+        return model;
+
+    // Replaces the file compiled from the previous version of the source
+    if (! CResourceManager::DirectoryExists(MODEL_CACHE_DIR))
+        CResourceManager::CreateDirectory(MODEL_CACHE_DIR);
+    for (const std::string& file : CResourceManager::ListFiles(MODEL_CACHE_DIR))
+    {
+        if (file.size() == cacheName.size() && file.compare(0, prefix.size(), prefix) == 0)
+            CResourceManager::Remove(MODEL_CACHE_DIR + "/" + file);
+    }
+
+    try
+    {
+        COutputStream stream;
+        stream.open(cacheFile);
+        if (!stream.is_open())
+            throw CModelIOException(std::string("Could not open file '") + cacheFile + "'");
+
+        ModelOutput::Write(model, stream, ModelFormat::Cache);
+    }
+    catch (const CModelIOException& e)
+    {
+        GetLogger()->Warn("Could not save model cache '%s': %s\n", cacheFile.c_str(), e.what());
+        CResourceManager::Remove(cacheFile);
+    }
+
+    return model;
+}
+
+CModel ModelCache::ReadMapped(const std::string& path)
+{
+    try
+    {
+        boost::interprocess::file_mapping file(path.c_str(), boost::interprocess::read_only);
+        boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+
+        return ModelInput::ReadCache(static_cast<const char*>(region.get_address()), region.get_size());
+    }
+    catch (const boost::interprocess::interprocess_exception& e)
+    {
+        throw CModelIOException(std::string("Could not map file '") + path + "': " + e.what());
+    }
+}
+
+} // namespace Gfx
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#pragma once
+
+#include "graphics/model/model.h"
+#include "graphics/model/model_format.h"
+
+#include <string>
+
+namespace Gfx
+{
+
+/**
+ * \namespace ModelCache
+ * \brief Namespace with functions to read models through the model cache
+ *
+ * Models read with Load() are compiled to ModelFormat::Cache and saved in
+ * the save directory, named after the source path and its modification time.
+ * The next time the same source is requested, the compiled file is memory-mapped
+ * instead of parsing the source again.
+ */
+namespace ModelCache
+{
+    //! Reads model from file \a fileName in given source \a format, through the cache
+    /**
+     * @throws CModelIOException on read error
+     */
+    CModel Load(const std::string& fileName, ModelFormat format);
+
+    //! Reads model in ModelFormat::Cache by memory-mapping file at system path \a path
+    /**
+     * @throws CModelIOException on read error
+     */
+    CModel ReadMapped(const std::string& path);
+}
+
+} // namespace Gfx
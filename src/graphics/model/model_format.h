@@ -30,7 +30,8 @@ enum class ModelFormat
 {
     Text,   //!< new text format
     Binary, //!< new binary format
-    Old        //!< old binary format, deprecated
+    Old,       //!< old binary format, deprecated
+    Cache      //!< compiled binary format of the model cache
 };
 
 } // namespace Gfx
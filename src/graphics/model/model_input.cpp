@@ -29,6 +29,8 @@
 
 #include <fstream>
 #include <cstdio>
+#include <cstring>
+#include <iterator>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -50,6 +52,16 @@ namespace ModelInput
     void ReadBinaryModelV1AndV2(CModel &model, std::istream &stream);
     void ReadBinaryModelV3(CModel &model, std::istream &stream);
 
+    void ReadCacheModel(CModel &model, std::istream &stream);
+    CModelMesh ReadCacheMesh(const char* data, std::size_t size, std::size_t& offset, std::string& meshName);
+    int ReadCacheInt(const char* data, std::size_t size, std::size_t& offset);
+    float ReadCacheFloat(const char* data, std::size_t size, std::size_t& offset);
+    std::string ReadCacheString(const char* data, std::size_t size, std::size_t& offset);
+    Math::Vector ReadCacheVector(const char* data, std::size_t size, std::size_t& offset);
+    Color ReadCacheColor(const char* data, std::size_t size, std::size_t& offset);
+    VertexTex2 ReadCacheVertexTex2(const char* data, std::size_t size, std::size_t& offset);
+    bool IsLittleEndian();
+
     void ReadOldModel(CModel &model, std::istream &stream);
     std::vector<ModelTriangle> ReadOldModelV1(std::istream &stream, int totalTriangles);
     std::vector<ModelTriangle> ReadOldModelV2(std::istream &stream, int totalTriangles);
@@ -98,6 +110,10 @@ CModel ModelInput::Read(std::istream &stream, ModelFormat format)
             case ModelFormat::Old:
                 ReadOldModel(model, stream);
                 break;
+
+            case ModelFormat::Cache:
+                ReadCacheModel(model, stream);
+                break;
         }
     }
     catch (const CModelIOException& e)
@@ -112,6 +128,203 @@ CModel ModelInput::Read(std::istream &stream, ModelFormat format)
     return model;
 }
 
+CModel ModelInput::ReadCache(const char* data, std::size_t size)
+{
+    std::size_t offset = 0;
+
+    if (size < sizeof(MODEL_CACHE_MAGIC) || std::memcmp(data, MODEL_CACHE_MAGIC, sizeof(MODEL_CACHE_MAGIC)) != 0)
+        throw CModelIOException("Not a model cache file");
+    offset += sizeof(MODEL_CACHE_MAGIC);
+
+    ModelCacheHeader header;
+    header.version = ReadCacheInt(data, size, offset);
+    if (header.version != MODEL_CACHE_VERSION)
+        throw CModelIOException(std::string("Unexpected version number: ") + boost::lexical_cast<std::string>(header.version));
+
+    header.totalCrashSpheres = ReadCacheInt(data, size, offset);
+    header.hasShadowSpot = ReadCacheInt(data, size, offset) != 0;
+    header.hasCameraCollisionSphere = ReadCacheInt(data, size, offset) != 0;
+    header.totalMeshes = ReadCacheInt(data, size, offset);
+
+    CModel model;
+
+    for (int i = 0; i < header.totalCrashSpheres; ++i)
+    {
+        ModelCrashSphere crashSphere;
+        crashSphere.position = ReadCacheVector(data, size, offset);
+        crashSphere.radius = ReadCacheFloat(data, size, offset);
+        crashSphere.sound = ReadCacheString(data, size, offset);
+        crashSphere.hardness = ReadCacheFloat(data, size, offset);
+        model.AddCrashSphere(crashSphere);
+    }
+
+    if (header.hasShadowSpot)
+    {
+        ModelShadowSpot shadowSpot;
+        shadowSpot.radius = ReadCacheFloat(data, size, offset);
+        shadowSpot.intensity = ReadCacheFloat(data, size, offset);
+        model.SetShadowSpot(shadowSpot);
+    }
+
+    if (header.hasCameraCollisionSphere)
+    {
+        Math::Sphere sphere;
+        sphere.pos = ReadCacheVector(data, size, offset);
+        sphere.radius = ReadCacheFloat(data, size, offset);
+        model.SetCameraCollisionSphere(sphere);
+    }
+
+    for (int i = 0; i < header.totalMeshes; ++i)
+    {
+        std::string meshName;
+        CModelMesh mesh = ReadCacheMesh(data, size, offset, meshName);
+        model.AddMesh(meshName, std::move(mesh));
+    }
+
+    return model;
+}
+
+void ModelInput::ReadCacheModel(CModel &model, std::istream &stream)
+{
+    std::vector<char> data{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+
+    model = ReadCache(data.data(), data.size());
+}
+
+CModelMesh ModelInput::ReadCacheMesh(const char* data, std::size_t size, std::size_t& offset, std::string& meshName)
+{
+    CModelMesh mesh;
+
+    meshName = ReadCacheString(data, size, offset);
+    mesh.SetPosition(ReadCacheVector(data, size, offset));
+    mesh.SetRotation(ReadCacheVector(data, size, offset));
+    mesh.SetScale(ReadCacheVector(data, size, offset));
+    mesh.SetParent(ReadCacheString(data, size, offset));
+
+    std::vector<ModelTriangle> triangles;
+
+    int totalGroups = ReadCacheInt(data, size, offset);
+    for (int group = 0; group < totalGroups; ++group)
+    {
+        ModelTriangle triangle;
+        triangle.tex1Name = ReadCacheString(data, size, offset);
+        triangle.tex2Name = ReadCacheString(data, size, offset);
+        triangle.diffuse = ReadCacheColor(data, size, offset);
+        triangle.ambient = ReadCacheColor(data, size, offset);
+        triangle.specular = ReadCacheColor(data, size, offset);
+        triangle.variableTex2 = ReadCacheInt(data, size, offset) != 0;
+        triangle.doubleSided = ReadCacheInt(data, size, offset) != 0;
+        triangle.transparentMode = static_cast<ModelTransparentMode>(ReadCacheInt(data, size, offset));
+        triangle.specialMark = static_cast<ModelSpecialMark>(ReadCacheInt(data, size, offset));
+
+        int totalVertices = ReadCacheInt(data, size, offset);
+        if (totalVertices < 0 || totalVertices % 3 != 0 ||
+            static_cast<std::size_t>(totalVertices) * 10 * 4 > size - offset)
+            throw CModelIOException("Invalid vertex count in model cache");
+
+        triangles.reserve(triangles.size() + totalVertices / 3);
+
+        // The vertex array has the in-memory layout of VertexTex2 on little-endian machines
+        bool copyInPlace = IsLittleEndian() && sizeof(VertexTex2) == 10 * sizeof(float);
+
+        for (int i = 0; i < totalVertices / 3; ++i)
+        {
+            if (copyInPlace)
+            {
+                std::memcpy(&triangle.p1, data + offset,                          sizeof(VertexTex2));
+                std::memcpy(&triangle.p2, data + offset +     sizeof(VertexTex2), sizeof(VertexTex2));
+                std::memcpy(&triangle.p3, data + offset + 2 * sizeof(VertexTex2), sizeof(VertexTex2));
+                offset += 3 * sizeof(VertexTex2);
+            }
+            else
+            {
+                triangle.p1 = ReadCacheVertexTex2(data, size, offset);
+                triangle.p2 = ReadCacheVertexTex2(data, size, offset);
+                triangle.p3 = ReadCacheVertexTex2(data, size, offset);
+            }
+
+            triangles.push_back(triangle);
+        }
+    }
+
+    mesh.SetTriangles(std::move(triangles));
+
+    return mesh;
+}
+
+int ModelInput::ReadCacheInt(const char* data, std::size_t size, std::size_t& offset)
+{
+    if (size - offset < 4)
+        throw CModelIOException("Unexpected end of model cache");
+
+    unsigned int value = 0;
+    for (int i = 0; i < 4; ++i)
+        value |= static_cast<unsigned int>(static_cast<unsigned char>(data[offset + i])) << (i*8);
+
+    offset += 4;
+    return static_cast<int>(value);
+}
+
+float ModelInput::ReadCacheFloat(const char* data, std::size_t size, std::size_t& offset)
+{
+    unsigned int bits = static_cast<unsigned int>(ReadCacheInt(data, size, offset));
+
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+std::string ModelInput::ReadCacheString(const char* data, std::size_t size, std::size_t& offset)
+{
+    int length = ReadCacheInt(data, size, offset);
+    std::size_t paddedLength = (static_cast<std::size_t>(length) + 3) / 4 * 4;
+    if (length < 0 || paddedLength > size - offset)
+        throw CModelIOException("Invalid string length in model cache");
+
+    std::string value(data + offset, length);
+    offset += paddedLength;
+    return value;
+}
+
+Math::Vector ModelInput::ReadCacheVector(const char* data, std::size_t size, std::size_t& offset)
+{
+    Math::Vector vector;
+    vector.x = ReadCacheFloat(data, size, offset);
+    vector.y = ReadCacheFloat(data, size, offset);
+    vector.z = ReadCacheFloat(data, size, offset);
+    return vector;
+}
+
+Color ModelInput::ReadCacheColor(const char* data, std::size_t size, std::size_t& offset)
+{
+    Color color;
+    color.r = ReadCacheFloat(data, size, offset);
+    color.g = ReadCacheFloat(data, size, offset);
+    color.b = ReadCacheFloat(data, size, offset);
+    color.a = ReadCacheFloat(data, size, offset);
+    return color;
+}
+
+VertexTex2 ModelInput::ReadCacheVertexTex2(const char* data, std::size_t size, std::size_t& offset)
+{
+    VertexTex2 vertex;
+    vertex.coord = ReadCacheVector(data, size, offset);
+    vertex.normal = ReadCacheVector(data, size, offset);
+    vertex.texCoord.x = ReadCacheFloat(data, size, offset);
+    vertex.texCoord.y = ReadCacheFloat(data, size, offset);
+    vertex.texCoord2.x = ReadCacheFloat(data, size, offset);
+    vertex.texCoord2.y = ReadCacheFloat(data, size, offset);
+    return vertex;
+}
+
+bool ModelInput::IsLittleEndian()
+{
+    unsigned int one = 1;
+    unsigned char firstByte = 0;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
 void ModelInput::ReadBinaryModel(CModel &model, std::istream &stream)
 {
     int version = 0;
@@ -22,6 +22,7 @@
 #include "graphics/model/model.h"
 #include "graphics/model/model_format.h"
 
+#include <cstddef>
 #include <istream>
 
 namespace Gfx
@@ -38,6 +39,12 @@ namespace ModelInput
      * @throws CModelIOException on read/write error
      */
     CModel Read(std::istream &stream, ModelFormat format);
+
+    //! Reads model in ModelFormat::Cache from \a size bytes of memory at \a data
+    /**
+     * @throws CModelIOException on read error
+     */
+    CModel ReadCache(const char* data, std::size_t size);
 }
 
 } // namespace Gfx
@@ -150,6 +150,41 @@ struct ModelMeshHeaderV3
 struct ModelTriangleV3 : ModelTriangle {};
 
 
+/*******************************************************
+                    Model cache format
+ *******************************************************/
+
+//! Magic bytes at the start of model cache file
+const char MODEL_CACHE_MAGIC[4] = { 'C', 'B', 'M', 'C' };
+//! Current version of model cache file
+const int MODEL_CACHE_VERSION = 1;
+
+/**
+ * \struct ModelCacheHeader
+ * \brief Header for model cache file
+ *
+ * All values in the file are little-endian 32-bit words and strings are
+ * padded to 4 bytes, so the vertex arrays are aligned and can be copied
+ * from a memory-mapped file as they are.
+ *
+ * Each mesh stores its triangles as groups of consecutive triangles
+ * with the same textures, colors and flags, followed by one vertex array.
+ */
+struct ModelCacheHeader
+{
+    //! File version
+    int version = 0;
+    //! Total number of crash spheres
+    int totalCrashSpheres = 0;
+    //! Whether model has shadow spot
+    bool hasShadowSpot = false;
+    //! Whether model has camera collision sphere
+    bool hasCameraCollisionSphere = false;
+    //! Total number of meshes
+    int totalMeshes = 0;
+};
+
+
 
 /*******************************************************
                       Deprecated formats
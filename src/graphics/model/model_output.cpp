@@ -47,6 +47,13 @@ namespace ModelOutput
 
     void WriteOldModel(const CModel& model, std::ostream &stream);
 
+    void WriteCacheModel(const CModel& model, std::ostream &stream);
+    void WriteCacheMesh(const CModelMesh* mesh, const std::string& meshName, std::ostream &stream);
+    bool IsSameCacheGroup(const ModelTriangle& a, const ModelTriangle& b);
+    void WriteCacheString(const std::string& value, std::ostream &stream);
+    void WriteCacheVector(const Math::Vector& vector, std::ostream &stream);
+    void WriteCacheColor(const Color& color, std::ostream &stream);
+
     int ConvertToOldState(const ModelTriangle& triangle);
 
     void WriteBinaryVertexTex2(VertexTex2 vertex, std::ostream &stream);
@@ -77,6 +84,10 @@ void ModelOutput::Write(const CModel& model, std::ostream &stream, ModelFormat f
             case ModelFormat::Old:
                 WriteOldModel(model, stream);
                 break;
+
+            case ModelFormat::Cache:
+                WriteCacheModel(model, stream);
+                break;
         }
     }
     catch (const CModelIOException& e)
@@ -410,6 +421,132 @@ int ModelOutput::ConvertToOldState(const ModelTriangle& triangle)
     return state;
 }
 
+void ModelOutput::WriteCacheModel(const CModel& model, std::ostream &stream)
+{
+    ModelCacheHeader header;
+    header.version = MODEL_CACHE_VERSION;
+    header.totalCrashSpheres = model.GetCrashSphereCount();
+    header.hasShadowSpot = model.HasShadowSpot();
+    header.hasCameraCollisionSphere = model.HasCameraCollisionSphere();
+    header.totalMeshes = model.GetMeshCount();
+
+    stream.write(MODEL_CACHE_MAGIC, sizeof(MODEL_CACHE_MAGIC));
+    WriteBinary<4, int>(header.version, stream);
+    WriteBinary<4, int>(header.totalCrashSpheres, stream);
+    WriteBinary<4, int>(header.hasShadowSpot ? 1 : 0, stream);
+    WriteBinary<4, int>(header.hasCameraCollisionSphere ? 1 : 0, stream);
+    WriteBinary<4, int>(header.totalMeshes, stream);
+
+    for (const auto& crashSphere : model.GetCrashSpheres())
+    {
+        WriteCacheVector(crashSphere.position, stream);
+        WriteBinaryFloat(crashSphere.radius, stream);
+        WriteCacheString(crashSphere.sound, stream);
+        WriteBinaryFloat(crashSphere.hardness, stream);
+    }
+
+    if (model.HasShadowSpot())
+    {
+        WriteBinaryFloat(model.GetShadowSpot().radius, stream);
+        WriteBinaryFloat(model.GetShadowSpot().intensity, stream);
+    }
+
+    if (model.HasCameraCollisionSphere())
+    {
+        WriteCacheVector(model.GetCameraCollisionSphere().pos, stream);
+        WriteBinaryFloat(model.GetCameraCollisionSphere().radius, stream);
+    }
+
+    for (const std::string& meshName : model.GetMeshNames())
+    {
+        const CModelMesh* mesh = model.GetMesh(meshName);
+        assert(mesh != nullptr);
+        WriteCacheMesh(mesh, meshName, stream);
+    }
+}
+
+void ModelOutput::WriteCacheMesh(const CModelMesh* mesh, const std::string& meshName, std::ostream &stream)
+{
+    WriteCacheString(meshName, stream);
+    WriteCacheVector(mesh->GetPosition(), stream);
+    WriteCacheVector(mesh->GetRotation(), stream);
+    WriteCacheVector(mesh->GetScale(), stream);
+    WriteCacheString(mesh->GetParent(), stream);
+
+    const std::vector<ModelTriangle>& triangles = mesh->GetTriangles();
+
+    // Runs of triangles with the same attributes share one vertex array
+    std::vector<int> groupStarts;
+    for (int i = 0; i < static_cast<int>( triangles.size() ); ++i)
+    {
+        if (i == 0 || !IsSameCacheGroup(triangles[i - 1], triangles[i]))
+            groupStarts.push_back(i);
+    }
+    groupStarts.push_back(triangles.size());
+
+    WriteBinary<4, int>(groupStarts.size() - 1, stream);
+
+    for (int group = 0; group < static_cast<int>( groupStarts.size() ) - 1; ++group)
+    {
+        const ModelTriangle& first = triangles[groupStarts[group]];
+
+        WriteCacheString(first.tex1Name, stream);
+        WriteCacheString(first.tex2Name, stream);
+        WriteCacheColor(first.diffuse, stream);
+        WriteCacheColor(first.ambient, stream);
+        WriteCacheColor(first.specular, stream);
+        WriteBinary<4, int>(first.variableTex2 ? 1 : 0, stream);
+        WriteBinary<4, int>(first.doubleSided ? 1 : 0, stream);
+        WriteBinary<4, int>(static_cast<int>(first.transparentMode), stream);
+        WriteBinary<4, int>(static_cast<int>(first.specialMark), stream);
+
+        WriteBinary<4, int>(3 * (groupStarts[group + 1] - groupStarts[group]), stream);
+        for (int i = groupStarts[group]; i < groupStarts[group + 1]; ++i)
+        {
+            WriteBinaryVertexTex2(triangles[i].p1, stream);
+            WriteBinaryVertexTex2(triangles[i].p2, stream);
+            WriteBinaryVertexTex2(triangles[i].p3, stream);
+        }
+    }
+}
+
+bool ModelOutput::IsSameCacheGroup(const ModelTriangle& a, const ModelTriangle& b)
+{
+    return a.tex1Name == b.tex1Name &&
+           a.tex2Name == b.tex2Name &&
+           a.diffuse == b.diffuse &&
+           a.ambient == b.ambient &&
+           a.specular == b.specular &&
+           a.variableTex2 == b.variableTex2 &&
+           a.doubleSided == b.doubleSided &&
+           a.transparentMode == b.transparentMode &&
+           a.specialMark == b.specialMark;
+}
+
+void ModelOutput::WriteCacheString(const std::string& value, std::ostream &stream)
+{
+    WriteBinaryString<4>(value, stream);
+
+    // Keeps the following data aligned to 4 bytes
+    for (int i = value.size(); i % 4 != 0; ++i)
+        stream.put('\0');
+}
+
+void ModelOutput::WriteCacheVector(const Math::Vector& vector, std::ostream &stream)
+{
+    WriteBinaryFloat(vector.x, stream);
+    WriteBinaryFloat(vector.y, stream);
+    WriteBinaryFloat(vector.z, stream);
+}
+
+void ModelOutput::WriteCacheColor(const Color& color, std::ostream &stream)
+{
+    WriteBinaryFloat(color.r, stream);
+    WriteBinaryFloat(color.g, stream);
+    WriteBinaryFloat(color.b, stream);
+    WriteBinaryFloat(color.a, stream);
+}
+
 void ModelOutput::WriteBinaryVertexTex2(VertexTex2 vertex, std::ostream &stream)
 {
     WriteBinaryFloat(vertex.coord.x, stream);
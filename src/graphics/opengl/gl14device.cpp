@@ -1897,6 +1897,16 @@ void CGL14Device::DrawStaticBuffer(unsigned int bufferId)
     }
 }
 
+void CGL14Device::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    // No instanced arrays in this profile, so draw each instance separately
+    for (int i = 0; i < instanceCount; i++)
+    {
+        SetTransform(TRANSFORM_WORLD, transforms[i]);
+        DrawStaticBuffer(bufferId);
+    }
+}
+
 void CGL14Device::DestroyStaticBuffer(unsigned int bufferId)
 {
     if (m_vertexBufferType != VBT_DISPLAY_LIST)
@@ -1653,6 +1653,16 @@ void CGL21Device::DrawStaticBuffer(unsigned int bufferId)
     }
 }
 
+void CGL21Device::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    // No instanced arrays in this profile, so draw each instance separately
+    for (int i = 0; i < instanceCount; i++)
+    {
+        SetTransform(TRANSFORM_WORLD, transforms[i]);
+        DrawStaticBuffer(bufferId);
+    }
+}
+
 void CGL21Device::DestroyStaticBuffer(unsigned int bufferId)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -39,6 +39,7 @@
 #include <physfs.h>
 
 #include <cassert>
+#include <cstddef>
 
 
 // Graphics module namespace
@@ -363,6 +364,7 @@ bool CGL33Device::Create()
         uni.modelMatrix = glGetUniformLocation(m_normalProgram, "uni_ModelMatrix");
         uni.normalMatrix = glGetUniformLocation(m_normalProgram, "uni_NormalMatrix");
         uni.shadowMatrix = glGetUniformLocation(m_normalProgram, "uni_ShadowMatrix");
+        uni.instanced = glGetUniformLocation(m_normalProgram, "uni_Instanced");
 
         uni.primaryTexture = glGetUniformLocation(m_normalProgram, "uni_PrimaryTexture");
         uni.secondaryTexture = glGetUniformLocation(m_normalProgram, "uni_SecondaryTexture");
@@ -420,6 +422,7 @@ bool CGL33Device::Create()
         glUniformMatrix4fv(uni.modelMatrix, 1, GL_FALSE, matrix.Array());
         glUniformMatrix4fv(uni.normalMatrix, 1, GL_FALSE, matrix.Array());
         glUniformMatrix4fv(uni.shadowMatrix, 1, GL_FALSE, matrix.Array());
+        glUniform1i(uni.instanced, 0);
 
         glUniform1i(uni.primaryTexture, 0);
         glUniform1i(uni.secondaryTexture, 1);
@@ -483,6 +486,7 @@ bool CGL33Device::Create()
         uni.projectionMatrix = glGetUniformLocation(m_shadowProgram, "uni_ProjectionMatrix");
         uni.viewMatrix = glGetUniformLocation(m_shadowProgram, "uni_ViewMatrix");
         uni.modelMatrix = glGetUniformLocation(m_shadowProgram, "uni_ModelMatrix");
+        uni.instanced = glGetUniformLocation(m_shadowProgram, "uni_Instanced");
 
         uni.primaryTexture = glGetUniformLocation(m_shadowProgram, "uni_Texture");
 
@@ -507,6 +511,8 @@ bool CGL33Device::Create()
 
         glUniform1i(uni.alphaTestEnabled, 0);
         glUniform1f(uni.alphaReference, 1.0f);
+
+        glUniform1i(uni.instanced, 0);
     }
 
     SetRenderMode(RENDER_MODE_NORMAL);
@@ -533,6 +539,10 @@ bool CGL33Device::Create()
 
     m_vboMemory += m_dynamicBuffer.size;
 
+    // create instance buffer, allocated on first use
+    glGenBuffers(1, &m_instanceBuffer);
+    m_instanceBufferSize = 0;
+
     GetLogger()->Info("CDevice created successfully\n");
 
     return true;
@@ -562,6 +572,12 @@ void CGL33Device::Destroy()
 
     m_vboMemory -= m_dynamicBuffer.size;
 
+    // delete instance buffer
+    glDeleteBuffers(1, &m_instanceBuffer);
+
+    m_vboMemory -= m_instanceBufferSize;
+    m_instanceBufferSize = 0;
+
     m_lights.clear();
     m_lightsEnabled.clear();
 
@@ -1687,6 +1703,90 @@ void CGL33Device::DrawStaticBuffer(unsigned int bufferId)
     glDrawArrays(mode, 0, info.vertexCount);
 }
 
+void CGL33Device::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    static_assert(sizeof(InstanceData) == 25 * sizeof(float), "InstanceData must be tightly packed floats");
+
+    if (instanceCount <= 0) return;
+
+    if (m_updateLights) UpdateLights();
+
+    auto it = m_vboObjects.find(bufferId);
+    if (it == m_vboObjects.end())
+        return;
+
+    VertexBufferInfo &info = (*it).second;
+
+    // Normal matrices are computed here once per instance, like SetTransform() does,
+    // instead of inverting the world matrix for every vertex in the shader
+    m_instanceData.resize(instanceCount);
+
+    for (int i = 0; i < instanceCount; i++)
+    {
+        InstanceData& instance = m_instanceData[i];
+        instance.world = transforms[i];
+
+        Math::Matrix inverse = transforms[i];
+
+        if (fabs(inverse.Det()) > 1e-6)
+            inverse = inverse.Inverse();
+
+        // Transpose of the upper 3x3 part of the inverse
+        for (int column = 0; column < 3; column++)
+        {
+            for (int row = 0; row < 3; row++)
+                instance.normal[column * 3 + row] = inverse.m[row * 4 + column];
+        }
+    }
+
+    unsigned int size = instanceCount * sizeof(InstanceData);
+
+    BindVBO(m_instanceBuffer);
+
+    if (m_instanceBufferSize < size)
+    {
+        m_vboMemory -= m_instanceBufferSize;
+        m_instanceBufferSize = size;
+        m_vboMemory += m_instanceBufferSize;
+    }
+
+    // Orphan the previous contents so the driver does not wait for the last draw
+    glBufferData(GL_ARRAY_BUFFER, m_instanceBufferSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, m_instanceData.data());
+
+    BindVAO(info.vao);
+
+    if (!info.instanced)
+    {
+        // World matrix, one column per attribute
+        for (int column = 0; column < 4; column++)
+        {
+            glEnableVertexAttribArray(5 + column);
+            glVertexAttribPointer(5 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                  reinterpret_cast<void*>(offsetof(InstanceData, world) + column * 4 * sizeof(float)));
+            glVertexAttribDivisor(5 + column, 1);
+        }
+
+        // Normal matrix, one column per attribute
+        for (int column = 0; column < 3; column++)
+        {
+            glEnableVertexAttribArray(9 + column);
+            glVertexAttribPointer(9 + column, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                  reinterpret_cast<void*>(offsetof(InstanceData, normal) + column * 3 * sizeof(float)));
+            glVertexAttribDivisor(9 + column, 1);
+        }
+
+        info.instanced = true;
+    }
+
+    glUniform1i(m_uni->instanced, 1);
+
+    GLenum mode = TranslateGfxPrimitive(info.primitiveType);
+    glDrawArraysInstanced(mode, 0, info.vertexCount, instanceCount);
+
+    glUniform1i(m_uni->instanced, 0);
+}
+
 void CGL33Device::DestroyStaticBuffer(unsigned int bufferId)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -142,6 +142,7 @@ public:
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
@@ -273,6 +274,17 @@ private:
         VertexType vertexType = {};
         int vertexCount = 0;
         unsigned int size = 0;
+        //! true if the VAO reads instance matrices from m_instanceBuffer
+        bool instanced = false;
+    };
+
+    //! Per-instance data read by the vertex shader in instanced draws
+    struct InstanceData
+    {
+        //! World matrix, vertex attributes 5-8
+        Math::Matrix world;
+        //! Normal matrix in column-major order, vertex attributes 9-11
+        float normal[9];
     };
 
     //! Detected capabilities
@@ -288,6 +300,13 @@ private:
     //! Total memory allocated in VBOs
     unsigned long m_vboMemory = 0;
 
+    //! Per-instance data for DrawStaticBufferInstanced()
+    GLuint m_instanceBuffer = 0;
+    //! Size of m_instanceBuffer in bytes
+    unsigned int m_instanceBufferSize = 0;
+    //! Staging copy of the instance data uploaded to m_instanceBuffer
+    std::vector<InstanceData> m_instanceData;
+
     //! Map of framebuffers
     std::map<std::string, std::unique_ptr<CFramebuffer>> m_framebuffers;
 
@@ -41,7 +41,7 @@ namespace Gfx
 GLuint textureCoordinates[] = { GL_S, GL_T, GL_R, GL_Q };
 GLuint textureCoordGen[] = { GL_TEXTURE_GEN_S, GL_TEXTURE_GEN_T, GL_TEXTURE_GEN_R, GL_TEXTURE_GEN_Q };
 
-bool InitializeGLEW()
+bool InitializeGLEW(bool offscreen)
 {
     static bool glewInited = false;
 
@@ -49,7 +49,15 @@ bool InitializeGLEW()
     {
         glewExperimental = GL_TRUE;
 
-        if (glewInit() != GLEW_OK)
+        GLenum result = glewInit();
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+        // The OpenGL functions are loaded before GLEW checks for the GLX display
+        if (offscreen && result == GLEW_ERROR_NO_GLX_DISPLAY)
+            result = GLEW_OK;
+#endif
+
+        if (result != GLEW_OK)
         {
             GetLogger()->Error("GLEW initialization failed\n");
             return false;
@@ -48,7 +48,12 @@ enum FramebufferSupport
     FBS_ARB,
 };
 
-bool InitializeGLEW();
+//! Initializes GLEW, once
+/**
+ * \param offscreen accept contexts made without a GLX display,
+ *                  like the offscreen EGL contexts of the unit tests
+ */
+bool InitializeGLEW(bool offscreen = false);
 
 FramebufferSupport DetectFramebufferSupport();
 
@@ -167,6 +172,8 @@ struct UniformLocations
     GLint shadowMatrix = -1;
     //! Normal matrix
     GLint normalMatrix = -1;
+    //! true takes the model matrix from per-instance attributes
+    GLint instanced = -1;
 
     //! Primary texture sampler
     GLint primaryTexture = -1;
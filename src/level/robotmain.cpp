@@ -33,6 +33,10 @@
 #include "common/settings.h"
 #include "common/stringutils.h"
 
+#include "common/system/system.h"
+
+#include "common/thread/thread_pool.h"
+
 #include "common/resources/inputstream.h"
 #include "common/resources/outputstream.h"
 #include "common/resources/resourcemanager.h"
@@ -62,9 +66,14 @@
 #include "math/const.h"
 #include "math/geometry.h"
 
+#include "object/nav_grid.h"
 #include "object/object.h"
 #include "object/object_create_exception.h"
 #include "object/object_manager.h"
+#include "object/obstacle_field.h"
+#include "object/part_transform_pool.h"
+#include "object/path_cache.h"
+#include "object/world_query.h"
 
 #include "object/auto/auto.h"
 
@@ -113,6 +122,8 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <SDL_cpuinfo.h>
+
 
 // Global variables.
 
@@ -147,7 +158,7 @@ CRobotMain::CRobotMain()
     m_settings    = MakeUnique<CSettings>();
     m_pause       = MakeUnique<CPauseManager>();
     m_interface   = MakeUnique<Ui::CInterface>();
-    m_terrain     = MakeUnique<Gfx::CTerrain>();
+    m_terrain     = MakeUnique<Gfx::CTerrain>(m_app->GetSystemUtils());
     m_camera      = MakeUnique<Gfx::CCamera>();
     m_displayText = MakeUnique<Ui::CDisplayText>();
     m_movie       = MakeUnique<CMainMovie>();
@@ -240,6 +251,10 @@ CRobotMain::CRobotMain()
 
     m_shotSaving = 0;
 
+    int threads = Math::Clamp(SDL_GetCPUCount() - 1, 0, 4);
+    m_threadPool = MakeUnique<CThreadPool>(threads, "Worker thread");
+    GetLogger()->Debug("Using %d worker thread(s)\n", threads);
+
     m_build = 0;
     m_researchDone.clear();  // no research done
     m_researchDone[0] = 0;
@@ -433,7 +448,6 @@ void CRobotMain::ChangePhase(Phase phase)
         m_engine->SetRankView(0);
         m_terrain->FlushRelief();
         m_engine->DeleteAllObjects();
-        m_oldModelManager->DeleteAllModelCopies();
         m_engine->SetWaterAddColor(Gfx::Color(0.0f, 0.0f, 0.0f, 0.0f));
         m_engine->SetBackground("");
         m_engine->SetBackForce(false);
@@ -2291,6 +2305,55 @@ void CRobotMain::UpdateInfoText()
             Math::Vector pos = obj->GetPosition();
             m_engine->SetStatisticPos(pos / g_unit);
         }
+
+        CPathCache* pathCache = m_objMan->GetPathCache();
+        int lookups = pathCache->GetLookupCount();
+        int hits = pathCache->GetHitCount();
+        m_engine->SetStatisticLine("Path cache hits",
+                                   StrUtils::Format("%d/%d (%d%%)", hits, lookups, lookups == 0 ? 0 : hits*100/lookups),
+                                   StrUtils::Format("%.2f ms", pathCache->GetSavedTime()/1e6f));
+        m_engine->SetStatisticLine("Path requests merged",
+                                   StrUtils::ToString<int>(pathCache->GetCoalescedCount()));
+
+        int chunks = 0, totalChunks = 0;
+        long long chunkMemory = 0, chunkTime = 0;
+        if (m_terrain->GetChunkStats(chunks, totalChunks, chunkMemory, chunkTime))
+        {
+            m_engine->SetStatisticLine("Terrain chunks",
+                                       StrUtils::Format("%d/%d (%.1f MB)", chunks, totalChunks, chunkMemory/1048576.0f),
+                                       StrUtils::Format("%.2f ms", chunkTime/1e6f));
+        }
+
+        if (m_engine->GetShowStats())
+        {
+            int physicsTotal = 0, physicsSleeping = 0;
+            int autoTotal = 0, autoSleeping = 0;
+            for (CObject* obj : m_objMan->GetAllObjects())
+            {
+                if (obj->Implements(ObjectInterfaceType::Movable))
+                {
+                    CPhysics* physics = dynamic_cast<CMovableObject*>(obj)->GetPhysics();
+                    if (physics != nullptr)
+                    {
+                        physicsTotal++;
+                        if (physics->IsSleeping()) physicsSleeping++;
+                    }
+                }
+                if (obj->Implements(ObjectInterfaceType::Old))
+                {
+                    CAuto* automat = obj->GetAuto();
+                    if (automat != nullptr)
+                    {
+                        autoTotal++;
+                        if (automat->IsSleeping()) autoSleeping++;
+                    }
+                }
+            }
+            m_engine->SetStatisticLine("Physics sleeping/awake",
+                                       StrUtils::Format("%d/%d", physicsSleeping, physicsTotal-physicsSleeping));
+            m_engine->SetStatisticLine("Autos sleeping/awake",
+                                       StrUtils::Format("%d/%d", autoSleeping, autoTotal-autoSleeping));
+        }
     }
     m_engine->SetTimerDisplay(m_missionTimerEnabled && m_missionTimerStarted ? TimeFormat(m_missionTimer) : "");
 }
@@ -2370,6 +2433,9 @@ bool CRobotMain::EventFrame(const Event &event)
         }
 
         m_engine->GetPyroManager()->EventProcess(event);
+
+        // Objects moved, the camera and particles will need fresh bounds
+        m_objMan->GetWorldQuery()->SetObjectsChanged();
     }
 
     // The camera follows the object, because its position
@@ -2525,6 +2591,13 @@ bool CRobotMain::EventFrame(const Event &event)
     {
         if (!m_editLock && !m_engine->GetPause())
         {
+            m_conditionCheckTime -= event.rTime;
+            if (m_conditionCheckTime <= 0.0f)
+            {
+                CountSceneConditions();
+                m_conditionCheckTime = m_conditionCheckPeriod;
+            }
+
             CheckEndMission(true);
             UpdateAudio(true);
             if (m_scoreboard)
@@ -2619,6 +2692,9 @@ bool CRobotMain::EventObject(const Event &event)
 
     m_resetCreate = false;
 
+    if (event.type == EVENT_FRAME)
+        m_objMan->GetNavGrid()->SetObjectsChanged();
+
     for (CObject* obj : m_objMan->GetAllObjects())
     {
         if (obj->Implements(ObjectInterfaceType::Interactive))
@@ -2627,9 +2703,27 @@ bool CRobotMain::EventObject(const Event &event)
         }
     }
 
+    if (event.type == EVENT_FRAME && m_phasedObjectUpdate)
+    {
+        // Matrices of the parts moved by EventProcess(), all at once
+        m_objMan->GetPartTransformPool()->Update(m_threadPool.get());
+
+        for (CObject* obj : m_objMan->GetAllObjects())
+        {
+            if (obj->Implements(ObjectInterfaceType::Interactive))
+            {
+                dynamic_cast<CInteractiveObject*>(obj)->EventFrameCommit(event);
+            }
+        }
+    }
+
+    // Side effects phase
     if (m_resetCreate)
         ResetCreate();
 
+    if (event.type == EVENT_FRAME)
+        m_objMan->GetWorldQuery()->SetObjectsChanged();
+
     return true;
 }
 
@@ -2640,7 +2734,6 @@ void CRobotMain::ScenePerso()
     DeleteAllObjects();  // removes all the current 3D Scene
     m_terrain->FlushRelief();
     m_engine->DeleteAllObjects();
-    m_oldModelManager->DeleteAllModelCopies();
     m_terrain->FlushBuildingLevel();
     m_terrain->FlushFlyingLimit();
     m_lightMan->FlushLights();
@@ -2672,6 +2765,10 @@ void CRobotMain::ScenePerso()
 //! Creates the whole scene
 void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
 {
+    CSystemUtils* systemUtils = m_app->GetSystemUtils();
+    SystemTimeStamp* loadStart = systemUtils->CreateTimeStamp();
+    systemUtils->GetCurrentTimeStamp(loadStart);
+
     m_fixScene = fixScene;
 
     m_base = nullptr;
@@ -2701,6 +2798,7 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
         m_endingLost = "";
         m_audioChange.clear();
         m_endTake.clear();
+        m_conditionCheckTime = 0.0f;
         m_endTakeImmediat = false;
         m_endTakeResearch = 0;
         m_endTakeTimeout = -1.0f;
@@ -3115,6 +3213,8 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
                                     line->GetParam("vision")->AsFloat(500.0f)*g_unit,
                                     line->GetParam("depth")->AsInt(2),
                                     line->GetParam("hard")->AsFloat(0.5f));
+                m_objMan->GetWorldQuery()->SetTerrain(m_terrain->GetBrickSize(),
+                                                      [this](const Math::Vector& pos) { return m_terrain->GetFloorLevel(pos, true); });
                 continue;
             }
 
@@ -3784,10 +3884,18 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
     catch (...)
     {
         m_sceneReadPath = "";
+        systemUtils->DestroyTimeStamp(loadStart);
         throw;
     }
     m_sceneReadPath = "";
 
+    SystemTimeStamp* loadEnd = systemUtils->CreateTimeStamp();
+    systemUtils->GetCurrentTimeStamp(loadEnd);
+    GetLogger()->Info("Scene '%s' created in %.2f ms\n", m_levelFile.c_str(),
+                      systemUtils->TimeStampDiff(loadStart, loadEnd, STU_MSEC));
+    systemUtils->DestroyTimeStamp(loadStart);
+    systemUtils->DestroyTimeStamp(loadEnd);
+
     if (m_app->GetSceneTestMode())
         m_eventQueue->AddEvent(Event(EVENT_QUIT));
 
@@ -4010,52 +4118,51 @@ void CRobotMain::ChangeColor()
 //! Calculates the distance to the nearest object
 namespace
 {
-float SearchNearestObject(CObjectManager* objMan, Math::Vector center, CObject* exclu)
+//! Updates the obstacles seen by FreeSpace() and similar functions
+CObstacleField* UpdateObstacleField(CObjectManager* objMan)
 {
-    float min = 100000.0f;
+    CObstacleField* field = objMan->GetObstacleField();
+    field->BeginUpdate();
+
+    ObstacleShape shape;
     for (CObject* obj : objMan->GetAllObjects())
     {
         if (!obj->GetDetectable()) continue;  // inactive?
         if (IsObjectBeingTransported(obj)) continue;
 
-        if (obj == exclu) continue;
-
         ObjectType type = obj->GetType();
+        shape.spheres.clear();
+        shape.hideInner = false;
 
+        // The whole area of a base is occupied, unless looking from its center
         if (type == OBJECT_BASE)
         {
-            Math::Vector oPos = obj->GetPosition();
-            if (oPos.x != center.x ||
-                oPos.z != center.z)
-            {
-                float dist = Math::Distance(center, oPos) - 80.0f;
-                if (dist < 0.0f) dist = 0.0f;
-                min = Math::Min(min, dist);
-                continue;
-            }
+            shape.spheres.push_back(Math::Sphere(obj->GetPosition(), 80.0f));
+            shape.hideInner = true;
         }
 
         if (type == OBJECT_STATION ||
             type == OBJECT_REPAIR ||
             type == OBJECT_DESTROYER)
         {
-            Math::Vector oPos = obj->GetPosition();
-            float dist = Math::Distance(center, oPos) - 8.0f;
-            if (dist < 0.0f) dist = 0.0f;
-            min = Math::Min(min, dist);
+            shape.spheres.push_back(Math::Sphere(obj->GetPosition(), 8.0f));
         }
 
         for (const auto &crashSphere : obj->GetAllCrashSpheres())
         {
-            Math::Vector oPos = crashSphere.sphere.pos;
-            float oRadius = crashSphere.sphere.radius;
-
-            float dist = Math::Distance(center, oPos) - oRadius;
-            if (dist < 0.0f) dist = 0.0f;
-            min = Math::Min(min, dist);
+            shape.spheres.push_back(crashSphere.sphere);
         }
+
+        field->SetObstacle(obj->GetID(), shape);
     }
-    return min;
+
+    field->EndUpdate();
+    return field;
+}
+
+int GetExcludedId(CObject* exclu)
+{
+    return exclu != nullptr ? exclu->GetID() : -1;
 }
 }
 
@@ -4063,6 +4170,9 @@ float SearchNearestObject(CObjectManager* objMan, Math::Vector center, CObject*
 bool CRobotMain::FreeSpace(Math::Vector &center, float minRadius, float maxRadius,
                            float space, CObject *exclu)
 {
+    CObstacleField* field = UpdateObstacleField(m_objMan.get());
+    int excluId = GetExcludedId(exclu);
+
     if (minRadius < maxRadius)  // from internal to external?
     {
         for (float radius = minRadius; radius <= maxRadius; radius += space)
@@ -4079,7 +4189,7 @@ bool CRobotMain::FreeSpace(Math::Vector &center, float minRadius, float maxRadiu
                 pos.z = p.y;
                 pos.y = 0.0f;
                 m_terrain->AdjustToFloor(pos, true);
-                float dist = SearchNearestObject(m_objMan.get(), pos, exclu);
+                float dist = field->GetDistance(pos, excluId, space);
                 if (dist >= space)
                 {
                     float flat = m_terrain->GetFlatZoneRadius(pos, dist/2.0f);
@@ -4108,7 +4218,7 @@ bool CRobotMain::FreeSpace(Math::Vector &center, float minRadius, float maxRadiu
                 pos.z = p.y;
                 pos.y = 0.0f;
                 m_terrain->AdjustToFloor(pos, true);
-                float dist = SearchNearestObject(m_objMan.get(), pos, exclu);
+                float dist = field->GetDistance(pos, excluId, space);
                 if (dist >= space)
                 {
                     float flat = m_terrain->GetFlatZoneRadius(pos, dist/2.0f);
@@ -4128,6 +4238,9 @@ bool CRobotMain::FreeSpace(Math::Vector &center, float minRadius, float maxRadiu
 bool CRobotMain::FlatFreeSpace(Math::Vector &center, float minFlat, float minRadius, float maxRadius,
                            float space, CObject *exclu)
 {
+    CObstacleField* field = UpdateObstacleField(m_objMan.get());
+    int excluId = GetExcludedId(exclu);
+
     if (minRadius < maxRadius)  // from internal to external?
     {
         for (float radius = minRadius; radius <= maxRadius; radius += space)
@@ -4144,7 +4257,7 @@ bool CRobotMain::FlatFreeSpace(Math::Vector &center, float minFlat, float minRad
                 pos.z = p.y;
                 pos.y = 0.0f;
                 m_terrain->AdjustToFloor(pos, true);
-                float dist = SearchNearestObject(m_objMan.get(), pos, exclu);
+                float dist = field->GetDistance(pos, excluId, space);
                 if (dist >= space)
                 {
                     float flat = m_terrain->GetFlatZoneRadius(pos, dist/2.0f);
@@ -4177,7 +4290,7 @@ bool CRobotMain::FlatFreeSpace(Math::Vector &center, float minFlat, float minRad
                 pos.z = p.y;
                 pos.y = 0.0f;
                 m_terrain->AdjustToFloor(pos, true);
-                float dist = SearchNearestObject(m_objMan.get(), pos, exclu);
+                float dist = field->GetDistance(pos, excluId, space);
                 if (dist >= space)
                 {
                     float flat = m_terrain->GetFlatZoneRadius(pos, dist/2.0f);
@@ -4201,7 +4314,7 @@ bool CRobotMain::FlatFreeSpace(Math::Vector &center, float minFlat, float minRad
 float CRobotMain::GetFlatZoneRadius(Math::Vector center, float maxRadius,
                                     CObject *exclu)
 {
-    float dist = SearchNearestObject(m_objMan.get(), center, exclu);
+    float dist = UpdateObstacleField(m_objMan.get())->GetDistance(center, GetExcludedId(exclu));
     if (dist == 0.0f) return 0.0f;
     if (dist < maxRadius)
         maxRadius = dist;
@@ -4947,6 +5060,25 @@ void CRobotMain::UpdateAudio(bool frame)
     }
 }
 
+//! Counts objects for all scene conditions in a single pass
+void CRobotMain::CountSceneConditions()
+{
+    std::vector<CSceneCondition*> conditions;
+    if (!m_missionResultFromScript)
+    {
+        for (std::unique_ptr<CSceneEndCondition>& endTake : m_endTake)
+            conditions.push_back(endTake.get());
+    }
+    for (std::unique_ptr<CAudioChangeCondition>& audioChange : m_audioChange)
+    {
+        if (audioChange->changed) continue;
+        conditions.push_back(audioChange.get());
+    }
+    if (conditions.empty()) return;
+
+    CSceneCondition::CountAll(conditions);
+}
+
 //! Set mission result from LevelController script
 void CRobotMain::SetMissionResultFromScript(Error result, float delay)
 {
@@ -5150,6 +5282,10 @@ Error CRobotMain::ProcessEndMissionTake()
 //! Checks if the mission is over
 Error CRobotMain::CheckEndMission(bool frame)
 {
+    // Outside of the frame loop, don't rely on counts from an earlier frame
+    if (!frame)
+        CountSceneConditions();
+
     // Process EndMissionTake, unless we are using LevelController script for processing ending conditions
     if (!m_missionResultFromScript)
     {
@@ -5618,6 +5754,31 @@ int CRobotMain::GetAutosaveSlots()
     return m_autosaveSlots;
 }
 
+void CRobotMain::SetPhasedObjectUpdate(bool phased)
+{
+    m_phasedObjectUpdate = phased;
+}
+
+bool CRobotMain::GetPhasedObjectUpdate()
+{
+    return m_phasedObjectUpdate;
+}
+
+CThreadPool* CRobotMain::GetThreadPool()
+{
+    return m_threadPool.get();
+}
+
+void CRobotMain::SetConditionCheckPeriod(float period)
+{
+    m_conditionCheckPeriod = Math::Max(period, 0.0f);
+}
+
+float CRobotMain::GetConditionCheckPeriod()
+{
+    return m_conditionCheckPeriod;
+}
+
 // Remove oldest saves with autosave prefix
 void CRobotMain::AutosaveRotate()
 {
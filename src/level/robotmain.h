@@ -92,6 +92,8 @@ class CPlayerProfile;
 class CSettings;
 class COldObject;
 class CPauseManager;
+class CThreadPool;
+class CInteractiveObject;
 struct ActivePause;
 
 namespace Gfx
@@ -242,6 +244,8 @@ public:
 
     void        ResetObject();
     void        UpdateAudio(bool frame);
+    //! Counts objects for all EndMissionTake and AudioChange conditions in one pass
+    void        CountSceneConditions();
     void        SetMissionResultFromScript(Error result, float delay);
     Error       CheckEndMission(bool frame);
     Error       ProcessEndMissionTake();
@@ -362,6 +366,32 @@ public:
     int         GetAutosaveSlots();
     //@}
 
+    /**
+     * \name Phased object update
+     *
+     * With the phased object update, objects send their moved parts to the
+     * part transform pool during EventProcess(), the pool computes all their
+     * matrices at once, then EventFrameCommit() gives the matrices to CEngine.
+     * Objects are otherwise processed one by one on the main thread.
+     */
+    //@{
+    void        SetPhasedObjectUpdate(bool phased);
+    bool        GetPhasedObjectUpdate();
+    //@}
+    //! Returns the worker thread pool shared by the part transform pool, particles and the minimap
+    CThreadPool* GetThreadPool();
+
+    //! Management of the scene condition check period
+    /**
+     * EndMissionTake and AudioChange conditions are counted with a single
+     * shared scan over all objects, repeated every \a period seconds of game
+     * time. Checks in between reuse the last counts. 0 counts every frame.
+     */
+    //@{
+    void        SetConditionCheckPeriod(float period);
+    float       GetConditionCheckPeriod();
+    //@}
+
     //! Enable mode where completing mission closes the game
     void        SetExitAfterMission(bool exit);
 
@@ -682,6 +712,10 @@ protected:
 
     std::vector<std::unique_ptr<CAudioChangeCondition>> m_audioChange;
 
+    float           m_conditionCheckPeriod = 0.1f;
+    //! Time left until the next CountSceneConditions()
+    float           m_conditionCheckTime = 0.0f;
+
     //! The scoreboard
     //! If the scoreboard is not enabled for this level, this will be null
     std::unique_ptr<CScoreboard> m_scoreboard;
@@ -718,6 +752,9 @@ protected:
 
     int             m_shotSaving = 0;
 
+    bool            m_phasedObjectUpdate = true;
+    std::unique_ptr<CThreadPool> m_threadPool;
+
     std::deque<CObject*> m_selectionHistory;
     bool            m_debugCrashSpheres;
 
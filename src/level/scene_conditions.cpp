@@ -30,6 +30,7 @@
 #include "object/interface/transportable_object.h"
 
 #include <limits>
+#include <map>
 
 
 void CObjectCondition::Read(CLevelParserLine* line)
@@ -138,10 +139,53 @@ void CSceneCondition::Read(CLevelParserLine* line)
 
 bool CSceneCondition::Check()
 {
-    int nb = CountObjects();
+    int nb = GetCount();
     return nb >= this->min && nb <= this->max;
 }
 
+int CSceneCondition::GetCount()
+{
+    if (this->count < 0)
+        return CountObjects();
+    return this->count;
+}
+
+void CSceneCondition::CountAll(const std::vector<CSceneCondition*>& conditions)
+{
+    std::vector<CSceneCondition*> anyType;
+    std::map<ObjectType, std::vector<CSceneCondition*>> byType;
+    for (CSceneCondition* condition : conditions)
+    {
+        condition->count = 0;
+        // Same rule as the type check in CheckForObject()
+        if (condition->tool == ToolType::Other &&
+            condition->drive == DriveType::Other &&
+            condition->type != OBJECT_NULL)
+            byType[condition->type].push_back(condition);
+        else
+            anyType.push_back(condition);
+    }
+
+    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    {
+        if (!obj->GetActive()) continue;
+
+        for (CSceneCondition* condition : anyType)
+        {
+            if (condition->CheckForObject(obj))
+                condition->count ++;
+        }
+
+        auto it = byType.find(obj->GetType());
+        if (it == byType.end()) continue;
+        for (CSceneCondition* condition : it->second)
+        {
+            if (condition->CheckForObject(obj))
+                condition->count ++;
+        }
+    }
+}
+
 void CSceneEndCondition::Read(CLevelParserLine* line)
 {
     CSceneCondition::Read(line);
@@ -152,7 +196,7 @@ void CSceneEndCondition::Read(CLevelParserLine* line)
 
 bool CSceneEndCondition::CheckLost()
 {
-    int nb = CountObjects();
+    int nb = GetCount();
     return nb <= this->lost;
 }
 
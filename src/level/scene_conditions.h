@@ -33,6 +33,8 @@
 #include "object/object_type.h"
 #include "object/tool_type.h"
 
+#include <vector>
+
 class CLevelParserLine;
 class CObject;
 
@@ -73,11 +75,25 @@ public:
     int           min = 1;        // wins if >
     int           max = 9999;     // wins if <
 
+    //! Object count from the last CountAll() call, -1 if not counted yet
+    int           count = -1;
+
     //! Read from line in scene file
     void Read(CLevelParserLine* line) override;
 
     //! Checks if this condition is met
     bool Check();
+
+    //! Returns the object count from the last CountAll(), or counts now if not available
+    int GetCount();
+
+    //! Counts objects for all given conditions in a single pass over the object list
+    /**
+     * Conditions that only match a single object type are bucketed by that type,
+     * so each object is only tested against the conditions that can match it.
+     * The results are stored in \a count of each condition.
+     */
+    static void CountAll(const std::vector<CSceneCondition*>& conditions);
 };
 
 /**
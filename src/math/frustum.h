@@ -0,0 +1,106 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file math/frustum.h
+ * \brief Frustum struct and sphere visibility test
+ */
+
+#pragma once
+
+#include "math/matrix.h"
+#include "math/sphere.h"
+#include "math/vector.h"
+
+
+// Math module namespace
+namespace Math
+{
+
+/**
+ * \struct Frustum math/frustum.h
+ * \brief View frustum as six planes facing inwards
+ *
+ * Planes are in order: left, right, bottom, top, front, back,
+ * the same as the FRUSTUM_PLANE_* flags of the graphics device.
+ */
+struct Frustum
+{
+    //! Normalized plane normals
+    Vector normal[6];
+    //! Plane distances from origin
+    float  distance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+};
+
+/**
+ * \brief Extracts world-space frustum planes from combined projection * view matrix
+ *
+ * Uses the same plane extraction as CDevice::ComputeSphereVisibility(), so \a viewProj
+ * must include the Z flip applied by the device to the view matrix.
+ */
+inline Frustum ExtractFrustum(Matrix viewProj)
+{
+    Frustum frustum;
+
+    for (int i = 0; i < 6; i++)
+    {
+        int row = i / 2 + 1;
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+
+        Vector normal;
+        normal.x = viewProj.Get(4, 1) + sign * viewProj.Get(row, 1);
+        normal.y = viewProj.Get(4, 2) + sign * viewProj.Get(row, 2);
+        normal.z = viewProj.Get(4, 3) + sign * viewProj.Get(row, 3);
+        float length = normal.Length();
+
+        frustum.normal[i] = normal / length;
+        frustum.distance[i] = (viewProj.Get(4, 4) + sign * viewProj.Get(row, 4)) / length;
+    }
+
+    return frustum;
+}
+
+//! Result of testing a sphere against a frustum
+enum FrustumTest
+{
+    FRUSTUM_OUTSIDE = 0,
+    FRUSTUM_INTERSECT = 1,
+    FRUSTUM_INSIDE = 2
+};
+
+//! Tests whether \a sphere is outside, partially inside or fully inside the \a frustum
+inline FrustumTest TestSphereInFrustum(const Frustum& frustum, const Sphere& sphere)
+{
+    FrustumTest result = FRUSTUM_INSIDE;
+
+    for (int i = 0; i < 6; i++)
+    {
+        float distance = frustum.distance[i] + DotProduct(frustum.normal[i], sphere.pos);
+
+        if (distance < -sphere.radius)
+            return FRUSTUM_OUTSIDE;
+
+        if (distance < sphere.radius)
+            result = FRUSTUM_INTERSECT;
+    }
+
+    return result;
+}
+
+} // namespace Math
@@ -402,6 +402,25 @@ void CAuto::SetMotor(bool bMotor)
 }
 
 
+// Management of the sleep state, for controllers waiting for a trigger.
+// The object wakes the controller up on a cargo change, damage, etc.
+
+void CAuto::Sleep()
+{
+    m_bSleeping = true;
+}
+
+void CAuto::WakeUp()
+{
+    m_bSleeping = false;
+}
+
+bool CAuto::IsSleeping()
+{
+    return m_bSleeping;
+}
+
+
 // Saves all parameters of the controller.
 
 bool CAuto::Write(CLevelParserLine* line)
@@ -81,6 +81,11 @@ public:
     virtual bool    GetMotor();
     virtual void    SetMotor(bool bMotor);
 
+    //! Stops the frame updates until the object wakes the controller up
+    void            Sleep();
+    void            WakeUp();
+    bool            IsSleeping();
+
     virtual bool    Write(CLevelParserLine* line);
     virtual bool    Read(CLevelParserLine* line);
 
@@ -110,6 +115,7 @@ protected:
     ObjectType  m_type = OBJECT_NULL;
     bool        m_bBusy = false;
     bool        m_bMotor = false;
+    bool        m_bSleeping = false;
     float       m_time = 0.0f;
     float       m_lastUpdateTime = 0.0f;
     float       m_progressTime = 0.0f;
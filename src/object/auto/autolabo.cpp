@@ -147,6 +147,7 @@ Error CAutoLabo::StartAction(int param)
 
     power->SetLock(true);  // ball longer usable
 
+    WakeUp();
     SoundManip(1.0f, 1.0f, 1.0f);
     m_phase    = ALAP_OPEN1;
     m_progress = 0.0f;
@@ -210,6 +211,11 @@ bool CAutoLabo::EventProcess(const Event &event)
             m_phase    = ALAP_WAIT;  // still waiting ...
             m_progress = 0.0f;
             m_speed    = 1.0f/2.0f;
+
+            if ( !m_object->GetSelect() )
+            {
+                Sleep();  // until a research is started
+            }
         }
     }
 
@@ -148,6 +148,11 @@ bool CAutoNuclearPlant::EventProcess(const Event &event)
                 m_phase    = ANUP_WAIT;  // still waiting ...
                 m_progress = 0.0f;
                 m_speed    = 1.0f/2.0f;
+
+                if ( cargo == nullptr && !m_object->GetSelect() )
+                {
+                    Sleep();  // until some uranium is brought
+                }
             }
             else
             {
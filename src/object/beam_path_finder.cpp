@@ -0,0 +1,288 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/beam_path_finder.h"
+
+#include "math/func.h"
+#include "math/geometry.h"
+
+#include <cmath>
+
+
+namespace
+{
+
+const float BEAM_ACCURACY = 5.0f;  // higher value = more accurate, but slower
+
+} // anonymous namespace
+
+
+CBeamPathFinder::CBeamPathFinder()
+{
+}
+
+CBeamPathFinder::~CBeamPathFinder()
+{
+}
+
+void CBeamPathFinder::Init(int size, float cellSize, BlockedFunction blocked)
+{
+    m_size = size;
+    m_cellSize = cellSize;
+    m_offset = size*cellSize/2.0f;
+    m_blocked = blocked;
+    m_trail.assign(size*size, false);
+}
+
+void CBeamPathFinder::Start()
+{
+    for (int i = 0; i < BEAM_MAX_POINTS; i++)
+    {
+        m_iter[i] = -1;
+    }
+    m_total = 0;
+}
+
+// Calculates points and passes to go from start to goal.
+// goalRadius: distance at which we must approach the goal
+
+Error CBeamPathFinder::Continue(const Math::Vector& start, const Math::Vector& goal,
+                                float goalRadius, int maxIterations)
+{
+    float len = Math::DistanceProjected(start, goal);
+    float step = len/BEAM_ACCURACY;
+    if ( step < m_cellSize*2.1f )  step = m_cellSize*2.1f;
+    if ( step > 20.0f           )  step = 20.0f;
+    m_iterCounter = 0;
+    return Explore(start, start, goal, goalRadius, 165.0f*Math::PI/180.0f, 22, step, 0, maxIterations);
+}
+
+const Math::Vector* CBeamPathFinder::GetPoints() const
+{
+    return m_points;
+}
+
+int CBeamPathFinder::GetTotal() const
+{
+    return m_total;
+}
+
+// prevPos: previous position
+// curPos:  current position
+// goalPos: position that seeks to achieve
+// angle:   angle to the goal we explores
+// nbDiv:   number of subdivisions being done with angle
+// step     length of a step
+// i        number of recursions made
+// nbIter   maximum number of iterations you have the right to make before temporarily interrupt
+
+Error CBeamPathFinder::Explore(const Math::Vector& prevPos, const Math::Vector& curPos,
+                               const Math::Vector& goalPos, float goalRadius,
+                               float angle, int nbDiv, float step,
+                               int i, int nbIter)
+{
+    Math::Vector    newPos;
+    Error       ret;
+    int         iDiv, iClear, iLar;
+
+    iLar = 0;
+    if ( i >= BEAM_MAX_POINTS )  return ERR_GOTO_ITER;  // too many recursions
+
+    m_total = i;
+
+    if ( m_iter[i] == -1 )
+    {
+        m_iter[i] = 0;
+
+        if ( i == 0 )
+        {
+            m_points[i] = curPos;
+        }
+        else
+        {
+            if ( !TestLine(prevPos, curPos, angle/nbDiv, true) )  return ERR_GOTO_IMPOSSIBLE;
+
+            m_points[i] = curPos;
+
+            if ( Math::DistanceProjected(curPos, goalPos)-goalRadius <= step )
+            {
+                if ( goalRadius == 0.0f )
+                {
+                    newPos = goalPos;
+                }
+                else
+                {
+                    newPos = Point(curPos, goalPos, 0, Math::DistanceProjected(curPos, goalPos)-goalRadius);
+                }
+                if ( TestLine(curPos, newPos, angle/nbDiv, false) )
+                {
+                    m_points[i+1] = newPos;
+                    m_total = i+1;
+                    return ERR_OK;
+                }
+            }
+        }
+    }
+
+    if ( iLar >= m_iter[i] )
+    {
+        newPos = Point(curPos, goalPos, 0, step);
+        ret = Explore(curPos, newPos, goalPos, goalRadius, angle, nbDiv, step, i+1, nbIter);
+        if ( ret != ERR_GOTO_IMPOSSIBLE )  return ret;
+        m_iter[i] = iLar+1;
+        for ( iClear=i+1 ; iClear<=BEAM_MAX_POINTS ; iClear++ )  m_iter[iClear] = -1;
+        m_iterCounter ++;
+        if ( m_iterCounter >= nbIter )  return ERR_CONTINUE;
+    }
+    iLar ++;
+
+    for ( iDiv=1 ; iDiv<=nbDiv ; iDiv++ )
+    {
+        if ( iLar >= m_iter[i] )
+        {
+            newPos = Point(curPos, goalPos, angle*iDiv/nbDiv, step);
+            ret = Explore(curPos, newPos, goalPos, goalRadius, angle, nbDiv, step, i+1, nbIter);
+            if ( ret != ERR_GOTO_IMPOSSIBLE )  return ret;
+            m_iter[i] = iLar+1;
+            for ( iClear=i+1 ; iClear<=BEAM_MAX_POINTS ; iClear++ )  m_iter[iClear] = -1;
+            m_iterCounter ++;
+            if ( m_iterCounter >= nbIter )  return ERR_CONTINUE;
+        }
+        iLar ++;
+
+        if ( iLar >= m_iter[i] )
+        {
+            newPos = Point(curPos, goalPos, -angle*iDiv/nbDiv, step);
+            ret = Explore(curPos, newPos, goalPos, goalRadius, angle, nbDiv, step, i+1, nbIter);
+            if ( ret != ERR_GOTO_IMPOSSIBLE )  return ret;
+            m_iter[i] = iLar+1;
+            for ( iClear=i+1 ; iClear<=BEAM_MAX_POINTS ; iClear++ )  m_iter[iClear] = -1;
+            m_iterCounter ++;
+            if ( m_iterCounter >= nbIter )  return ERR_CONTINUE;
+        }
+        iLar ++;
+    }
+
+    return ERR_GOTO_IMPOSSIBLE;
+}
+
+// Is a right "start-goal". Calculates the point located at the distance "step"
+// from the point "start" and an angle "angle" with the right.
+
+Math::Vector CBeamPathFinder::Point(const Math::Vector& startPoint,
+                                    const Math::Vector& goalPoint,
+                                    float angle, float step)
+{
+    Math::Vector    resPoint;
+    float       goalAngle;
+
+    goalAngle = Math::RotateAngle(goalPoint.x-startPoint.x, goalPoint.z-startPoint.z);
+
+    resPoint.x = startPoint.x + cosf(goalAngle+angle)*step;
+    resPoint.z = startPoint.z + sinf(goalAngle+angle)*step;
+    resPoint.y = 0.0f;
+
+    return resPoint;
+}
+
+// Tests if a path along a straight line is possible.
+// With bSecond, the line is marked as crossed, and crossing a marked line fails.
+
+bool CBeamPathFinder::TestLine(const Math::Vector& start, const Math::Vector& goal,
+                               float stepAngle, bool bSecond)
+{
+    Math::Vector    pos, inc;
+    float       dist, step;
+    float       distNoB2;
+    int         i, max, x, y;
+
+    if ( !m_blocked )  return true;
+
+    dist = Math::DistanceProjected(start, goal);
+    if ( dist == 0.0f )  return true;
+    step = m_cellSize*0.5f;
+
+    inc.x = (goal.x-start.x)*step/dist;
+    inc.z = (goal.z-start.z)*step/dist;
+
+    pos = start;
+
+    if ( bSecond )
+    {
+        x = static_cast<int>((pos.x+m_offset)/m_cellSize);
+        y = static_cast<int>((pos.z+m_offset)/m_cellSize);
+        SetTrail(x, y);  // puts the flag as the starting point
+    }
+
+    max = static_cast<int>(dist/step);
+    if ( max == 0 )  max = 1;
+    distNoB2 = m_cellSize*sqrtf(2.0f)/sinf(stepAngle);
+    for ( i=0 ; i<max ; i++ )
+    {
+        if ( i == max-1 )
+        {
+            pos = goal;  // tests the point of arrival
+        }
+        else
+        {
+            pos.x += inc.x;
+            pos.z += inc.z;
+        }
+
+        x = static_cast<int>((pos.x+m_offset)/m_cellSize);
+        y = static_cast<int>((pos.z+m_offset)/m_cellSize);
+
+        if ( bSecond )
+        {
+            if ( i > 2 && TestTrail(x, y) )  return false;
+
+            if ( step*(i+1) > distNoB2 && i < max-2 )
+            {
+                SetTrail(x, y);
+            }
+        }
+
+        if ( m_blocked(x, y) )  return false;
+    }
+    return true;
+}
+
+bool CBeamPathFinder::TestTrail(int x, int y) const
+{
+    if ( x < 0 || x >= m_size ||
+         y < 0 || y >= m_size )  return false;
+
+    return m_trail[x+y*m_size];
+}
+
+void CBeamPathFinder::SetTrail(int x, int y)
+{
+    if ( x < 0 || x >= m_size ||
+         y < 0 || y >= m_size )  return;
+
+    m_trail[x+y*m_size] = true;
+}
+
+void CBeamPathFinder::Clear()
+{
+    m_blocked = nullptr;
+    m_trail.clear();
+    m_trail.shrink_to_fit();
+    m_total = 0;
+}
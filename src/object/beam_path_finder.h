@@ -0,0 +1,111 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/beam_path_finder.h
+ * \brief Resumable beam search of a path, as used by goto()
+ */
+
+#pragma once
+
+#include "common/error.h"
+
+#include "math/vector.h"
+
+#include <functional>
+#include <vector>
+
+//! Maximum number of points of a path found by the beam search
+const int BEAM_MAX_POINTS = 500;
+
+/**
+ * \class CBeamPathFinder
+ * \brief Original path search of goto(), which can be spread over several frames
+ *
+ * From each point, tries to go forward towards the goal, then at increasing
+ * angles on both sides, and recurses. Lines already crossed by the search are
+ * marked, so the search doesn't go back on its own trail.
+ *
+ * Positions are in world coordinates, the grid of cells is centered on (0, 0).
+ */
+class CBeamPathFinder
+{
+public:
+    //! Returns true if the cell can't be crossed
+    using BlockedFunction = std::function<bool(int x, int y)>;
+
+    CBeamPathFinder();
+    ~CBeamPathFinder();
+
+    /**
+     * \brief Sets the grid used by the next searches and clears the trail
+     * \param size width and height of the grid, in cells
+     * \param cellSize size of one cell, in world units
+     */
+    void        Init(int size, float cellSize, BlockedFunction blocked);
+
+    //! Resets the state of the search before the first call to Continue()
+    void        Start();
+
+    /**
+     * \brief Continues the search
+     * \param goalRadius distance at which the goal is reached
+     * \param maxIterations maximum number of dead ends explored in this call
+     * \return ERR_OK if a path was found, ERR_CONTINUE if not done yet,
+     *         ERR_GOTO_IMPOSSIBLE if there is no path, ERR_GOTO_ITER if too many recursions
+     */
+    Error       Continue(const Math::Vector& start, const Math::Vector& goal,
+                         float goalRadius, int maxIterations = 200);
+
+    //! Returns the points of the path found, or of the path being explored
+    const Math::Vector* GetPoints() const;
+    //! Returns the index of the last point given by GetPoints()
+    int         GetTotal() const;
+
+    //! Tests if a path along a straight line is possible
+    bool        TestLine(const Math::Vector& start, const Math::Vector& goal,
+                         float stepAngle = 0.0f, bool bSecond = false);
+    //! Tests if a cell has been crossed by the search
+    bool        TestTrail(int x, int y) const;
+
+    //! Frees the memory used by the search
+    void        Clear();
+
+    //! Returns the point at distance step from startPoint, at angle from the direction of goalPoint
+    static Math::Vector Point(const Math::Vector& startPoint, const Math::Vector& goalPoint,
+                              float angle, float step);
+
+protected:
+    Error       Explore(const Math::Vector& prevPos, const Math::Vector& curPos,
+                        const Math::Vector& goalPos, float goalRadius,
+                        float angle, int nbDiv, float step, int i, int nbIter);
+    void        SetTrail(int x, int y);
+
+protected:
+    int         m_size = 0;
+    float       m_cellSize = 1.0f;
+    float       m_offset = 0.0f;
+    BlockedFunction m_blocked;
+    std::vector<bool> m_trail;
+
+    int         m_total = 0;
+    Math::Vector m_points[BEAM_MAX_POINTS+2];
+    char        m_iter[BEAM_MAX_POINTS+2] = {};
+    int         m_iterCounter = 0;
+};
@@ -0,0 +1,194 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/grid_path_finder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+
+namespace
+{
+
+const float DIAGONAL_COST = 1.41421356f;
+
+const int NEIGHBOR_DX[8] = { 1, -1,  0,  0,  1, -1,  1, -1 };
+const int NEIGHBOR_DY[8] = { 0,  0,  1, -1,  1,  1, -1, -1 };
+
+} // anonymous namespace
+
+
+CGridPathFinder::CGridPathFinder()
+{
+}
+
+CGridPathFinder::~CGridPathFinder()
+{
+}
+
+void CGridPathFinder::Start(int size, const Math::IntPoint& start, const Math::IntPoint& goal,
+                            float goalRadius, BlockedFunction blocked, int maxVisited)
+{
+    Clear();
+
+    m_size = size;
+    m_start = start;
+    m_goal = goal;
+    m_goalRadius = goalRadius;
+    m_blocked = blocked;
+    m_maxVisited = maxVisited;
+    m_result = ERR_CONTINUE;
+
+    if ( start.x < 0 || start.x >= size ||
+         start.y < 0 || start.y >= size )
+    {
+        m_result = ERR_GOTO_IMPOSSIBLE;
+        return;
+    }
+
+    int index = start.x+start.y*m_size;
+    m_nodes[index] = Node();
+    m_open.push(OpenEntry{Heuristic(start.x, start.y), 0.0f, index});
+}
+
+Error CGridPathFinder::Continue(int maxExpansions)
+{
+    if (m_result != ERR_CONTINUE) return m_result;
+
+    for (int i = 0; i < maxExpansions; i++)
+    {
+        if (m_open.empty())
+        {
+            m_result = ERR_GOTO_IMPOSSIBLE;
+            return m_result;
+        }
+
+        OpenEntry entry = m_open.top();
+        m_open.pop();
+
+        Node& node = m_nodes[entry.index];
+        if (node.closed || entry.cost > node.cost) continue;  // outdated entry
+        node.closed = true;
+        m_expanded ++;
+
+        int x = entry.index%m_size;
+        int y = entry.index/m_size;
+
+        float dx = static_cast<float>(x-m_goal.x);
+        float dy = static_cast<float>(y-m_goal.y);
+        if (sqrtf(dx*dx+dy*dy) <= m_goalRadius)
+        {
+            BuildPath(entry.index);
+            m_result = ERR_OK;
+            return m_result;
+        }
+
+        for (int n = 0; n < 8; n++)
+        {
+            int nx = x+NEIGHBOR_DX[n];
+            int ny = y+NEIGHBOR_DY[n];
+            if (IsBlocked(nx, ny)) continue;
+
+            float cost = entry.cost;
+            if (n < 4)
+            {
+                cost += 1.0f;
+            }
+            else
+            {
+                // Doesn't cut corners
+                if (IsBlocked(nx, y) || IsBlocked(x, ny)) continue;
+                cost += DIAGONAL_COST;
+            }
+
+            int index = nx+ny*m_size;
+            auto it = m_nodes.find(index);
+            if (it != m_nodes.end())
+            {
+                if (it->second.closed || cost >= it->second.cost) continue;
+            }
+            else
+            {
+                if (static_cast<int>(m_nodes.size()) >= m_maxVisited)
+                {
+                    m_result = ERR_GOTO_ITER;
+                    return m_result;
+                }
+                it = m_nodes.insert(std::make_pair(index, Node())).first;
+            }
+
+            it->second.cost = cost;
+            it->second.parent = entry.index;
+            m_open.push(OpenEntry{cost+Heuristic(nx, ny), cost, index});
+        }
+    }
+
+    return ERR_CONTINUE;
+}
+
+const std::vector<Math::IntPoint>& CGridPathFinder::GetPath() const
+{
+    return m_path;
+}
+
+int CGridPathFinder::GetExpandedCount() const
+{
+    return m_expanded;
+}
+
+void CGridPathFinder::Clear()
+{
+    m_nodes.clear();
+    m_open = std::priority_queue<OpenEntry>();
+    m_path.clear();
+    m_expanded = 0;
+    m_result = ERR_GOTO_IMPOSSIBLE;
+}
+
+float CGridPathFinder::Heuristic(int x, int y) const
+{
+    float dx = static_cast<float>(std::abs(x-m_goal.x));
+    float dy = static_cast<float>(std::abs(y-m_goal.y));
+    float h = std::max(dx, dy) + (DIAGONAL_COST-1.0f)*std::min(dx, dy);
+    return std::max(h-m_goalRadius*DIAGONAL_COST, 0.0f);
+}
+
+bool CGridPathFinder::IsBlocked(int x, int y)
+{
+    if ( x < 0 || x >= m_size ||
+         y < 0 || y >= m_size )  return true;
+
+    return m_blocked(x, y);
+}
+
+void CGridPathFinder::BuildPath(int index)
+{
+    m_path.clear();
+    while (index != -1)
+    {
+        m_path.push_back(Math::IntPoint(index%m_size, index/m_size));
+        index = m_nodes[index].parent;
+    }
+    std::reverse(m_path.begin(), m_path.end());
+
+    // The search state is not needed anymore
+    m_nodes.clear();
+    m_open = std::priority_queue<OpenEntry>();
+}
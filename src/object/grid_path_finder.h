@@ -0,0 +1,123 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/grid_path_finder.h
+ * \brief Resumable A* search on a grid
+ */
+
+#pragma once
+
+#include "common/error.h"
+
+#include "math/intpoint.h"
+
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \class CGridPathFinder
+ * \brief A* path search on a square grid, which can be spread over several frames
+ *
+ * Moves are allowed to the 8 neighbors, diagonal moves only if both adjacent
+ * cells are free, so the path never cuts the corner of an obstacle.
+ * The heuristic is the octile distance, so the path found is the shortest one.
+ *
+ * The search state is kept between the calls to Continue(), so each call can
+ * be given a small budget. Only visited cells are stored, so the memory used
+ * depends on the explored area and not on the size of the grid.
+ */
+class CGridPathFinder
+{
+public:
+    //! Returns true if the cell can't be crossed
+    using BlockedFunction = std::function<bool(int x, int y)>;
+
+    CGridPathFinder();
+    ~CGridPathFinder();
+
+    /**
+     * \brief Starts a new search
+     * \param size width and height of the grid
+     * \param goalRadius distance to the goal (in cells) at which the goal is reached
+     * \param maxVisited maximum number of cells visited before giving up with ERR_GOTO_ITER
+     */
+    void        Start(int size, const Math::IntPoint& start, const Math::IntPoint& goal,
+                      float goalRadius, BlockedFunction blocked, int maxVisited = 200000);
+
+    /**
+     * \brief Continues the search
+     * \param maxExpansions maximum number of cells to expand in this call
+     * \return ERR_OK if a path was found, ERR_CONTINUE if not done yet,
+     *         ERR_GOTO_IMPOSSIBLE if there is no path, ERR_GOTO_ITER if too many cells were visited
+     */
+    Error       Continue(int maxExpansions);
+
+    //! Returns the cells of the path found, from start to the end, which is close to the goal
+    const std::vector<Math::IntPoint>& GetPath() const;
+
+    //! Returns the number of cells expanded since Start()
+    int         GetExpandedCount() const;
+
+    //! Frees the memory used by the search
+    void        Clear();
+
+protected:
+    struct Node
+    {
+        float   cost = 0.0f;
+        int     parent = -1;
+        bool    closed = false;
+    };
+
+    struct OpenEntry
+    {
+        float   estimate;
+        float   cost;
+        int     index;
+
+        bool operator<(const OpenEntry& other) const
+        {
+            // std::priority_queue gives the largest first
+            if (estimate != other.estimate) return estimate > other.estimate;
+            if (cost != other.cost) return cost < other.cost;  // prefers deeper nodes
+            return index > other.index;
+        }
+    };
+
+    float       Heuristic(int x, int y) const;
+    bool        IsBlocked(int x, int y);
+    void        BuildPath(int index);
+
+protected:
+    int         m_size = 0;
+    Math::IntPoint m_start;
+    Math::IntPoint m_goal;
+    float       m_goalRadius = 0.0f;
+    BlockedFunction m_blocked;
+    int         m_maxVisited = 0;
+
+    std::unordered_map<int, Node> m_nodes;
+    std::priority_queue<OpenEntry> m_open;
+    std::vector<Math::IntPoint> m_path;
+    int         m_expanded = 0;
+    Error       m_result = ERR_GOTO_IMPOSSIBLE;
+};
@@ -142,6 +142,7 @@ Error CTaskExecutorObjectImpl::StartForegroundTask(Args&&... args)
     StopForegroundTask();
 
     assert(m_object->Implements(ObjectInterfaceType::Old)); //TODO
+    dynamic_cast<COldObject*>(m_object)->WakeUp();
     std::unique_ptr<TaskType> task = MakeUnique<TaskType>(dynamic_cast<COldObject*>(m_object));
     Error err = task->Start(std::forward<Args>(args)...);
     if (err == ERR_OK)
@@ -155,6 +156,9 @@ Error CTaskExecutorObjectImpl::StartBackgroundTask(Args&&... args)
 {
     static_assert(std::is_base_of<CBackgroundTask, TaskType>::value, "not a background task");
 
+    assert(m_object->Implements(ObjectInterfaceType::Old)); //TODO
+    dynamic_cast<COldObject*>(m_object)->WakeUp();
+
     Error err;
     TaskType* task = dynamic_cast<TaskType*>(m_backgroundTask.get());
     if (task != nullptr)
@@ -253,9 +257,9 @@ Error CTaskExecutorObjectImpl::StartTaskTurn(float angle)
     return StartForegroundTask<CTaskTurn>(angle);
 }
 
-Error CTaskExecutorObjectImpl::StartTaskGoto(Math::Vector pos, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode)
+Error CTaskExecutorObjectImpl::StartTaskGoto(Math::Vector pos, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode, TaskGotoSearch searchMode)
 {
-    return StartForegroundTask<CTaskGoto>(pos, altitude, goalMode, crashMode);
+    return StartForegroundTask<CTaskGoto>(pos, altitude, goalMode, crashMode, searchMode);
 }
 
 Error CTaskExecutorObjectImpl::StartTaskInfo(const char *name, float value, float power, bool bSend)
@@ -58,7 +58,7 @@ public:
     Error StartTaskWait(float time) override;
     Error StartTaskAdvance(float length) override;
     Error StartTaskTurn(float angle) override;
-    Error StartTaskGoto(Math::Vector pos, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode) override;
+    Error StartTaskGoto(Math::Vector pos, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode, TaskGotoSearch searchMode = TGS_DEFAULT) override;
     Error StartTaskInfo(const char *name, float value, float power, bool bSend) override;
 
     Error StartTaskShield(TaskShieldMode mode, float delay = 1000.0f) override;
@@ -38,4 +38,8 @@ public:
     {}
 
     virtual bool EventProcess(const Event& event) = 0;
+
+    //! Called for EVENT_FRAME after the part transform pool computed the matrices of all objects
+    virtual void EventFrameCommit(const Event& event)
+    {}
 };
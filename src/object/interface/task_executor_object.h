@@ -63,7 +63,7 @@ public:
     virtual Error StartTaskWait(float time) = 0;
     virtual Error StartTaskAdvance(float length) = 0;
     virtual Error StartTaskTurn(float angle) = 0;
-    virtual Error StartTaskGoto(Math::Vector pos, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode) = 0;
+    virtual Error StartTaskGoto(Math::Vector pos, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode, TaskGotoSearch searchMode = TGS_DEFAULT) = 0;
     virtual Error StartTaskInfo(const char *name, float value, float power, bool bSend) = 0;
     //@}
     //! Starts a background task
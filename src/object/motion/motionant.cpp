@@ -256,7 +256,7 @@ void CMotionAnt::Create(Math::Vector pos, float angle, ObjectType type,
     pos = m_object->GetPosition();
     m_object->SetPosition(pos);  // to display the shadows immediately
 
-    m_engine->LoadAllTextures();
+    m_object->LoadTextures();
 }
 
 // Creates the physics of the object.
@@ -270,7 +270,7 @@ void CMotionBee::Create(Math::Vector pos, float angle, ObjectType type,
     pos = m_object->GetPosition();
     m_object->SetPosition(pos);  // to display the shadows immediately
 
-    m_engine->LoadAllTextures();
+    m_object->LoadTextures();
 }
 
 // Creates the physical object.
@@ -137,7 +137,7 @@ void CMotionHuman::Create(Math::Vector pos, float angle, ObjectType type,
         CreatePhysics(type);
         m_object->SetFloorHeight(0.0f);
 
-        m_engine->LoadAllTextures();
+        m_object->LoadTextures();
 
         return;
     }
@@ -333,7 +333,7 @@ void CMotionHuman::Create(Math::Vector pos, float angle, ObjectType type,
     pos = m_object->GetPosition();
     m_object->SetPosition(pos);  // to display the shadows immediately
 
-    m_engine->LoadAllTextures();
+    m_object->LoadTextures();
 }
 
 // Creates the physical object.
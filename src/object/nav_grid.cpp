@@ -0,0 +1,393 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/nav_grid.h"
+
+#include "graphics/engine/terrain.h"
+#include "graphics/engine/water.h"
+
+#include "math/func.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+CNavGrid::CNavGrid(Gfx::CTerrain* terrain, Gfx::CWater* water, const ObjectUpdateFunction& updateObjects)
+    : m_terrain(terrain),
+      m_water(water),
+      m_updateObjects(updateObjects),
+      m_tileObstacles(NAV_TILE_COUNT*NAV_TILE_COUNT),
+      m_tileRevision(NAV_TILE_COUNT*NAV_TILE_COUNT, 0)
+{
+}
+
+CNavGrid::~CNavGrid()
+{
+}
+
+void CNavGrid::Reset()
+{
+    for (TerrainLayer& layer : m_terrainLayers)
+    {
+        std::fill(layer.tileBlocked.begin(), layer.tileBlocked.end(), -1);
+    }
+    m_reliefRevision = -1;
+
+    m_obstacles.clear();
+    for (std::vector<int>& ids : m_tileObstacles)
+    {
+        ids.clear();
+    }
+    TouchTiles(0, 0, NAV_TILE_COUNT-1, NAV_TILE_COUNT-1);
+    m_objectsChanged = true;
+}
+
+void CNavGrid::SetObjectsChanged()
+{
+    m_objectsChanged = true;
+}
+
+int CNavGrid::GetTerrainLayer(float slopeLimit, bool acceptWater, bool fly)
+{
+    for (int i = 0; i < static_cast<int>(m_terrainLayers.size()); i++)
+    {
+        const TerrainLayer& layer = m_terrainLayers[i];
+        if (layer.slopeLimit == slopeLimit &&
+            layer.acceptWater == acceptWater &&
+            layer.fly == fly)
+            return i;
+    }
+
+    TerrainLayer layer;
+    layer.slopeLimit = slopeLimit;
+    layer.acceptWater = acceptWater;
+    layer.fly = fly;
+    layer.cells.resize(NAV_GRID_SIZE*NAV_GRID_SIZE, false);
+    layer.tileBlocked.resize(NAV_TILE_COUNT*NAV_TILE_COUNT, -1);
+    m_terrainLayers.push_back(std::move(layer));
+    return static_cast<int>(m_terrainLayers.size())-1;
+}
+
+bool CNavGrid::TestTerrain(int layer, int x, int y)
+{
+    if ( x < 0 || x >= NAV_GRID_SIZE ||
+         y < 0 || y >= NAV_GRID_SIZE )  return false;
+
+    CheckTerrain();
+
+    TerrainLayer& l = m_terrainLayers[layer];
+    int tx = x/NAV_TILE_SIZE;
+    int ty = y/NAV_TILE_SIZE;
+    if (l.tileBlocked[tx+ty*NAV_TILE_COUNT] < 0)
+        ComputeTerrainTile(l, tx, ty);
+
+    return l.cells[x+y*NAV_GRID_SIZE];
+}
+
+bool CNavGrid::IsTerrainTileFree(int layer, int tx, int ty)
+{
+    if ( tx < 0 || tx >= NAV_TILE_COUNT ||
+         ty < 0 || ty >= NAV_TILE_COUNT )  return true;
+
+    CheckTerrain();
+
+    TerrainLayer& l = m_terrainLayers[layer];
+    if (l.tileBlocked[tx+ty*NAV_TILE_COUNT] < 0)
+        ComputeTerrainTile(l, tx, ty);
+
+    return l.tileBlocked[tx+ty*NAV_TILE_COUNT] == 0;
+}
+
+void CNavGrid::GetObstacles(int minX, int minY, int maxX, int maxY, float margin,
+                            std::vector<const NavObstacle*>& result)
+{
+    UpdateObjects();
+
+    int minTX = Math::Clamp(PosToCell(CellToPos(minX)-margin)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+    int minTY = Math::Clamp(PosToCell(CellToPos(minY)-margin)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+    int maxTX = Math::Clamp(PosToCell(CellToPos(maxX+1)+margin)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+    int maxTY = Math::Clamp(PosToCell(CellToPos(maxY+1)+margin)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+
+    m_queryStamp ++;
+    for (int ty = minTY; ty <= maxTY; ty++)
+    {
+        for (int tx = minTX; tx <= maxTX; tx++)
+        {
+            for (int id : m_tileObstacles[tx+ty*NAV_TILE_COUNT])
+            {
+                NavObstacle& obstacle = m_obstacles[id];
+                if (obstacle.queryStamp == m_queryStamp) continue;
+                obstacle.queryStamp = m_queryStamp;
+                result.push_back(&obstacle);
+            }
+        }
+    }
+}
+
+int CNavGrid::GetTileRevision(int tx, int ty)
+{
+    CheckTerrain();
+    UpdateObjects();
+    return m_tileRevision[tx+ty*NAV_TILE_COUNT];
+}
+
+int CNavGrid::PosToCell(float coord)
+{
+    return static_cast<int>((coord+1600.0f)/NAV_CELL_SIZE);
+}
+
+float CNavGrid::CellToPos(int cell)
+{
+    return cell*NAV_CELL_SIZE-1600.0f;
+}
+
+void CNavGrid::CheckTerrain()
+{
+    if (m_terrain == nullptr) return;
+
+    bool all = false;
+
+    int revision = m_terrain->GetReliefRevision();
+    if (revision != m_reliefRevision)
+    {
+        Math::Vector min, max;
+        if (m_reliefRevision < 0 || !m_terrain->GetReliefChanges(m_reliefRevision, min, max))
+        {
+            all = true;
+        }
+        else if (min.x != max.x || min.z != max.z)
+        {
+            InvalidateTerrain(PosToCell(min.x), PosToCell(min.z), PosToCell(max.x), PosToCell(max.z));
+        }
+        m_reliefRevision = revision;
+
+        // Floor levels under the objects may have changed too
+        for (auto& it : m_obstacles)
+        {
+            it.second.lastAngle = NAN;
+        }
+        m_objectsChanged = true;
+    }
+
+    float waterLevel = m_water != nullptr ? m_water->GetLevel() : 0.0f;
+    float flyingMaxHeight = m_terrain->GetFlyingMaxHeight();
+    if (waterLevel != m_waterLevel || flyingMaxHeight != m_flyingMaxHeight)
+    {
+        m_waterLevel = waterLevel;
+        m_flyingMaxHeight = flyingMaxHeight;
+        all = true;
+    }
+
+    if (all)
+    {
+        InvalidateTerrain(0, 0, NAV_GRID_SIZE-1, NAV_GRID_SIZE-1);
+    }
+}
+
+void CNavGrid::InvalidateTerrain(int minX, int minY, int maxX, int maxY)
+{
+    // Underwater cells also block their neighbors
+    int minTX = Math::Clamp((minX-1)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+    int minTY = Math::Clamp((minY-1)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+    int maxTX = Math::Clamp((maxX+1)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+    int maxTY = Math::Clamp((maxY+1)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+
+    for (TerrainLayer& layer : m_terrainLayers)
+    {
+        for (int ty = minTY; ty <= maxTY; ty++)
+        {
+            for (int tx = minTX; tx <= maxTX; tx++)
+            {
+                layer.tileBlocked[tx+ty*NAV_TILE_COUNT] = -1;
+            }
+        }
+    }
+    TouchTiles(minTX, minTY, maxTX, maxTY);
+}
+
+void CNavGrid::ComputeTerrainTile(TerrainLayer& layer, int tx, int ty)
+{
+    int minX = tx*NAV_TILE_SIZE;
+    int minY = ty*NAV_TILE_SIZE;
+    int blocked = 0;
+
+    if (m_terrain == nullptr)
+    {
+        for (int y = minY; y < minY+NAV_TILE_SIZE; y++)
+        {
+            for (int x = minX; x < minX+NAV_TILE_SIZE; x++)
+            {
+                layer.cells[x+y*NAV_GRID_SIZE] = false;
+            }
+        }
+        layer.tileBlocked[tx+ty*NAV_TILE_COUNT] = 0;
+        return;
+    }
+
+    // Underwater flags of the tile with a border of one cell
+    const int UNDER_SIZE = NAV_TILE_SIZE+2;
+    bool under[UNDER_SIZE*UNDER_SIZE] = {};
+    if (!layer.fly && !layer.acceptWater)
+    {
+        for (int y = 0; y < UNDER_SIZE; y++)
+        {
+            for (int x = 0; x < UNDER_SIZE; x++)
+            {
+                Math::Vector p;
+                p.x = CellToPos(minX+x-1);
+                p.z = CellToPos(minY+y-1);
+                float h = m_terrain->GetFloorLevel(p, true);
+                under[x+y*UNDER_SIZE] = h < m_waterLevel-2.0f;  // accepts that a robot is 50cm under water
+            }
+        }
+    }
+
+    for (int y = 0; y < NAV_TILE_SIZE; y++)
+    {
+        for (int x = 0; x < NAV_TILE_SIZE; x++)
+        {
+            Math::Vector p;
+            p.x = CellToPos(minX+x);
+            p.z = CellToPos(minY+y);
+
+            bool cell = false;
+            if (layer.fly)  // flying robot?
+            {
+                float h = m_terrain->GetFloorLevel(p, true);
+                cell = h >= m_flyingMaxHeight-5.0f;
+            }
+            else
+            {
+                int u = (x+1)+(y+1)*UNDER_SIZE;
+                cell = under[u] || under[u-1] || under[u+1] ||
+                       under[u-UNDER_SIZE] || under[u+UNDER_SIZE];
+
+                if (!cell)
+                    cell = m_terrain->GetFineSlope(p) > layer.slopeLimit;
+            }
+
+            layer.cells[(minX+x)+(minY+y)*NAV_GRID_SIZE] = cell;
+            if (cell) blocked ++;
+        }
+    }
+
+    layer.tileBlocked[tx+ty*NAV_TILE_COUNT] = blocked;
+}
+
+void CNavGrid::UpdateObjects()
+{
+    if (!m_objectsChanged) return;
+    m_objectsChanged = false;
+
+    m_seenStamp ++;
+    if (m_updateObjects)
+        m_updateObjects(*this);
+
+    // Forget objects which were destroyed or are being transported
+    for (auto it = m_obstacles.begin(); it != m_obstacles.end(); )
+    {
+        if (it->second.seenStamp != m_seenStamp)
+        {
+            IndexObstacle(it->first, it->second, false);
+            it = m_obstacles.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void CNavGrid::SetObstacle(int id, CObject* object, ObjectType type,
+                           const Math::Vector& position, float angle, const SpheresFunction& getSpheres)
+{
+    bool added = m_obstacles.count(id) == 0;
+    NavObstacle& obstacle = m_obstacles[id];
+    obstacle.seenStamp = m_seenStamp;
+
+    if (!added &&
+        obstacle.object == object &&
+        obstacle.lastPosition.x == position.x &&
+        obstacle.lastPosition.y == position.y &&
+        obstacle.lastPosition.z == position.z &&
+        obstacle.lastAngle == angle)  return;
+
+    if (!added)
+        IndexObstacle(id, obstacle, false);
+
+    obstacle.id = id;
+    obstacle.object = object;
+    obstacle.type = type;
+    obstacle.lastPosition = position;
+    obstacle.lastAngle = angle;
+    obstacle.floorLevel = m_terrain != nullptr ? m_terrain->GetFloorLevel(position, false) : 0.0f;
+    obstacle.spheres.clear();
+    getSpheres(obstacle.spheres);
+
+    IndexObstacle(id, obstacle, true);
+}
+
+void CNavGrid::IndexObstacle(int id, NavObstacle& obstacle, bool add)
+{
+    if (add)
+    {
+        obstacle.tileMinX = obstacle.tileMinY = 0;
+        obstacle.tileMaxX = obstacle.tileMaxY = -1;
+        if (obstacle.spheres.empty()) return;
+
+        float minX =  1.0e6f, minZ =  1.0e6f;
+        float maxX = -1.0e6f, maxZ = -1.0e6f;
+        for (const Math::Sphere& sphere : obstacle.spheres)
+        {
+            minX = Math::Min(minX, sphere.pos.x-sphere.radius);
+            minZ = Math::Min(minZ, sphere.pos.z-sphere.radius);
+            maxX = Math::Max(maxX, sphere.pos.x+sphere.radius);
+            maxZ = Math::Max(maxZ, sphere.pos.z+sphere.radius);
+        }
+
+        obstacle.tileMinX = Math::Clamp(PosToCell(minX)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+        obstacle.tileMinY = Math::Clamp(PosToCell(minZ)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+        obstacle.tileMaxX = Math::Clamp(PosToCell(maxX)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+        obstacle.tileMaxY = Math::Clamp(PosToCell(maxZ)/NAV_TILE_SIZE, 0, NAV_TILE_COUNT-1);
+    }
+
+    for (int ty = obstacle.tileMinY; ty <= obstacle.tileMaxY; ty++)
+    {
+        for (int tx = obstacle.tileMinX; tx <= obstacle.tileMaxX; tx++)
+        {
+            std::vector<int>& ids = m_tileObstacles[tx+ty*NAV_TILE_COUNT];
+            if (add)
+                ids.push_back(id);
+            else
+                ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        }
+    }
+    TouchTiles(obstacle.tileMinX, obstacle.tileMinY, obstacle.tileMaxX, obstacle.tileMaxY);
+}
+
+void CNavGrid::TouchTiles(int minTX, int minTY, int maxTX, int maxTY)
+{
+    for (int ty = minTY; ty <= maxTY; ty++)
+    {
+        for (int tx = minTX; tx <= maxTX; tx++)
+        {
+            m_tileRevision[tx+ty*NAV_TILE_COUNT] ++;
+        }
+    }
+}
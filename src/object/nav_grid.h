@@ -0,0 +1,187 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/nav_grid.h
+ * \brief Shared occupancy grid used for path finding
+ */
+
+#pragma once
+
+#include "math/sphere.h"
+#include "math/vector.h"
+
+#include "object/object_type.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class CObject;
+
+namespace Gfx
+{
+class CTerrain;
+class CWater;
+} // namespace Gfx
+
+//! Size of one cell of the navigation grid (in game units)
+const float NAV_CELL_SIZE  = 5.0f;
+//! Number of cells along one side of the grid, covering the whole 3200x3200 world
+const int   NAV_GRID_SIZE  = static_cast<int>(3200.0f/NAV_CELL_SIZE);
+//! Number of cells along one side of a tile
+const int   NAV_TILE_SIZE  = 16;
+//! Number of tiles along one side of the grid
+const int   NAV_TILE_COUNT = NAV_GRID_SIZE/NAV_TILE_SIZE;
+
+/**
+ * \struct NavObstacle
+ * \brief Crash spheres of one object, as seen by the navigation grid
+ */
+struct NavObstacle
+{
+    int         id = -1;
+    CObject*    object = nullptr;
+    ObjectType  type = OBJECT_NULL;
+    //! Floor level under the object
+    float       floorLevel = 0.0f;
+    std::vector<Math::Sphere> spheres;
+
+    // Used to detect changes and to index the obstacle
+    Math::Vector lastPosition;
+    float       lastAngle = 0.0f;
+    int         tileMinX = 0, tileMinY = 0;
+    int         tileMaxX = -1, tileMaxY = -1;
+    int         seenStamp = 0;
+    int         queryStamp = 0;
+};
+
+/**
+ * \class CNavGrid
+ * \brief World-owned occupancy data shared by all CTaskGoto instances
+ *
+ * The grid has two levels of resolution: cells of NAV_CELL_SIZE, which are
+ * the pixels of the goto bitmap, and tiles of NAV_TILE_SIZE x NAV_TILE_SIZE cells.
+ *
+ * Terrain obstacles (slopes, water, flying height) only depend on the class of
+ * the vehicle, so there is one terrain layer per class. Layers are computed
+ * lazily one tile at a time and each tile keeps a count of blocked cells, so
+ * free tiles can be skipped entirely. Tiles are invalidated when the relief changes
+ * (see CTerrain::GetReliefChanges()).
+ *
+ * Object obstacles depend on the size and altitude of the robot looking for
+ * a path, so they are not rasterized here. Instead, crash spheres of all
+ * objects are kept in a tile index, refreshed incrementally: after
+ * SetObjectsChanged(), the next query calls the object update function, which
+ * gives every object with SetObstacle(). Only objects that have been created,
+ * destroyed, moved or rotated since the previous update are re-indexed.
+ *
+ * Each tile has a revision, incremented whenever its content changes.
+ */
+class CNavGrid
+{
+public:
+    //! Gives all objects to the grid with SetObstacle()
+    using ObjectUpdateFunction = std::function<void(CNavGrid& grid)>;
+    //! Gives the crash spheres of an object
+    using SpheresFunction = std::function<void(std::vector<Math::Sphere>& spheres)>;
+
+    CNavGrid(Gfx::CTerrain* terrain, Gfx::CWater* water, const ObjectUpdateFunction& updateObjects);
+    ~CNavGrid();
+
+    //! Forgets all cached data, used when the level changes
+    void        Reset();
+    //! Notifies that objects may have moved, called once every frame
+    void        SetObjectsChanged();
+
+    /**
+     * \brief Sets an object, called by the object update function
+     *
+     * Objects which are not set again in the next update are forgotten.
+     * \param getSpheres is only called if the object is new, moved or rotated
+     */
+    void        SetObstacle(int id, CObject* object, ObjectType type,
+                            const Math::Vector& position, float angle, const SpheresFunction& getSpheres);
+
+    //! Returns the terrain layer for given vehicle class, creating it if needed
+    int         GetTerrainLayer(float slopeLimit, bool acceptWater, bool fly);
+    //! Tests if the terrain cell is blocked in given layer
+    bool        TestTerrain(int layer, int x, int y);
+    //! Returns true if there is no blocked terrain cell in the tile
+    bool        IsTerrainTileFree(int layer, int tx, int ty);
+
+    /**
+     * \brief Gets objects which may block cells in the given rectangle
+     * \param margin distance around the crash spheres to take into account
+     * \param result receives the obstacles; the pointers are valid until the next query
+     */
+    void        GetObstacles(int minX, int minY, int maxX, int maxY, float margin, std::vector<const NavObstacle*>& result);
+
+    //! Returns the revision of the tile
+    int         GetTileRevision(int tx, int ty);
+
+    //! Converts world position to cell coordinates (not clamped)
+    static int  PosToCell(float coord);
+    //! Converts cell coordinates to world position of the cell corner
+    static float CellToPos(int cell);
+
+protected:
+    struct TerrainLayer
+    {
+        float       slopeLimit = 0.0f;
+        bool        acceptWater = false;
+        bool        fly = false;
+        //! Cell blocked flags, NAV_GRID_SIZE*NAV_GRID_SIZE
+        std::vector<bool> cells;
+        //! Number of blocked cells in each tile, -1 if not computed yet
+        std::vector<int> tileBlocked;
+    };
+
+    //! Invalidates terrain tiles if the relief, water or flying limits changed
+    void        CheckTerrain();
+    //! Invalidates terrain tiles of all layers in given cell rectangle
+    void        InvalidateTerrain(int minX, int minY, int maxX, int maxY);
+    //! Computes one tile of the terrain layer
+    void        ComputeTerrainTile(TerrainLayer& layer, int tx, int ty);
+
+    //! Re-indexes objects which changed since the last call
+    void        UpdateObjects();
+    //! Adds or removes the obstacle from the tile index
+    void        IndexObstacle(int id, NavObstacle& obstacle, bool add);
+    //! Increments the revision of tiles in given tile rectangle
+    void        TouchTiles(int minTX, int minTY, int maxTX, int maxTY);
+
+protected:
+    Gfx::CTerrain*  m_terrain;
+    Gfx::CWater*    m_water;
+    ObjectUpdateFunction m_updateObjects;
+
+    std::vector<TerrainLayer> m_terrainLayers;
+    int             m_reliefRevision = -1;
+    float           m_waterLevel = 0.0f;
+    float           m_flyingMaxHeight = 0.0f;
+
+    std::unordered_map<int, NavObstacle> m_obstacles;
+    //! IDs of the obstacles touching each tile
+    std::vector<std::vector<int>> m_tileObstacles;
+    std::vector<int> m_tileRevision;
+    bool            m_objectsChanged = true;
+    int             m_seenStamp = 0;
+    int             m_queryStamp = 0;
+};
@@ -320,117 +320,437 @@ CObjectUPtr CObjectFactory::CreateObject(const ObjectCreateParams& params)
     return nullptr;
 }
 
-// Creates a small resource set on the ground.
+// Returns the prototype of an object made of a single model,
+// building it on first use. Instances are then cloned from it.
 
-CObjectUPtr CObjectFactory::CreateResource(const ObjectCreateParams& params)
+const CObjectFactory::ObjectPrototype& CObjectFactory::GetPrototype(ObjectType type, int variant, bool mirrored)
 {
-    Math::Vector pos = params.pos;
-    float angle = params.angle;
-    ObjectType type = params.type;
-    float power = params.power;
+    PrototypeKey key;
+    key.type = type;
+    key.variant = variant;
+    key.mirrored = mirrored;
 
-    auto obj = MakeUnique<COldObject>(params.id);
+    auto it = m_prototypes.find(key);
+    if (it != m_prototypes.end())
+        return it->second;
 
-    obj->SetType(type);
-    obj->SetTeam(params.team);
+    ObjectPrototype proto;
+    proto.variant = variant;
+    proto.mirrored = mirrored;
+
+    switch (type)
+    {
+        case OBJECT_PLANT0:
+        case OBJECT_PLANT1:
+        case OBJECT_PLANT2:
+        case OBJECT_PLANT3:
+        case OBJECT_PLANT4:
+        case OBJECT_PLANT5:
+        case OBJECT_PLANT6:
+        case OBJECT_PLANT7:
+        case OBJECT_PLANT8:
+        case OBJECT_PLANT9:
+        case OBJECT_PLANT10:
+        case OBJECT_PLANT11:
+        case OBJECT_PLANT12:
+        case OBJECT_PLANT13:
+        case OBJECT_PLANT14:
+        case OBJECT_PLANT15:
+        case OBJECT_PLANT16:
+        case OBJECT_PLANT17:
+        case OBJECT_PLANT18:
+        case OBJECT_PLANT19:
+        case OBJECT_TREE0:
+        case OBJECT_TREE1:
+        case OBJECT_TREE2:
+        case OBJECT_TREE3:
+        case OBJECT_TREE4:
+        case OBJECT_TREE5:
+            BuildPlantPrototype(proto, type);
+            break;
+
+        case OBJECT_MUSHROOM1:
+        case OBJECT_MUSHROOM2:
+            BuildMushroomPrototype(proto, type);
+            break;
+
+        default:
+            BuildResourcePrototype(proto, type);
+            break;
+    }
 
+    // Load the shared geometry once, every clone only references it
+    if (!m_oldModelManager->IsModelLoaded(proto.modelName, proto.mirrored, proto.variant))
+        m_oldModelManager->LoadModel(proto.modelName, proto.mirrored, proto.variant);
+
+    return m_prototypes.insert(std::make_pair(key, proto)).first->second;
+}
+
+void CObjectFactory::ClonePrototype(const ObjectPrototype& proto, COldObject* obj, Math::Vector pos, float angle)
+{
     int rank = m_engine->CreateObject();
     m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);  // it is a stationary object
     obj->SetObjectRank(0, rank);
-    obj->SetEnergyLevel(power);
 
-    std::string name;
-    if ( type == OBJECT_STONE       )  name = "stone.mod";
-    if ( type == OBJECT_URANIUM     )  name = "uranium.mod";
-    if ( type == OBJECT_METAL       )  name = "metal.mod";
-    if ( type == OBJECT_POWER       )  name = "power.mod";
-    if ( type == OBJECT_ATOMIC      )  name = "atomic.mod";
-    if ( type == OBJECT_BULLET      )  name = "bullet.mod";
-    if ( type == OBJECT_BBOX        )  name = "bbox.mod";
-    if ( type == OBJECT_KEYa        )  name = "keya.mod";
-    if ( type == OBJECT_KEYb        )  name = "keyb.mod";
-    if ( type == OBJECT_KEYc        )  name = "keyc.mod";
-    if ( type == OBJECT_KEYd        )  name = "keyd.mod";
-    if ( type == OBJECT_TNT         )  name = "tnt.mod";
-    if ( type == OBJECT_BOMB        )  name = "bomb.mod";
-    if ( type == OBJECT_WAYPOINT    )  name = "waypoint.mod";
-    if ( type == OBJECT_SHOW        )  name = "show.mod";
-    if ( type == OBJECT_WINFIRE     )  name = "winfire.mod";
-    if ( type == OBJECT_BAG         )  name = "bag.mod";
-    if ( type == OBJECT_MARKSTONE   )  name = "cross1.mod";
-    if ( type == OBJECT_MARKURANIUM )  name = "cross3.mod";
-    if ( type == OBJECT_MARKPOWER   )  name = "cross2.mod";
-    if ( type == OBJECT_MARKKEYa    )  name = "crossa.mod";
-    if ( type == OBJECT_MARKKEYb    )  name = "crossb.mod";
-    if ( type == OBJECT_MARKKEYc    )  name = "crossc.mod";
-    if ( type == OBJECT_MARKKEYd    )  name = "crossd.mod";
-    if ( type == OBJECT_EGG         )  name = "egg.mod";
-
-    if (type == OBJECT_POWER || type == OBJECT_ATOMIC)
-    {
-        m_oldModelManager->AddModelCopy(name, false, rank, obj->GetTeam());
+    if (proto.modelCopy)
+    {
+        m_oldModelManager->AddModelCopy(proto.modelName, proto.mirrored, rank, proto.variant);
     }
     else
     {
-        m_oldModelManager->AddModelReference(name, false, rank, obj->GetTeam());
+        m_oldModelManager->AddModelReference(proto.modelName, proto.mirrored, rank, proto.variant);
     }
 
     obj->SetPosition(pos);
     obj->SetRotationY(angle);
 
-    if ( type == OBJECT_SHOW )  // remains in the air?
+    if ( !proto.onGround )
+        return;
+
+    for (const CrashSphere& crashSphere : proto.crashSpheres)
     {
-        return std::move(obj);
+        obj->AddCrashSphere(crashSphere);
+    }
+    if (proto.hasCameraSphere)
+    {
+        obj->SetCameraCollisionSphere(proto.cameraSphere);
+    }
+    if (proto.hasJostlingSphere)
+    {
+        obj->SetJostlingSphere(proto.jostlingSphere);
+    }
+    if (proto.scale != 1.0f)
+    {
+        obj->SetScale(proto.scale);
     }
 
-    float radius = 1.5f;
-    float height = 0.0f;
+    obj->CreateShadowCircle(proto.shadowRadius, proto.shadowIntensity);
+}
 
-    if ( type == OBJECT_MARKSTONE   ||
-         type == OBJECT_MARKURANIUM ||
-         type == OBJECT_MARKKEYa    ||
-         type == OBJECT_MARKKEYb    ||
-         type == OBJECT_MARKKEYc    ||
-         type == OBJECT_MARKKEYd    ||
-         type == OBJECT_MARKPOWER   ||
-         type == OBJECT_WAYPOINT    )
+// Describes a small resource.
+
+void CObjectFactory::BuildResourcePrototype(ObjectPrototype& proto, ObjectType type)
+{
+    if ( type == OBJECT_STONE       )  proto.modelName = "stone.mod";
+    if ( type == OBJECT_URANIUM     )  proto.modelName = "uranium.mod";
+    if ( type == OBJECT_METAL       )  proto.modelName = "metal.mod";
+    if ( type == OBJECT_POWER       )  proto.modelName = "power.mod";
+    if ( type == OBJECT_ATOMIC      )  proto.modelName = "atomic.mod";
+    if ( type == OBJECT_BULLET      )  proto.modelName = "bullet.mod";
+    if ( type == OBJECT_BBOX        )  proto.modelName = "bbox.mod";
+    if ( type == OBJECT_KEYa        )  proto.modelName = "keya.mod";
+    if ( type == OBJECT_KEYb        )  proto.modelName = "keyb.mod";
+    if ( type == OBJECT_KEYc        )  proto.modelName = "keyc.mod";
+    if ( type == OBJECT_KEYd        )  proto.modelName = "keyd.mod";
+    if ( type == OBJECT_TNT         )  proto.modelName = "tnt.mod";
+    if ( type == OBJECT_BOMB        )  proto.modelName = "bomb.mod";
+    if ( type == OBJECT_WAYPOINT    )  proto.modelName = "waypoint.mod";
+    if ( type == OBJECT_SHOW        )  proto.modelName = "show.mod";
+    if ( type == OBJECT_WINFIRE     )  proto.modelName = "winfire.mod";
+    if ( type == OBJECT_BAG         )  proto.modelName = "bag.mod";
+    if ( type == OBJECT_MARKSTONE   )  proto.modelName = "cross1.mod";
+    if ( type == OBJECT_MARKURANIUM )  proto.modelName = "cross3.mod";
+    if ( type == OBJECT_MARKPOWER   )  proto.modelName = "cross2.mod";
+    if ( type == OBJECT_MARKKEYa    )  proto.modelName = "crossa.mod";
+    if ( type == OBJECT_MARKKEYb    )  proto.modelName = "crossb.mod";
+    if ( type == OBJECT_MARKKEYc    )  proto.modelName = "crossc.mod";
+    if ( type == OBJECT_MARKKEYd    )  proto.modelName = "crossd.mod";
+    if ( type == OBJECT_EGG         )  proto.modelName = "egg.mod";
+
+    // The mapping of the power cells changes with their energy level
+    proto.modelCopy = (type == OBJECT_POWER || type == OBJECT_ATOMIC);
+
+    if ( type == OBJECT_SHOW )  // remains in the air?
+    {
+        proto.onGround = false;
+    }
+    else if ( type == OBJECT_MARKSTONE   ||
+              type == OBJECT_MARKURANIUM ||
+              type == OBJECT_MARKKEYa    ||
+              type == OBJECT_MARKKEYb    ||
+              type == OBJECT_MARKKEYc    ||
+              type == OBJECT_MARKKEYd    ||
+              type == OBJECT_MARKPOWER   ||
+              type == OBJECT_WAYPOINT    )
     {
     }
     else if ( type == OBJECT_EGG )
     {
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-1.0f, 2.8f, 0.0f), 3.0f, SOUND_BOUMm, 0.45f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 5.0f, 0.0f), 10.0f));
-        radius = 3.0f;
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-1.0f, 2.8f, 0.0f), 3.0f, SOUND_BOUMm, 0.45f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 5.0f, 0.0f), 10.0f);
+        proto.hasCameraSphere = true;
+        proto.shadowRadius = 3.0f;
     }
     else if ( type == OBJECT_BOMB )
     {
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 3.0f, SOUND_BOUMm, 0.45f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 3.0f));
-        radius = 3.0f;
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 3.0f, SOUND_BOUMm, 0.45f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 3.0f);
+        proto.hasCameraSphere = true;
+        proto.shadowRadius = 3.0f;
     }
     else if ( type == OBJECT_BAG )
     {
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f, SOUND_BOUMm, 0.45f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f));
-        obj->SetScale(1.5f);
-        radius =  5.0f;
-        height = -1.4f;
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f, SOUND_BOUMm, 0.45f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f);
+        proto.hasCameraSphere = true;
+        proto.scale = 1.5f;
+        proto.shadowRadius = 5.0f;
+        proto.height = -1.4f;
     }
     else
     {
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 1.0f, 0.0f), 1.0f, SOUND_BOUMm, 0.45f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 1.0f, 0.0f), 1.5f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 1.0f, 0.0f), 1.0f, SOUND_BOUMm, 0.45f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 1.0f, 0.0f), 1.5f);
+        proto.hasCameraSphere = true;
+    }
+}
+
+// Describes a plant or a tree.
+
+void CObjectFactory::BuildPlantPrototype(ObjectPrototype& proto, ObjectType type)
+{
+    if ( type == OBJECT_PLANT0 ||
+         type == OBJECT_PLANT1 ||
+         type == OBJECT_PLANT2 ||
+         type == OBJECT_PLANT3 ||
+         type == OBJECT_PLANT4 )  // standard?
+    {
+        if ( type == OBJECT_PLANT0 )  proto.modelName = "plant0.mod";
+        if ( type == OBJECT_PLANT1 )  proto.modelName = "plant1.mod";
+        if ( type == OBJECT_PLANT2 )  proto.modelName = "plant2.mod";
+        if ( type == OBJECT_PLANT3 )  proto.modelName = "plant3.mod";
+        if ( type == OBJECT_PLANT4 )  proto.modelName = "plant4.mod";
+
+        proto.height = -2.0f;
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 6.0f);
+        proto.hasCameraSphere = true;
+        proto.jostlingSphere = Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 8.0f);
+        proto.hasJostlingSphere = true;
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.5f;
     }
 
-    obj->CreateShadowCircle(radius, 1.0f);
+    if ( type == OBJECT_PLANT5 ||
+         type == OBJECT_PLANT6 ||
+         type == OBJECT_PLANT7 )  // clover?
+    {
+        if ( type == OBJECT_PLANT5 )  proto.modelName = "plant5.mod";
+        if ( type == OBJECT_PLANT6 )  proto.modelName = "plant6.mod";
+        if ( type == OBJECT_PLANT7 )  proto.modelName = "plant7.mod";
+
+//?     proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 3.0f, SOUND_BOUM, 0.10f));
+        proto.jostlingSphere = Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f);
+        proto.hasJostlingSphere = true;
+
+        proto.shadowRadius = 5.0f;
+        proto.shadowIntensity = 0.3f;
+    }
+
+    if ( type == OBJECT_PLANT8 ||
+         type == OBJECT_PLANT9 )  // squash?
+    {
+        if ( type == OBJECT_PLANT8 )  proto.modelName = "plant8.mod";
+        if ( type == OBJECT_PLANT9 )  proto.modelName = "plant9.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f,  2.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 10.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
+
+        proto.shadowRadius = 10.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_PLANT10 ||
+         type == OBJECT_PLANT11 ||
+         type == OBJECT_PLANT12 ||
+         type == OBJECT_PLANT13 ||
+         type == OBJECT_PLANT14 )  // succulent?
+    {
+        if ( type == OBJECT_PLANT10 )  proto.modelName = "plant10.mod";
+        if ( type == OBJECT_PLANT11 )  proto.modelName = "plant11.mod";
+        if ( type == OBJECT_PLANT12 )  proto.modelName = "plant12.mod";
+        if ( type == OBJECT_PLANT13 )  proto.modelName = "plant13.mod";
+        if ( type == OBJECT_PLANT14 )  proto.modelName = "plant14.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 12.0f, 0.0f), 5.0f, SOUND_BOUM, 0.10f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 6.0f, 0.0f), 6.0f);
+        proto.hasCameraSphere = true;
+        proto.jostlingSphere = Math::Sphere(Math::Vector(0.0f, 4.0f, 0.0f), 8.0f);
+        proto.hasJostlingSphere = true;
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.3f;
+    }
+
+    if ( type == OBJECT_PLANT15 ||
+         type == OBJECT_PLANT16 ||
+         type == OBJECT_PLANT17 ||
+         type == OBJECT_PLANT18 ||
+         type == OBJECT_PLANT19 )  // fern?
+    {
+        if ( type == OBJECT_PLANT15 )  proto.modelName = "plant15.mod";
+        if ( type == OBJECT_PLANT16 )  proto.modelName = "plant16.mod";
+        if ( type == OBJECT_PLANT17 )  proto.modelName = "plant17.mod";
+        if ( type == OBJECT_PLANT18 )  proto.modelName = "plant18.mod";
+        if ( type == OBJECT_PLANT19 )  proto.modelName = "plant19.mod";
+
+        if ( type != OBJECT_PLANT19 )
+        {
+            proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
+            proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 6.0f);
+            proto.hasCameraSphere = true;
+        }
+        proto.jostlingSphere = Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 8.0f);
+        proto.hasJostlingSphere = true;
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_TREE0 )
+    {
+        proto.modelName = "tree0.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 0.0f,  3.0f, 2.0f), 3.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-1.0f, 10.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 0.0f, 17.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 1.0f, 27.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_TREE1 )
+    {
+        proto.modelName = "tree1.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 0.0f,  3.0f, 2.0f), 3.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-2.0f, 11.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-2.0f, 19.0f, 2.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 2.0f, 26.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 2.0f, 34.0f,-2.0f), 2.0f, SOUND_BOUMs, 0.20f));
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_TREE2 )
+    {
+        proto.modelName = "tree2.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 0.0f,  3.0f, 1.0f), 3.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-2.0f, 10.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-2.0f, 19.0f, 2.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 2.0f, 25.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 3.0f, 32.0f,-2.0f), 2.0f, SOUND_BOUMs, 0.20f));
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_TREE3 )
+    {
+        proto.modelName = "tree3.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-2.0f,  3.0f, 2.0f), 3.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-3.0f,  9.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 0.0f, 18.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 0.0f, 27.0f, 7.0f), 2.0f, SOUND_BOUMs, 0.20f));
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_TREE4 )
+    {
+        proto.modelName = "tree4.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 10.0f, 0.0f), 10.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 21.0f, 0.0f),  8.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 32.0f, 0.0f),  7.0f, SOUND_BOUMs, 0.20f));
+
+        proto.shadowRadius = 8.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_TREE5 )  // giant tree (for the world "teen")
+    {
+        proto.modelName = "tree5.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(  0.0f, 5.0f,-10.0f), 25.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(-65.0f, 5.0f, 65.0f), 20.0f, SOUND_BOUMs, 0.20f));
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector( 38.0f, 5.0f, 21.0f), 18.0f, SOUND_BOUMs, 0.20f));
+
+        proto.shadowRadius = 50.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+}
+
+// Describes a mushroom.
+
+void CObjectFactory::BuildMushroomPrototype(ObjectPrototype& proto, ObjectType type)
+{
+    if ( type == OBJECT_MUSHROOM1 )
+    {
+        proto.modelName = "mush1.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 4.0f, 0.0f), 3.0f, SOUND_BOUM, 0.10f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 5.5f);
+        proto.hasCameraSphere = true;
+        proto.jostlingSphere = Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 5.5f);
+        proto.hasJostlingSphere = true;
+
+        proto.shadowRadius = 6.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+
+    if ( type == OBJECT_MUSHROOM2 )
+    {
+        proto.modelName = "mush2.mod";
+
+        proto.crashSpheres.push_back(CrashSphere(Math::Vector(0.0f, 5.0f, 0.0f), 3.0f, SOUND_BOUM, 0.10f));
+        proto.cameraSphere = Math::Sphere(Math::Vector(0.0f, 4.0f, 0.0f), 5.5f);
+        proto.hasCameraSphere = true;
+        proto.jostlingSphere = Math::Sphere(Math::Vector(0.0f, 4.0f, 0.0f), 5.5f);
+        proto.hasJostlingSphere = true;
+
+        proto.shadowRadius = 5.0f;
+        proto.shadowIntensity = 0.5f;
+    }
+}
+
+// Creates a small resource set on the ground.
+
+CObjectUPtr CObjectFactory::CreateResource(const ObjectCreateParams& params)
+{
+    Math::Vector pos = params.pos;
+    float angle = params.angle;
+    ObjectType type = params.type;
+    float power = params.power;
+
+    auto obj = MakeUnique<COldObject>(params.id);
+
+    obj->SetType(type);
+    obj->SetTeam(params.team);
+    obj->SetEnergyLevel(power);
+
+    const ObjectPrototype& proto = GetPrototype(type, obj->GetTeam(), false);
+    ClonePrototype(proto, obj.get(), pos, angle);
+
+    if ( !proto.onGround )
+    {
+        return std::move(obj);
+    }
 
     obj->SetFloorHeight(0.0f);
     AddObjectAuto(obj.get());
-    m_engine->LoadAllTextures();
+    obj->LoadTextures();
     obj->FloorAdjust();
 
     pos = obj->GetPosition();
-    pos.y += height;
+    pos.y += proto.height;
     obj->SetPosition(pos);  // to display the shadows immediately
 
     return std::move(obj);
@@ -488,7 +808,7 @@ CObjectUPtr CObjectFactory::CreateFlag(const ObjectCreateParams& params)
 
     obj->SetFloorHeight(0.0f);
     AddObjectAuto(obj.get());
-    m_engine->LoadAllTextures();
+    obj->LoadTextures();
     obj->FloorAdjust();
 
     pos = obj->GetPosition();
@@ -651,220 +971,9 @@ CObjectUPtr CObjectFactory::CreatePlant(const ObjectCreateParams& params)
     obj->SetType(type);
     obj->SetTeam(params.team);
 
-    if ( type == OBJECT_PLANT0 ||
-         type == OBJECT_PLANT1 ||
-         type == OBJECT_PLANT2 ||
-         type == OBJECT_PLANT3 ||
-         type == OBJECT_PLANT4 )  // standard?
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        if ( type == OBJECT_PLANT0 )  m_oldModelManager->AddModelReference("plant0.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT1 )  m_oldModelManager->AddModelReference("plant1.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT2 )  m_oldModelManager->AddModelReference("plant2.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT3 )  m_oldModelManager->AddModelReference("plant3.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT4 )  m_oldModelManager->AddModelReference("plant4.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        height -= 2.0f;
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 6.0f));
-        obj->SetJostlingSphere(Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 8.0f));
-
-        obj->CreateShadowCircle(8.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_PLANT5 ||
-         type == OBJECT_PLANT6 ||
-         type == OBJECT_PLANT7 )  // clover?
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        if ( type == OBJECT_PLANT5 )  m_oldModelManager->AddModelReference("plant5.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT6 )  m_oldModelManager->AddModelReference("plant6.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT7 )  m_oldModelManager->AddModelReference("plant7.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-//?     obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 3.0f, SOUND_BOUM, 0.10f));
-        obj->SetJostlingSphere(Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f));
-
-        obj->CreateShadowCircle(5.0f, 0.3f);
-    }
-
-    if ( type == OBJECT_PLANT8 ||
-         type == OBJECT_PLANT9 )  // squash?
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        if ( type == OBJECT_PLANT8 )  m_oldModelManager->AddModelReference("plant8.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT9 )  m_oldModelManager->AddModelReference("plant9.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f,  2.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 10.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
-
-        obj->CreateShadowCircle(10.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_PLANT10 ||
-         type == OBJECT_PLANT11 ||
-         type == OBJECT_PLANT12 ||
-         type == OBJECT_PLANT13 ||
-         type == OBJECT_PLANT14 )  // succulent?
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        if ( type == OBJECT_PLANT10 )  m_oldModelManager->AddModelReference("plant10.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT11 )  m_oldModelManager->AddModelReference("plant11.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT12 )  m_oldModelManager->AddModelReference("plant12.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT13 )  m_oldModelManager->AddModelReference("plant13.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT14 )  m_oldModelManager->AddModelReference("plant14.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 12.0f, 0.0f), 5.0f, SOUND_BOUM, 0.10f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 6.0f, 0.0f), 6.0f));
-        obj->SetJostlingSphere(Math::Sphere(Math::Vector(0.0f, 4.0f, 0.0f), 8.0f));
-
-        obj->CreateShadowCircle(8.0f, 0.3f);
-    }
-
-    if ( type == OBJECT_PLANT15 ||
-         type == OBJECT_PLANT16 ||
-         type == OBJECT_PLANT17 ||
-         type == OBJECT_PLANT18 ||
-         type == OBJECT_PLANT19 )  // fern?
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        if ( type == OBJECT_PLANT15 )  m_oldModelManager->AddModelReference("plant15.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT16 )  m_oldModelManager->AddModelReference("plant16.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT17 )  m_oldModelManager->AddModelReference("plant17.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT18 )  m_oldModelManager->AddModelReference("plant18.mod", false, rank, obj->GetTeam());
-        if ( type == OBJECT_PLANT19 )  m_oldModelManager->AddModelReference("plant19.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        if ( type != OBJECT_PLANT19 )
-        {
-            obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 0.0f, 0.0f), 4.0f, SOUND_BOUM, 0.10f));
-            obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 6.0f));
-        }
-        obj->SetJostlingSphere(Math::Sphere(Math::Vector(0.0f, 0.0f, 0.0f), 8.0f));
-
-        obj->CreateShadowCircle(8.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_TREE0 )
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("tree0.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 0.0f,  3.0f, 2.0f), 3.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-1.0f, 10.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 0.0f, 17.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 1.0f, 27.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
-
-        obj->CreateShadowCircle(8.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_TREE1 )
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("tree1.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 0.0f,  3.0f, 2.0f), 3.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-2.0f, 11.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-2.0f, 19.0f, 2.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 2.0f, 26.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 2.0f, 34.0f,-2.0f), 2.0f, SOUND_BOUMs, 0.20f));
-
-        obj->CreateShadowCircle(8.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_TREE2 )
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("tree2.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 0.0f,  3.0f, 1.0f), 3.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-2.0f, 10.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-2.0f, 19.0f, 2.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 2.0f, 25.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 3.0f, 32.0f,-2.0f), 2.0f, SOUND_BOUMs, 0.20f));
-
-        obj->CreateShadowCircle(8.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_TREE3 )
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("tree3.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-2.0f,  3.0f, 2.0f), 3.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-3.0f,  9.0f, 1.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 0.0f, 18.0f, 0.0f), 2.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 0.0f, 27.0f, 7.0f), 2.0f, SOUND_BOUMs, 0.20f));
-
-        obj->CreateShadowCircle(8.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_TREE4 )
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("tree4.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 10.0f, 0.0f), 10.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 21.0f, 0.0f),  8.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 32.0f, 0.0f),  7.0f, SOUND_BOUMs, 0.20f));
-
-        obj->CreateShadowCircle(8.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_TREE5 )  // giant tree (for the world "teen")
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("tree5.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(  0.0f, 5.0f,-10.0f), 25.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector(-65.0f, 5.0f, 65.0f), 20.0f, SOUND_BOUMs, 0.20f));
-        obj->AddCrashSphere(CrashSphere(Math::Vector( 38.0f, 5.0f, 21.0f), 18.0f, SOUND_BOUMs, 0.20f));
-
-        obj->CreateShadowCircle(50.0f, 0.5f);
-    }
+    const ObjectPrototype& proto = GetPrototype(type, obj->GetTeam(), false);
+    ClonePrototype(proto, obj.get(), pos, angle);
+    height += proto.height;
 
     pos = obj->GetPosition();
     obj->SetPosition(pos);  // to display the shadows immediately
@@ -893,37 +1002,8 @@ CObjectUPtr CObjectFactory::CreateMushroom(const ObjectCreateParams& params)
     obj->SetType(type);
     obj->SetTeam(params.team);
 
-    if ( type == OBJECT_MUSHROOM1 )
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("mush1.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 4.0f, 0.0f), 3.0f, SOUND_BOUM, 0.10f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 5.5f));
-        obj->SetJostlingSphere(Math::Sphere(Math::Vector(0.0f, 3.0f, 0.0f), 5.5f));
-
-        obj->CreateShadowCircle(6.0f, 0.5f);
-    }
-
-    if ( type == OBJECT_MUSHROOM2 )
-    {
-        int rank = m_engine->CreateObject();
-        m_engine->SetObjectType(rank, Gfx::ENG_OBJTYPE_FIX);
-        obj->SetObjectRank(0, rank);
-        m_oldModelManager->AddModelReference("mush2.mod", false, rank, obj->GetTeam());
-        obj->SetPosition(pos);
-        obj->SetRotationY(angle);
-
-        obj->AddCrashSphere(CrashSphere(Math::Vector(0.0f, 5.0f, 0.0f), 3.0f, SOUND_BOUM, 0.10f));
-        obj->SetCameraCollisionSphere(Math::Sphere(Math::Vector(0.0f, 4.0f, 0.0f), 5.5f));
-        obj->SetJostlingSphere(Math::Sphere(Math::Vector(0.0f, 4.0f, 0.0f), 5.5f));
-
-        obj->CreateShadowCircle(5.0f, 0.5f);
-    }
+    const ObjectPrototype& proto = GetPrototype(type, obj->GetTeam(), false);
+    ClonePrototype(proto, obj.get(), pos, angle);
 
     pos = obj->GetPosition();
     obj->SetPosition(pos);  // to display the shadows immediately
@@ -24,11 +24,16 @@
 
 #pragma once
 
+#include "math/sphere.h"
 #include "math/vector.h"
 
+#include "object/crash_sphere.h"
 #include "object/object_type.h"
 
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Gfx
 {
@@ -57,6 +62,53 @@ public:
     CObjectUPtr CreateObject(const ObjectCreateParams& params);
 
 private:
+    //! Instance-independent description of an object made of a single model,
+    //! shared by all objects of the same type, model variant and mirroring
+    struct ObjectPrototype
+    {
+        std::string modelName;
+        //! Model variant and mirroring, as passed to COldModelManager
+        int variant = 0;
+        bool mirrored = false;
+        //! Whether each instance needs its own copy of the model
+        bool modelCopy = false;
+        //! Whether the object gets collision spheres and a shadow
+        bool onGround = true;
+        std::vector<CrashSphere> crashSpheres;
+        bool hasCameraSphere = false;
+        Math::Sphere cameraSphere;
+        bool hasJostlingSphere = false;
+        Math::Sphere jostlingSphere;
+        float scale = 1.0f;
+        float shadowRadius = 1.5f;
+        float shadowIntensity = 1.0f;
+        //! Added to the height of the instance
+        float height = 0.0f;
+    };
+
+    struct PrototypeKey
+    {
+        ObjectType type;
+        int variant;
+        bool mirrored;
+
+        inline bool operator<(const PrototypeKey& other) const
+        {
+            if (type != other.type)
+                return type < other.type;
+            if (variant != other.variant)
+                return variant < other.variant;
+            return !mirrored && other.mirrored;
+        }
+    };
+
+    const ObjectPrototype& GetPrototype(ObjectType type, int variant, bool mirrored);
+    void BuildResourcePrototype(ObjectPrototype& proto, ObjectType type);
+    void BuildPlantPrototype(ObjectPrototype& proto, ObjectType type);
+    void BuildMushroomPrototype(ObjectPrototype& proto, ObjectType type);
+    //! Creates the engine object of a new instance of \a proto and sets up \a obj from it
+    void ClonePrototype(const ObjectPrototype& proto, COldObject* obj, Math::Vector pos, float angle);
+
     CObjectUPtr CreateResource(const ObjectCreateParams& params);
     CObjectUPtr CreateFlag(const ObjectCreateParams& params);
     CObjectUPtr CreateBarrier(const ObjectCreateParams& params);
@@ -76,4 +128,5 @@ private:
     Gfx::COldModelManager* m_oldModelManager;
     Gfx::CModelManager* m_modelManager;
     Gfx::CParticle* m_particle;
+    std::map<PrototypeKey, ObjectPrototype> m_prototypes;
 };
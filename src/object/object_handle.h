@@ -0,0 +1,56 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/object_handle.h
+ * \brief ObjectHandle struct
+ */
+
+#pragma once
+
+/**
+ * \struct ObjectHandle
+ * \brief Weak reference to an object owned by CObjectManager
+ *
+ * A handle is the slot of the object in CObjectManager and the generation of
+ * that slot. The generation changes when the object is deleted, so a handle
+ * to a deleted object resolves to nullptr in CObjectManager::GetObjectByHandle(),
+ * even if the slot is reused.
+ */
+struct ObjectHandle
+{
+    unsigned int slot = 0;
+    //! 0 for the null handle, slots start at generation 1
+    unsigned int generation = 0;
+
+    bool IsNull() const
+    {
+        return generation == 0;
+    }
+
+    bool operator==(const ObjectHandle& other) const
+    {
+        return slot == other.slot && generation == other.generation;
+    }
+
+    bool operator!=(const ObjectHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
@@ -0,0 +1,115 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/object_id_map.h"
+
+#include <cassert>
+
+CObjectIdMap::CObjectIdMap()
+    : m_size(0)
+{
+}
+
+int CObjectIdMap::Find(int id) const
+{
+    if (id < 0 || m_entries.empty()) return -1;
+
+    std::size_t mask = m_entries.size() - 1;
+    for (std::size_t index = GetHome(id); m_entries[index].id != -1; index = (index + 1) & mask)
+    {
+        if (m_entries[index].id == id) return m_entries[index].slot;
+    }
+    return -1;
+}
+
+void CObjectIdMap::Insert(int id, int slot)
+{
+    assert(id >= 0);
+
+    // Keep the load factor under 1/2, so probe sequences stay short
+    if (2 * (m_size + 1) > m_entries.size())
+        Grow();
+
+    std::size_t mask = m_entries.size() - 1;
+    std::size_t index = GetHome(id);
+    while (m_entries[index].id != -1 && m_entries[index].id != id)
+        index = (index + 1) & mask;
+
+    if (m_entries[index].id == -1)
+        m_size++;
+    m_entries[index].id = id;
+    m_entries[index].slot = slot;
+}
+
+void CObjectIdMap::Erase(int id)
+{
+    if (id < 0 || m_entries.empty()) return;
+
+    std::size_t mask = m_entries.size() - 1;
+    std::size_t index = GetHome(id);
+    while (m_entries[index].id != id)
+    {
+        if (m_entries[index].id == -1) return;
+        index = (index + 1) & mask;
+    }
+
+    // Moves back the following entries which would not be found anymore across the hole
+    std::size_t hole = index;
+    for (index = (hole + 1) & mask; m_entries[index].id != -1; index = (index + 1) & mask)
+    {
+        std::size_t home = GetHome(m_entries[index].id);
+        if (((index - home) & mask) >= ((index - hole) & mask))
+        {
+            m_entries[hole] = m_entries[index];
+            hole = index;
+        }
+    }
+    m_entries[hole] = Entry();
+    m_size--;
+}
+
+void CObjectIdMap::Clear()
+{
+    m_entries.clear();
+    m_size = 0;
+}
+
+std::size_t CObjectIdMap::GetSize() const
+{
+    return m_size;
+}
+
+std::size_t CObjectIdMap::GetHome(int id) const
+{
+    // Ids are mostly consecutive, mix them so that their neighbours do not cluster
+    unsigned int hash = static_cast<unsigned int>(id) * 2654435769u;
+    hash ^= hash >> 16;
+    return hash & (m_entries.size() - 1);
+}
+
+void CObjectIdMap::Grow()
+{
+    std::vector<Entry> entries(m_entries.empty() ? 64 : 2 * m_entries.size());
+    entries.swap(m_entries);
+    m_size = 0;
+    for (const Entry& entry : entries)
+    {
+        if (entry.id != -1) Insert(entry.id, entry.slot);
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/object_id_map.h
+ * \brief Flat hash map from object ids to slots
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * \class CObjectIdMap
+ * \brief Open addressing hash map from object ids to slots of CObjectManager
+ *
+ * Ids come from save files and scene files, so they may be large and sparse.
+ * The table only grows with the number of stored ids, not with their values.
+ * Keys are kept in one flat array with linear probing, removal shifts the
+ * following entries back, so there are no tombstones.
+ */
+class CObjectIdMap
+{
+public:
+    CObjectIdMap();
+
+    //! Returns the slot stored for the id, -1 if none
+    int         Find(int id) const;
+    //! Stores the slot for the id, replacing the previous one
+    void        Insert(int id, int slot);
+    //! Removes the id, does nothing if it is not stored
+    void        Erase(int id);
+    //! Removes all ids
+    void        Clear();
+
+    //! Returns the number of stored ids
+    std::size_t GetSize() const;
+
+private:
+    struct Entry
+    {
+        //! -1 if the entry is empty
+        int id = -1;
+        int slot = -1;
+    };
+
+    std::size_t GetHome(int id) const;
+    void        Grow();
+
+private:
+    std::vector<Entry> m_entries;
+    std::size_t m_size;
+};
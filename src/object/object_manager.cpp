@@ -22,33 +22,68 @@
 #include "common/global.h"
 #include "common/make_unique.h"
 
+#include "graphics/engine/engine.h"
+
 #include "math/all.h"
 
+#include "object/nav_grid.h"
 #include "object/object.h"
 #include "object/object_create_exception.h"
 #include "object/object_create_params.h"
 #include "object/object_factory.h"
+#include "object/obstacle_field.h"
 #include "object/old_object.h"
+#include "object/part_transform_pool.h"
+#include "object/path_cache.h"
+#include "object/world_query.h"
 
 #include "object/auto/auto.h"
 
+#include "object/interface/transportable_object.h"
+
 #include "physics/physics.h"
 
 #include <algorithm>
+#include <iterator>
+#include <limits>
+
+CObjectContainerProxy::CObjectContainerProxy(CObjectManager& manager, const std::vector<ObjectEntry>& objects)
+  : m_manager(manager),
+    m_objects(objects),
+    m_next(0)
+{
+    m_manager.BeginIteration(this);
+}
+
+CObjectContainerProxy::CObjectContainerProxy(CObjectContainerProxy&& other)
+  : m_manager(other.m_manager),
+    m_objects(other.m_objects),
+    m_next(other.m_next)
+{
+    m_manager.BeginIteration(this);
+}
+
+CObjectContainerProxy::~CObjectContainerProxy()
+{
+    m_manager.EndIteration(this);
+}
 
 CObjectManager::CObjectManager(Gfx::CEngine* engine,
                                Gfx::CTerrain* terrain,
                                Gfx::COldModelManager* oldModelManager,
                                Gfx::CModelManager* modelManager,
                                Gfx::CParticle* particle)
-  : m_objectFactory(MakeUnique<CObjectFactory>(engine,
+  : m_partTransformPool(MakeUnique<CPartTransformPool>()),
+    m_navGrid(MakeUnique<CNavGrid>(terrain, engine->GetWater(), [this](CNavGrid& grid) { UpdateNavGrid(grid); })),
+    m_pathCache(MakeUnique<CPathCache>(m_navGrid.get())),
+    m_obstacleField(MakeUnique<CObstacleField>()),
+    m_worldQuery(MakeUnique<CWorldQuery>([this](CWorldQuery& query) { UpdateWorldQuery(query); })),
+    m_objectFactory(MakeUnique<CObjectFactory>(engine,
                                                terrain,
                                                oldModelManager,
                                                modelManager,
                                                particle)),
-    m_nextId(0),
-    m_activeObjectIterators(0),
-    m_shouldCleanRemovedObjects(false)
+    m_nextId(0)
 {
 }
 
@@ -65,41 +100,91 @@ bool CObjectManager::DeleteObject(CObject* instance)
     if (oldObj != nullptr)
         oldObj->DeleteObject();
 
-    auto it = m_objects.find(instance->GetID());
-    if (it != m_objects.end())
+    int id = instance->GetID();
+    int slot = GetSlotById(id);
+    if (slot != -1 && m_slots[slot].object.get() == instance)
     {
-        it->second.reset();
-        m_shouldCleanRemovedObjects = true;
+        RemoveDenseEntry(m_slots[slot].denseIndex);
+
+        m_idSlots.Erase(id);
+        m_slots[slot].generation ++;
+        m_freeSlots.push_back(slot);
+        // Running iterations may still use the object, it is freed after them
+        if (!m_iterations.empty())
+            m_deletedObjects.push_back(std::move(m_slots[slot].object));
+        else
+            m_slots[slot].object.reset();
+        m_worldQuery->SetObjectsChanged();
         return true;
     } else assert(false);
 
     return false;
 }
 
-void CObjectManager::CleanRemovedObjectsIfNeeded()
+void CObjectManager::RemoveDenseEntry(std::size_t index)
 {
-    if (m_activeObjectIterators != 0)
-        return;
+    assert(index < m_denseObjects.size());
 
-    if (! m_shouldCleanRemovedObjects)
-        return;
+    // Every iteration has visited the entries before its position and not the ones after it.
+    // The hole is moved to the end over these positions in ascending order, each time taking
+    // the last visited entry of the next iteration, so that no entry changes sides for any of them.
+    std::vector<std::size_t*> positions;
+    for (CObjectContainerProxy* iteration : m_iterations)
+    {
+        if (iteration->m_next > index && iteration->m_next <= m_denseObjects.size())
+            positions.push_back(&iteration->m_next);
+    }
+    std::sort(positions.begin(), positions.end(),
+              [](const std::size_t* a, const std::size_t* b) { return *a < *b; });
+
+    std::size_t hole = index;
+    for (std::size_t* position : positions)
+    {
+        std::size_t lastVisited = *position - 1;
+        if (lastVisited != hole)
+        {
+            m_denseObjects[hole] = m_denseObjects[lastVisited];
+            m_slots[m_denseObjects[hole].slot].denseIndex = hole;
+            hole = lastVisited;
+        }
+        *position = lastVisited;
+    }
 
-    auto it = m_objects.begin();
-    if (it != m_objects.end())
+    std::size_t last = m_denseObjects.size() - 1;
+    if (last != hole)
     {
-        if (it->second == nullptr)
-            it = m_objects.erase(it);
+        m_denseObjects[hole] = m_denseObjects[last];
+        m_slots[m_denseObjects[hole].slot].denseIndex = hole;
     }
+    m_denseObjects.pop_back();
+}
+
+void CObjectManager::BeginIteration(CObjectContainerProxy* iteration)
+{
+    m_iterations.push_back(iteration);
+}
 
-    m_shouldCleanRemovedObjects = false;
+void CObjectManager::EndIteration(CObjectContainerProxy* iteration)
+{
+    auto it = std::find(m_iterations.rbegin(), m_iterations.rend(), iteration);
+    assert(it != m_iterations.rend());
+    m_iterations.erase(std::next(it).base());
+
+    if (m_iterations.empty() && !m_deletedObjects.empty())
+    {
+        // Destructors may delete more objects, they go to the emptied list
+        std::vector<std::unique_ptr<CObject>> deletedObjects;
+        deletedObjects.swap(m_deletedObjects);
+        deletedObjects.clear();
+    }
 }
 
 void CObjectManager::DeleteAllObjects()
 {
-    for (auto& it : m_objects)
+    for (const ObjectEntry& entry : m_denseObjects)
     {
         // TODO: temporarily...
-        auto oldObj = dynamic_cast<COldObject*>(it.second.get());
+        auto oldObj = dynamic_cast<COldObject*>(entry.object);
         if (oldObj != nullptr)
         {
             bool all = true;
@@ -107,15 +192,125 @@ void CObjectManager::DeleteAllObjects()
         }
     }
 
-    m_objects.clear();
+    // Slots are kept, so handles to deleted objects stay invalid
+    std::vector<std::unique_ptr<CObject>> objects;
+    m_freeSlots.clear();
+    for (int slot = static_cast<int>(m_slots.size())-1; slot >= 0; slot--)
+    {
+        if (m_slots[slot].object != nullptr)
+        {
+            objects.push_back(std::move(m_slots[slot].object));
+            m_slots[slot].generation ++;
+        }
+        m_freeSlots.push_back(slot);
+    }
+    m_idSlots.Clear();
+    m_denseObjects.clear();
+    if (!m_iterations.empty())
+    {
+        std::move(objects.begin(), objects.end(), std::back_inserter(m_deletedObjects));
+    }
+    objects.clear();
+
+    m_navGrid->Reset();
+    m_pathCache->Clear();
+    m_obstacleField->Reset();
+    m_worldQuery->Reset();
 
     m_nextId = 0;
 }
 
+CPartTransformPool* CObjectManager::GetPartTransformPool()
+{
+    return m_partTransformPool.get();
+}
+
+CNavGrid* CObjectManager::GetNavGrid()
+{
+    return m_navGrid.get();
+}
+
+void CObjectManager::UpdateNavGrid(CNavGrid& grid)
+{
+    for (CObject* obj : GetAllObjects())
+    {
+        if (IsObjectBeingTransported(obj)) continue;
+
+        grid.SetObstacle(obj->GetID(), obj, obj->GetType(), obj->GetPosition(), obj->GetRotationY(),
+                         [obj](std::vector<Math::Sphere>& spheres)
+                         {
+                             for (const CrashSphere& crashSphere : obj->GetAllCrashSpheres())
+                             {
+                                 spheres.push_back(crashSphere.sphere);
+                             }
+                         });
+    }
+}
+
+CPathCache* CObjectManager::GetPathCache()
+{
+    return m_pathCache.get();
+}
+
+CObstacleField* CObjectManager::GetObstacleField()
+{
+    return m_obstacleField.get();
+}
+
+CWorldQuery* CObjectManager::GetWorldQuery()
+{
+    return m_worldQuery.get();
+}
+
+void CObjectManager::UpdateWorldQuery(CWorldQuery& query)
+{
+    for (CObject* obj : GetAllObjects())
+    {
+        query.SetObject(obj->GetID(), obj, obj->GetPosition(),
+                        [obj](std::vector<Math::Sphere>& spheres)
+                        {
+                            for (const CrashSphere& crashSphere : obj->GetAllCrashSpheres())
+                            {
+                                spheres.push_back(crashSphere.sphere);
+                            }
+                        },
+                        obj->GetCameraCollisionSphere());
+    }
+}
+
 CObject* CObjectManager::GetObjectById(unsigned int id)
 {
-    if (m_objects.count(id) == 0) return nullptr;
-    return m_objects[id].get();
+    int slot = GetSlotById(id);
+    if (slot == -1) return nullptr;
+    return m_slots[slot].object.get();
+}
+
+int CObjectManager::GetSlotById(unsigned int id)
+{
+    if (id > static_cast<unsigned int>(std::numeric_limits<int>::max())) return -1;
+    return m_idSlots.Find(static_cast<int>(id));
+}
+
+ObjectHandle CObjectManager::GetHandle(CObject* object)
+{
+    ObjectHandle handle;
+    if (object == nullptr) return handle;
+
+    int slot = GetSlotById(object->GetID());
+    if (slot == -1 || m_slots[slot].object.get() != object) return handle;
+
+    handle.slot = slot;
+    handle.generation = m_slots[slot].generation;
+    return handle;
+}
+
+CObject* CObjectManager::GetObjectByHandle(ObjectHandle handle)
+{
+    if (handle.IsNull() || handle.slot >= m_slots.size()) return nullptr;
+
+    const ObjectSlot& slot = m_slots[handle.slot];
+    if (slot.generation != handle.generation) return nullptr;
+    return slot.object.get();
 }
 
 CObject* CObjectManager::GetObjectByRank(unsigned int id)
@@ -136,13 +331,17 @@ CObject* CObjectManager::CreateObject(ObjectCreateParams params)
     }
     else
     {
+        if (params.id == std::numeric_limits<int>::max())
+        {
+            throw CObjectCreateException("Object id out of range", params.type);
+        }
         if (params.id >= m_nextId)
         {
             m_nextId = params.id + 1;
         }
     }
 
-    assert(m_objects.find(params.id) == m_objects.end());
+    assert(GetObjectById(params.id) == nullptr);
 
     auto objectUPtr = m_objectFactory->CreateObject(params);
 
@@ -151,7 +350,24 @@ CObject* CObjectManager::CreateObject(ObjectCreateParams params)
 
     CObject* objectPtr = objectUPtr.get();
 
-    m_objects[params.id] = std::move(objectUPtr);
+    int slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<int>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[slot].object = std::move(objectUPtr);
+
+    m_idSlots.Insert(params.id, slot);
+
+    m_slots[slot].denseIndex = m_denseObjects.size();
+    m_denseObjects.push_back(ObjectEntry{objectPtr, slot});
+    m_worldQuery->SetObjectsChanged();
 
     return objectPtr;
 }
@@ -282,12 +498,11 @@ std::vector<CObject*> CObjectManager::RadarAll(CObject* pThis, Math::Vector this
     // from the origin to be returned.
     std::multimap<float, CObject*> best;
 
-    for ( auto it = m_objects.begin() ; it != m_objects.end() ; ++it )
+    for (const ObjectEntry& entry : m_denseObjects)
     {
-        pObj = it->second.get();
+        pObj = entry.object;
         if ( pObj == pThis )  continue; // pThis may be nullptr but it doesn't matter
 
-        if (pObj == nullptr) continue;
         if (IsObjectBeingTransported(pObj))  continue;
         if ( !pObj->GetDetectable() )  continue;
         if ( pObj->GetProxyActivate() )  continue;
@@ -30,6 +30,8 @@
 #include "math/vector.h"
 
 #include "object/object_create_params.h"
+#include "object/object_handle.h"
+#include "object/object_id_map.h"
 #include "object/object_interface_type.h"
 #include "object/object_type.h"
 
@@ -49,7 +51,13 @@ class CTerrain;
 } // namespace Gfx
 
 class CObject;
+class CNavGrid;
+class CObstacleField;
+class CPathCache;
 class CObjectFactory;
+class CObjectManager;
+class CPartTransformPool;
+class CWorldQuery;
 
 enum RadarFilter
 {
@@ -63,84 +71,94 @@ enum RadarFilter
     FILTER_NEUTRAL     = 1 << (8+4),
 };
 
-using CObjectMap = std::map<int, std::unique_ptr<CObject>>;
-using CObjectMapCIt = std::map<int, std::unique_ptr<CObject>>::const_iterator;
+//! Object in the dense list of CObjectManager
+struct ObjectEntry
+{
+    CObject*    object;
+    //! Index in the slots of CObjectManager
+    int         slot;
+};
 
 class CObjectIteratorProxy
 {
 private:
     friend class CObjectContainerProxy;
 
-    CObjectIteratorProxy(CObjectMapCIt currentIt, CObjectMapCIt endIt)
-     : m_currentIt(currentIt)
-     , m_endIt(endIt)
-    {
-        while (m_currentIt != m_endIt && m_currentIt->second == nullptr)
-        {
-            ++m_currentIt;
-        }
-    }
+    //! \a next is nullptr for the end iterator
+    CObjectIteratorProxy(const std::vector<ObjectEntry>& objects, std::size_t* next)
+     : m_objects(objects)
+     , m_next(next)
+    {}
 
 public:
     CObject* operator*()
     {
-        return m_currentIt->second.get();
+        return m_objects[*m_next - 1].object;
     }
 
     void operator++()
     {
-        do
-        {
-            ++m_currentIt;
-        }
-        while (m_currentIt != m_endIt && m_currentIt->second == nullptr);
+        ++*m_next;
     }
 
+    // The end is not a fixed index, so objects created during the iteration are visited too
     bool operator==(const CObjectIteratorProxy& other)
     {
-        return m_currentIt == other.m_currentIt;
+        return AtEnd() == other.AtEnd() && (AtEnd() || m_next == other.m_next);
     }
 
     bool operator!=(const CObjectIteratorProxy& other)
     {
-        return m_currentIt != other.m_currentIt;
+        return !(*this == other);
+    }
+
+private:
+    bool AtEnd() const
+    {
+        return m_next == nullptr || *m_next > m_objects.size();
     }
 
 private:
-    CObjectMapCIt m_currentIt;
-    CObjectMapCIt m_endIt;
+    const std::vector<ObjectEntry>& m_objects;
+    std::size_t* m_next;
 };
 
+/**
+ * \class CObjectContainerProxy
+ * \brief Iteration over all objects of CObjectManager
+ *
+ * The position of the iteration is kept here and shared by its iterators, so that
+ * CObjectManager can move entries around it when objects are deleted.
+ */
 class CObjectContainerProxy
 {
 private:
     friend class CObjectManager;
 
-    CObjectContainerProxy(const CObjectMap& map, int& activeIteratorsCounter)
-     : m_map(map),
-       m_activeIteratorsCounter(activeIteratorsCounter)
-    {
-        ++m_activeIteratorsCounter;
-    }
+    CObjectContainerProxy(CObjectManager& manager, const std::vector<ObjectEntry>& objects);
 
 public:
-    ~CObjectContainerProxy()
-    {
-        --m_activeIteratorsCounter;
-    }
+    CObjectContainerProxy(CObjectContainerProxy&& other);
+    ~CObjectContainerProxy();
+
+    CObjectContainerProxy(const CObjectContainerProxy&) = delete;
+    CObjectContainerProxy& operator=(const CObjectContainerProxy&) = delete;
 
-    CObjectIteratorProxy begin() const
+    CObjectIteratorProxy begin()
     {
-        return CObjectIteratorProxy(m_map.begin(), m_map.end());
+        m_next = 1;
+        return CObjectIteratorProxy(m_objects, &m_next);
     }
-    CObjectIteratorProxy end() const
+    CObjectIteratorProxy end()
     {
-        return CObjectIteratorProxy(m_map.end(), m_map.end());
+        return CObjectIteratorProxy(m_objects, nullptr);
     }
 
 private:
-    const CObjectMap& m_map;
-    int& m_activeIteratorsCounter;
+    CObjectManager& m_manager;
+    const std::vector<ObjectEntry>& m_objects;
+    //! Number of entries visited so far, including the current one
+    std::size_t m_next;
 };
 
 /**
@@ -171,6 +189,11 @@ public:
     //! Finds object by id (CObject::GetID())
     CObject*  GetObjectById(unsigned int id);
 
+    //! Returns a handle to the object, which stays safe to resolve after it is deleted
+    ObjectHandle GetHandle(CObject* object);
+    //! Resolves the handle, nullptr if it is null or the object was deleted
+    CObject*  GetObjectByHandle(ObjectHandle handle);
+
     //! Gets object by id in range <0; number of objects - 1>
     CObject*  GetObjectByRank(unsigned int id);
 
@@ -187,11 +210,25 @@ public:
     //! Counts all objects implementing given interface
     int CountObjectsImplementing(ObjectInterfaceType interface);
 
+    //! Returns the pool computing part matrices of all objects
+    CPartTransformPool* GetPartTransformPool();
+
+    //! Returns the occupancy grid shared by all path finding tasks
+    CNavGrid* GetNavGrid();
+
+    //! Returns the cache of paths shared by all path finding tasks
+    CPathCache* GetPathCache();
+
+    //! Returns the distance field of obstacles used to look for free space
+    CObstacleField* GetObstacleField();
+
+    //! Returns the spatial index of objects used by segment and box queries
+    CWorldQuery* GetWorldQuery();
+
     //! Returns all objects
     CObjectContainerProxy GetAllObjects()
     {
-        CleanRemovedObjectsIfNeeded();
-        return CObjectContainerProxy(m_objects, m_activeObjectIterators);
+        return CObjectContainerProxy(*this, m_denseObjects);
     }
 
     //! Finds an object, like radar() in CBot
@@ -303,12 +340,50 @@ public:
     //@}
 
 private:
-    void CleanRemovedObjectsIfNeeded();
+    friend class CObjectContainerProxy;
+
+    //! Swap-removes the entry from m_denseObjects, keeping unvisited entries after the position of running iterations
+    void RemoveDenseEntry(std::size_t index);
+    //! Called by CObjectContainerProxy
+    //@{
+    void BeginIteration(CObjectContainerProxy* iteration);
+    void EndIteration(CObjectContainerProxy* iteration);
+    //@}
+    //! Returns the slot of the object with given id, -1 if none
+    int  GetSlotById(unsigned int id);
+    //! Gives all objects to the navigation grid, see CNavGrid::SetObstacle()
+    void UpdateNavGrid(CNavGrid& grid);
+    //! Gives all objects to the world query, see CWorldQuery::SetObject()
+    void UpdateWorldQuery(CWorldQuery& query);
 
 private:
-    CObjectMap m_objects;
+    struct ObjectSlot
+    {
+        std::unique_ptr<CObject> object;
+        //! Incremented when the object is deleted, invalidating its handles
+        unsigned int generation = 1;
+        //! Index of the object in m_denseObjects
+        std::size_t denseIndex = 0;
+    };
+
+    //! Declared before m_slots, as objects release their parts on destruction
+    std::unique_ptr<CPartTransformPool> m_partTransformPool;
+    //! Declared before m_slots, as goto tasks of objects cancel their queries on destruction
+    std::unique_ptr<CNavGrid> m_navGrid;
+    std::unique_ptr<CPathCache> m_pathCache;
+    std::unique_ptr<CObstacleField> m_obstacleField;
+    std::unique_ptr<CWorldQuery> m_worldQuery;
+    //! Storage of objects, indexed by ObjectHandle::slot
+    std::vector<ObjectSlot> m_slots;
+    std::vector<int> m_freeSlots;
+    //! Slot of each object id
+    CObjectIdMap m_idSlots;
+    //! All objects without holes, for iteration
+    std::vector<ObjectEntry> m_denseObjects;
+    //! Running iterations over m_denseObjects
+    std::vector<CObjectContainerProxy*> m_iterations;
+    //! Objects deleted during an iteration, freed after the last one ends
+    std::vector<std::unique_ptr<CObject>> m_deletedObjects;
     std::unique_ptr<CObjectFactory> m_objectFactory;
     int m_nextId;
-    int m_activeObjectIterators;
-    bool m_shouldCleanRemovedObjects;
 };
@@ -0,0 +1,433 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/obstacle_field.h"
+
+#include "math/func.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+//! Value of cells without obstacle in the distance transform
+const float TRANSFORM_INFINITY = 1.0e20f;
+
+/**
+ * \brief One dimensional squared distance transform (Felzenszwalb and Huttenlocher)
+ * \param f input values, 0 at obstacles and TRANSFORM_INFINITY elsewhere
+ * \param d receives min over q of (p-q)^2 + f(q)
+ * \param source receives the q reaching the minimum
+ * \param v buffer of n ints
+ * \param z buffer of n+1 floats
+ */
+void DistanceTransform(const float* f, int n, float* d, int* source, int* v, float* z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -TRANSFORM_INFINITY;
+    z[1] =  TRANSFORM_INFINITY;
+    for (int q = 1; q < n; q++)
+    {
+        float s = ((f[q]+q*q) - (f[v[k]]+v[k]*v[k])) / (2*q - 2*v[k]);
+        while (s <= z[k])
+        {
+            k--;
+            s = ((f[q]+q*q) - (f[v[k]]+v[k]*v[k])) / (2*q - 2*v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = TRANSFORM_INFINITY;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; q++)
+    {
+        while (z[k+1] < q) k++;
+        d[q] = (q-v[k])*(q-v[k]) + f[v[k]];
+        source[q] = v[k];
+    }
+}
+
+} // anonymous namespace
+
+
+CObstacleField::CObstacleField()
+    : m_buckets(OBSTACLE_BUCKET_COUNT*OBSTACLE_BUCKET_COUNT),
+      m_distance(OBSTACLE_GRID_SIZE*OBSTACLE_GRID_SIZE, OBSTACLE_MAX_DISTANCE),
+      m_nearest(OBSTACLE_GRID_SIZE*OBSTACLE_GRID_SIZE, -1)
+{
+}
+
+CObstacleField::~CObstacleField()
+{
+}
+
+void CObstacleField::Reset()
+{
+    m_entries.clear();
+    for (std::vector<int>& ids : m_buckets)
+    {
+        ids.clear();
+    }
+    std::fill(m_distance.begin(), m_distance.end(), OBSTACLE_MAX_DISTANCE);
+    std::fill(m_nearest.begin(), m_nearest.end(), -1);
+
+    m_dirtyMinX = m_dirtyMinY = 0;
+    m_dirtyMaxX = m_dirtyMaxY = -1;
+}
+
+void CObstacleField::BeginUpdate()
+{
+    m_seenStamp ++;
+}
+
+void CObstacleField::SetObstacle(int id, const ObstacleShape& shape)
+{
+    if (shape.spheres.empty()) return;  // removed by EndUpdate()
+
+    auto it = m_entries.find(id);
+    if (it != m_entries.end())
+    {
+        Entry& entry = it->second;
+        entry.seenStamp = m_seenStamp;
+
+        bool same = entry.shape.hideInner == shape.hideInner &&
+                    entry.shape.spheres.size() == shape.spheres.size();
+        for (std::size_t i = 0; same && i < shape.spheres.size(); i++)
+        {
+            const Math::Sphere& a = entry.shape.spheres[i];
+            const Math::Sphere& b = shape.spheres[i];
+            same = a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.pos.z == b.pos.z && a.radius == b.radius;
+        }
+        if (same) return;
+
+        IndexEntry(id, entry, false);
+        entry.shape = shape;
+        IndexEntry(id, entry, true);
+        return;
+    }
+
+    Entry& entry = m_entries[id];
+    entry.seenStamp = m_seenStamp;
+    entry.shape = shape;
+    IndexEntry(id, entry, true);
+}
+
+void CObstacleField::EndUpdate()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        if (it->second.seenStamp != m_seenStamp)
+        {
+            IndexEntry(it->first, it->second, false);
+            it = m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (m_dirtyMinX > m_dirtyMaxX) return;
+
+    ComputeField(m_dirtyMinX, m_dirtyMinY, m_dirtyMaxX, m_dirtyMaxY);
+    m_dirtyMinX = m_dirtyMinY = 0;
+    m_dirtyMaxX = m_dirtyMaxY = -1;
+}
+
+float CObstacleField::GetDistance(const Math::Vector& center, int excludeId, float below)
+{
+    float best = OBSTACLE_NONE_DISTANCE;
+
+    int x = PosToCell(center.x);
+    int y = PosToCell(center.z);
+    if (x < 0 || x >= OBSTACLE_GRID_SIZE ||
+        y < 0 || y >= OBSTACLE_GRID_SIZE)  // outside of the world?
+    {
+        for (const auto& it : m_entries)
+        {
+            if (it.first == excludeId) continue;
+            best = Math::Min(best, Evaluate(it.second.shape, center));
+        }
+        return best;
+    }
+
+    // The nearest obstacle of the cell gives an upper bound,
+    // which is enough if it is below the lower bound or the threshold
+    int index = x+y*OBSTACLE_GRID_SIZE;
+    int nearest = m_nearest[index];
+    if (nearest != -1 && nearest != excludeId)
+    {
+        auto it = m_entries.find(nearest);
+        if (it != m_entries.end())
+        {
+            best = Evaluate(it->second.shape, center);
+            if (best < below || best <= m_distance[index]) return best;
+        }
+    }
+
+    // Visits rings of buckets around the position; obstacles not visited yet
+    // are out of the square of rings visited so far, so at least that far away
+    m_queryStamp ++;
+    int bx = x/OBSTACLE_BUCKET_SIZE;
+    int by = y/OBSTACLE_BUCKET_SIZE;
+    const float bucketSize = OBSTACLE_BUCKET_SIZE*OBSTACLE_CELL_SIZE;
+    for (int ring = 0; ring < OBSTACLE_BUCKET_COUNT; ring++)
+    {
+        if (ring > 0 && best <= (ring-1)*bucketSize) break;
+
+        int minX = bx-ring, maxX = bx+ring;
+        int minY = by-ring, maxY = by+ring;
+        if (minX < 0 && minY < 0 &&
+            maxX >= OBSTACLE_BUCKET_COUNT && maxY >= OBSTACLE_BUCKET_COUNT)  break;
+
+        for (int j = Math::Max(minY, 0); j <= Math::Min(maxY, OBSTACLE_BUCKET_COUNT-1); j++)
+        {
+            bool edge = (j == minY || j == maxY);
+            int step = edge ? 1 : maxX-minX;
+            for (int i = minX; i <= maxX; i += Math::Max(step, 1))
+            {
+                if (i < 0 || i >= OBSTACLE_BUCKET_COUNT) continue;
+
+                for (int id : m_buckets[i+j*OBSTACLE_BUCKET_COUNT])
+                {
+                    if (id == excludeId) continue;
+                    Entry& entry = m_entries[id];
+                    if (entry.queryStamp == m_queryStamp) continue;
+                    entry.queryStamp = m_queryStamp;
+
+                    best = Math::Min(best, Evaluate(entry.shape, center));
+                }
+            }
+        }
+
+        if (best < below) return best;
+    }
+    return best;
+}
+
+float CObstacleField::GetLowerBound(float x, float z)
+{
+    int cx = PosToCell(x);
+    int cy = PosToCell(z);
+    if (cx < 0 || cx >= OBSTACLE_GRID_SIZE ||
+        cy < 0 || cy >= OBSTACLE_GRID_SIZE)  return 0.0f;
+
+    return m_distance[cx+cy*OBSTACLE_GRID_SIZE];
+}
+
+int CObstacleField::PosToCell(float coord)
+{
+    return static_cast<int>(std::floor((coord+OBSTACLE_GRID_SIZE*OBSTACLE_CELL_SIZE/2.0f)/OBSTACLE_CELL_SIZE));
+}
+
+float CObstacleField::Evaluate(const ObstacleShape& shape, const Math::Vector& center)
+{
+    std::size_t first = 0;
+    if (shape.hideInner)
+    {
+        const Math::Sphere& outer = shape.spheres[0];
+        if (outer.pos.x != center.x ||
+            outer.pos.z != center.z)
+        {
+            float dist = Math::Distance(center, outer.pos) - outer.radius;
+            if (dist < 0.0f) dist = 0.0f;
+            return dist;
+        }
+        first = 1;
+    }
+
+    float min = OBSTACLE_NONE_DISTANCE;
+    for (std::size_t i = first; i < shape.spheres.size(); i++)
+    {
+        float dist = Math::Distance(center, shape.spheres[i].pos) - shape.spheres[i].radius;
+        if (dist < 0.0f) dist = 0.0f;
+        min = Math::Min(min, dist);
+    }
+    return min;
+}
+
+void CObstacleField::IndexEntry(int id, Entry& entry, bool add)
+{
+    if (add)
+    {
+        float minX =  1.0e6f, minZ =  1.0e6f;
+        float maxX = -1.0e6f, maxZ = -1.0e6f;
+        for (const Math::Sphere& sphere : entry.shape.spheres)
+        {
+            minX = Math::Min(minX, sphere.pos.x-sphere.radius);
+            minZ = Math::Min(minZ, sphere.pos.z-sphere.radius);
+            maxX = Math::Max(maxX, sphere.pos.x+sphere.radius);
+            maxZ = Math::Max(maxZ, sphere.pos.z+sphere.radius);
+        }
+
+        entry.minX = Math::Clamp(PosToCell(minX), 0, OBSTACLE_GRID_SIZE-1);
+        entry.minY = Math::Clamp(PosToCell(minZ), 0, OBSTACLE_GRID_SIZE-1);
+        entry.maxX = Math::Clamp(PosToCell(maxX), 0, OBSTACLE_GRID_SIZE-1);
+        entry.maxY = Math::Clamp(PosToCell(maxZ), 0, OBSTACLE_GRID_SIZE-1);
+    }
+
+    for (int j = entry.minY/OBSTACLE_BUCKET_SIZE; j <= entry.maxY/OBSTACLE_BUCKET_SIZE; j++)
+    {
+        for (int i = entry.minX/OBSTACLE_BUCKET_SIZE; i <= entry.maxX/OBSTACLE_BUCKET_SIZE; i++)
+        {
+            std::vector<int>& ids = m_buckets[i+j*OBSTACLE_BUCKET_COUNT];
+            if (add)
+                ids.push_back(id);
+            else
+                ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        }
+    }
+    AddDirty(entry.minX, entry.minY, entry.maxX, entry.maxY);
+}
+
+void CObstacleField::AddDirty(int minX, int minY, int maxX, int maxY)
+{
+    if (minX > maxX) return;
+
+    if (m_dirtyMinX > m_dirtyMaxX)
+    {
+        m_dirtyMinX = minX;
+        m_dirtyMinY = minY;
+        m_dirtyMaxX = maxX;
+        m_dirtyMaxY = maxY;
+        return;
+    }
+
+    m_dirtyMinX = Math::Min(m_dirtyMinX, minX);
+    m_dirtyMinY = Math::Min(m_dirtyMinY, minY);
+    m_dirtyMaxX = Math::Max(m_dirtyMaxX, maxX);
+    m_dirtyMaxY = Math::Max(m_dirtyMaxY, maxY);
+}
+
+void CObstacleField::ComputeField(int minX, int minY, int maxX, int maxY)
+{
+    // A cell more than this far from the changes keeps its clamped distance,
+    // and only obstacles this far from a cell can change its value
+    const float diagonal = OBSTACLE_CELL_SIZE*sqrtf(2.0f);
+    const int margin = static_cast<int>(std::ceil((OBSTACLE_MAX_DISTANCE+diagonal)/OBSTACLE_CELL_SIZE))+1;
+
+    int innerMinX = Math::Max(minX-margin, 0);
+    int innerMinY = Math::Max(minY-margin, 0);
+    int innerMaxX = Math::Min(maxX+margin, OBSTACLE_GRID_SIZE-1);
+    int innerMaxY = Math::Min(maxY+margin, OBSTACLE_GRID_SIZE-1);
+
+    int outerMinX = Math::Max(innerMinX-margin, 0);
+    int outerMinY = Math::Max(innerMinY-margin, 0);
+    int outerMaxX = Math::Min(innerMaxX+margin, OBSTACLE_GRID_SIZE-1);
+    int outerMaxY = Math::Min(innerMaxY+margin, OBSTACLE_GRID_SIZE-1);
+
+    int width  = outerMaxX-outerMinX+1;
+    int height = outerMaxY-outerMinY+1;
+
+    // Seeds are the cells touched by a sphere, seen from above
+    m_seeds.assign(width*height, -1);
+    m_queryStamp ++;
+    for (int j = outerMinY/OBSTACLE_BUCKET_SIZE; j <= outerMaxY/OBSTACLE_BUCKET_SIZE; j++)
+    {
+        for (int i = outerMinX/OBSTACLE_BUCKET_SIZE; i <= outerMaxX/OBSTACLE_BUCKET_SIZE; i++)
+        {
+            for (int id : m_buckets[i+j*OBSTACLE_BUCKET_COUNT])
+            {
+                Entry& entry = m_entries[id];
+                if (entry.queryStamp == m_queryStamp) continue;
+                entry.queryStamp = m_queryStamp;
+
+                for (const Math::Sphere& sphere : entry.shape.spheres)
+                {
+                    int x0 = Math::Max(PosToCell(sphere.pos.x-sphere.radius), outerMinX);
+                    int y0 = Math::Max(PosToCell(sphere.pos.z-sphere.radius), outerMinY);
+                    int x1 = Math::Min(PosToCell(sphere.pos.x+sphere.radius), outerMaxX);
+                    int y1 = Math::Min(PosToCell(sphere.pos.z+sphere.radius), outerMaxY);
+                    for (int y = y0; y <= y1; y++)
+                    {
+                        float cellZ = y*OBSTACLE_CELL_SIZE - OBSTACLE_GRID_SIZE*OBSTACLE_CELL_SIZE/2.0f;
+                        float dz = Math::Max(Math::Max(cellZ-sphere.pos.z, sphere.pos.z-(cellZ+OBSTACLE_CELL_SIZE)), 0.0f);
+                        for (int x = x0; x <= x1; x++)
+                        {
+                            float cellX = x*OBSTACLE_CELL_SIZE - OBSTACLE_GRID_SIZE*OBSTACLE_CELL_SIZE/2.0f;
+                            float dx = Math::Max(Math::Max(cellX-sphere.pos.x, sphere.pos.x-(cellX+OBSTACLE_CELL_SIZE)), 0.0f);
+                            if (dx*dx+dz*dz > sphere.radius*sphere.radius) continue;
+
+                            m_seeds[(x-outerMinX)+(y-outerMinY)*width] = id;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    int length = Math::Max(width, height);
+    m_lineInput.resize(length);
+    m_lineOutput.resize(length);
+    m_lineSource.resize(length);
+    m_hullVertices.resize(length);
+    m_hullBounds.resize(length+1);
+    m_squared.resize(width*height);
+    m_rowNearest.resize(width*height);
+
+    // Transform along rows
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            m_lineInput[x] = m_seeds[x+y*width] != -1 ? 0.0f : TRANSFORM_INFINITY;
+        }
+        DistanceTransform(m_lineInput.data(), width, m_lineOutput.data(), m_lineSource.data(),
+                          m_hullVertices.data(), m_hullBounds.data());
+        for (int x = 0; x < width; x++)
+        {
+            m_squared[x+y*width] = m_lineOutput[x];
+            m_rowNearest[x+y*width] = m_seeds[m_lineSource[x]+y*width];
+        }
+    }
+
+    // Transform along columns, storing only the inner rectangle
+    for (int x = innerMinX-outerMinX; x <= innerMaxX-outerMinX; x++)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            m_lineInput[y] = m_squared[x+y*width];
+        }
+        DistanceTransform(m_lineInput.data(), height, m_lineOutput.data(), m_lineSource.data(),
+                          m_hullVertices.data(), m_hullBounds.data());
+        for (int y = innerMinY-outerMinY; y <= innerMaxY-outerMinY; y++)
+        {
+            int index = (x+outerMinX)+(y+outerMinY)*OBSTACLE_GRID_SIZE;
+            int nearest = m_rowNearest[x+m_lineSource[y]*width];
+
+            // Any point of the cell is within a half diagonal of its center,
+            // as any point of an obstacle is from the center of the seed
+            float dist = sqrtf(m_lineOutput[y])*OBSTACLE_CELL_SIZE - diagonal;
+            if (nearest == -1 || dist >= OBSTACLE_MAX_DISTANCE)
+            {
+                m_distance[index] = OBSTACLE_MAX_DISTANCE;
+                m_nearest[index] = -1;
+            }
+            else
+            {
+                m_distance[index] = Math::Max(dist, 0.0f);
+                m_nearest[index] = nearest;
+            }
+        }
+    }
+}
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/obstacle_field.h
+ * \brief Distance field of obstacles used to look for free space
+ */
+
+#pragma once
+
+#include "math/sphere.h"
+#include "math/vector.h"
+
+#include <unordered_map>
+#include <vector>
+
+//! Size of one cell of the distance field (in game units)
+const float OBSTACLE_CELL_SIZE      = 8.0f;
+//! Number of cells along one side of the field, covering the whole 3200x3200 world
+const int   OBSTACLE_GRID_SIZE      = static_cast<int>(3200.0f/OBSTACLE_CELL_SIZE);
+//! Number of cells along one side of a bucket of the obstacle index
+const int   OBSTACLE_BUCKET_SIZE    = 4;
+//! Number of buckets along one side of the obstacle index
+const int   OBSTACLE_BUCKET_COUNT   = OBSTACLE_GRID_SIZE/OBSTACLE_BUCKET_SIZE;
+//! Distances stored in the field are clamped to this value
+const float OBSTACLE_MAX_DISTANCE   = 64.0f;
+//! Distance returned when there is no obstacle at all
+const float OBSTACLE_NONE_DISTANCE  = 100000.0f;
+
+/**
+ * \struct ObstacleShape
+ * \brief Spheres of one object, as seen by CObstacleField
+ */
+struct ObstacleShape
+{
+    std::vector<Math::Sphere> spheres;
+    //! If true, the first sphere hides the other ones, except exactly at its center (used by OBJECT_BASE)
+    bool        hideInner = false;
+};
+
+/**
+ * \class CObstacleField
+ * \brief Answers "how far is the nearest obstacle" queries for CRobotMain::FreeSpace() and similar
+ *
+ * The world is divided in cells of OBSTACLE_CELL_SIZE. For each cell, the field stores
+ * a lower bound of the distance to the nearest obstacle and the ID of that obstacle.
+ * It is computed with the linear time distance transform of Felzenszwalb and Huttenlocher,
+ * only around the obstacles which changed since the previous update.
+ *
+ * The field is an approximation, but GetDistance() returns the exact value: the lower bound
+ * and the distance to the nearest obstacle of the cell are often enough to answer,
+ * otherwise the obstacles are visited in rings of buckets around the position,
+ * until no remaining obstacle can be closer.
+ *
+ * Obstacles are updated in batches: BeginUpdate(), SetObstacle() for every object, EndUpdate().
+ * Unchanged obstacles cost only a comparison.
+ */
+class CObstacleField
+{
+public:
+    CObstacleField();
+    ~CObstacleField();
+
+    //! Forgets all obstacles, used when the level changes
+    void        Reset();
+
+    //! Starts an update, obstacles which are not set again before EndUpdate() are removed
+    void        BeginUpdate();
+    //! Sets the shape of the obstacle, an empty shape removes it
+    void        SetObstacle(int id, const ObstacleShape& shape);
+    //! Removes missing obstacles and recomputes the field where obstacles changed
+    void        EndUpdate();
+
+    /**
+     * \brief Returns the distance from \a center to the nearest obstacle
+     * \param excludeId ID of an obstacle to ignore, -1 if none
+     * \param below if the distance is lower than this, any value lower than this may be returned
+     * \return distance to the surface of the nearest sphere, 0 inside, OBSTACLE_NONE_DISTANCE if no obstacle
+     */
+    float       GetDistance(const Math::Vector& center, int excludeId, float below = 0.0f);
+
+    //! Returns a lower bound of the distance to the nearest obstacle, at most OBSTACLE_MAX_DISTANCE
+    float       GetLowerBound(float x, float z);
+
+    //! Converts world position to cell coordinates (not clamped)
+    static int  PosToCell(float coord);
+
+protected:
+    struct Entry
+    {
+        ObstacleShape shape;
+        int         minX = 0, minY = 0;
+        int         maxX = -1, maxY = -1;
+        int         seenStamp = 0;
+        int         queryStamp = 0;
+    };
+
+    //! Returns the distance from \a center to the obstacle
+    static float Evaluate(const ObstacleShape& shape, const Math::Vector& center);
+    //! Adds or removes the entry from the bucket index
+    void        IndexEntry(int id, Entry& entry, bool add);
+    //! Extends the rectangle of cells to recompute
+    void        AddDirty(int minX, int minY, int maxX, int maxY);
+    //! Recomputes the field in the given rectangle of cells
+    void        ComputeField(int minX, int minY, int maxX, int maxY);
+
+protected:
+    std::unordered_map<int, Entry> m_entries;
+    //! IDs of the obstacles touching each bucket
+    std::vector<std::vector<int>> m_buckets;
+    //! Lower bound of the distance to the nearest obstacle, for each cell
+    std::vector<float> m_distance;
+    //! ID of the nearest obstacle for each cell, -1 if farther than OBSTACLE_MAX_DISTANCE
+    std::vector<int> m_nearest;
+
+    int         m_dirtyMinX = 0, m_dirtyMinY = 0;
+    int         m_dirtyMaxX = -1, m_dirtyMaxY = -1;
+    int         m_seenStamp = 0;
+    int         m_queryStamp = 0;
+
+    // Buffers of the distance transform
+    std::vector<int> m_seeds;
+    std::vector<float> m_squared;
+    std::vector<int> m_rowNearest;
+    std::vector<float> m_lineInput;
+    std::vector<float> m_lineOutput;
+    std::vector<int> m_lineSource;
+    std::vector<int> m_hullVertices;
+    std::vector<float> m_hullBounds;
+};
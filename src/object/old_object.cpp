@@ -43,6 +43,7 @@
 #include "math/geometry.h"
 
 #include "object/object_manager.h"
+#include "object/part_transform_pool.h"
 
 #include "object/auto/auto.h"
 #include "object/auto/autobase.h"
@@ -108,6 +109,7 @@ COldObject::COldObject(int id)
     m_main        = CRobotMain::GetInstancePointer();
     m_terrain     = m_main->GetTerrain();
     m_camera      = m_main->GetCamera();
+    m_partPool    = CObjectManager::GetInstancePointer()->GetPartTransformPool();
 
     m_type = OBJECT_NULL;
     m_option = 0;
@@ -185,6 +187,14 @@ COldObject::COldObject(int id)
 COldObject::~COldObject()
 {
     m_main->HideDropZone(this);
+
+    for (int i=0 ; i<OBJECTMAXPART ; i++ )
+    {
+        if ( m_objectPart[i].poolSlot != -1 )
+        {
+            m_partPool->RemovePart(m_objectPart[i].poolSlot);
+        }
+    }
 }
 
 
@@ -205,7 +215,6 @@ void COldObject::DeleteObject(bool bAll)
     if ( !bAll )
     {
         m_engine->GetPyroManager()->CutObjectLink(this);
-        m_particle->CutObjectLink(this);
 
         if ( m_bSelect )
         {
@@ -346,6 +355,8 @@ bool COldObject::DamageObject(DamageType type, float force, CObject* killer)
 
     if ( IsDying() )  return false;
 
+    WakeUp();
+
     if ( m_type == OBJECT_ANT    ||
          m_type == OBJECT_WORM   ||
          m_type == OBJECT_SPIDER ||
@@ -611,8 +622,27 @@ void COldObject::InitPart(int part)
     m_objectPart[part].matRotate.LoadIdentity();
     m_objectPart[part].matTransform.LoadIdentity();
     m_objectPart[part].matWorld.LoadIdentity();;
+    m_objectPart[part].bLocalStale = false;
 
     m_objectPart[part].masterParti = -1;
+
+    if ( m_objectPart[part].poolSlot == -1 )
+    {
+        m_objectPart[part].poolSlot = m_partPool->AddPart();
+    }
+    else
+    {
+        m_partPool->SetParent(m_objectPart[part].poolSlot, -1);
+    }
+
+    // Children may have been attached before this part existed
+    for ( int i=0 ; i<OBJECTMAXPART ; i++ )
+    {
+        if ( i != part && m_objectPart[i].poolSlot != -1 && m_objectPart[i].parentPart == part )
+        {
+            m_partPool->SetParent(m_objectPart[i].poolSlot, m_objectPart[part].poolSlot);
+        }
+    }
 }
 
 // Removes part.
@@ -629,6 +659,8 @@ void COldObject::DeletePart(int part)
 
     m_objectPart[part].bUsed = false;
     m_engine->DeleteObject(m_objectPart[part].object);
+    m_partPool->RemovePart(m_objectPart[part].poolSlot);
+    m_objectPart[part].poolSlot = -1;
     UpdateTotalPart();
 }
 
@@ -674,6 +706,12 @@ int COldObject::GetObjectRank(int part)
 void COldObject::SetObjectParent(int part, int parent)
 {
     m_objectPart[part].parentPart = parent;
+
+    if ( m_objectPart[part].poolSlot != -1 )
+    {
+        int parentSlot = parent == -1 ? -1 : m_objectPart[parent].poolSlot;
+        m_partPool->SetParent(m_objectPart[part].poolSlot, parentSlot);
+    }
 }
 
 
@@ -1580,6 +1618,7 @@ void COldObject::SetMasterParticle(int part, int parti)
 void COldObject::SetPower(CObject* power)
 {
     m_power = power;
+    WakeUp();
 }
 
 CObject* COldObject::GetPower()
@@ -1603,6 +1642,7 @@ Math::Vector COldObject::GetPowerPosition()
 void COldObject::SetCargo(CObject* cargo)
 {
     m_cargo = cargo;
+    WakeUp();
 }
 
 CObject* COldObject::GetCargo()
@@ -1637,11 +1677,14 @@ void COldObject::SetTransporterPart(int part)
 
 Math::Matrix* COldObject::GetRotateMatrix(int part)
 {
+    UpdateStaleLocalTransform(part);
     return &m_objectPart[part].matRotate;
 }
 
 Math::Matrix* COldObject::GetWorldMatrix(int part)
 {
+    ApplyPoolTransforms();
+
     if ( m_objectPart[0].bTranslate ||
          m_objectPart[0].bRotate    )
     {
@@ -1728,13 +1771,72 @@ bool COldObject::CreateShadowCircle(float radius, float intensity,
     return true;
 }
 
+// Rebuilds the local matrices of a part.
+// The rotations occur in the order Y, Z and X.
+
+void COldObject::UpdateLocalTransform(int part, bool bTranslate, bool bRotate)
+{
+    Math::Vector position = m_objectPart[part].position;
+    Math::Vector angle    = m_objectPart[part].angle;
+
+    if ( part == 0 )  // main part?
+    {
+        position += m_linVibration;
+        angle    += m_cirVibration+m_tilt;
+    }
+
+    if ( bTranslate )
+    {
+        m_objectPart[part].matTranslate.LoadIdentity();
+        m_objectPart[part].matTranslate.Set(1, 4, position.x);
+        m_objectPart[part].matTranslate.Set(2, 4, position.y);
+        m_objectPart[part].matTranslate.Set(3, 4, position.z);
+    }
+
+    if ( bRotate )
+    {
+        Math::LoadRotationZXYMatrix(m_objectPart[part].matRotate, angle);
+    }
+
+    if ( m_objectPart[part].bZoom )
+    {
+        Math::Matrix    mz;
+        mz.LoadIdentity();
+        mz.Set(1, 1, m_objectPart[part].zoom.x);
+        mz.Set(2, 2, m_objectPart[part].zoom.y);
+        mz.Set(3, 3, m_objectPart[part].zoom.z);
+        m_objectPart[part].matTransform = Math::MultiplyMatrices(m_objectPart[part].matTranslate,
+                                            Math::MultiplyMatrices(m_objectPart[part].matRotate, mz));
+    }
+    else
+    {
+        m_objectPart[part].matTransform = Math::MultiplyMatrices(m_objectPart[part].matTranslate,
+                                                                 m_objectPart[part].matRotate);
+    }
+
+    // Keep the pool in sync, the children may be computed there
+    if ( m_objectPart[part].poolSlot != -1 )
+    {
+        Math::Vector zoom = m_objectPart[part].bZoom ? m_objectPart[part].zoom : Math::Vector(1.0f, 1.0f, 1.0f);
+        m_partPool->SetLocal(m_objectPart[part].poolSlot, position, angle, zoom, false);
+    }
+}
+
+// Updates the local matrices of a part computed through the pool.
+
+void COldObject::UpdateStaleLocalTransform(int part)
+{
+    if ( !m_objectPart[part].bLocalStale )  return;
+
+    UpdateLocalTransform(part, true, true);
+    m_objectPart[part].bLocalStale = false;
+}
+
 // Calculates the matrix for transforming the object.
 // Returns true if the matrix has changed.
-// The rotations occur in the order Y, Z and X.
 
 bool COldObject::UpdateTransformObject(int part, bool bForceUpdate)
 {
-    Math::Vector    position, angle, eye;
     bool        bModif = false;
     int         parent;
 
@@ -1748,46 +1850,14 @@ bool COldObject::UpdateTransformObject(int part, bool bForceUpdate)
          !m_objectPart[part].bTranslate &&
          !m_objectPart[part].bRotate    )  return false;
 
-    position = m_objectPart[part].position;
-    angle    = m_objectPart[part].angle;
-
-    if ( part == 0 )  // main part?
-    {
-        position += m_linVibration;
-        angle    += m_cirVibration+m_tilt;
-    }
-
-    if ( m_objectPart[part].bTranslate ||
-         m_objectPart[part].bRotate    )
+    if ( m_objectPart[part].bTranslate  ||
+         m_objectPart[part].bRotate     ||
+         m_objectPart[part].bLocalStale )
     {
-        if ( m_objectPart[part].bTranslate )
-        {
-            m_objectPart[part].matTranslate.LoadIdentity();
-            m_objectPart[part].matTranslate.Set(1, 4, position.x);
-            m_objectPart[part].matTranslate.Set(2, 4, position.y);
-            m_objectPart[part].matTranslate.Set(3, 4, position.z);
-        }
-
-        if ( m_objectPart[part].bRotate )
-        {
-            Math::LoadRotationZXYMatrix(m_objectPart[part].matRotate, angle);
-        }
-
-        if ( m_objectPart[part].bZoom )
-        {
-            Math::Matrix    mz;
-            mz.LoadIdentity();
-            mz.Set(1, 1, m_objectPart[part].zoom.x);
-            mz.Set(2, 2, m_objectPart[part].zoom.y);
-            mz.Set(3, 3, m_objectPart[part].zoom.z);
-            m_objectPart[part].matTransform = Math::MultiplyMatrices(m_objectPart[part].matTranslate,
-                                                Math::MultiplyMatrices(m_objectPart[part].matRotate, mz));
-        }
-        else
-        {
-            m_objectPart[part].matTransform = Math::MultiplyMatrices(m_objectPart[part].matTranslate,
-                                                                     m_objectPart[part].matRotate);
-        }
+        UpdateLocalTransform(part,
+                             m_objectPart[part].bTranslate || m_objectPart[part].bLocalStale,
+                             m_objectPart[part].bRotate    || m_objectPart[part].bLocalStale);
+        m_objectPart[part].bLocalStale = false;
         bModif = true;
     }
 
@@ -1823,6 +1893,11 @@ bool COldObject::UpdateTransformObject(int part, bool bForceUpdate)
     {
         m_engine->SetObjectTransform(m_objectPart[part].object,
                                      m_objectPart[part].matWorld);
+
+        if ( m_objectPart[part].poolSlot != -1 )
+        {
+            m_partPool->SetWorld(m_objectPart[part].poolSlot, m_objectPart[part].matWorld);
+        }
     }
 
     m_objectPart[part].bTranslate = false;
@@ -1903,6 +1978,8 @@ void COldObject::FlatParent()
 
     for ( i=0 ; i<m_totalPart ; i++ )
     {
+        UpdateStaleLocalTransform(i);
+
         m_objectPart[i].position.x = m_objectPart[i].matWorld.Get(1, 4);
         m_objectPart[i].position.y = m_objectPart[i].matWorld.Get(2, 4);
         m_objectPart[i].position.z = m_objectPart[i].matWorld.Get(3, 4);
@@ -1916,6 +1993,10 @@ void COldObject::FlatParent()
         m_objectPart[i].matTranslate.Set(3, 4, 0.0f);
 
         m_objectPart[i].parentPart = -1;  // more parents
+        if ( m_objectPart[i].poolSlot != -1 )
+        {
+            m_partPool->SetParent(m_objectPart[i].poolSlot, -1);
+        }
     }
 
     m_bFlat = true;
@@ -2116,7 +2197,13 @@ bool COldObject::EventProcess(const Event &event)
 
     if ( m_auto != nullptr )
     {
-        if (!GetLock())
+        if ( m_bSelect )
+        {
+            m_auto->WakeUp();
+        }
+
+        // A sleeping controller only skips the frames, it still gets the other events
+        if ( !GetLock() && !(event.type == EVENT_FRAME && m_auto->IsSleeping()) )
         {
             m_auto->EventProcess(event);
         }
@@ -2168,7 +2255,14 @@ bool COldObject::EventFrame(const Event &event)
     PartiFrame(event.rTime);
 
     UpdateMapping();
-    UpdateTransformObject();
+    if ( m_main->GetPhasedObjectUpdate() )
+    {
+        SendPartsToPool();  // see EventFrameCommit()
+    }
+    else
+    {
+        UpdateTransformObject();
+    }
     UpdateSelectParticle();
 
     if (Implements(ObjectInterfaceType::ShieldedAutoRegen))
@@ -2185,6 +2279,97 @@ bool COldObject::EventFrame(const Event &event)
     return true;
 }
 
+// Sends the parts moved since the last frame to the part transform pool,
+// which computes the matrices of all objects at once before EventFrameCommit.
+
+void COldObject::SendPartsToPool()
+{
+    m_transformPending = true;
+
+    // The matrices of a transported object depend on its transporter,
+    // and debris no longer have a proper hierarchy; see EventFrameCommit.
+    if ( m_transporter != nullptr || m_bFlat )  return;
+
+    for ( int i = 0; i < m_totalPart; i++ )
+    {
+        ObjectPart& part = m_objectPart[i];
+        if ( !part.bUsed || part.poolSlot == -1 )  continue;
+        if ( !part.bTranslate && !part.bRotate )  continue;
+
+        Math::Vector position = part.position;
+        Math::Vector angle    = part.angle;
+        if ( i == 0 )  // main part?
+        {
+            position += m_linVibration;
+            angle    += m_cirVibration+m_tilt;
+        }
+        Math::Vector zoom = part.bZoom ? part.zoom : Math::Vector(1.0f, 1.0f, 1.0f);
+
+        m_partPool->SetLocal(part.poolSlot, position, angle, zoom);
+        part.bTranslate  = false;
+        part.bRotate     = false;
+        part.bLocalStale = true;
+    }
+
+    m_poolTransformsPending = true;
+}
+
+// Sends the matrices computed by the part transform pool to CEngine.
+
+void COldObject::EventFrameCommit(const Event &event)
+{
+    if ( !m_transformPending )  return;
+    m_transformPending = false;
+
+    if ( m_transporter != nullptr || m_bFlat )
+    {
+        UpdateTransformObject();
+        return;
+    }
+
+    ApplyPoolTransforms();
+    UpdateTransformObject();  // parts moved by other objects after EventFrame
+}
+
+// Copies the world matrices updated by the part transform pool.
+
+void COldObject::ApplyPoolTransforms()
+{
+    if ( !m_poolTransformsPending )  return;
+    m_poolTransformsPending = false;
+
+    for ( int i = 0; i < m_totalPart; i++ )
+    {
+        ObjectPart& part = m_objectPart[i];
+        if ( !part.bUsed || part.poolSlot == -1 )  continue;
+        if ( !m_partPool->IsUpdated(part.poolSlot) )  continue;
+
+        part.matWorld = m_partPool->GetWorld(part.poolSlot);
+        m_engine->SetObjectTransform(part.object, part.matWorld);
+    }
+}
+
+// Loads the textures used by the parts of the object.
+// Cheaper than CEngine::LoadAllTextures(), which walks the whole scene.
+
+void COldObject::LoadTextures()
+{
+    for (int i = 0; i < m_totalPart; i++)
+    {
+        if ( !m_objectPart[i].bUsed )  continue;
+        m_engine->LoadObjectTextures(m_objectPart[i].object);
+    }
+}
+
+// Wakes up the physics and the controller of the object,
+// when something happened that they may have to react to.
+
+void COldObject::WakeUp()
+{
+    if ( m_physics != nullptr )  m_physics->WakeUp();
+    if ( m_auto != nullptr )  m_auto->WakeUp();
+}
+
 // Updates the mapping of the object.
 
 void COldObject::UpdateMapping()
@@ -2392,7 +2577,7 @@ void COldObject::AdjustCamera(Math::Vector &eye, float &dirH, float &dirV,
             upVec.z += speed*0.08f;
         }
     }
-    upVec = Math::Transform(m_objectPart[0].matRotate, upVec);
+    upVec = Math::Transform(*GetRotateMatrix(0), upVec);
 
     dirH = -(m_objectPart[part].angle.y+Math::PI/2.0f);
     dirV = 0.0f;
@@ -2523,6 +2708,7 @@ void COldObject::SetVirusMode(bool bEnable)
 {
     m_bVirusMode = bEnable;
     m_virusTime = 0.0f;
+    WakeUp();
 
     if ( m_bVirusMode && Implements(ObjectInterfaceType::Programmable) )
     {
@@ -2613,6 +2799,8 @@ void COldObject::SetSelect(bool select, bool bDisplayError)
     if ( !m_bSelect )
         return;  // if not selected, we're done
 
+    WakeUp();
+
     Error err = ERR_OK;
     if ( m_physics != nullptr )
     {
@@ -49,6 +49,8 @@
 #include "object/interface/trace_drawing_object.h"
 #include "object/interface/transportable_object.h"
 
+class CPartTransformPool;
+
 // The father of all parts must always be the part number zero!
 const int OBJECTMAXPART         = 40;
 
@@ -64,6 +66,8 @@ struct ObjectPart
     bool         bTranslate = false;
     bool         bRotate = false;
     bool         bZoom = false;
+    bool         bLocalStale = false;  // matTranslate/matRotate/matTransform not up to date
+    int          poolSlot = -1;       // slot in CPartTransformPool
     Math::Matrix matTranslate;
     Math::Matrix matRotate;
     Math::Matrix matTransform;
@@ -114,7 +118,10 @@ public:
     void        DestroyObject(DestructionType type, CObject* killer = nullptr) override;
 
     bool EventProcess(const Event& event) override;
+    void EventFrameCommit(const Event& event) override;
     void        UpdateMapping();
+    void        LoadTextures();
+    void        WakeUp();
 
     void        DeletePart(int part) override;
     void        SetObjectRank(int part, int objRank);
@@ -302,8 +309,12 @@ protected:
     void        UpdateTotalPart();
     int         SearchDescendant(int parent, int n);
     void        UpdateEnergyMapping();
+    void        UpdateLocalTransform(int part, bool bTranslate, bool bRotate);
+    void        UpdateStaleLocalTransform(int part);
     bool        UpdateTransformObject(int part, bool bForceUpdate);
     bool        UpdateTransformObject();
+    void        ApplyPoolTransforms();
+    void        SendPartsToPool();
     void        UpdateSelectParticle();
     void        TransformCrashSphere(Math::Sphere &crashSphere) override;
     void TransformCameraCollisionSphere(Math::Sphere& collisionSphere) override;
@@ -392,4 +403,10 @@ protected:
     float       m_traceWidth;
 
     bool        m_bulletWall = false;
+
+    CPartTransformPool* m_partPool = nullptr;
+    //! EventFrame() left the transform update to EventFrameCommit()
+    bool        m_transformPending = false;
+    //! The part matrices were sent to m_partPool and still have to be applied
+    bool        m_poolTransformsPending = false;
 };
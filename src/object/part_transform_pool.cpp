@@ -0,0 +1,429 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/part_transform_pool.h"
+
+#include "common/thread/thread_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PART_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+
+//! Slot of the implicit root part, its world matrix is always identity
+const int ROOT_SLOT = 0;
+
+//! Deeper hierarchies are treated as broken links
+const int MAX_DEPTH = 32;
+
+//! Number of parts handed to a single thread at once
+const int THREAD_CHUNK_SIZE = 64;
+
+//! One part at a time with plain floats
+struct ScalarBatch
+{
+    using Lane = float;
+    static const int SIZE = 1;
+
+    static Lane Zero()                                 { return 0.0f; }
+    static Lane Load(const float* values)              { return values[0]; }
+    static Lane Add(Lane a, Lane b)                    { return a + b; }
+    static Lane Sub(Lane a, Lane b)                    { return a - b; }
+    static Lane Mul(Lane a, Lane b)                    { return a * b; }
+
+    static Lane Gather(const std::vector<float>& values, const int* slots)
+    {
+        return values[slots[0]];
+    }
+
+    static void Scatter(std::vector<float>& values, const int* slots, int count, Lane value)
+    {
+        values[slots[0]] = value;
+    }
+};
+
+#ifdef PART_TRANSFORM_SSE2
+//! Four parts at a time with SSE2
+struct SSE2Batch
+{
+    using Lane = __m128;
+    static const int SIZE = 4;
+
+    static Lane Zero()                                 { return _mm_setzero_ps(); }
+    static Lane Load(const float* values)              { return _mm_loadu_ps(values); }
+    static Lane Add(Lane a, Lane b)                    { return _mm_add_ps(a, b); }
+    static Lane Sub(Lane a, Lane b)                    { return _mm_sub_ps(a, b); }
+    static Lane Mul(Lane a, Lane b)                    { return _mm_mul_ps(a, b); }
+
+    static Lane Gather(const std::vector<float>& values, const int* slots)
+    {
+        return _mm_set_ps(values[slots[3]], values[slots[2]], values[slots[1]], values[slots[0]]);
+    }
+
+    static void Scatter(std::vector<float>& values, const int* slots, int count, Lane value)
+    {
+        float result[SIZE];
+        _mm_storeu_ps(result, value);
+        for (int i = 0; i < count; ++i)
+            values[slots[i]] = result[i];
+    }
+};
+#endif
+
+} // anonymous namespace
+
+
+CPartTransformPool::CPartTransformPool()
+{
+    // Slot 0 is the root of all parts without a parent
+    AddPart();
+    m_partCount = 0;
+}
+
+CPartTransformPool::~CPartTransformPool()
+{
+}
+
+int CPartTransformPool::AddPart()
+{
+    int slot = 0;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<int>(m_used.size());
+        m_used.push_back(0);
+        m_dirty.push_back(0);
+        m_updated.push_back(0);
+        m_parent.push_back(ROOT_SLOT);
+        m_depth.push_back(0);
+        m_posX.push_back(0.0f);
+        m_posY.push_back(0.0f);
+        m_posZ.push_back(0.0f);
+        m_angleX.push_back(0.0f);
+        m_angleY.push_back(0.0f);
+        m_angleZ.push_back(0.0f);
+        m_zoomX.push_back(1.0f);
+        m_zoomY.push_back(1.0f);
+        m_zoomZ.push_back(1.0f);
+        for (int i = 0; i < WORLD_SIZE; ++i)
+            m_world[i].push_back(0.0f);
+    }
+
+    m_used[slot] = 1;
+    m_dirty[slot] = 0;  // the local transform is not known yet
+    m_updated[slot] = 0;
+    m_parent[slot] = ROOT_SLOT;
+    SetLocal(slot, Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(1.0f, 1.0f, 1.0f), false);
+    SetWorld(slot, Math::Matrix());
+
+    m_partCount++;
+    m_topologyChanged = true;
+    return slot;
+}
+
+void CPartTransformPool::RemovePart(int slot)
+{
+    assert(slot > ROOT_SLOT && slot < static_cast<int>(m_used.size()) && m_used[slot]);
+
+    m_used[slot] = 0;
+    m_dirty[slot] = 0;
+    m_updated[slot] = 0;
+
+    // Children are detached in UpdateTopology(), the slot can't be reused before that
+    m_releasedSlots.push_back(slot);
+    m_partCount--;
+    m_topologyChanged = true;
+}
+
+void CPartTransformPool::SetParent(int slot, int parentSlot)
+{
+    if (parentSlot < 0) parentSlot = ROOT_SLOT;
+    if (m_parent[slot] == parentSlot) return;
+
+    m_parent[slot] = parentSlot;
+    m_topologyChanged = true;
+}
+
+int CPartTransformPool::GetParent(int slot) const
+{
+    if (m_parent[slot] == ROOT_SLOT || !m_used[m_parent[slot]]) return -1;
+    return m_parent[slot];
+}
+
+void CPartTransformPool::SetLocal(int slot, const Math::Vector& position, const Math::Vector& angle,
+                                  const Math::Vector& zoom, bool dirty)
+{
+    m_posX[slot] = position.x;
+    m_posY[slot] = position.y;
+    m_posZ[slot] = position.z;
+    m_angleX[slot] = angle.x;
+    m_angleY[slot] = angle.y;
+    m_angleZ[slot] = angle.z;
+    m_zoomX[slot] = zoom.x;
+    m_zoomY[slot] = zoom.y;
+    m_zoomZ[slot] = zoom.z;
+    if (dirty)
+        m_dirty[slot] = 1;
+}
+
+void CPartTransformPool::SetWorld(int slot, const Math::Matrix& world)
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            m_world[row*4+col][slot] = world.m[col*4+row];
+        }
+    }
+}
+
+Math::Matrix CPartTransformPool::GetWorld(int slot) const
+{
+    Math::Matrix world;
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            world.m[col*4+row] = m_world[row*4+col][slot];
+        }
+    }
+    return world;
+}
+
+bool CPartTransformPool::IsUpdated(int slot) const
+{
+    return m_updated[slot] != 0;
+}
+
+int CPartTransformPool::GetPartCount() const
+{
+    return m_partCount;
+}
+
+int CPartTransformPool::GetUpdatedCount() const
+{
+    return static_cast<int>(m_updatedSlots.size());
+}
+
+void CPartTransformPool::UpdateTopology()
+{
+    int slotCount = static_cast<int>(m_used.size());
+    int maxDepth = 0;
+
+    for (int slot = 0; slot < slotCount; ++slot)
+    {
+        if (m_used[slot] && !m_used[m_parent[slot]])
+            m_parent[slot] = ROOT_SLOT;
+    }
+    m_freeSlots.insert(m_freeSlots.end(), m_releasedSlots.begin(), m_releasedSlots.end());
+    m_releasedSlots.clear();
+
+    std::fill(m_depth.begin(), m_depth.end(), -1);
+    m_depth[ROOT_SLOT] = 0;
+
+    for (int slot = 0; slot < slotCount; ++slot)
+    {
+        if (!m_used[slot] || m_depth[slot] >= 0) continue;
+
+        // Walk up to the first part with known depth
+        int chain[MAX_DEPTH];
+        int length = 0;
+        int current = slot;
+        while (m_depth[current] < 0 && length < MAX_DEPTH)
+        {
+            chain[length++] = current;
+            current = m_parent[current];
+        }
+
+        if (m_depth[current] < 0)  // loop in the hierarchy?
+        {
+            m_parent[slot] = ROOT_SLOT;
+            current = ROOT_SLOT;
+            length = 1;
+        }
+
+        int depth = m_depth[current];
+        for (int i = length-1; i >= 0; --i)
+        {
+            m_depth[chain[i]] = ++depth;
+        }
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    // Counting sort by depth
+    m_levels.resize(maxDepth+1);
+    for (auto& level : m_levels)
+        level.clear();
+    for (int slot = 1; slot < slotCount; ++slot)
+    {
+        if (m_used[slot])
+            m_levels[m_depth[slot]].push_back(slot);
+    }
+
+    m_order.clear();
+    for (const auto& level : m_levels)
+        m_order.insert(m_order.end(), level.begin(), level.end());
+
+    m_topologyChanged = false;
+}
+
+void CPartTransformPool::Update(CThreadPool* threadPool)
+{
+    if (m_topologyChanged)
+        UpdateTopology();
+
+    for (int slot : m_updatedSlots)
+        m_updated[slot] = 0;
+    m_updatedSlots.clear();
+
+    for (auto& level : m_levels)
+        level.clear();
+
+    // Parents always come before their children in m_order
+    for (int slot : m_order)
+    {
+        if (!m_dirty[slot] && !m_updated[m_parent[slot]]) continue;
+
+        m_dirty[slot] = 0;
+        m_updated[slot] = 1;
+        m_updatedSlots.push_back(slot);
+        m_levels[m_depth[slot]].push_back(slot);
+    }
+
+    for (const auto& level : m_levels)
+    {
+        int count = static_cast<int>(level.size());
+        if (count == 0) continue;
+
+        if (threadPool != nullptr)
+        {
+            threadPool->ParallelFor(count, THREAD_CHUNK_SIZE, [this, &level](int begin, int end)
+            {
+                ComputeRange(level, begin, end);
+            });
+        }
+        else
+        {
+            ComputeRange(level, 0, count);
+        }
+    }
+}
+
+void CPartTransformPool::ComputeRange(const std::vector<int>& slots, int begin, int end)
+{
+#ifdef PART_TRANSFORM_SSE2
+    for (int i = begin; i < end; i += SSE2Batch::SIZE)
+    {
+        ComputeBatch<SSE2Batch>(&slots[i], std::min(SSE2Batch::SIZE, end - i));
+    }
+#else
+    for (int i = begin; i < end; ++i)
+    {
+        ComputeBatch<ScalarBatch>(&slots[i], 1);
+    }
+#endif
+}
+
+template<typename Batch>
+void CPartTransformPool::ComputeBatch(const int* slots, int count)
+{
+    using Lane = typename Batch::Lane;
+    const int SIZE = Batch::SIZE;
+
+    // Unused lanes repeat the last part, their results are not stored
+    int s[SIZE];
+    int p[SIZE];
+    float sinX[SIZE], cosX[SIZE], sinY[SIZE], cosY[SIZE], sinZ[SIZE], cosZ[SIZE];
+    for (int i = 0; i < SIZE; ++i)
+    {
+        s[i] = slots[i < count ? i : count-1];
+        p[i] = m_parent[s[i]];
+        sinX[i] = sinf(m_angleX[s[i]]);
+        cosX[i] = cosf(m_angleX[s[i]]);
+        sinY[i] = sinf(m_angleY[s[i]]);
+        cosY[i] = cosf(m_angleY[s[i]]);
+        sinZ[i] = sinf(m_angleZ[s[i]]);
+        cosZ[i] = cosf(m_angleZ[s[i]]);
+    }
+
+    Lane sx = Batch::Load(sinX), cx = Batch::Load(cosX);
+    Lane sy = Batch::Load(sinY), cy = Batch::Load(cosY);
+    Lane sz = Batch::Load(sinZ), cz = Batch::Load(cosZ);
+
+    // Rotation Y * Z * X, see Math::LoadRotationZXYMatrix()
+    Lane sysz = Batch::Mul(sy, sz);
+    Lane cysz = Batch::Mul(cy, sz);
+    Lane rot[3][3];
+    rot[0][0] = Batch::Mul(cy, cz);
+    rot[0][1] = Batch::Sub(Batch::Mul(sy, sx), Batch::Mul(cysz, cx));
+    rot[0][2] = Batch::Add(Batch::Mul(cysz, sx), Batch::Mul(sy, cx));
+    rot[1][0] = sz;
+    rot[1][1] = Batch::Mul(cz, cx);
+    rot[1][2] = Batch::Sub(Batch::Zero(), Batch::Mul(cz, sx));
+    rot[2][0] = Batch::Sub(Batch::Zero(), Batch::Mul(sy, cz));
+    rot[2][1] = Batch::Add(Batch::Mul(sysz, cx), Batch::Mul(cy, sx));
+    rot[2][2] = Batch::Sub(Batch::Mul(cy, cx), Batch::Mul(sysz, sx));
+
+    // Local transform: translation * rotation * scale
+    Lane zoom[3] = { Batch::Gather(m_zoomX, s), Batch::Gather(m_zoomY, s), Batch::Gather(m_zoomZ, s) };
+    Lane local[3][4];
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 3; ++col)
+        {
+            local[row][col] = Batch::Mul(rot[row][col], zoom[col]);
+        }
+    }
+    local[0][3] = Batch::Gather(m_posX, s);
+    local[1][3] = Batch::Gather(m_posY, s);
+    local[2][3] = Batch::Gather(m_posZ, s);
+
+    // World transform: parent world * local
+    Lane parent[WORLD_SIZE];
+    for (int i = 0; i < WORLD_SIZE; ++i)
+    {
+        parent[i] = Batch::Gather(m_world[i], p);
+    }
+
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            Lane value = Batch::Add(Batch::Add(Batch::Mul(parent[row*4+0], local[0][col]),
+                                               Batch::Mul(parent[row*4+1], local[1][col])),
+                                               Batch::Mul(parent[row*4+2], local[2][col]));
+            if (col == 3)
+                value = Batch::Add(value, parent[row*4+3]);
+
+            Batch::Scatter(m_world[row*4+col], s, count, value);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/part_transform_pool.h
+ * \brief Batched computation of object part matrices
+ */
+
+#pragma once
+
+#include "math/matrix.h"
+#include "math/vector.h"
+
+#include <vector>
+
+class CThreadPool;
+
+/**
+ * \class CPartTransformPool
+ * \brief Structure-of-arrays storage for the part hierarchies of all objects
+ *
+ * Every part has a local transform (translation * rotation ZXY * scale, the same
+ * as the one built by COldObject::UpdateTransformObject()) and a parent part.
+ * Update() recomputes the world matrices of the parts marked dirty, and all
+ * their descendants, level by level in topological order. Parts of the same
+ * level are processed four at a time with SSE2 where available.
+ *
+ * Slots are allocated and linked from the main thread only. SetLocal() may be
+ * called concurrently as long as different threads use different slots.
+ */
+class CPartTransformPool
+{
+public:
+    CPartTransformPool();
+    ~CPartTransformPool();
+
+    //! Adds a new part without a parent, returns its slot
+    int         AddPart();
+    //! Removes the part, its children lose their parent
+    void        RemovePart(int slot);
+
+    //! Changes the parent of the part, -1 to remove it
+    void        SetParent(int slot, int parentSlot);
+    int         GetParent(int slot) const;
+
+    /**
+     * \brief Sets the local transform of the part
+     * \param dirty if true, the world matrix will be recomputed by the next Update()
+     */
+    void        SetLocal(int slot, const Math::Vector& position, const Math::Vector& angle, const Math::Vector& zoom, bool dirty = true);
+    //! Stores a world matrix computed outside of the pool, for use by the children
+    void        SetWorld(int slot, const Math::Matrix& world);
+
+    //! Recomputes world matrices of dirty parts and their descendants
+    void        Update(CThreadPool* threadPool = nullptr);
+
+    //! Returns true if the world matrix of the part was recomputed by the last Update()
+    bool        IsUpdated(int slot) const;
+    //! Returns the world matrix of the part
+    Math::Matrix GetWorld(int slot) const;
+
+    //! Returns the number of parts in the pool
+    int         GetPartCount() const;
+    //! Returns the number of parts recomputed by the last Update()
+    int         GetUpdatedCount() const;
+
+private:
+    //! Rebuilds the depth of each part and the depth-sorted order
+    void        UpdateTopology();
+    //! Computes world matrices of parts slots[begin] to slots[end-1]
+    void        ComputeRange(const std::vector<int>& slots, int begin, int end);
+    //! Computes world matrices of up to Batch::SIZE parts at once
+    template<typename Batch>
+    void        ComputeBatch(const int* slots, int count);
+
+private:
+    //! Number of values in the upper 3x4 part of a matrix
+    static const int WORLD_SIZE = 12;
+
+    std::vector<unsigned char> m_used;
+    std::vector<unsigned char> m_dirty;
+    std::vector<unsigned char> m_updated;
+    std::vector<int>    m_parent;
+    std::vector<int>    m_depth;
+
+    std::vector<float>  m_posX, m_posY, m_posZ;
+    std::vector<float>  m_angleX, m_angleY, m_angleZ;
+    std::vector<float>  m_zoomX, m_zoomY, m_zoomZ;
+    //! World matrices, m_world[row*4+col][slot]
+    std::vector<float>  m_world[WORLD_SIZE];
+
+    std::vector<int>    m_freeSlots;
+    //! Removed slots waiting for UpdateTopology() before they can be reused
+    std::vector<int>    m_releasedSlots;
+    int                 m_partCount = 0;
+
+    bool                m_topologyChanged = false;
+    //! Used slots sorted by depth
+    std::vector<int>    m_order;
+    //! Parts recomputed by the last Update(), grouped by depth
+    std::vector<std::vector<int>> m_levels;
+    std::vector<int>    m_updatedSlots;
+};
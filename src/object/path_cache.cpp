@@ -0,0 +1,231 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/path_cache.h"
+
+#include "math/geometry.h"
+
+#include "object/nav_grid.h"
+
+#include <algorithm>
+
+
+namespace
+{
+
+//! Maximum number of paths kept
+const int MAX_ENTRIES = 32;
+
+} // anonymous namespace
+
+
+bool PathCacheKey::operator==(const PathCacheKey& other) const
+{
+    return startX == other.startX && startY == other.startY &&
+           goalX == other.goalX && goalY == other.goalY &&
+           goalRadius == other.goalRadius &&
+           layer == other.layer &&
+           radius == other.radius &&
+           altitude == other.altitude &&
+           ignoredId == other.ignoredId;
+}
+
+
+CPathCache::CPathCache(CNavGrid* navGrid)
+    : m_navGrid(navGrid)
+{
+}
+
+CPathCache::~CPathCache()
+{
+}
+
+void CPathCache::Clear()
+{
+    m_entries.clear();
+    m_pending.clear();
+    m_useStamp = 0;
+
+    m_lookupCount = 0;
+    m_hitCount = 0;
+    m_coalescedCount = 0;
+    m_savedTime = 0;
+}
+
+PathCacheResult CPathCache::Find(const PathCacheKey& key, int ownerId,
+                                 const Math::Vector& start, const Math::Vector& goal, bool exactGoal,
+                                 const TestFunction& test, std::vector<Math::Vector>& points)
+{
+    for (PendingSearch& pending : m_pending)
+    {
+        if (!(pending.key == key)) continue;
+        if (pending.ownerId == ownerId) break;  // restarted its own search
+
+        if (std::find(pending.waiters.begin(), pending.waiters.end(), ownerId) == pending.waiters.end())
+        {
+            pending.waiters.push_back(ownerId);
+            m_coalescedCount ++;
+        }
+        return PathCacheResult::Pending;
+    }
+
+    m_lookupCount ++;
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (!(it->key == key)) continue;
+
+        points = it->points;
+        points.front() = start;
+        if (exactGoal)  points.back() = goal;
+
+        bool valid = test(points[0], points[1]);
+        if (valid && exactGoal && points.size() > 2)
+        {
+            valid = test(points[points.size()-2], points.back());
+        }
+        if (valid && TilesChanged(it->tiles))
+        {
+            for (std::size_t i = 1; i+1 < points.size() && valid; i++)
+            {
+                valid = test(points[i], points[i+1]);
+            }
+            if (valid)  CollectTiles(it->points, it->tiles);
+        }
+
+        if (valid)
+        {
+            it->lastUse = ++m_useStamp;
+            m_hitCount ++;
+            m_savedTime += it->computeTime;
+            return PathCacheResult::Hit;
+        }
+
+        m_entries.erase(it);  // blocked by something new
+        break;
+    }
+
+    Cancel(ownerId);
+    PendingSearch pending;
+    pending.key = key;
+    pending.ownerId = ownerId;
+    m_pending.push_back(pending);
+    return PathCacheResult::Miss;
+}
+
+void CPathCache::Store(const PathCacheKey& key, int ownerId,
+                       const std::vector<Math::Vector>& points, long long computeTime)
+{
+    Cancel(ownerId);
+    if (points.size() < 2) return;
+
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                           [&key](const Entry& entry) { return entry.key == key; });
+    if (it == m_entries.end())
+    {
+        if (static_cast<int>(m_entries.size()) >= MAX_ENTRIES)
+        {
+            it = std::min_element(m_entries.begin(), m_entries.end(),
+                                  [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+        }
+        else
+        {
+            it = m_entries.insert(m_entries.end(), Entry());
+        }
+    }
+
+    it->key = key;
+    it->points = points;
+    it->computeTime = computeTime;
+    it->lastUse = ++m_useStamp;
+    CollectTiles(points, it->tiles);
+}
+
+void CPathCache::Cancel(int ownerId)
+{
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                   [ownerId](const PendingSearch& pending) { return pending.ownerId == ownerId; }),
+                    m_pending.end());
+}
+
+int CPathCache::GetLookupCount() const
+{
+    return m_lookupCount;
+}
+
+int CPathCache::GetHitCount() const
+{
+    return m_hitCount;
+}
+
+int CPathCache::GetCoalescedCount() const
+{
+    return m_coalescedCount;
+}
+
+long long CPathCache::GetSavedTime() const
+{
+    return m_savedTime;
+}
+
+void CPathCache::CollectTiles(const std::vector<Math::Vector>& points, std::vector<std::pair<int, int>>& tiles)
+{
+    const float tileSize = NAV_TILE_SIZE*NAV_CELL_SIZE;
+
+    // Samples the segments every half tile; the neighbors are included,
+    // as obstacles are indexed in the tiles they may block.
+    std::vector<int> indexes;
+    for (std::size_t i = 0; i+1 < points.size(); i++)
+    {
+        float dist = Math::DistanceProjected(points[i], points[i+1]);
+        int steps = static_cast<int>(dist/(tileSize*0.5f))+1;
+        for (int j = 0; j <= steps; j++)
+        {
+            Math::Vector pos = points[i]+(points[i+1]-points[i])*(static_cast<float>(j)/steps);
+            int tx = CNavGrid::PosToCell(pos.x)/NAV_TILE_SIZE;
+            int ty = CNavGrid::PosToCell(pos.z)/NAV_TILE_SIZE;
+            for (int y = ty-1; y <= ty+1; y++)
+            {
+                for (int x = tx-1; x <= tx+1; x++)
+                {
+                    if (x < 0 || y < 0 || x >= NAV_TILE_COUNT || y >= NAV_TILE_COUNT) continue;
+                    indexes.push_back(x+y*NAV_TILE_COUNT);
+                }
+            }
+        }
+    }
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+
+    tiles.clear();
+    for (int index : indexes)
+    {
+        tiles.push_back(std::make_pair(index, m_navGrid->GetTileRevision(index%NAV_TILE_COUNT, index/NAV_TILE_COUNT)));
+    }
+}
+
+bool CPathCache::TilesChanged(const std::vector<std::pair<int, int>>& tiles)
+{
+    for (const auto& tile : tiles)
+    {
+        if (m_navGrid->GetTileRevision(tile.first%NAV_TILE_COUNT, tile.first/NAV_TILE_COUNT) != tile.second)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,167 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/path_cache.h
+ * \brief Cache of the paths found by goto()
+ */
+
+#pragma once
+
+#include "math/vector.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+class CNavGrid;
+
+/**
+ * \struct PathCacheKey
+ * \brief Identifies a path request
+ *
+ * Requests from nearby start cells to the same goal cell, made by vehicles
+ * of the same class, share the key.
+ */
+struct PathCacheKey
+{
+    //! Start cell divided by PATH_CACHE_START_BUCKET
+    int     startX = 0, startY = 0;
+    //! Goal cell
+    int     goalX = 0, goalY = 0;
+    //! Distance to the goal at which the path ends, in tenths of game unit
+    int     goalRadius = 0;
+    //! Terrain layer of the vehicle (see CNavGrid::GetTerrainLayer())
+    int     layer = 0;
+    //! Radius of the vehicle, in tenths of game unit
+    int     radius = 0;
+    //! Flying altitude, 0 for ground vehicles
+    int     altitude = 0;
+    //! ID of the object ignored as an obstacle (carried object), or -1
+    int     ignoredId = -1;
+
+    bool operator==(const PathCacheKey& other) const;
+};
+
+//! Number of cells along one side of the square of start cells sharing a key
+const int PATH_CACHE_START_BUCKET = 4;
+
+/**
+ * \enum PathCacheResult
+ * \brief Result of CPathCache::Find()
+ */
+enum class PathCacheResult
+{
+    Hit,        //!< a valid path was found
+    Miss,       //!< no path, the caller must search and then call Store() or Cancel()
+    Pending,    //!< another robot is searching for this path, try again later
+};
+
+/**
+ * \class CPathCache
+ * \brief Recent paths found by goto(), shared by all robots
+ *
+ * Each path remembers the revisions of the navigation grid tiles it crosses
+ * (see CNavGrid::GetTileRevision()). As long as they don't change, only the
+ * first segment, from the actual position of the requester, has to be checked.
+ * Otherwise the whole path is checked again, and dropped if it is now blocked.
+ *
+ * Requests for a key which is being searched by another robot are coalesced:
+ * Find() returns PathCacheResult::Pending until that search is stored or cancelled.
+ */
+class CPathCache
+{
+public:
+    //! Returns true if the vehicle can go in a straight line between the two points
+    using TestFunction = std::function<bool(const Math::Vector& start, const Math::Vector& goal)>;
+
+    explicit CPathCache(CNavGrid* navGrid);
+    ~CPathCache();
+
+    //! Forgets all paths and statistics, used when the level changes
+    void        Clear();
+
+    /**
+     * \brief Looks for a path
+     * \param ownerId ID of the requesting object
+     * \param start actual position of the requester, replaces the first point
+     * \param goal replaces the last point if \a exactGoal is true
+     * \param test checks a segment of the path for the requester
+     * \param points receives the path on PathCacheResult::Hit
+     *
+     * On PathCacheResult::Miss, the key is reserved for \a ownerId until Store() or Cancel().
+     */
+    PathCacheResult Find(const PathCacheKey& key, int ownerId,
+                         const Math::Vector& start, const Math::Vector& goal, bool exactGoal,
+                         const TestFunction& test, std::vector<Math::Vector>& points);
+
+    /**
+     * \brief Stores the path found after a miss
+     * \param computeTime time spent in the search (in nanoseconds)
+     */
+    void        Store(const PathCacheKey& key, int ownerId,
+                      const std::vector<Math::Vector>& points, long long computeTime);
+
+    //! Releases the key reserved by the object, if any
+    void        Cancel(int ownerId);
+
+    //! Returns the number of lookups, without the ones waiting for another robot
+    int         GetLookupCount() const;
+    //! Returns the number of lookups which found a path
+    int         GetHitCount() const;
+    //! Returns the number of requests which waited for the search of another robot
+    int         GetCoalescedCount() const;
+    //! Returns the search time saved by the hits (in nanoseconds)
+    long long   GetSavedTime() const;
+
+protected:
+    struct Entry
+    {
+        PathCacheKey key;
+        std::vector<Math::Vector> points;
+        //! Tiles crossed by the path (index, revision)
+        std::vector<std::pair<int, int>> tiles;
+        long long   computeTime = 0;
+        int         lastUse = 0;
+    };
+
+    struct PendingSearch
+    {
+        PathCacheKey key;
+        int         ownerId = -1;
+        std::vector<int> waiters;
+    };
+
+    //! Lists the tiles around the path, with their current revision
+    void        CollectTiles(const std::vector<Math::Vector>& points, std::vector<std::pair<int, int>>& tiles);
+    //! Tests if the tiles changed since CollectTiles()
+    bool        TilesChanged(const std::vector<std::pair<int, int>>& tiles);
+
+protected:
+    CNavGrid*   m_navGrid;
+
+    std::vector<Entry> m_entries;
+    std::vector<PendingSearch> m_pending;
+    int         m_useStamp = 0;
+
+    int         m_lookupCount = 0;
+    int         m_hitCount = 0;
+    int         m_coalescedCount = 0;
+    long long   m_savedTime = 0;
+};
@@ -885,7 +885,7 @@ std::unique_ptr<CBaseBuilding> CBaseBuilding::Create(
         obj->SetAuto(std::move(objAuto));
     }
 
-    engine->LoadAllTextures();
+    obj->LoadTextures();
 
     obj->UpdateMapping();
 
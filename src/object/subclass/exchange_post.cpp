@@ -102,7 +102,7 @@ std::unique_ptr<CExchangePost> CExchangePost::Create(
     objAuto->Init();
     obj->SetAuto(std::move(objAuto));
 
-    engine->LoadAllTextures();
+    obj->LoadTextures();
 
     return obj;
 }
@@ -20,18 +20,26 @@
 
 #include "object/task/taskgoto.h"
 
+#include "app/app.h"
+
 #include "common/event.h"
 #include "common/global.h"
 #include "common/image.h"
+#include "common/logger.h"
 #include "common/make_unique.h"
 
+#include "common/system/system.h"
+
 #include "graphics/engine/terrain.h"
 #include "graphics/engine/water.h"
 
 #include "math/geometry.h"
 
+#include "object/grid_path_finder.h"
+#include "object/nav_grid.h"
 #include "object/object_manager.h"
 #include "object/old_object.h"
+#include "object/world_query.h"
 
 #include "object/interface/transportable_object.h"
 
@@ -46,8 +54,9 @@ const float FLY_DIST_GROUND = 80.0f;    // minimum distance to remain on the gro
 const float FLY_DEF_HEIGHT  = 50.0f;    // default flying height
 
 // Settings that define goto() accuracy:
-const float BM_DIM_STEP     = 5.0f;     // Size of one pixel on the bitmap. Setting 5 means that 5x5 square (in game units) will be represented by 1 px on the bitmap. Decreasing this value will make a bigger bitmap, and may increase accuracy. TODO: Check how it actually impacts goto() accuracy
-const float BEAM_ACCURACY   = 5.0f;    // higher value = more accurate, but slower
+const float BM_DIM_STEP     = NAV_CELL_SIZE;     // Size of one pixel on the bitmap. Setting 5 means that 5x5 square (in game units) will be represented by 1 px on the bitmap. Decreasing this value will make a bigger bitmap, and may increase accuracy. TODO: Check how it actually impacts goto() accuracy
+const float ASTAR_FRAME_TIME = 0.002f;  // CPU time (in seconds) that the A* search may use in one frame
+const int   ASTAR_SLICE     = 64;       // number of cells expanded between checks of the time limit
 const float SAFETY_MARGIN   = 0.5f;     // Smallest distance between two objects. Smaller = less "no route to destination", but higher probability of collisions between objects.
 // Changing SAFETY_MARGIN (old value was 4.0f) seems to have fixed many issues with goto(). TODO: maybe we could make it even smaller? Did changing it introduce any new bugs?
 
@@ -59,6 +68,12 @@ const float SAFETY_MARGIN   = 0.5f;     // Smallest distance between two objects
 CTaskGoto::CTaskGoto(COldObject* object) : CForegroundTask(object)
 {
     m_bmArray = nullptr;
+    m_navGrid = CObjectManager::GetInstancePointer()->GetNavGrid();
+    m_pathCache = CObjectManager::GetInstancePointer()->GetPathCache();
+
+    CSystemUtils* systemUtils = CApplication::GetInstancePointer()->GetSystemUtils();
+    m_bmSearchStart = systemUtils->CreateTimeStamp();
+    m_bmSearchNow = systemUtils->CreateTimeStamp();
 }
 
 // Object's destructor.
@@ -66,6 +81,11 @@ CTaskGoto::CTaskGoto(COldObject* object) : CForegroundTask(object)
 CTaskGoto::~CTaskGoto()
 {
     BitmapClose();
+    m_pathCache->Cancel(m_object->GetID());
+
+    CSystemUtils* systemUtils = CApplication::GetInstancePointer()->GetSystemUtils();
+    systemUtils->DestroyTimeStamp(m_bmSearchStart);
+    systemUtils->DestroyTimeStamp(m_bmSearchNow);
 
     if (m_engine->GetDebugGoto() && m_object->GetSelect())
         m_engine->SetDebugGotoBitmap(std::move(nullptr));
@@ -121,7 +141,7 @@ bool CTaskGoto::EventProcess(const Event &event)
                     for (int y = 0; y < m_bmSize; y++)
                     {
                         bool a = BitmapTestDot(0, x, y);
-                        bool b = BitmapTestDot(1, x, y);
+                        bool b = m_beamFinder.TestTrail(x, y);
                         if (a || b)
                         {
                             Gfx::Color c = Gfx::Color(0.0f, 0.0f, 0.0f, 1.0f);
@@ -200,12 +220,6 @@ bool CTaskGoto::EventProcess(const Event &event)
 
     if ( m_phase == TGP_BEAMSEARCH )  // search path?
     {
-        if ( m_bmStep == 0 )
-        {
-            // Frees the area around the departure.
-            BitmapClearCircle(m_object->GetPosition(), BM_DIM_STEP*1.8f);
-        }
-
         pos = m_object->GetPosition();
 
         if ( m_bmCargoObject == nullptr )
@@ -220,7 +234,55 @@ bool CTaskGoto::EventProcess(const Event &event)
             if ( m_bmCargoObject->GetType() == OBJECT_BASE )  dist = 12.0f;
         }
 
-        ret = BeamSearch(pos, goal, dist);
+        PathCacheResult cached = PathCacheResult::Miss;
+        if ( m_bmStep == 0 )
+        {
+            // Frees the area around the departure.
+            BitmapClearCircle(pos, BM_DIM_STEP*1.8f);
+
+            cached = PathCacheFind(pos, goal, dist);
+            if ( cached == PathCacheResult::Pending )  return true;  // another robot is searching the same path
+        }
+
+        if ( cached == PathCacheResult::Hit )
+        {
+            ret = ERR_OK;
+            GetLogger()->Debug("goto(): path found in cache, %d point(s)\n", m_bmTotal+1);
+        }
+        else
+        {
+            CSystemUtils* systemUtils = CApplication::GetInstancePointer()->GetSystemUtils();
+            systemUtils->GetCurrentTimeStamp(m_bmSearchStart);
+
+            if ( m_searchMode == TGS_ASTAR )
+            {
+                ret = PathSearch(pos, goal, dist);
+            }
+            else
+            {
+                ret = BeamSearch(pos, goal, dist);
+            }
+
+            systemUtils->GetCurrentTimeStamp(m_bmSearchNow);
+            m_bmSearchTime += systemUtils->TimeStampExactDiff(m_bmSearchStart, m_bmSearchNow);
+            if ( ret != ERR_CONTINUE )
+            {
+                GetLogger()->Debug("goto(): %s search ended with code %d after %d frame(s), %.2f ms, %d point(s)\n",
+                                   m_searchMode == TGS_ASTAR ? "A*" : "beam", ret, m_bmStep,
+                                   m_bmSearchTime/1000000.0f, ret == ERR_OK ? m_bmTotal+1 : 0);
+            }
+
+            if ( ret == ERR_OK )
+            {
+                std::vector<Math::Vector> points(m_bmPoints, m_bmPoints+m_bmTotal+1);
+                m_pathCache->Store(m_bmCacheKey, m_object->GetID(), points, m_bmSearchTime);
+            }
+            else if ( ret != ERR_CONTINUE )
+            {
+                m_pathCache->Cancel(m_object->GetID());
+            }
+        }
+
         if ( ret == ERR_OK )
         {
             if ( m_physics->GetLand() )  m_phase = TGP_BEAMWCOLD;
@@ -647,7 +709,8 @@ void CTaskGoto::WormFrame(float rTime)
 // "dist" is the distance that needs to go far to make a deposit or object.
 
 Error CTaskGoto::Start(Math::Vector goal, float altitude,
-                       TaskGotoGoal goalMode, TaskGotoCrash crashMode)
+                       TaskGotoGoal goalMode, TaskGotoCrash crashMode,
+                       TaskGotoSearch searchMode)
 {
     Math::Vector    pos;
     CObject*    target;
@@ -683,9 +746,19 @@ Error CTaskGoto::Start(Math::Vector goal, float altitude,
         }
     }
 
+    if ( searchMode == TGS_DEFAULT )
+    {
+        searchMode = TGS_BEAM;
+    }
+    if ( searchMode != TGS_BEAM && searchMode != TGS_ASTAR )
+    {
+        return ERR_UNKNOWN;
+    }
+
     m_altitude   = altitude;
     m_goalMode   = goalMode;
     m_crashMode  = crashMode;
+    m_searchMode = searchMode;
     m_goalObject = goal;
     m_goal       = goal;
 
@@ -1614,7 +1687,7 @@ int CTaskGoto::BeamShortcut()
 
     for ( i=m_bmTotal ; i>=m_bmIndex+2 ; i-- )  // tries from the last
     {
-        if ( BitmapTestLine(m_bmPoints[m_bmIndex], m_bmPoints[i], 0.0f, false) )
+        if ( BitmapTestLine(m_bmPoints[m_bmIndex], m_bmPoints[i]) )
         {
             return i;  // bingo, found
         }
@@ -1627,20 +1700,7 @@ int CTaskGoto::BeamShortcut()
 
 void CTaskGoto::BeamStart()
 {
-    Math::Vector    min, max;
-
     BitmapOpen();
-    BitmapObject();
-
-    min = m_object->GetPosition();
-    max = m_goal;
-    if ( min.x > max.x )  Math::Swap(min.x, max.x);
-    if ( min.z > max.z )  Math::Swap(min.z, max.z);
-    min.x -= 10.0f*BM_DIM_STEP;
-    min.z -= 10.0f*BM_DIM_STEP;
-    max.x += 10.0f*BM_DIM_STEP;
-    max.z += 10.0f*BM_DIM_STEP;
-    BitmapTerrain(min, max);
 
     if ( LeakSearch(m_leakPos, m_leakDelay) )
     {
@@ -1660,13 +1720,9 @@ void CTaskGoto::BeamStart()
 
 void CTaskGoto::BeamInit()
 {
-    int     i;
-
-    for ( i=0 ; i<MAXPOINTS ; i++ )
-    {
-        m_bmIter[i] = -1;
-    }
+    m_beamFinder.Start();
     m_bmStep = 0;
+    m_bmSearchTime = 0;
 }
 
 // Calculates points and passes to go from start to goal.
@@ -1680,226 +1736,252 @@ void CTaskGoto::BeamInit()
 Error CTaskGoto::BeamSearch(const Math::Vector &start, const Math::Vector &goal,
                             float goalRadius)
 {
-    float     step, len;
-    int       nbIter;
+    Error       ret;
+    int         i;
 
     m_bmStep ++;
 
-    len = Math::DistanceProjected(start, goal);
-    step = len/BEAM_ACCURACY;
-    if ( step < BM_DIM_STEP*2.1f )  step = BM_DIM_STEP*2.1f;
-    if ( step > 20.0f            )  step = 20.0f;
-    nbIter = 200;  // in order not to lower the framerate
-    m_bmIterCounter = 0;
-    return BeamExplore(start, start, goal, goalRadius, 165.0f*Math::PI/180.0f, 22, step, 0, nbIter);
+    ret = m_beamFinder.Continue(start, goal, goalRadius, 200);  // in order not to lower the framerate
+    m_bmChanged = true;
+
+    m_bmTotal = m_beamFinder.GetTotal();
+    for ( i=0 ; i<=m_bmTotal ; i++ )
+    {
+        m_bmPoints[i] = m_beamFinder.GetPoints()[i];
+    }
+    return ret;
 }
 
-// prevPos: previous position
-// curPos:  current position
-// goalPos: position that seeks to achieve
-// angle:   angle to the goal we explores
-// nbDiv:   number of subdivisions being done with angle
-// step     length of a step
-// i        number of recursions made
-// nbIter   maximum number of iterations you have the right to make before temporarily interrupt
-
-Error CTaskGoto::BeamExplore(const Math::Vector &prevPos, const Math::Vector &curPos,
-                             const Math::Vector &goalPos, float goalRadius,
-                             float angle, int nbDiv, float step,
-                             int i, int nbIter)
-{
-    Math::Vector    newPos;
-    Error       ret;
-    int         iDiv, iClear, iLar;
+// Calculates points and passes to go from start to goal, using A* on the bitmap.
+// The search is spread over several frames, it stops after ASTAR_FRAME_TIME.
+// Returns the same values as BeamSearch.
 
-    iLar = 0;
-    if ( i >= MAXPOINTS )  return ERR_GOTO_ITER;  // too many recursions
+Error CTaskGoto::PathSearch(const Math::Vector &start, const Math::Vector &goal,
+                            float goalRadius)
+{
+    CSystemUtils*   systemUtils;
+    Error           ret;
 
-    m_bmTotal = i;
+    m_bmStep ++;
 
-    if ( m_bmIter[i] == -1 )
+    if ( m_bmStep == 1 )
     {
-        m_bmIter[i] = 0;
-
-        if ( i == 0 )
+        if ( m_pathFinder == nullptr )
         {
-            m_bmPoints[i] = curPos;
+            m_pathFinder = MakeUnique<CGridPathFinder>();
         }
-        else
-        {
-            if ( !BitmapTestLine(prevPos, curPos, angle/nbDiv, true) )  return ERR_GOTO_IMPOSSIBLE;
-
-            m_bmPoints[i] = curPos;
 
-            if ( Math::DistanceProjected(curPos, goalPos)-goalRadius <= step )
-            {
-                if ( goalRadius == 0.0f )
-                {
-                    newPos = goalPos;
-                }
-                else
-                {
-                    newPos = BeamPoint(curPos, goalPos, 0, Math::DistanceProjected(curPos, goalPos)-goalRadius);
-                }
-                if ( BitmapTestLine(curPos, newPos, angle/nbDiv, false) )
-                {
-                    m_bmPoints[i+1] = newPos;
-                    m_bmTotal = i+1;
-                    return ERR_OK;
-                }
-            }
-        }
+        Math::IntPoint startCell(CNavGrid::PosToCell(start.x), CNavGrid::PosToCell(start.z));
+        Math::IntPoint goalCell(CNavGrid::PosToCell(goal.x), CNavGrid::PosToCell(goal.z));
+        m_pathFinder->Start(m_bmSize, startCell, goalCell, goalRadius/BM_DIM_STEP,
+                            [this](int x, int y) { return BitmapTestDot(0, x, y); });
     }
 
-    if ( iLar >= m_bmIter[i] )
+    systemUtils = CApplication::GetInstancePointer()->GetSystemUtils();
+    while ( true )
     {
-        newPos = BeamPoint(curPos, goalPos, 0, step);
-        ret = BeamExplore(curPos, newPos, goalPos, goalRadius, angle, nbDiv, step, i+1, nbIter);
-        if ( ret != ERR_GOTO_IMPOSSIBLE )  return ret;
-        m_bmIter[i] = iLar+1;
-        for ( iClear=i+1 ; iClear<=MAXPOINTS ; iClear++ )  m_bmIter[iClear] = -1;
-        m_bmIterCounter ++;
-        if ( m_bmIterCounter >= nbIter )  return ERR_CONTINUE;
+        ret = m_pathFinder->Continue(ASTAR_SLICE);
+        if ( ret != ERR_CONTINUE )  break;
+
+        systemUtils->GetCurrentTimeStamp(m_bmSearchNow);
+        if ( systemUtils->TimeStampExactDiff(m_bmSearchStart, m_bmSearchNow) > ASTAR_FRAME_TIME*1e9f )  break;
     }
-    iLar ++;
 
-    for ( iDiv=1 ; iDiv<=nbDiv ; iDiv++ )
+    if ( ret == ERR_OK )
     {
-        if ( iLar >= m_bmIter[i] )
-        {
-            newPos = BeamPoint(curPos, goalPos, angle*iDiv/nbDiv, step);
-            ret = BeamExplore(curPos, newPos, goalPos, goalRadius, angle, nbDiv, step, i+1, nbIter);
-            if ( ret != ERR_GOTO_IMPOSSIBLE )  return ret;
-            m_bmIter[i] = iLar+1;
-            for ( iClear=i+1 ; iClear<=MAXPOINTS ; iClear++ )  m_bmIter[iClear] = -1;
-            m_bmIterCounter ++;
-            if ( m_bmIterCounter >= nbIter )  return ERR_CONTINUE;
-        }
-        iLar ++;
-
-        if ( iLar >= m_bmIter[i] )
-        {
-            newPos = BeamPoint(curPos, goalPos, -angle*iDiv/nbDiv, step);
-            ret = BeamExplore(curPos, newPos, goalPos, goalRadius, angle, nbDiv, step, i+1, nbIter);
-            if ( ret != ERR_GOTO_IMPOSSIBLE )  return ret;
-            m_bmIter[i] = iLar+1;
-            for ( iClear=i+1 ; iClear<=MAXPOINTS ; iClear++ )  m_bmIter[iClear] = -1;
-            m_bmIterCounter ++;
-            if ( m_bmIterCounter >= nbIter )  return ERR_CONTINUE;
-        }
-        iLar ++;
+        ret = PathPoints(start, goal, goalRadius);
     }
-
-    return ERR_GOTO_IMPOSSIBLE;
+    if ( ret != ERR_CONTINUE )
+    {
+        m_pathFinder->Clear();
+    }
+    return ret;
 }
 
-// Is a right "start-goal". Calculates the point located at the distance "step"
-// from the point "start" and an angle "angle" with the right.
+// Looks for a path found recently by a robot of the same class.
+// Returns PathCacheResult::Hit if m_bmPoints have been filled,
+// PathCacheResult::Pending if another robot is searching it right now.
 
-Math::Vector CTaskGoto::BeamPoint(const Math::Vector &startPoint,
-                               const Math::Vector &goalPoint,
-                               float angle, float step)
+PathCacheResult CTaskGoto::PathCacheFind(const Math::Vector &start, const Math::Vector &goal,
+                                         float goalRadius)
 {
-    Math::Vector    resPoint;
-    float       goalAngle;
+    std::vector<Math::Vector> points;
+    PathCacheResult result;
+    int             i;
 
-    goalAngle = Math::RotateAngle(goalPoint.x-startPoint.x, goalPoint.z-startPoint.z);
+    m_bmCacheKey.startX = Math::Clamp(CNavGrid::PosToCell(start.x), 0, NAV_GRID_SIZE-1)/PATH_CACHE_START_BUCKET;
+    m_bmCacheKey.startY = Math::Clamp(CNavGrid::PosToCell(start.z), 0, NAV_GRID_SIZE-1)/PATH_CACHE_START_BUCKET;
+    m_bmCacheKey.goalX = Math::Clamp(CNavGrid::PosToCell(goal.x), 0, NAV_GRID_SIZE-1);
+    m_bmCacheKey.goalY = Math::Clamp(CNavGrid::PosToCell(goal.z), 0, NAV_GRID_SIZE-1);
+    m_bmCacheKey.goalRadius = static_cast<int>(goalRadius*10.0f+0.5f);
+    m_bmCacheKey.layer = m_bmTerrainLayer;
+    m_bmCacheKey.radius = static_cast<int>(m_bmRadius*10.0f+0.5f);
+    m_bmCacheKey.altitude = 0;
+    if ( m_object->Implements(ObjectInterfaceType::Flying) && m_altitude > 0.0f )
+    {
+        m_bmCacheKey.altitude = static_cast<int>(m_altitude+0.5f);
+    }
+    m_bmCacheKey.ignoredId = m_bmCargoObject == nullptr ? -1 : m_bmCargoObject->GetID();
 
-    resPoint.x = startPoint.x + cosf(goalAngle+angle)*step;
-    resPoint.z = startPoint.z + sinf(goalAngle+angle)*step;
-    resPoint.y = 0.0f;
+    result = m_pathCache->Find(m_bmCacheKey, m_object->GetID(), start, goal, goalRadius == 0.0f,
+                               [this](const Math::Vector& a, const Math::Vector& b) { return BitmapTestLine(a, b); },
+                               points);
+    if ( result != PathCacheResult::Hit )  return result;
 
-    return resPoint;
+    for ( i=0 ; i<static_cast<int>(points.size()) ; i++ )
+    {
+        m_bmPoints[i] = points[i];
+    }
+    m_bmTotal = static_cast<int>(points.size())-1;
+    return result;
 }
 
-// Tests if a path along a straight line is possible.
+// Converts the cells found by the A* search to the list of points m_bmPoints.
+// Only the turning points are kept, then the ones which can be skipped
+// by going in a straight line are removed.
 
-bool CTaskGoto::BitmapTestLine(const Math::Vector &start, const Math::Vector &goal,
-                               float stepAngle, bool bSecond)
+Error CTaskGoto::PathPoints(const Math::Vector &start, const Math::Vector &goal,
+                            float goalRadius)
 {
-    Math::Vector    pos, inc;
-    float       dist, step;
-    float       distNoB2;
-    int         i, max, x, y;
-
-    if ( m_bmArray == nullptr )  return true;
+    std::vector<Math::Vector> points;
+    Math::Vector    pos;
+    float           dist;
+    int             i, j, total;
 
-    dist = Math::DistanceProjected(start, goal);
-    if ( dist == 0.0f )  return true;
-    step = BM_DIM_STEP*0.5f;
+    const std::vector<Math::IntPoint>& cells = m_pathFinder->GetPath();
 
-    inc.x = (goal.x-start.x)*step/dist;
-    inc.z = (goal.z-start.z)*step/dist;
+    points.push_back(start);
+    for ( i=1 ; i<static_cast<int>(cells.size()) ; i++ )
+    {
+        if ( i < static_cast<int>(cells.size())-1 &&
+             cells[i].x-cells[i-1].x == cells[i+1].x-cells[i].x &&
+             cells[i].y-cells[i-1].y == cells[i+1].y-cells[i].y )  continue;  // same direction
 
-    pos = start;
+        pos.x = CNavGrid::CellToPos(cells[i].x)+BM_DIM_STEP*0.5f;
+        pos.z = CNavGrid::CellToPos(cells[i].y)+BM_DIM_STEP*0.5f;
+        pos.y = 0.0f;
+        points.push_back(pos);
+    }
 
-    if ( bSecond )
+    // Goes exactly to the goal, or stops at goalRadius from it.
+    pos = points.back();
+    if ( goalRadius == 0.0f )
     {
-        x = static_cast<int>((pos.x+1600.0f)/BM_DIM_STEP);
-        y = static_cast<int>((pos.z+1600.0f)/BM_DIM_STEP);
-        BitmapSetDot(1, x, y);  // puts the flag as the starting point
+        pos = goal;
     }
-
-    max = static_cast<int>(dist/step);
-    if ( max == 0 )  max = 1;
-    distNoB2 = BM_DIM_STEP*sqrtf(2.0f)/sinf(stepAngle);
-    for ( i=0 ; i<max ; i++ )
+    else
     {
-        if ( i == max-1 )
+        dist = Math::DistanceProjected(pos, goal);
+        if ( dist > goalRadius )
         {
-            pos = goal;  // tests the point of arrival
+            pos = CBeamPathFinder::Point(pos, goal, 0.0f, dist-goalRadius);
         }
-        else
+    }
+    if ( points.size() == 1 )
+    {
+        points.push_back(pos);
+    }
+    else
+    {
+        points.back() = pos;
+    }
+
+    // Removes the unnecessary intermediate points.
+    m_bmPoints[0] = points[0];
+    total = 0;
+    i = 0;
+    while ( i < static_cast<int>(points.size())-1 )
+    {
+        for ( j=static_cast<int>(points.size())-1 ; j>i+1 ; j-- )
         {
-            pos.x += inc.x;
-            pos.z += inc.z;
+            if ( BitmapTestLine(points[i], points[j]) )  break;
         }
 
-        x = static_cast<int>((pos.x+1600.0f)/BM_DIM_STEP);
-        y = static_cast<int>((pos.z+1600.0f)/BM_DIM_STEP);
+        if ( total >= MAXPOINTS )  return ERR_GOTO_ITER;
+        m_bmPoints[++total] = points[j];
+        i = j;
+    }
+    m_bmTotal = total;
 
-        if ( bSecond )
-        {
-            if ( i > 2 && BitmapTestDot(1, x, y) )  return false;
+    return ERR_OK;
+}
 
-            if ( step*(i+1) > distNoB2 && i < max-2 )
-            {
-                BitmapSetDot(1, x, y);
-            }
-        }
+// Tests if a path along a straight line is possible.
+// Every cell crossed by the line is tested, except the starting one.
 
-        if ( BitmapTestDot(0, x, y) )  return false;
-    }
-    return true;
+bool CTaskGoto::BitmapTestLine(const Math::Vector &start, const Math::Vector &goal)
+{
+    if ( m_bmArray == nullptr )  return true;
+
+    bool first = true;
+    bool free = true;
+    CWorldQuery::TraverseCells(start, goal, BM_DIM_STEP, m_bmSize*BM_DIM_STEP/2.0f,
+                               [&](int x, int y, float, float)
+    {
+        if ( first )
+        {
+            first = false;
+            return true;
+        }
+        free = !BitmapTestDot(0, x, y);
+        return free;
+    });
+    return free;
 }
 
-// Adds the objects in the bitmap.
+// Fills one tile of the bitmap from the shared navigation grid.
+// Only the tiles actually used by the search are filled.
 
-void CTaskGoto::BitmapObject()
+void CTaskGoto::BitmapTile(int tx, int ty)
 {
-    auto firstCrashSphere = m_object->GetFirstCrashSphere();
-    float iRadius = firstCrashSphere.sphere.radius;
+    int     minx, miny, maxx, maxy, x, y;
+    bool    bFly;
+    float   h;
 
-    for (CObject* pObj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    m_bmTiles[tx+ty*NAV_TILE_COUNT] = true;
+
+    minx = tx*NAV_TILE_SIZE;
+    miny = ty*NAV_TILE_SIZE;
+    maxx = minx+NAV_TILE_SIZE-1;
+    maxy = miny+NAV_TILE_SIZE-1;
+
+    // Adds the section of land.
+    if ( !m_navGrid->IsTerrainTileFree(m_bmTerrainLayer, tx, ty) )
     {
-        ObjectType type = pObj->GetType();
+        for ( y=miny ; y<=maxy ; y++ )
+        {
+            for ( x=minx ; x<=maxx ; x++ )
+            {
+                if ( m_navGrid->TestTerrain(m_bmTerrainLayer, x, y) )
+                {
+                    BitmapSetDot(0, x, y);
+                }
+            }
+        }
+    }
 
-        if ( pObj == m_object )  continue;
-        if ( pObj == m_bmCargoObject )  continue;
-        if (IsObjectBeingTransported(pObj))  continue;
+    // Adds the objects.
+    bFly = m_object->Implements(ObjectInterfaceType::Flying) && m_altitude > 0.0f;
 
-        float h = m_terrain->GetFloorLevel(pObj->GetPosition(), false);
-        if ( m_object->Implements(ObjectInterfaceType::Flying) && m_altitude > 0.0f )
+    m_bmObstacles.clear();
+    m_navGrid->GetObstacles(minx, miny, maxx, maxy, m_bmRadius+SAFETY_MARGIN, m_bmObstacles);
+    for (const NavObstacle* obstacle : m_bmObstacles)
+    {
+        if ( obstacle->object == m_object )  continue;
+        if ( obstacle->object == m_bmCargoObject )  continue;
+
+        h = obstacle->floorLevel;
+        if ( bFly )
         {
             h += m_altitude;
         }
 
-        for (const auto& crashSphere : pObj->GetAllCrashSpheres())
+        for (const Math::Sphere& sphere : obstacle->spheres)
         {
-            Math::Vector oPos = crashSphere.sphere.pos;
-            float oRadius = crashSphere.sphere.radius;
+            Math::Vector oPos = sphere.pos;
+            float oRadius = sphere.radius;
 
-            if ( m_object->Implements(ObjectInterfaceType::Flying) && m_altitude > 0.0f )  // flying?
+            if ( bFly )  // flying?
             {
                 if ( oPos.y-oRadius > h+8.0f ||
                      oPos.y+oRadius < h-8.0f )  continue;
@@ -1909,51 +1991,33 @@ void CTaskGoto::BitmapObject()
                 if ( oPos.y-oRadius > h+8.0f )  continue;
             }
 
-            if ( type == OBJECT_PARA )  oRadius -= 2.0f;
-            BitmapSetCircle(oPos, oRadius+iRadius+SAFETY_MARGIN);
+            if ( obstacle->type == OBJECT_PARA )  oRadius -= 2.0f;
+            BitmapSetCircle(oPos, oRadius+m_bmRadius+SAFETY_MARGIN, minx, miny, maxx, maxy);
         }
     }
 }
 
-// Adds a section of land in the bitmap.
-
-void CTaskGoto::BitmapTerrain(const Math::Vector &min, const Math::Vector &max)
-{
-    int     minx, miny, maxx, maxy;
-
-    minx = static_cast<int>((min.x+1600.0f)/BM_DIM_STEP);
-    miny = static_cast<int>((min.z+1600.0f)/BM_DIM_STEP);
-    maxx = static_cast<int>((max.x+1600.0f)/BM_DIM_STEP);
-    maxy = static_cast<int>((max.z+1600.0f)/BM_DIM_STEP);
-
-    BitmapTerrain(minx, miny, maxx, maxy);
-}
-
-// Adds a section of land in the bitmap.
+// Opens an empty bitmap.
 
-void CTaskGoto::BitmapTerrain(int minx, int miny, int maxx, int maxy)
+bool CTaskGoto::BitmapOpen()
 {
     ObjectType  type;
-    Math::Vector    p;
-    float       aLimit, angle, h;
-    int         x, y;
+    float       aLimit;
     bool        bAcceptWater, bFly;
 
-    if ( minx > maxx )  Math::Swap(minx, maxx);
-    if ( miny > maxy )  Math::Swap(miny, maxy);
+    BitmapClose();
+
+    m_bmSize = NAV_GRID_SIZE;
+    m_bmArray = MakeUniqueArray<unsigned char>(m_bmSize*m_bmSize/8);
+    m_beamFinder.Init(m_bmSize, BM_DIM_STEP, [this](int x, int y) { return BitmapTestDot(0, x, y); });
+    m_bmChanged = true;
 
-    if ( minx < 0          )  minx = 0;
-    if ( miny < 0          )  miny = 0;
-    if ( maxx > m_bmSize-1 )  maxx = m_bmSize-1;
-    if ( maxy > m_bmSize-1 )  maxy = m_bmSize-1;
+    m_bmOffset = m_bmSize/2;
+    m_bmLine = m_bmSize/8;
 
-    if ( minx > m_bmMinX )  minx = m_bmMinX;
-    if ( miny > m_bmMinY )  miny = m_bmMinY;
-    if ( maxx < m_bmMaxX )  maxx = m_bmMaxX;
-    if ( maxy < m_bmMaxY )  maxy = m_bmMaxY;
+    m_bmTiles.assign(NAV_TILE_COUNT*NAV_TILE_COUNT, false);  // nothing filled yet
 
-    if ( minx >= m_bmMinX && maxx <= m_bmMaxX &&
-         miny >= m_bmMinY && maxy <= m_bmMaxY )  return;
+    m_bmRadius = m_object->GetFirstCrashSphere().sphere.radius;
 
     aLimit = 20.0f*Math::PI/180.0f;
     bAcceptWater = false;
@@ -2016,70 +2080,7 @@ void CTaskGoto::BitmapTerrain(int minx, int miny, int maxx, int maxy)
         aLimit = 60.0f*Math::PI/180.0f;
     }
 
-    for ( y=miny ; y<=maxy ; y++ )
-    {
-        for ( x=minx ; x<=maxx ; x++ )
-        {
-            if ( x >= m_bmMinX && x <= m_bmMaxX &&
-                 y >= m_bmMinY && y <= m_bmMaxY )  continue;
-
-            p.x = x*BM_DIM_STEP-1600.0f;
-            p.z = y*BM_DIM_STEP-1600.0f;
-
-            if ( bFly )  // flying robot?
-            {
-                h = m_terrain->GetFloorLevel(p, true);
-                if ( h >= m_terrain->GetFlyingMaxHeight()-5.0f )
-                {
-                    BitmapSetDot(0, x, y);
-                }
-                continue;
-            }
-
-            if ( !bAcceptWater )  // not going underwater?
-            {
-                h = m_terrain->GetFloorLevel(p, true);
-                if ( h < m_water->GetLevel()-2.0f )  // under water (*)?
-                {
-//?                 BitmapSetDot(0, x, y);
-                    BitmapSetCircle(p, BM_DIM_STEP*1.0f);
-                    continue;
-                }
-            }
-
-            angle = m_terrain->GetFineSlope(p);
-            if ( angle > aLimit )
-            {
-                BitmapSetDot(0, x, y);
-            }
-        }
-    }
-
-    m_bmMinX = minx;
-    m_bmMinY = miny;
-    m_bmMaxX = maxx;
-    m_bmMaxY = maxy;  // expanded rectangular area
-}
-
-// (*)  Accepts that a robot is 50cm under water, for example Tropica 3!
-
-// Opens an empty bitmap.
-
-bool CTaskGoto::BitmapOpen()
-{
-    BitmapClose();
-
-    m_bmSize = static_cast<int>(3200.0f/BM_DIM_STEP);
-    m_bmArray = MakeUniqueArray<unsigned char>(m_bmSize*m_bmSize/8*2);
-    m_bmChanged = true;
-
-    m_bmOffset = m_bmSize/2;
-    m_bmLine = m_bmSize/8;
-
-    m_bmMinX = m_bmSize;  // non-existent rectangular area
-    m_bmMinY = m_bmSize;
-    m_bmMaxX = 0;
-    m_bmMaxY = 0;
+    m_bmTerrainLayer = m_navGrid->GetTerrainLayer(aLimit, bAcceptWater, bFly);
 
     return true;
 }
@@ -2089,13 +2090,15 @@ bool CTaskGoto::BitmapOpen()
 bool CTaskGoto::BitmapClose()
 {
     m_bmArray.reset();
+    m_beamFinder.Clear();
     m_bmChanged = true;
     return true;
 }
 
-// Puts a circle in the bitmap.
+// Puts a circle in the bitmap, limited to a rectangle.
 
-void CTaskGoto::BitmapSetCircle(const Math::Vector &pos, float radius)
+void CTaskGoto::BitmapSetCircle(const Math::Vector &pos, float radius,
+                                int minx, int miny, int maxx, int maxy)
 {
     float   d, r;
     int     cx, cy, ix, iy;
@@ -2104,9 +2107,9 @@ void CTaskGoto::BitmapSetCircle(const Math::Vector &pos, float radius)
     cy = static_cast<int>((pos.z+1600.0f)/BM_DIM_STEP);
     r = radius/BM_DIM_STEP;
 
-    for ( iy=cy-static_cast<int>(r) ; iy<=cy+static_cast<int>(r) ; iy++ )
+    for ( iy=Math::Max(cy-static_cast<int>(r), miny) ; iy<=Math::Min(cy+static_cast<int>(r), maxy) ; iy++ )
     {
-        for ( ix=cx-static_cast<int>(r) ; ix<=cx+static_cast<int>(r) ; ix++ )
+        for ( ix=Math::Max(cx-static_cast<int>(r), minx) ; ix<=Math::Min(cx+static_cast<int>(r), maxx) ; ix++ )
         {
             d = Math::Point(static_cast<float>(ix-cx), static_cast<float>(iy-cy)).Length();
             if ( d > r )  continue;
@@ -2157,6 +2160,11 @@ void CTaskGoto::BitmapClearDot(int rank, int x, int y)
     if ( x < 0 || x >= m_bmSize ||
          y < 0 || y >= m_bmSize )  return;
 
+    if ( !m_bmTiles[x/NAV_TILE_SIZE+y/NAV_TILE_SIZE*NAV_TILE_COUNT] )
+    {
+        BitmapTile(x/NAV_TILE_SIZE, y/NAV_TILE_SIZE);  // not to be filled again later
+    }
+
     m_bmArray[rank*m_bmLine*m_bmSize + m_bmLine*y + x/8] &= ~(1<<x%8);
     m_bmChanged = true;
 }
@@ -2169,10 +2177,9 @@ bool CTaskGoto::BitmapTestDot(int rank, int x, int y)
     if ( x < 0 || x >= m_bmSize ||
          y < 0 || y >= m_bmSize )  return false;
 
-    if ( x < m_bmMinX || x > m_bmMaxX ||
-         y < m_bmMinY || y > m_bmMaxY )
+    if ( !m_bmTiles[x/NAV_TILE_SIZE+y/NAV_TILE_SIZE*NAV_TILE_COUNT] )
     {
-        BitmapTerrain(x-10,y-10, x+10,y+10);  // remade a layer
+        BitmapTile(x/NAV_TILE_SIZE, y/NAV_TILE_SIZE);
     }
 
     return m_bmArray[rank*m_bmLine*m_bmSize + m_bmLine*y + x/8] & (1<<x%8);
@@ -23,7 +23,11 @@
 
 #include "math/vector.h"
 
+#include "object/beam_path_finder.h"
+#include "object/path_cache.h"
+
 #include <memory>
+#include <vector>
 
 namespace Math
 {
@@ -32,8 +36,12 @@ struct Point;
 
 
 class CObject;
+class CGridPathFinder;
+class CNavGrid;
+struct NavObstacle;
+struct SystemTimeStamp;
 
-const int MAXPOINTS = 500;
+const int MAXPOINTS = BEAM_MAX_POINTS;
 
 
 enum TaskGotoGoal
@@ -54,6 +62,13 @@ enum TaskGotoCrash
     TGC_BEAM        = 5,    // algorithm "sunlight"
 };
 
+enum TaskGotoSearch
+{
+    TGS_DEFAULT     = -1,   // default mode
+    TGS_BEAM        = 0,    // path search with rays
+    TGS_ASTAR       = 1,    // path search with A* on the bitmap
+};
+
 
 enum TaskGotoPhase
 {
@@ -85,7 +100,7 @@ public:
 
     bool        EventProcess(const Event &event) override;
 
-    Error       Start(Math::Vector goal, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode);
+    Error       Start(Math::Vector goal, float altitude, TaskGotoGoal goalMode, TaskGotoCrash crashMode, TaskGotoSearch searchMode = TGS_DEFAULT);
     Error       IsEnded() override;
 
 protected:
@@ -103,16 +118,16 @@ protected:
     void        BeamStart();
     void        BeamInit();
     Error       BeamSearch(const Math::Vector &start, const Math::Vector &goal, float goalRadius);
-    Error       BeamExplore(const Math::Vector &prevPos, const Math::Vector &curPos, const Math::Vector &goalPos, float goalRadius, float angle, int nbDiv, float step, int i, int nbIter);
-    Math::Vector    BeamPoint(const Math::Vector &startPoint, const Math::Vector &goalPoint, float angle, float step);
 
-    bool        BitmapTestLine(const Math::Vector &start, const Math::Vector &goal, float stepAngle, bool bSecond);
-    void        BitmapObject();
-    void        BitmapTerrain(const Math::Vector &min, const Math::Vector &max);
-    void        BitmapTerrain(int minx, int miny, int maxx, int maxy);
+    Error       PathSearch(const Math::Vector &start, const Math::Vector &goal, float goalRadius);
+    Error       PathPoints(const Math::Vector &start, const Math::Vector &goal, float goalRadius);
+    PathCacheResult PathCacheFind(const Math::Vector &start, const Math::Vector &goal, float goalRadius);
+
+    bool        BitmapTestLine(const Math::Vector &start, const Math::Vector &goal);
+    void        BitmapTile(int tx, int ty);
     bool        BitmapOpen();
     bool        BitmapClose();
-    void        BitmapSetCircle(const Math::Vector &pos, float radius);
+    void        BitmapSetCircle(const Math::Vector &pos, float radius, int minx, int miny, int maxx, int maxy);
     void        BitmapClearCircle(const Math::Vector &pos, float radius);
     void        BitmapSetDot(int rank, int x, int y);
     void        BitmapClearDot(int rank, int x, int y);
@@ -125,6 +140,7 @@ protected:
     float           m_altitude = 0.0f;
     TaskGotoCrash   m_crashMode = TGC_DEFAULT;
     TaskGotoGoal    m_goalMode = TGG_DEFAULT;
+    TaskGotoSearch  m_searchMode = TGS_BEAM;
     TaskGotoPhase   m_phase = TGP_ADVANCE;
     int             m_try = 0;
     Error           m_error = ERR_OK;
@@ -142,19 +158,27 @@ protected:
     int             m_bmOffset = 0;     // m_bmSize/2
     int             m_bmLine = 0;       // increment line m_bmSize/8
     std::unique_ptr<unsigned char[]> m_bmArray;      // bit table
-    int             m_bmMinX = 0, m_bmMinY = 0;
-    int             m_bmMaxX = 0, m_bmMaxY = 0;
+    std::vector<bool> m_bmTiles;        // tiles of m_bmArray already filled from the navigation grid
+    CNavGrid*       m_navGrid = nullptr;
+    int             m_bmTerrainLayer = 0;
+    float           m_bmRadius = 0.0f;  // radius of this object, added around obstacles
+    std::vector<const NavObstacle*> m_bmObstacles;
     int             m_bmTotal = 0;      // number of points in m_bmPoints
     int             m_bmIndex = 0;      // index in m_bmPoints
     Math::Vector        m_bmPoints[MAXPOINTS+2];
-    char            m_bmIter[MAXPOINTS+2] = {};
-    int             m_bmIterCounter = 0;
     CObject*        m_bmCargoObject = nullptr;
     float           m_bmFinalMove = 0.0f;  // final advance distance
     float           m_bmFinalDist = 0.0f;  // effective distance to advance
     Math::Vector        m_bmFinalPos;   // initial position before advance
     float           m_bmTimeLimit = 0.0f;
     int             m_bmStep = 0;
+    std::unique_ptr<CGridPathFinder> m_pathFinder;
+    CBeamPathFinder m_beamFinder;
+    CPathCache*     m_pathCache = nullptr;
+    PathCacheKey    m_bmCacheKey;
+    SystemTimeStamp* m_bmSearchStart = nullptr;
+    SystemTimeStamp* m_bmSearchNow = nullptr;
+    long long       m_bmSearchTime = 0;     // CPU time spent searching the path (ns)
     Math::Vector        m_bmWatchDogPos;
     float           m_bmWatchDogTime = 0.0f;
     Math::Vector        m_leakPos;      // initial position leak
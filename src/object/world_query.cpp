@@ -0,0 +1,438 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/world_query.h"
+
+#include "math/func.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace
+{
+
+//! Finds where the segment enters the sphere, 0 if it starts inside
+bool IntersectSphere(const Math::Vector& p1, const Math::Vector& p2, const Math::Sphere& sphere, float& distance)
+{
+    Math::Vector m = p1 - sphere.pos;
+    float c = Math::DotProduct(m, m) - sphere.radius*sphere.radius;
+    if (c < 0.0f)
+    {
+        distance = 0.0f;
+        return true;
+    }
+
+    float length = Math::Distance(p1, p2);
+    if (length == 0.0f) return false;
+
+    float b = Math::DotProduct(m, (p2 - p1) / length);
+    if (b > 0.0f) return false;  // going away from the sphere
+
+    float discriminant = b*b - c;
+    if (discriminant < 0.0f) return false;
+
+    float t = -b - sqrtf(discriminant);
+    if (t > length) return false;
+
+    distance = t;
+    return true;
+}
+
+} // anonymous namespace
+
+
+CWorldQuery::CWorldQuery(const ObjectUpdateFunction& updateObjects)
+    : m_updateObjects(updateObjects),
+      m_cells(WORLD_QUERY_GRID_SIZE*WORLD_QUERY_GRID_SIZE)
+{
+}
+
+CWorldQuery::~CWorldQuery()
+{
+}
+
+void CWorldQuery::Reset()
+{
+    m_entries.clear();
+    for (std::vector<int>& ids : m_cells)
+    {
+        ids.clear();
+    }
+    m_objectsChanged = true;
+}
+
+void CWorldQuery::SetObjectsChanged()
+{
+    m_objectsChanged = true;
+}
+
+void CWorldQuery::SetObject(int id, CObject* object, const Math::Vector& position,
+                            const SpheresFunction& getCrashSpheres, const Math::Sphere& cameraSphere)
+{
+    bool added = m_entries.count(id) == 0;
+    Entry& entry = m_entries[id];
+    entry.seenStamp = m_seenStamp;
+    entry.order = m_order++;
+
+    entry.crashSpheres.clear();
+    getCrashSpheres(entry.crashSpheres);
+    entry.cameraSphere = cameraSphere;
+
+    float radius = 0.0f;
+    for (const Math::Sphere& sphere : entry.crashSpheres)
+    {
+        radius = Math::Max(radius, Math::Distance(position, sphere.pos)+sphere.radius);
+    }
+    if (cameraSphere.radius > 0.0f)
+        radius = Math::Max(radius, Math::Distance(position, cameraSphere.pos)+cameraSphere.radius);
+
+    if (!added &&
+        entry.object == object &&
+        entry.position.x == position.x &&
+        entry.position.y == position.y &&
+        entry.position.z == position.z &&
+        entry.radius >= radius)  return;
+
+    if (!added)
+        IndexEntry(id, entry, false);
+
+    entry.object = object;
+    entry.position = position;
+    entry.radius = radius;
+    IndexEntry(id, entry, true);
+}
+
+void CWorldQuery::SetTerrain(float cellSize, const FloorLevelFunction& getFloorLevel)
+{
+    m_terrainCellSize = cellSize;
+    m_getFloorLevel = getFloorLevel;
+}
+
+void CWorldQuery::GetObjectsInBox(const Math::Vector& min, const Math::Vector& max, std::vector<CObject*>& result)
+{
+    result.clear();
+    Update();
+
+    int minX = PosToCell(min.x);
+    int minY = PosToCell(min.z);
+    int maxX = PosToCell(max.x);
+    int maxY = PosToCell(max.z);
+
+    m_queryStamp ++;
+    m_candidates.clear();
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            for (int id : m_cells[x+y*WORLD_QUERY_GRID_SIZE])
+            {
+                Entry& entry = m_entries[id];
+                if (entry.queryStamp == m_queryStamp) continue;
+                entry.queryStamp = m_queryStamp;
+
+                // Box of the bound, like the tests done by the callers on the spheres it contains
+                const Math::Vector& pos = entry.position;
+                float r = entry.radius;
+                if ( pos.x+r < min.x || pos.x-r > max.x ||
+                     pos.y+r < min.y || pos.y-r > max.y ||
+                     pos.z+r < min.z || pos.z-r > max.z )  continue;
+
+                m_candidates.push_back(&entry);
+            }
+        }
+    }
+
+    std::sort(m_candidates.begin(), m_candidates.end(),
+              [](const Entry* a, const Entry* b) { return a->order < b->order; });
+    for (const Entry* entry : m_candidates)
+    {
+        result.push_back(entry->object);
+    }
+}
+
+void CWorldQuery::GetObjectsNearSegment(const Math::Vector& p1, const Math::Vector& p2, float margin, std::vector<CObject*>& result)
+{
+    Math::Vector min(Math::Min(p1.x, p2.x)-margin, Math::Min(p1.y, p2.y)-margin, Math::Min(p1.z, p2.z)-margin);
+    Math::Vector max(Math::Max(p1.x, p2.x)+margin, Math::Max(p1.y, p2.y)+margin, Math::Max(p1.z, p2.z)+margin);
+    GetObjectsInBox(min, max, result);
+}
+
+bool CWorldQuery::IntersectSegment(const Math::Vector& p1, const Math::Vector& p2, WorldQuerySpheres spheres,
+                                   WorldQueryHit& hit, const ObjectFilter& filter)
+{
+    Update();
+
+    float length = Math::Distance(p1, p2);
+    bool found = false;
+    int foundOrder = 0;
+
+    m_queryStamp ++;
+    TraverseCells(p1, p2, WORLD_QUERY_CELL_SIZE, WORLD_QUERY_GRID_SIZE*WORLD_QUERY_CELL_SIZE/2.0f,
+                  [&](int x, int y, float tEnter, float)
+    {
+        // A sphere is indexed in the cell where the segment enters it,
+        // so the following cells only have spheres further than the one found
+        if (found && tEnter*length > hit.distance) return false;
+
+        x = Math::Clamp(x, 0, WORLD_QUERY_GRID_SIZE-1);
+        y = Math::Clamp(y, 0, WORLD_QUERY_GRID_SIZE-1);
+        for (int id : m_cells[x+y*WORLD_QUERY_GRID_SIZE])
+        {
+            Entry& entry = m_entries[id];
+            if (entry.queryStamp == m_queryStamp) continue;
+            entry.queryStamp = m_queryStamp;
+
+            if (filter != nullptr && !filter(entry.object)) continue;
+
+            WorldQueryHit entryHit;
+            if (!IntersectEntry(entry, spheres, p1, p2, entryHit)) continue;
+
+            if (!found || entryHit.distance < hit.distance ||
+                (entryHit.distance == hit.distance && entry.order < foundOrder))
+            {
+                hit = entryHit;
+                hit.id = id;
+                found = true;
+                foundOrder = entry.order;
+            }
+        }
+        return true;
+    });
+
+    return found;
+}
+
+void CWorldQuery::GetSegmentHits(const Math::Vector& p1, const Math::Vector& p2, WorldQuerySpheres spheres,
+                                 std::vector<WorldQueryHit>& hits)
+{
+    hits.clear();
+    Update();
+
+    m_queryStamp ++;
+    TraverseCells(p1, p2, WORLD_QUERY_CELL_SIZE, WORLD_QUERY_GRID_SIZE*WORLD_QUERY_CELL_SIZE/2.0f,
+                  [&](int x, int y, float, float)
+    {
+        x = Math::Clamp(x, 0, WORLD_QUERY_GRID_SIZE-1);
+        y = Math::Clamp(y, 0, WORLD_QUERY_GRID_SIZE-1);
+        for (int id : m_cells[x+y*WORLD_QUERY_GRID_SIZE])
+        {
+            Entry& entry = m_entries[id];
+            if (entry.queryStamp == m_queryStamp) continue;
+            entry.queryStamp = m_queryStamp;
+
+            WorldQueryHit hit;
+            if (!IntersectEntry(entry, spheres, p1, p2, hit)) continue;
+            hit.id = id;
+            hits.push_back(hit);
+        }
+        return true;
+    });
+
+    std::sort(hits.begin(), hits.end(), [this](const WorldQueryHit& a, const WorldQueryHit& b)
+    {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return m_entries[a.id].order < m_entries[b.id].order;
+    });
+}
+
+bool CWorldQuery::IntersectTerrain(const Math::Vector& p1, const Math::Vector& p2, Math::Vector& hit)
+{
+    if (m_getFloorLevel == nullptr || m_terrainCellSize <= 0.0f) return false;
+
+    // Height of the segment above the terrain
+    auto getAbove = [&](float t)
+    {
+        Math::Vector pos = p1 + (p2 - p1) * t;
+        return pos.y - m_getFloorLevel(pos);
+    };
+
+    float prevT = 0.0f;
+    float prevAbove = getAbove(0.0f);
+    if (prevAbove < 0.0f)
+    {
+        hit = p1;
+        return true;
+    }
+
+    float size = m_terrainCellSize;
+    bool found = false;
+    TraverseCells(p1, p2, size, 0.0f, [&](int x, int y, float tEnter, float tExit)
+    {
+        // The two triangles of the cell are split by the diagonal from (x+1, y) to (x, y+1),
+        // on each side of it the terrain is linear along the segment
+        float samples[2];
+        int count = 0;
+        float diagonal1 = (p1.x + (p2.x - p1.x) * tEnter) / size - x + (p1.z + (p2.z - p1.z) * tEnter) / size - y;
+        float diagonal2 = (p1.x + (p2.x - p1.x) * tExit)  / size - x + (p1.z + (p2.z - p1.z) * tExit)  / size - y;
+        if ((diagonal1 - 1.0f) * (diagonal2 - 1.0f) < 0.0f)
+            samples[count++] = tEnter + (tExit - tEnter) * (1.0f - diagonal1) / (diagonal2 - diagonal1);
+        samples[count++] = tExit;
+
+        for (int i = 0; i < count; i++)
+        {
+            float t = samples[i];
+            float above = getAbove(t);
+            if (above < 0.0f)
+            {
+                float tHit = prevT + (t - prevT) * prevAbove / (prevAbove - above);
+                hit = p1 + (p2 - p1) * tHit;
+                found = true;
+                return false;
+            }
+            prevT = t;
+            prevAbove = above;
+        }
+        return true;
+    });
+
+    return found;
+}
+
+void CWorldQuery::TraverseCells(const Math::Vector& p1, const Math::Vector& p2, float cellSize, float offset,
+                                const CellFunction& visit)
+{
+    float x1 = (p1.x + offset) / cellSize;
+    float y1 = (p1.z + offset) / cellSize;
+    float x2 = (p2.x + offset) / cellSize;
+    float y2 = (p2.z + offset) / cellSize;
+
+    int x = static_cast<int>(std::floor(x1));
+    int y = static_cast<int>(std::floor(y1));
+    int endX = static_cast<int>(std::floor(x2));
+    int endY = static_cast<int>(std::floor(y2));
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    int stepX = dx > 0.0f ? 1 : -1;
+    int stepY = dy > 0.0f ? 1 : -1;
+    float deltaX = dx != 0.0f ? std::fabs(1.0f / dx) : infinity;
+    float deltaY = dy != 0.0f ? std::fabs(1.0f / dy) : infinity;
+    // Parameters of the segment where it crosses the next vertical and horizontal lines
+    float nextX = dx > 0.0f ? (x + 1 - x1) / dx : (dx < 0.0f ? (x - x1) / dx : infinity);
+    float nextY = dy > 0.0f ? (y + 1 - y1) / dy : (dy < 0.0f ? (y - y1) / dy : infinity);
+
+    // Each step moves one cell towards the last one, so the count also protects from rounding errors
+    int steps = std::abs(endX - x) + std::abs(endY - y);
+    float t = 0.0f;
+    for (int i = 0; ; i++)
+    {
+        float tExit = i == steps ? 1.0f : Math::Min(nextX, nextY, 1.0f);
+        if (!visit(x, y, t, tExit)) return;
+        if (i == steps) return;
+
+        if (nextX < nextY)
+        {
+            x += stepX;
+            t = nextX;
+            nextX += deltaX;
+        }
+        else
+        {
+            y += stepY;
+            t = nextY;
+            nextY += deltaY;
+        }
+    }
+}
+
+void CWorldQuery::Update()
+{
+    if (!m_objectsChanged) return;
+    m_objectsChanged = false;
+
+    m_seenStamp ++;
+    m_order = 0;
+    m_updateObjects(*this);
+
+    // Forget objects which were deleted
+    for (auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        if (it->second.seenStamp != m_seenStamp)
+        {
+            IndexEntry(it->first, it->second, false);
+            it = m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool CWorldQuery::IntersectEntry(const Entry& entry, WorldQuerySpheres spheres,
+                                 const Math::Vector& p1, const Math::Vector& p2, WorldQueryHit& hit)
+{
+    bool found = false;
+    auto testSphere = [&](const Math::Sphere& sphere)
+    {
+        float distance = 0.0f;
+        if (!IntersectSphere(p1, p2, sphere, distance)) return;
+        if (found && distance >= hit.distance) return;
+
+        hit.object = entry.object;
+        hit.sphere = sphere;
+        hit.distance = distance;
+        found = true;
+    };
+
+    if (spheres == WorldQuerySpheres::Crash)
+    {
+        for (const Math::Sphere& sphere : entry.crashSpheres)
+        {
+            testSphere(sphere);
+        }
+    }
+    else if (entry.cameraSphere.radius > 0.0f)
+    {
+        testSphere(entry.cameraSphere);
+    }
+    return found;
+}
+
+void CWorldQuery::IndexEntry(int id, Entry& entry, bool add)
+{
+    if (add)
+    {
+        entry.minX = PosToCell(entry.position.x-entry.radius);
+        entry.minY = PosToCell(entry.position.z-entry.radius);
+        entry.maxX = PosToCell(entry.position.x+entry.radius);
+        entry.maxY = PosToCell(entry.position.z+entry.radius);
+    }
+
+    for (int y = entry.minY; y <= entry.maxY; y++)
+    {
+        for (int x = entry.minX; x <= entry.maxX; x++)
+        {
+            std::vector<int>& ids = m_cells[x+y*WORLD_QUERY_GRID_SIZE];
+            if (add)
+                ids.push_back(id);
+            else
+                ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        }
+    }
+}
+
+int CWorldQuery::PosToCell(float coord)
+{
+    int cell = static_cast<int>(std::floor((coord+WORLD_QUERY_GRID_SIZE*WORLD_QUERY_CELL_SIZE/2.0f)/WORLD_QUERY_CELL_SIZE));
+    return Math::Clamp(cell, 0, WORLD_QUERY_GRID_SIZE-1);
+}
@@ -0,0 +1,194 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file object/world_query.h
+ * \brief Spatial index of objects and terrain for segment and box queries
+ */
+
+#pragma once
+
+#include "math/sphere.h"
+#include "math/vector.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class CObject;
+
+//! Size of one cell of the object index (in game units)
+const float WORLD_QUERY_CELL_SIZE = 20.0f;
+//! Number of cells along one side of the index, covering the whole 3200x3200 world
+const int   WORLD_QUERY_GRID_SIZE = static_cast<int>(3200.0f/WORLD_QUERY_CELL_SIZE);
+
+//! Spheres of the objects tested by segment queries
+enum class WorldQuerySpheres
+{
+    //! CObject::GetAllCrashSpheres()
+    Crash,
+    //! CObject::GetCameraCollisionSphere()
+    Camera,
+};
+
+//! Object crossed by a segment
+struct WorldQueryHit
+{
+    int          id = -1;
+    CObject*     object = nullptr;
+    //! First sphere of the object crossed by the segment
+    Math::Sphere sphere;
+    //! Distance from the start of the segment to the sphere, 0 if the segment starts inside it
+    float        distance = 0.0f;
+};
+
+/**
+ * \class CWorldQuery
+ * \brief Finds objects near a segment or in a box without scanning all objects
+ *
+ * Each object is bounded by a sphere around its position, containing all its
+ * crash spheres and its camera collision sphere. The bounds are kept in a grid of
+ * WORLD_QUERY_CELL_SIZE cells, seen from above.
+ *
+ * Objects are refreshed lazily, on the first query after SetObjectsChanged(), by
+ * the function given to the constructor, which calls SetObject() for each of them.
+ * CObjectManager calls SetObjectsChanged() when objects are created or deleted, and
+ * CRobotMain after objects moved during a frame. Only objects whose bound changed
+ * are re-indexed.
+ *
+ * Box queries return candidates in the order the objects were given, so callers
+ * which stop at the first match give the same result as a full scan.
+ * Segment queries walk the cells crossed by the segment from its start.
+ */
+class CWorldQuery
+{
+public:
+    //! Gives all objects to the query with SetObject()
+    using ObjectUpdateFunction = std::function<void(CWorldQuery& query)>;
+    //! Appends the crash spheres of an object
+    using SpheresFunction = std::function<void(std::vector<Math::Sphere>& spheres)>;
+    //! Returns the level of the terrain at 2D (XZ) position
+    using FloorLevelFunction = std::function<float(const Math::Vector& pos)>;
+    //! Called for each cell crossed by a segment, with the part of the segment inside it; returns false to stop
+    using CellFunction = std::function<bool(int x, int y, float tEnter, float tExit)>;
+    //! Returns false for objects ignored by a segment query
+    using ObjectFilter = std::function<bool(CObject* object)>;
+
+    explicit CWorldQuery(const ObjectUpdateFunction& updateObjects);
+    ~CWorldQuery();
+
+    //! Forgets all objects, used when the level changes
+    void        Reset();
+    //! Notifies that objects may have been created, deleted or moved
+    void        SetObjectsChanged();
+
+    /**
+     * \brief Gives one object, during the update
+     * \param getCrashSpheres called to get the crash spheres of the object
+     * \param cameraSphere camera collision sphere, with zero radius if none
+     */
+    void        SetObject(int id, CObject* object, const Math::Vector& position,
+                          const SpheresFunction& getCrashSpheres, const Math::Sphere& cameraSphere);
+
+    /**
+     * \brief Sets the terrain used by IntersectTerrain()
+     * \param cellSize size of the terrain cells, which are aligned on multiples of it
+     * \param getFloorLevel level of the terrain, linear on each of the two triangles of a cell
+     */
+    void        SetTerrain(float cellSize, const FloorLevelFunction& getFloorLevel);
+
+    /**
+     * \brief Gets objects whose bounds may touch the box
+     * \param result receives the objects, in the order they were given to SetObject()
+     */
+    void        GetObjectsInBox(const Math::Vector& min, const Math::Vector& max, std::vector<CObject*>& result);
+    //! Gets objects whose bounds may touch the segment, expanded by \a margin in all directions
+    void        GetObjectsNearSegment(const Math::Vector& p1, const Math::Vector& p2, float margin, std::vector<CObject*>& result);
+
+    /**
+     * \brief Finds the first sphere crossed by the segment from \a p1 to \a p2
+     * \param filter if given, objects for which it returns false are ignored
+     * \return false if no sphere is crossed
+     *
+     * Among spheres at the same distance, the object given first to SetObject() wins.
+     */
+    bool        IntersectSegment(const Math::Vector& p1, const Math::Vector& p2, WorldQuerySpheres spheres,
+                                 WorldQueryHit& hit, const ObjectFilter& filter = nullptr);
+    //! Gets all objects crossed by the segment, one hit each, sorted by distance
+    void        GetSegmentHits(const Math::Vector& p1, const Math::Vector& p2, WorldQuerySpheres spheres,
+                               std::vector<WorldQueryHit>& hits);
+
+    /**
+     * \brief Finds the first point where the segment goes under the terrain
+     * \return false if the segment stays above it, or no terrain was set
+     */
+    bool        IntersectTerrain(const Math::Vector& p1, const Math::Vector& p2, Math::Vector& hit);
+
+    /**
+     * \brief Walks the cells of a grid crossed by the segment, seen from above, from \a p1 to \a p2
+     *
+     * Cell (x, y) covers [x*cellSize-offset; (x+1)*cellSize-offset) along X and the same along Z.
+     * Every cell touched by the segment is visited once, in order.
+     */
+    static void TraverseCells(const Math::Vector& p1, const Math::Vector& p2, float cellSize, float offset,
+                              const CellFunction& visit);
+
+protected:
+    struct Entry
+    {
+        CObject*    object = nullptr;
+        Math::Vector position;
+        float       radius = 0.0f;
+        std::vector<Math::Sphere> crashSpheres;
+        Math::Sphere cameraSphere;
+        int         minX = 0, minY = 0;
+        int         maxX = -1, maxY = -1;
+        //! Rank in the last update
+        int         order = 0;
+        int         seenStamp = 0;
+        int         queryStamp = 0;
+    };
+
+    //! Refreshes bounds of all objects if needed
+    void        Update();
+    //! Adds or removes the entry from the grid
+    void        IndexEntry(int id, Entry& entry, bool add);
+    //! Calls the function for the entries in the cells crossed by the segment, each once, until it returns false
+    void        TraverseEntries(const Math::Vector& p1, const Math::Vector& p2,
+                                const std::function<bool(int id, Entry& entry, float tEnter)>& visit);
+    //! Finds the first sphere of the entry crossed by the segment
+    static bool IntersectEntry(const Entry& entry, WorldQuerySpheres spheres,
+                               const Math::Vector& p1, const Math::Vector& p2, WorldQueryHit& hit);
+    //! Converts world position to cell coordinates, clamped to the grid
+    static int  PosToCell(float coord);
+
+protected:
+    ObjectUpdateFunction m_updateObjects;
+    std::unordered_map<int, Entry> m_entries;
+    //! IDs of the objects touching each cell
+    std::vector<std::vector<int>> m_cells;
+    std::vector<Entry*> m_candidates;
+    bool        m_objectsChanged = true;
+    int         m_seenStamp = 0;
+    int         m_queryStamp = 0;
+    int         m_order = 0;
+
+    float       m_terrainCellSize = 0.0f;
+    FloorLevelFunction m_getFloorLevel;
+};
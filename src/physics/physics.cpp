@@ -64,6 +64,9 @@ const float LANDING_SPEED   = 3.0f;
 const float LANDING_ACCEL   = 5.0f;
 const float LANDING_ACCELh  = 1.5f;
 
+const float SLEEP_DELAY     = 3.0f;     // time at rest before sleeping
+const float WAKE_DISTANCE   = 2.0f;     // margin around the crash spheres
+
 
 
 
@@ -123,6 +126,9 @@ CPhysics::CPhysics(COldObject* object)
     m_minFallingHeight = 20.0f;
     m_fallDamageFraction = 0.007f;
     m_floorLevel = 0.0f;
+    m_bSleeping = false;
+    m_restTime = 0.0f;
+    m_sleepReliefRevision = 0;
 }
 
 // Object's destructor.
@@ -1448,6 +1454,20 @@ bool CPhysics::EventFrame(const Event &event)
     m_timeUnderWater += event.rTime;
     m_soundTimeJostle += event.rTime;
 
+    if ( m_bSleeping )
+    {
+        // Nothing to simulate as long as nobody touched the object
+        if ( IsAtRest()                                                 &&
+             Math::VectorsEqual(m_object->GetPosition(), m_sleepPosition) &&
+             Math::VectorsEqual(m_object->GetRotation(), m_sleepRotation) &&
+             m_terrain->GetReliefRevision() == m_sleepReliefRevision      &&
+             GetObjectEnergyLevel(m_object) == m_lastEnergy               )
+        {
+            return true;
+        }
+        WakeUp();
+    }
+
     type = m_object->GetType();
 
     FrameParticle(m_time, event.rTime);
@@ -1590,9 +1610,94 @@ bool CPhysics::EventFrame(const Event &event)
 
     m_bForceUpdate = false;
 
+    if ( IsAtRest() )
+    {
+        m_restTime += event.rTime;
+        if ( m_restTime >= SLEEP_DELAY )  // settled for good?
+        {
+            m_bSleeping = true;
+            m_sleepPosition = m_object->GetPosition();
+            m_sleepRotation = m_object->GetRotation();
+            m_sleepReliefRevision = m_terrain->GetReliefRevision();
+        }
+    }
+    else
+    {
+        m_restTime = 0.0f;
+    }
+
+    return true;
+}
+
+// Checks whether the object is settled on the ground: no motor order,
+// no speed left and no effect still fading out.
+
+bool CPhysics::IsAtRest()
+{
+    ObjectType type = m_object->GetType();
+    if ( type == OBJECT_MOTHER ||
+         type == OBJECT_ANT    ||
+         type == OBJECT_SPIDER ||
+         type == OBJECT_BEE    ||
+         type == OBJECT_WORM   )  return false;  // insects are never quiet
+
+    if ( m_bForceUpdate || m_bFreeze )  return false;
+    if ( !m_bLand || m_bSwim )  return false;
+    if ( m_fallingHeight != 0.0f || m_repeatCollision != 0 )  return false;
+
+    if ( m_motorSpeed.x != 0.0f ||
+         m_motorSpeed.y != 0.0f ||
+         m_motorSpeed.z != 0.0f )  return false;
+
+    Math::Vector zero(0.0f, 0.0f, 0.0f);
+    if ( !Math::VectorsEqual(m_linMotion.currentSpeed, zero) ||
+         !Math::VectorsEqual(m_linMotion.realSpeed,    zero) ||
+         !Math::VectorsEqual(m_cirMotion.currentSpeed, zero) ||
+         !Math::VectorsEqual(m_cirMotion.realSpeed,    zero) )  return false;
+
+    if ( m_soundChannel != -1 || m_soundChannelSlide != -1 )  return false;
+    if ( m_restBreakParticle > 0.0f      ||
+         m_absorbWater != 0.0f           ||
+         m_reactorTemperature != 0.0f    )  return false;
+
+    if ( m_object->Implements(ObjectInterfaceType::JetFlying) )
+    {
+        CJetFlyingObject* jetFlying = dynamic_cast<CJetFlyingObject*>(m_object);
+        if ( jetFlying->GetRange() > 0.0f && jetFlying->GetReactorRange() < 1.0f )  return false;  // still cooling?
+    }
+
+    if ( m_object->GetSelect() || m_object->IsForegroundTask() )  return false;
+    if ( m_object->IsDying() )  return false;
+
     return true;
 }
 
+// Resumes the simulation of a sleeping object.
+
+void CPhysics::WakeUp()
+{
+    m_bSleeping = false;
+    m_restTime = 0.0f;
+}
+
+bool CPhysics::IsSleeping()
+{
+    return m_bSleeping;
+}
+
+// Wakes up another object approached by this one.
+
+void CPhysics::WakeUpObject(CObject* pObj)
+{
+    if (!pObj->Implements(ObjectInterfaceType::Movable))  return;
+
+    CPhysics* physics = dynamic_cast<CMovableObject*>(pObj)->GetPhysics();
+    if ( physics != nullptr && physics->IsSleeping() )
+    {
+        physics->WakeUp();
+    }
+}
+
 // Starts or stops the engine sounds.
 
 void CPhysics::SoundMotor(float rTime)
@@ -2550,6 +2655,10 @@ int CPhysics::ObjectAdapt(const Math::Vector &pos, const Math::Vector &angle)
             if ( iType == OBJECT_WORM   && oRad <= 1.2f )  continue;
 
             distance = Math::Distance(oPos, iPos);
+            if ( distance < iRad+oRad+WAKE_DISTANCE )  // approaches?
+            {
+                WakeUpObject(pObj);
+            }
             if ( distance < iRad+oRad )  // collision?
             {
                 distance = Math::Distance(oPos, iiPos);
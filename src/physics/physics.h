@@ -168,6 +168,9 @@ public:
     void        SetFallDamageFraction(float value);
     float       GetFallDamageFraction();
 
+    void        WakeUp();
+    bool        IsSleeping();
+
 protected:
     bool        EventFrame(const Event &event);
     void        WaterFrame(float aTime, float rTime);
@@ -195,6 +198,8 @@ protected:
     void        WaterParticle(float aTime, Math::Vector pos, ObjectType type, float floor, float advance, float turn);
     void        WheelParticle(TraceColor color, float width);
     void        SetFalling();
+    bool        IsAtRest();
+    void        WakeUpObject(CObject* pObj);
 
 protected:
     Gfx::CEngine*       m_engine;
@@ -253,4 +258,9 @@ protected:
     float       m_fallingHeight;
     float       m_fallDamageFraction;
     float       m_minFallingHeight;
+    bool        m_bSleeping;        // settled, frames are skipped
+    float       m_restTime;         // time spent at rest
+    Math::Vector    m_sleepPosition;
+    Math::Vector    m_sleepRotation;
+    int         m_sleepReliefRevision;
 };
@@ -1816,7 +1816,7 @@ bool CScriptFunctions::rTurn(CBotVar* var, CBotVar* result, int& exception, void
     return WaitForForegroundTask(script, result, exception);
 }
 
-// Compilation of the instruction "goto(pos, altitude, crash, goal)".
+// Compilation of the instruction "goto(pos, altitude, goal, crash, search)".
 
 CBotTypResult CScriptFunctions::cGoto(CBotVar* &var, void* user)
 {
@@ -1838,11 +1838,15 @@ CBotTypResult CScriptFunctions::cGoto(CBotVar* &var, void* user)
     if ( var->GetType() > CBotTypDouble )  return CBotTypResult(CBotErrBadNum);
     var = var->GetNext();
 
+    if ( var == nullptr )  return CBotTypResult(CBotTypFloat);
+    if ( var->GetType() > CBotTypDouble )  return CBotTypResult(CBotErrBadNum);
+    var = var->GetNext();
+
     if ( var == nullptr )  return CBotTypResult(CBotTypFloat);
     return CBotTypResult(CBotErrOverParam);
 }
 
-// Instruction "goto(pos, altitude, mode)".
+// Instruction "goto(pos, altitude, goal, crash, search)".
 
 bool CScriptFunctions::rGoto(CBotVar* var, CBotVar* result, int& exception, void* user)
 {
@@ -1850,6 +1854,7 @@ bool CScriptFunctions::rGoto(CBotVar* var, CBotVar* result, int& exception, void
     Math::Vector        pos;
     TaskGotoGoal    goal;
     TaskGotoCrash   crash;
+    TaskGotoSearch  search;
     float           altitude;
     Error           err;
 
@@ -1861,6 +1866,7 @@ bool CScriptFunctions::rGoto(CBotVar* var, CBotVar* result, int& exception, void
 
         goal  = TGG_DEFAULT;
         crash = TGC_DEFAULT;
+        search = TGS_DEFAULT;
         altitude = 0.0f*g_unit;
 
         if ( var != nullptr )
@@ -1876,11 +1882,23 @@ bool CScriptFunctions::rGoto(CBotVar* var, CBotVar* result, int& exception, void
                 if ( var != nullptr )
                 {
                     crash = static_cast<TaskGotoCrash>(var->GetValInt());
+
+                    var = var->GetNext();
+                    if ( var != nullptr )
+                    {
+                        search = static_cast<TaskGotoSearch>(var->GetValInt());
+                        if ( search != TGS_DEFAULT && search != TGS_BEAM && search != TGS_ASTAR )
+                        {
+                            exception = ERR_UNKNOWN;
+                            result->SetValInt(ERR_UNKNOWN);
+                            return false;
+                        }
+                    }
                 }
             }
         }
 
-        err = script->m_taskExecutor->StartTaskGoto(pos, altitude, goal, crash);
+        err = script->m_taskExecutor->StartTaskGoto(pos, altitude, goal, crash, search);
         if ( err != ERR_OK )
         {
             script->m_taskExecutor->StopForegroundTask();
@@ -70,6 +70,7 @@ void PrintUsage(const std::string& program)
     std::cerr << " old       => old binary format" << std::endl;
     std::cerr << " new_bin   => new binary format" << std::endl;
     std::cerr << " new_txt   => new text format" << std::endl;
+    std::cerr << " cache     => compiled format used by the model cache" << std::endl;
 }
 
 bool ParseArgs(int argc, char *argv[])
@@ -235,6 +236,8 @@ int main(int argc, char *argv[])
         inputFormat = ModelFormat::Binary;
     else if (ARGS.inputFormat == "new_txt")
         inputFormat = ModelFormat::Text;
+    else if (ARGS.inputFormat == "cache")
+        inputFormat = ModelFormat::Cache;
     else
     {
         std::cerr << "Invalid input format: " << ARGS.inputFormat << std::endl;
@@ -274,6 +277,8 @@ int main(int argc, char *argv[])
         outputFormat = ModelFormat::Binary;
     else if (ARGS.outputFormat == "new_txt")
         outputFormat = ModelFormat::Text;
+    else if (ARGS.outputFormat == "cache")
+        outputFormat = ModelFormat::Cache;
     else
     {
         std::cerr << "Invalid output format: " << ARGS.outputFormat << std::endl;
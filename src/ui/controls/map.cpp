@@ -20,7 +20,15 @@
 
 #include "ui/controls/map.h"
 
+#include "common/hash.h"
 #include "common/image.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+#include "common/stringutils.h"
+
+#include "common/resources/resourcemanager.h"
+
+#include "common/thread/thread_pool.h"
 
 #include "graphics/core/device.h"
 
@@ -40,6 +48,9 @@
 namespace Ui
 {
 
+//! Directory (in the save location) of the cached relief images
+const std::string MAP_CACHE_DIR = "cache/minimap";
+
 // Object's constructor.
 
 CMap::CMap() : CControl()
@@ -75,6 +86,7 @@ CMap::CMap() : CControl()
     m_mode = 0;
     m_bToy = false;
     m_bDebug = false;
+    m_reliefRevision = -1;
 }
 
 // Object's destructor.
@@ -201,7 +213,10 @@ bool CMap::EventProcess(const Event &event)
     CControl::EventProcess(event);
 
     if ( event.type == EVENT_FRAME )
+    {
         m_time += event.rTime;
+        CheckReliefChanges();
+    }
 
     if ( event.type == EVENT_MOUSE_MOVE || event.type == EVENT_MOUSE_BUTTON_DOWN || event.type == EVENT_MOUSE_BUTTON_UP )
     {
@@ -1018,122 +1033,157 @@ void CMap::UpdateTerrain()
 {
     if (! m_fixImage.empty()) return;  // still image?
 
-    CImage img(Math::IntPoint(256, 256));
+    if (m_terrainImage == nullptr)
+        m_terrainImage = MakeUnique<CImage>(Math::IntPoint(256, 256));
 
-    float scale = m_terrain->GetReliefScale();
-    float water = m_water->GetLevel();
+    m_reliefRevision = m_terrain->GetReliefRevision();
 
-    Gfx::Color color;
-    color.a = 0.0f;
+    // The image only depends on the relief, the colors and the water level
+    std::string prefix = StrUtils::Format("%s%.3d%.3d-", GetLevelCategoryDir(m_main->GetLevelCategory()).c_str(),
+                                          m_main->GetLevelChap(), m_main->GetLevelRank());
+    std::string cacheFile = MAP_CACHE_DIR + "/" + prefix + StrUtils::Format("%016llx.png", GetTerrainImageHash());
 
-    for (int y = 0; y < 256; y++)
+    CImage cached;
+    if (CResourceManager::Exists(cacheFile) && cached.Load(cacheFile) &&
+        cached.GetSize() == Math::IntPoint(256, 256))
     {
-        for (int x = 0; x < 256; x++)
+        for (int y = 0; y < 256; y++)
         {
-            Math::Vector pos;
-            pos.x =  (static_cast<float>(x) - 128.0f) * m_half / 128.0f;
-            pos.z = -(static_cast<float>(y) - 128.0f) * m_half / 128.0f;
-            pos.y = 0.0f;
-
-            float level;
-
-            if ( pos.x >= -m_half && pos.x <= m_half &&
-                 pos.z >= -m_half && pos.z <= m_half )
+            for (int x = 0; x < 256; x++)
             {
-                level = m_terrain->GetFloorLevel(pos, true) / scale;
-            }
-            else
-            {
-                level = 1000.0f;
-            }
-
-            float intensity = level / 256.0f;
-            if (intensity < 0.0f) intensity = 0.0f;
-            if (intensity > 1.0f) intensity = 1.0f;
-
-            if (level >= water)  // on water?
-            {
-                color.r = Math::Norm(m_floorColor.r + (intensity - 0.5f));
-                color.g = Math::Norm(m_floorColor.g + (intensity - 0.5f));
-                color.b = Math::Norm(m_floorColor.b + (intensity - 0.5f));
-            }
-            else    // underwater?
-            {
-                color.r = Math::Norm(m_waterColor.r + (intensity - 0.5f));
-                color.g = Math::Norm(m_waterColor.g + (intensity - 0.5f));
-                color.b = Math::Norm(m_waterColor.b + (intensity - 0.5f));
+                m_terrainImage->SetPixelInt(Math::IntPoint(x, y), cached.GetPixelInt(Math::IntPoint(x, y)));
             }
+        }
+    }
+    else
+    {
+        DrawTerrainPixels(0, 0, 256, 256);
 
-            img.SetPixel(Math::IntPoint(x, y), color);
+        // Replaces the image cached for the previous relief of this level
+        if (! CResourceManager::DirectoryExists(MAP_CACHE_DIR))
+            CResourceManager::CreateDirectory(MAP_CACHE_DIR);
+        for (const std::string& file : CResourceManager::ListFiles(MAP_CACHE_DIR))
+        {
+            if (file.compare(0, prefix.size(), prefix) == 0)
+                CResourceManager::Remove(MAP_CACHE_DIR + "/" + file);
         }
+        if (! m_terrainImage->SavePNG(CResourceManager::GetSaveLocation() + "/" + cacheFile))
+            GetLogger()->Warn("Could not save minimap cache '%s': %s\n", cacheFile.c_str(), m_terrainImage->GetError().c_str());
     }
 
     m_engine->DeleteTexture("interface/map.png");
-    m_engine->LoadTexture("textures/interface/map.png", &img);
+    m_engine->LoadTexture("textures/interface/map.png", m_terrainImage.get());
 }
 
-// Updates the field in the map.
+// Updates the field in the map, only in the given rectangle of pixels.
 
 void CMap::UpdateTerrain(int bx, int by, int ex, int ey)
 {
-    Gfx::Color   color;
-    Math::Vector        pos;
-    float           scale, water, level, intensity;
-    int             x, y;
-
     if (! m_fixImage.empty())  return;  // still image?
+    if (m_terrainImage == nullptr)  return;  // never drawn
+
+    DrawTerrainPixels(Math::Max(bx, 0), Math::Max(by, 0), Math::Min(ex, 256), Math::Min(ey, 256));
 
-    // TODO: map texture manipulation
-    return;
+    m_engine->CreateOrUpdateTexture("textures/interface/map.png", m_terrainImage.get());
+}
 
-    //if ( !m_engine->OpenImage("map.png") )  return;
-    //m_engine->LoadImage();
+// Draws the relief in the given rectangle of pixels of m_terrainImage.
+// The relief is sampled directly and the rows are split between the worker threads.
 
-    scale = m_terrain->GetReliefScale();
-    water = m_water->GetLevel();
-    color.a = 0.0f;
+void CMap::DrawTerrainPixels(int bx, int by, int ex, int ey)
+{
+    if (bx >= ex || by >= ey)  return;
 
-    for ( y=by ; y<ey ; y++ )
+    float scale = m_terrain->GetReliefScale();
+    float water = m_water->GetLevel();
+    int width = ex - bx;
+
+    CThreadPool* pool = m_main->GetThreadPool();
+    pool->ParallelFor(ey - by, 16, [&](int begin, int end)
     {
-        for ( x=bx ; x<ex ; x++ )
-        {
-            pos.x =  (static_cast<float>(x)-128.0f)*m_half/128.0f;
-            pos.z = -(static_cast<float>(y)-128.0f)*m_half/128.0f;
-            pos.y = 0.0f;
+        std::vector<float> levels(width * (end - begin));
+        float step = m_half / 128.0f;
+        m_terrain->SampleRelief((static_cast<float>(bx) - 128.0f) * step,
+                                -(static_cast<float>(by + begin) - 128.0f) * step,
+                                step, -step, width, end - begin, levels.data());
 
-            if ( pos.x >= -m_half && pos.x <= m_half &&
-                 pos.z >= -m_half && pos.z <= m_half )
-            {
-                level = m_terrain->GetFloorLevel(pos, true)/scale;
-            }
-            else
+        Gfx::Color color;
+        color.a = 0.0f;
+
+        for (int y = begin; y < end; y++)
+        {
+            const float* row = &levels[(y - begin) * width];
+            float posZ = -(static_cast<float>(by + y) - 128.0f) * step;
+            for (int x = 0; x < width; x++)
             {
-                level = 1000.0f;
+                float posX = (static_cast<float>(bx + x) - 128.0f) * step;
+                float level;
+                if ( posX >= -m_half && posX <= m_half &&
+                     posZ >= -m_half && posZ <= m_half )
+                {
+                    level = row[x] / scale;
+                }
+                else
+                    level = 1000.0f;
+
+                float intensity = level / 256.0f;
+                if (intensity < 0.0f) intensity = 0.0f;
+                if (intensity > 1.0f) intensity = 1.0f;
+
+                if (level >= water)  // on water?
+                {
+                    color.r = Math::Norm(m_floorColor.r + (intensity - 0.5f));
+                    color.g = Math::Norm(m_floorColor.g + (intensity - 0.5f));
+                    color.b = Math::Norm(m_floorColor.b + (intensity - 0.5f));
+                }
+                else    // underwater?
+                {
+                    color.r = Math::Norm(m_waterColor.r + (intensity - 0.5f));
+                    color.g = Math::Norm(m_waterColor.g + (intensity - 0.5f));
+                    color.b = Math::Norm(m_waterColor.b + (intensity - 0.5f));
+                }
+
+                m_terrainImage->SetPixel(Math::IntPoint(bx + x, by + y), color);
             }
+        }
+    });
+}
 
-            intensity = level/256.0f;
-            if ( intensity < 0.0f )  intensity = 0.0f;
-            if ( intensity > 1.0f )  intensity = 1.0f;
+// Returns the key of the image of the relief in the disk cache.
 
-            if ( level > water )  // on water?
-            {
-                color.r = m_floorColor.r + (intensity-0.5f);
-                color.g = m_floorColor.g + (intensity-0.5f);
-                color.b = m_floorColor.b + (intensity-0.5f);
-            }
-            else    // underwater?
-            {
-                color.r = m_waterColor.r + (intensity-0.5f);
-                color.g = m_waterColor.g + (intensity-0.5f);
-                color.b = m_waterColor.b + (intensity-0.5f);
-            }
+unsigned long long CMap::GetTerrainImageHash()
+{
+    unsigned long long hash = m_terrain->GetReliefHash();
+    float values[] = { m_floorColor.r, m_floorColor.g, m_floorColor.b,
+                       m_waterColor.r, m_waterColor.g, m_waterColor.b,
+                       m_water->GetLevel(), m_terrain->GetReliefScale(), m_half };
+    return HashUtils::AddFNV1a(hash, values, sizeof(values));
+}
 
-            //m_engine->SetDot(x, y, color);
-        }
+// Redraws the parts of the map where the relief was modified.
+
+void CMap::CheckReliefChanges()
+{
+    if (m_terrainImage == nullptr)  return;
+
+    int revision = m_terrain->GetReliefRevision();
+    if (revision == m_reliefRevision)  return;
+
+    Math::Vector min, max;
+    if (! m_terrain->GetReliefChanges(m_reliefRevision, min, max))
+    {
+        UpdateTerrain();  // too many changes
+        return;
     }
+    m_reliefRevision = revision;
+
+    int bx = static_cast<int>(floorf( min.x * 128.0f / m_half + 128.0f)) - 1;
+    int ex = static_cast<int>(ceilf ( max.x * 128.0f / m_half + 128.0f)) + 2;
+    int by = static_cast<int>(floorf(-max.z * 128.0f / m_half + 128.0f)) - 1;
+    int ey = static_cast<int>(ceilf (-min.z * 128.0f / m_half + 128.0f)) + 2;
+    if (bx >= ex || by >= ey)  return;
 
-    //m_engine->CopyImage();  // copy the ground drawing
-    //m_engine->CloseImage();
+    UpdateTerrain(bx, by, ex, ey);
 }
 
 
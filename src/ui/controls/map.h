@@ -25,6 +25,9 @@
 
 #include "object/object_type.h"
 
+#include <memory>
+
+class CImage;
 class CObject;
 
 namespace Gfx
@@ -114,6 +117,9 @@ protected:
     void        DrawTriangle(Math::Point p1, Math::Point p2, Math::Point p3, Math::Point uv1, Math::Point uv2);
     void        DrawPenta(Math::Point p1, Math::Point p2, Math::Point p3, Math::Point p4, Math::Point p5, Math::Point uv1, Math::Point uv2);
     void        DrawVertex(Math::Point uv1, Math::Point uv2, float zoom);
+    void        DrawTerrainPixels(int bx, int by, int ex, int ey);
+    unsigned long long GetTerrainImageHash();
+    void        CheckReliefChanges();
 
 protected:
     Gfx::CTerrain*  m_terrain;
@@ -139,6 +145,10 @@ protected:
     int             m_mode;
     bool            m_bToy;
     bool            m_bDebug;
+    //! Image of the relief, kept to update only the modified parts
+    std::unique_ptr<CImage> m_terrainImage;
+    //! Revision of the relief drawn in m_terrainImage
+    int             m_reliefRevision;
 };
 
 
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/thread/thread_pool.h"
+
+#include <vector>
+#include <gtest/gtest.h>
+
+
+TEST(CThreadPoolTest, EveryElementProcessedOnce)
+{
+    for (int threads : {0, 1, 3})
+    {
+        CThreadPool pool(threads);
+
+        for (int count : {0, 1, 15, 16, 17, 1000})
+        {
+            std::vector<int> data(count, 0);
+            pool.ParallelFor(count, 16, [&data](int begin, int end)
+            {
+                for (int i = begin; i < end; ++i)
+                    data[i]++;
+            });
+
+            for (int i = 0; i < count; ++i)
+                ASSERT_EQ(1, data[i]) << "threads = " << threads << ", count = " << count << ", i = " << i;
+        }
+    }
+}
+
+TEST(CThreadPoolTest, RepeatedCallsReuseThreads)
+{
+    CThreadPool pool(2);
+
+    std::vector<int> data(100, 0);
+    for (int run = 0; run < 200; ++run)
+    {
+        pool.ParallelFor(100, 7, [&data](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+                data[i] += i;
+        });
+    }
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(200 * i, data[i]);
+}
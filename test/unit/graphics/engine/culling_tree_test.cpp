@@ -0,0 +1,142 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/culling_tree.h"
+
+#include "math/geometry.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace Gfx;
+
+class CCullingTreeUT : public testing::Test
+{
+protected:
+    void SetUp() override;
+
+    std::vector<int> CullBruteForce(const Math::Frustum& frustum);
+    std::vector<int> CullTree(const Math::Frustum& frustum);
+
+    Math::Frustum MakeFrustum(const Math::Matrix& proj, const Math::Vector& eye, const Math::Vector& lookat);
+    Math::Frustum MakeCameraFrustum(const Math::Vector& eye, const Math::Vector& lookat);
+
+    std::vector<CullingItem> m_items;
+    CCullingTree m_tree;
+};
+
+void CCullingTreeUT::SetUp()
+{
+    for (int x = 0; x < 20; x++)
+    {
+        for (int z = 0; z < 20; z++)
+        {
+            CullingItem item;
+            item.id = m_items.size();
+            item.sphere = Math::Sphere(Math::Vector(x * 10.0f, (x * z) % 7, z * 10.0f), 1.0f + (x + z) % 5);
+            m_items.push_back(item);
+        }
+    }
+
+    m_tree.Build(m_items);
+}
+
+std::vector<int> CCullingTreeUT::CullBruteForce(const Math::Frustum& frustum)
+{
+    std::vector<int> result;
+    for (const CullingItem& item : m_items)
+    {
+        if (Math::TestSphereInFrustum(frustum, item.sphere) != Math::FRUSTUM_OUTSIDE)
+            result.push_back(item.id);
+    }
+    return result;
+}
+
+std::vector<int> CCullingTreeUT::CullTree(const Math::Frustum& frustum)
+{
+    std::vector<int> result;
+    m_tree.Cull(&frustum, 1, &result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+Math::Frustum CCullingTreeUT::MakeFrustum(const Math::Matrix& proj, const Math::Vector& eye, const Math::Vector& lookat)
+{
+    Math::Matrix view, flipZ;
+    Math::LoadViewMatrix(view, eye, lookat, Math::Vector(0.0f, 1.0f, 0.0f));
+    Math::LoadScaleMatrix(flipZ, Math::Vector(1.0f, 1.0f, -1.0f));
+    return Math::ExtractFrustum(Math::MultiplyMatrices(proj, Math::MultiplyMatrices(flipZ, view)));
+}
+
+Math::Frustum CCullingTreeUT::MakeCameraFrustum(const Math::Vector& eye, const Math::Vector& lookat)
+{
+    Math::Matrix proj;
+    Math::LoadProjectionMatrix(proj, Math::PI / 4.0f, 4.0f / 3.0f, 0.5f, 100.0f);
+    return MakeFrustum(proj, eye, lookat);
+}
+
+TEST_F(CCullingTreeUT, CullMatchesBruteForce)
+{
+    Math::Frustum frustum = MakeCameraFrustum(Math::Vector(-10.0f, 20.0f, -10.0f), Math::Vector(50.0f, 0.0f, 50.0f));
+
+    std::vector<int> expected = CullBruteForce(frustum);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_LT(expected.size(), m_items.size());
+    EXPECT_EQ(expected, CullTree(frustum));
+}
+
+TEST_F(CCullingTreeUT, CullMatchesBruteForceAfterRefit)
+{
+    for (CullingItem& item : m_items)
+    {
+        item.sphere.pos.x = 190.0f - item.sphere.pos.x;
+        item.sphere.pos.y += 5.0f;
+        m_tree.Update(item.id, item.sphere);
+    }
+    m_tree.Refit();
+
+    Math::Frustum frustum = MakeCameraFrustum(Math::Vector(100.0f, 30.0f, -20.0f), Math::Vector(120.0f, 0.0f, 60.0f));
+
+    std::vector<int> expected = CullBruteForce(frustum);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, CullTree(frustum));
+}
+
+TEST_F(CCullingTreeUT, CullSeveralFrustaInOneTraversal)
+{
+    Math::Frustum frusta[2];
+    frusta[0] = MakeCameraFrustum(Math::Vector(-10.0f, 20.0f, -10.0f), Math::Vector(50.0f, 0.0f, 50.0f));
+
+    Math::Matrix proj;
+    Math::LoadOrthoProjectionMatrix(proj, -30.0f, 30.0f, -30.0f, 30.0f, -200.0f, 200.0f);
+    frusta[1] = MakeFrustum(proj, Math::Vector(100.0f, 0.0f, 100.0f), Math::Vector(99.0f, -2.0f, 101.0f));
+
+    std::vector<int> visible[2];
+    m_tree.Cull(frusta, 2, visible);
+
+    for (int i = 0; i < 2; i++)
+    {
+        std::sort(visible[i].begin(), visible[i].end());
+        std::vector<int> expected = CullBruteForce(frusta[i]);
+        EXPECT_FALSE(expected.empty());
+        EXPECT_LT(expected.size(), m_items.size());
+        EXPECT_EQ(expected, visible[i]);
+    }
+}
@@ -187,3 +187,25 @@ TEST_F(CLightManagerUT, LightSorting_SortingAccordingToDistance)
     std::vector<int> expectedLights = { 2, 1, 3 };
     CheckLightSorting(ENG_OBJTYPE_TERRAIN, expectedLights);
 }
+
+TEST_F(CLightManagerUT, LightSelection_UnchangedLightsAreNotResent)
+{
+    const int lightCount = 2;
+    const Math::Vector eyePos(0.0f, 0.0f, 0.0f);
+    PrepareLightTesting(lightCount, eyePos);
+
+    AddLight(1, LIGHT_PRI_LOW, true, true, Math::Vector(1.0f, 0.0f, 0.0f), ENG_OBJTYPE_NULL, ENG_OBJTYPE_NULL);
+    AddLight(2, LIGHT_PRI_LOW, true, true, Math::Vector(2.0f, 0.0f, 0.0f), ENG_OBJTYPE_NULL, ENG_OBJTYPE_NULL);
+
+    std::vector<int> expectedLights = { 1, 2 };
+    CheckLightSorting(ENG_OBJTYPE_TERRAIN, expectedLights);
+
+    // Same selection for another type, nothing changed since - no device calls expected
+    m_lightManager->UpdateDeviceLights(ENG_OBJTYPE_FIX);
+    m_lightManager->UpdateDeviceLights(ENG_OBJTYPE_TERRAIN);
+
+    m_lightManager->SetLightEnabled(0, false);
+
+    expectedLights = { 2 };
+    CheckLightSorting(ENG_OBJTYPE_TERRAIN, expectedLights);
+}
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/particle_motion.h"
+
+#include "common/thread/thread_pool.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+using namespace Gfx;
+
+class ParticleMotionUT : public testing::Test
+{
+protected:
+    //! Adds a particle updated by the frame, with the given speed and mass
+    int AddParticle(const Math::Vector& speed, float mass)
+    {
+        m_motion.Add();
+        int rank = m_motion.GetSize()-1;
+        m_motion.SetPos(rank, Math::Vector(1.0f, 2.0f, 3.0f));
+        m_motion.SetSpeed(rank, speed);
+        m_motion.mass[rank] = mass;
+        m_motion.duration[rank] = 2.0f;
+        m_motion.zoom[rank] = 1.0f;
+        m_motion.intensity[rank] = 1.0f;
+        m_motion.update[rank] = 1.0f;
+        return rank;
+    }
+
+    ParticleMotion m_motion;
+};
+
+TEST_F(ParticleMotionUT, MovesBySpeedThenGravity)
+{
+    int rank = AddParticle(Math::Vector(1.0f, 4.0f, -2.0f), 10.0f);
+    m_motion.Integrate(0.5f, 0, m_motion.GetSize());
+
+    Math::Vector pos = m_motion.GetPos(rank);
+    EXPECT_FLOAT_EQ(1.5f, pos.x);
+    EXPECT_FLOAT_EQ(4.0f, pos.y);
+    EXPECT_FLOAT_EQ(2.0f, pos.z);
+    EXPECT_FLOAT_EQ(-1.0f, m_motion.GetSpeed(rank).y);
+}
+
+TEST_F(ParticleMotionUT, FixedAndNotUpdatedDontMove)
+{
+    int fixed = AddParticle(Math::Vector(1.0f, 1.0f, 1.0f), 10.0f);
+    m_motion.SetFixed(fixed, true);
+    int paused = AddParticle(Math::Vector(1.0f, 1.0f, 1.0f), 10.0f);
+    m_motion.update[paused] = 0.0f;
+
+    m_motion.Integrate(0.5f, 0, m_motion.GetSize());
+
+    for (int rank : { fixed, paused })
+    {
+        EXPECT_FLOAT_EQ(1.0f, m_motion.GetPos(rank).x);
+        EXPECT_FLOAT_EQ(2.0f, m_motion.GetPos(rank).y);
+        EXPECT_FLOAT_EQ(1.0f, m_motion.GetSpeed(rank).y);
+    }
+}
+
+TEST_F(ParticleMotionUT, Ramps)
+{
+    int both = AddParticle(Math::Vector(), 0.0f);
+    m_motion.SetZoomRamp(both, 0.1f, 1.0f);
+    m_motion.SetIntensityRamp(both, 1.0f, -1.0f);
+    m_motion.time[both] = 1.0f;
+
+    int zoomOnly = AddParticle(Math::Vector(), 0.0f);
+    m_motion.SetZoomRamp(zoomOnly, 1.0f, -0.5f);
+    m_motion.time[zoomOnly] = 1.5f;
+    m_motion.phaseTime[zoomOnly] = 0.5f;
+
+    int paused = AddParticle(Math::Vector(), 0.0f);
+    m_motion.SetZoomRamp(paused, 0.0f, 1.0f);
+    m_motion.update[paused] = 0.0f;
+    m_motion.duration[paused] = 0.0f;  // progress is not a number
+
+    m_motion.Integrate(0.5f, 0, m_motion.GetSize());
+
+    EXPECT_FLOAT_EQ(0.6f, m_motion.zoom[both]);
+    EXPECT_FLOAT_EQ(0.5f, m_motion.intensity[both]);
+    EXPECT_FLOAT_EQ(0.75f, m_motion.zoom[zoomOnly]);
+    EXPECT_FLOAT_EQ(1.0f, m_motion.intensity[zoomOnly]);
+    EXPECT_FLOAT_EQ(1.0f, m_motion.zoom[paused]);
+}
+
+TEST_F(ParticleMotionUT, ResetClearsBehavior)
+{
+    int rank = AddParticle(Math::Vector(1.0f, 0.0f, 0.0f), 0.0f);
+    m_motion.SetFixed(rank, true);
+    m_motion.SetZoomRamp(rank, 0.0f, 1.0f);
+
+    m_motion.Reset(rank);
+    m_motion.SetSpeed(rank, Math::Vector(1.0f, 0.0f, 0.0f));
+    m_motion.duration[rank] = 1.0f;
+    m_motion.zoom[rank] = 0.25f;
+    m_motion.update[rank] = 1.0f;
+    m_motion.Integrate(1.0f, 0, m_motion.GetSize());
+
+    EXPECT_FLOAT_EQ(1.0f, m_motion.GetPos(rank).x);
+    EXPECT_FLOAT_EQ(0.25f, m_motion.zoom[rank]);
+}
+
+// Run with --gtest_also_run_disabled_tests to print the figures.
+// Runs the parallel stage of CParticle::FrameParticle() on 10000 particles:
+// integration, then the ground below each particle with gravity, here
+// a procedural height instead of CTerrain.
+TEST_F(ParticleMotionUT, DISABLED_Benchmark)
+{
+    const int COUNT = 10000;
+    const int CHUNK = 256;
+    const int FRAMES = 200;
+
+    std::srand(42);
+    for (int i = 0; i < COUNT; i++)
+    {
+        float r = static_cast<float>(std::rand())/RAND_MAX;
+        int rank = AddParticle(Math::Vector(r*10.0f, r*20.0f, 5.0f-r*10.0f), i%2 == 0 ? 10.0f : 0.0f);
+        m_motion.SetZoomRamp(rank, 1.0f, -1.0f);
+        m_motion.SetIntensityRamp(rank, 1.0f, -1.0f);
+        m_motion.duration[rank] = 100.0f;
+    }
+    std::vector<float> floor(COUNT);
+
+    auto stage = [&](int begin, int end)
+    {
+        m_motion.Integrate(0.01f, begin, end);
+        for (int k = begin; k < end; k++)
+        {
+            floor[k] = 0.0f;
+            if (m_motion.mass[k] == 0.0f) continue;
+            floor[k] = sinf(m_motion.posX[k]*0.1f)*cosf(m_motion.posZ[k]*0.1f)*10.0f;
+        }
+    };
+
+    float single = 0.0f;
+    for (int threads = 0; threads <= 7; threads++)
+    {
+        CThreadPool pool(threads);
+        auto begin = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FRAMES; frame++)
+        {
+            pool.ParallelFor(COUNT, CHUNK, stage);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        float ms = std::chrono::duration<float, std::milli>(end-begin).count()/FRAMES;
+        if (threads == 0) single = ms;
+        std::printf("%d particles, %d thread(s): %.3f ms per frame, speedup %.2f\n",
+                    COUNT, threads+1, ms, single/ms);
+    }
+}
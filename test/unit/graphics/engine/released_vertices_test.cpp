@@ -0,0 +1,129 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/engine.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace Gfx;
+
+class ReleasedVerticesUT : public testing::Test
+{
+protected:
+    //! Returns a distinct vertex for each \a index
+    static VertexTex2 MakeVertex(int index);
+    //! Fills m_tier with \a uniqueCount vertices, each used \a useCount times
+    void FillTier(int uniqueCount, int useCount);
+    //! Checks that m_tier gives back the vertices it was filled with
+    void ExpectOriginalVertices();
+
+    EngineBaseObjDataTier m_tier;
+    std::vector<VertexTex2> m_original;
+};
+
+VertexTex2 ReleasedVerticesUT::MakeVertex(int index)
+{
+    float f = static_cast<float>(index);
+    return VertexTex2(Math::Vector(f, -f, 0.5f * f), Math::Vector(0.0f, 1.0f, 0.0f),
+                      Math::Point(f / 1000.0f, 0.25f), Math::Point(0.5f, f / 1000.0f));
+}
+
+void ReleasedVerticesUT::FillTier(int uniqueCount, int useCount)
+{
+    m_original.clear();
+    for (int use = 0; use < useCount; use++)
+    {
+        for (int i = 0; i < uniqueCount; i++)
+            m_original.push_back(MakeVertex(i));
+    }
+    m_tier.vertices = m_original;
+}
+
+void ReleasedVerticesUT::ExpectOriginalVertices()
+{
+    ASSERT_EQ(static_cast<int>(m_original.size()), m_tier.GetVertexCount());
+    int mismatches = 0;
+    for (std::size_t i = 0; i < m_original.size(); i++)
+    {
+        if (std::memcmp(&m_original[i], &m_tier.GetVertex(i), sizeof(VertexTex2)) != 0)
+            mismatches++;
+    }
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST_F(ReleasedVerticesUT, RoundTripKeepsVertices)
+{
+    FillTier(100, 6);
+
+    EXPECT_TRUE(ReleaseVertices(m_tier));
+    EXPECT_TRUE(m_tier.vertices.empty());
+    EXPECT_EQ(100u, m_tier.coldVertices.size());
+    ExpectOriginalVertices();
+
+    RestoreVertices(m_tier);
+    EXPECT_EQ(m_original.size(), m_tier.vertices.size());
+    EXPECT_TRUE(m_tier.coldVertices.empty());
+    EXPECT_TRUE(m_tier.coldIndices.empty());
+    ExpectOriginalVertices();
+}
+
+TEST_F(ReleasedVerticesUT, RoundTripUsesEvery16BitIndex)
+{
+    FillTier(65536, 3);
+
+    EXPECT_TRUE(ReleaseVertices(m_tier));
+    EXPECT_EQ(65536u, m_tier.coldVertices.size());
+    ExpectOriginalVertices();
+
+    RestoreVertices(m_tier);
+    ExpectOriginalVertices();
+}
+
+TEST_F(ReleasedVerticesUT, TooManyUniqueVerticesAreKept)
+{
+    FillTier(65537, 3);
+
+    EXPECT_FALSE(ReleaseVertices(m_tier));
+    EXPECT_TRUE(m_tier.keepVertices);
+    EXPECT_TRUE(m_tier.coldVertices.empty());
+    EXPECT_TRUE(m_tier.coldIndices.empty());
+    ExpectOriginalVertices();
+
+    // Restoring vertices that were not released changes nothing
+    RestoreVertices(m_tier);
+    ExpectOriginalVertices();
+}
+
+TEST_F(ReleasedVerticesUT, VerticesThatDontCompactAreKept)
+{
+    // All different, like triangle strips of terrain
+    FillTier(1000, 1);
+
+    EXPECT_FALSE(ReleaseVertices(m_tier));
+    EXPECT_TRUE(m_tier.keepVertices);
+    ExpectOriginalVertices();
+
+    // Later releases don't try again
+    m_tier.vertices.insert(m_tier.vertices.end(), m_original.begin(), m_original.end());
+    m_original = m_tier.vertices;
+    EXPECT_FALSE(ReleaseVertices(m_tier));
+    ExpectOriginalVertices();
+}
@@ -0,0 +1,139 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/render_queue.h"
+
+#include "graphics/core/nulldevice.h"
+
+#include <gtest/gtest.h>
+
+using namespace Gfx;
+
+class CRenderQueueUT : public testing::Test
+{
+protected:
+    void SetUp() override;
+
+    RenderItem MakeItem(int objRank, unsigned int tex, int data);
+    int SubmitAndCountTextures(const CRenderQueue& queue);
+
+    Math::Matrix m_transform;
+    std::vector<EngineBaseObjDataTier> m_data;
+    CNullDevice m_device;
+};
+
+void CRenderQueueUT::SetUp()
+{
+    m_data.resize(2);
+    m_data[0].material.diffuse = Color(1.0f, 0.0f, 0.0f, 1.0f);
+    m_data[1].material.diffuse = Color(0.0f, 1.0f, 0.0f, 1.0f);
+}
+
+RenderItem CRenderQueueUT::MakeItem(int objRank, unsigned int tex, int data)
+{
+    RenderItem item;
+    item.objRank = objRank;
+    item.objType = ENG_OBJTYPE_FIX;
+    item.tex1.id = tex;
+    item.transform = &m_transform;
+    item.data = &m_data[data];
+    return item;
+}
+
+int CRenderQueueUT::SubmitAndCountTextures(const CRenderQueue& queue)
+{
+    m_device.ResetCallCounts();
+    queue.Submit(&m_device, [](const RenderItem&) {});
+    return m_device.GetCallCounts().textures;
+}
+
+TEST_F(CRenderQueueUT, SortByStateGroupsTexturesAndMaterials)
+{
+    CRenderQueue queue;
+    for (int objRank = 0; objRank < 4; objRank++)
+    {
+        queue.Add(MakeItem(objRank, 1, 0));
+        queue.Add(MakeItem(objRank, 2, 1));
+    }
+
+    // Every item switches stage 0 texture; stage 1 is set once
+    EXPECT_EQ(9, SubmitAndCountTextures(queue));
+    EXPECT_EQ(8, m_device.GetCallCounts().materials);
+
+    queue.SortByState();
+
+    EXPECT_EQ(3, SubmitAndCountTextures(queue));
+    EXPECT_EQ(2, m_device.GetCallCounts().materials);
+    EXPECT_EQ(8, m_device.GetCallCounts().transforms);
+
+    const auto& items = queue.GetItems();
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(1u, items[i].tex1.id);
+        EXPECT_EQ(i, items[i].objRank);
+    }
+}
+
+TEST_F(CRenderQueueUT, SortBackToFront)
+{
+    CRenderQueue queue;
+    for (int objRank = 0; objRank < 3; objRank++)
+    {
+        RenderItem item = MakeItem(objRank, 1, 0);
+        item.depth = 10.0f * (objRank == 1 ? 3 : objRank);
+        queue.Add(item);
+    }
+
+    queue.SortBackToFront();
+
+    const auto& items = queue.GetItems();
+    ASSERT_EQ(3u, items.size());
+    EXPECT_EQ(1, items[0].objRank);
+    EXPECT_EQ(2, items[1].objRank);
+    EXPECT_EQ(0, items[2].objRank);
+}
+
+TEST_F(CRenderQueueUT, SubmitInstancedGroupsCopiesOfStaticBuffers)
+{
+    m_data[0].staticBufferId = 1;
+
+    CRenderQueue queue;
+    for (int objRank = 0; objRank < 3; objRank++)
+    {
+        queue.Add(MakeItem(objRank, 1, 0));
+        queue.Add(MakeItem(objRank, 1, 1));
+    }
+
+    queue.SortByState();
+
+    m_device.ResetCallCounts();
+    queue.SubmitInstanced(&m_device, [this](const RenderItem* items, int count)
+    {
+        std::vector<Math::Matrix> transforms(count, m_transform);
+        if (count > 1)
+            m_device.DrawStaticBufferInstanced(items[0].data->staticBufferId, transforms.data(), count);
+        else
+            m_device.DrawStaticBuffer(items[0].data->staticBufferId);
+    });
+
+    // Items with a static buffer become one instanced draw, the others are drawn one by one
+    EXPECT_EQ(4, m_device.GetCallCounts().drawCalls);
+    EXPECT_EQ(3, m_device.GetCallCounts().instances);
+    EXPECT_EQ(3, m_device.GetCallCounts().transforms);
+}
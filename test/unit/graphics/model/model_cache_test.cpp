@@ -0,0 +1,264 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/resources/resourcemanager.h"
+
+#include "graphics/model/model_cache.h"
+#include "graphics/model/model_input.h"
+#include "graphics/model/model_io_exception.h"
+#include "graphics/model/model_output.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace Gfx;
+
+namespace
+{
+
+ModelTriangle MakeTriangle(float offset, const std::string& tex1Name)
+{
+    ModelTriangle triangle;
+    triangle.p1 = VertexTex2(Math::Vector(offset, 0.0f, 0.0f), Math::Vector(0.0f, 1.0f, 0.0f), Math::Point(0.0f, 0.0f));
+    triangle.p2 = VertexTex2(Math::Vector(offset, 1.0f, 0.0f), Math::Vector(0.0f, 1.0f, 0.0f), Math::Point(0.0f, 1.0f));
+    triangle.p3 = VertexTex2(Math::Vector(offset, 0.0f, 1.0f), Math::Vector(0.0f, 1.0f, 0.0f), Math::Point(1.0f, 0.0f),
+                             Math::Point(0.5f, 0.25f));
+    triangle.diffuse = Color(0.5f, 0.25f, 1.0f, 1.0f);
+    triangle.tex1Name = tex1Name;
+    return triangle;
+}
+
+std::string WriteCache(const CModel& model)
+{
+    std::stringstream stream;
+    ModelOutput::Write(model, stream, ModelFormat::Cache);
+    return stream.str();
+}
+
+} // anonymous namespace
+
+TEST(ModelCacheFormatTest, RoundTripKeepsTrianglesInOrder)
+{
+    CModelMesh mesh;
+    mesh.AddTriangle(MakeTriangle(0.0f, "a.png"));
+    mesh.AddTriangle(MakeTriangle(1.0f, "a.png"));
+    ModelTriangle special = MakeTriangle(2.0f, "abcde.png");
+    special.variableTex2 = true;
+    special.transparentMode = ModelTransparentMode::MapBlackToAlpha;
+    special.specialMark = ModelSpecialMark::Part2;
+    mesh.AddTriangle(special);
+    mesh.AddTriangle(MakeTriangle(3.0f, "a.png"));
+    mesh.SetParent("root");
+
+    CModel model;
+    model.AddMesh("main", std::move(mesh));
+    ModelCrashSphere crashSphere;
+    crashSphere.position = Math::Vector(1.0f, 2.0f, 3.0f);
+    crashSphere.radius = 4.0f;
+    crashSphere.sound = "boom";
+    model.AddCrashSphere(crashSphere);
+
+    std::string data = WriteCache(model);
+    ASSERT_EQ(0u, data.size() % 4);
+
+    CModel read = ModelInput::ReadCache(data.data(), data.size());
+
+    ASSERT_EQ(1, read.GetCrashSphereCount());
+    EXPECT_EQ("boom", read.GetCrashSpheres()[0].sound);
+    EXPECT_FALSE(read.HasShadowSpot());
+
+    const CModelMesh* readMesh = read.GetMesh("main");
+    ASSERT_NE(nullptr, readMesh);
+    EXPECT_EQ("root", readMesh->GetParent());
+
+    const std::vector<ModelTriangle>& expected = model.GetMesh("main")->GetTriangles();
+    const std::vector<ModelTriangle>& actual = readMesh->GetTriangles();
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(expected[i].p1.coord.x, actual[i].p1.coord.x);
+        EXPECT_EQ(expected[i].p2.coord.y, actual[i].p2.coord.y);
+        EXPECT_EQ(expected[i].p3.texCoord2.x, actual[i].p3.texCoord2.x);
+        EXPECT_EQ(expected[i].p3.texCoord2.y, actual[i].p3.texCoord2.y);
+        EXPECT_EQ(expected[i].diffuse, actual[i].diffuse);
+        EXPECT_EQ(expected[i].tex1Name, actual[i].tex1Name);
+        EXPECT_EQ(expected[i].variableTex2, actual[i].variableTex2);
+        EXPECT_EQ(expected[i].transparentMode, actual[i].transparentMode);
+        EXPECT_EQ(expected[i].specialMark, actual[i].specialMark);
+    }
+}
+
+TEST(ModelCacheFormatTest, TruncatedDataIsRejected)
+{
+    CModelMesh mesh;
+    mesh.AddTriangle(MakeTriangle(0.0f, "a.png"));
+    CModel model;
+    model.AddMesh("main", std::move(mesh));
+
+    std::string data = WriteCache(model);
+
+    EXPECT_THROW(ModelInput::ReadCache(data.data(), data.size() - 4), CModelIOException);
+    EXPECT_THROW(ModelInput::ReadCache("CBMX", 4), CModelIOException);
+}
+
+/*
+ * Loads models through ModelCache with data and save directories
+ * in a temporary directory, mounted like CPathManager does.
+ */
+class ModelCacheUT : public testing::Test
+{
+protected:
+    ModelCacheUT()
+        : m_resourceManager(nullptr)
+    {}
+
+    void SetUp() override;
+    void TearDown() override;
+
+    //! Writes a text model with \a triangleCount triangles to models/test.txt in the data directory
+    void WriteSource(int triangleCount);
+    //! Returns names of files in cache/models of the save directory
+    std::vector<std::string> GetCacheFiles();
+
+    CResourceManager m_resourceManager;
+    boost::filesystem::path m_root;
+    boost::filesystem::path m_sourcePath;
+};
+
+void ModelCacheUT::SetUp()
+{
+    m_root = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("colobot-ut-%%%%-%%%%");
+    boost::filesystem::create_directories(m_root / "data" / "models");
+    boost::filesystem::create_directories(m_root / "save");
+    m_sourcePath = m_root / "data" / "models" / "test.txt";
+
+    CResourceManager::AddLocation((m_root / "data").string(), false);
+    CResourceManager::SetSaveLocation((m_root / "save").string());
+    CResourceManager::AddLocation((m_root / "save").string(), true);
+}
+
+void ModelCacheUT::TearDown()
+{
+    boost::filesystem::remove_all(m_root);
+}
+
+void ModelCacheUT::WriteSource(int triangleCount)
+{
+    CModelMesh mesh;
+    for (int i = 0; i < triangleCount; ++i)
+        mesh.AddTriangle(MakeTriangle(static_cast<float>(i), "a.png"));
+
+    CModel model;
+    model.AddMesh("main", std::move(mesh));
+
+    std::ofstream stream(m_sourcePath.string(), std::ios_base::out | std::ios_base::binary);
+    ModelOutput::Write(model, stream, ModelFormat::Text);
+}
+
+std::vector<std::string> ModelCacheUT::GetCacheFiles()
+{
+    std::vector<std::string> files;
+    boost::filesystem::path dir = m_root / "save" / "cache" / "models";
+    if (!boost::filesystem::is_directory(dir))
+        return files;
+
+    for (boost::filesystem::directory_iterator it(dir); it != boost::filesystem::directory_iterator(); ++it)
+        files.push_back(it->path().filename().string());
+    return files;
+}
+
+TEST_F(ModelCacheUT, SecondLoadReadsCompiledFile)
+{
+    WriteSource(3);
+
+    CModel first = ModelCache::Load("models/test.txt", ModelFormat::Text);
+    ASSERT_NE(nullptr, first.GetMesh("main"));
+    EXPECT_EQ(3, first.GetMesh("main")->GetTriangleCount());
+
+    std::vector<std::string> files = GetCacheFiles();
+    ASSERT_EQ(1u, files.size());
+    EXPECT_EQ(0u, files[0].find("models-test.txt-"));
+
+    // The source can no longer be parsed, so only the compiled file can give the model back
+    std::time_t modTime = boost::filesystem::last_write_time(m_sourcePath);
+    {
+        std::ofstream stream(m_sourcePath.string(), std::ios_base::out | std::ios_base::trunc);
+        stream << "garbage" << std::endl;
+    }
+    boost::filesystem::last_write_time(m_sourcePath, modTime);
+
+    CModel second = ModelCache::Load("models/test.txt", ModelFormat::Text);
+    ASSERT_NE(nullptr, second.GetMesh("main"));
+
+    const std::vector<ModelTriangle>& expected = first.GetMesh("main")->GetTriangles();
+    const std::vector<ModelTriangle>& actual = second.GetMesh("main")->GetTriangles();
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(expected[i].p1.coord.x, actual[i].p1.coord.x);
+        EXPECT_EQ(expected[i].p3.texCoord2.x, actual[i].p3.texCoord2.x);
+        EXPECT_EQ(expected[i].tex1Name, actual[i].tex1Name);
+    }
+    EXPECT_EQ(files, GetCacheFiles());
+}
+
+TEST_F(ModelCacheUT, ChangedSourceReplacesCompiledFile)
+{
+    WriteSource(1);
+    ModelCache::Load("models/test.txt", ModelFormat::Text);
+    std::vector<std::string> oldFiles = GetCacheFiles();
+    ASSERT_EQ(1u, oldFiles.size());
+
+    WriteSource(2);
+    boost::filesystem::last_write_time(m_sourcePath, boost::filesystem::last_write_time(m_sourcePath) + 10);
+
+    CModel model = ModelCache::Load("models/test.txt", ModelFormat::Text);
+    ASSERT_NE(nullptr, model.GetMesh("main"));
+    EXPECT_EQ(2, model.GetMesh("main")->GetTriangleCount());
+
+    std::vector<std::string> newFiles = GetCacheFiles();
+    ASSERT_EQ(1u, newFiles.size());
+    EXPECT_NE(oldFiles[0], newFiles[0]);
+
+    CModel cached = ModelCache::Load("models/test.txt", ModelFormat::Text);
+    ASSERT_NE(nullptr, cached.GetMesh("main"));
+    EXPECT_EQ(2, cached.GetMesh("main")->GetTriangleCount());
+}
+
+TEST_F(ModelCacheUT, DamagedCompiledFileFallsBackToSource)
+{
+    WriteSource(2);
+    ModelCache::Load("models/test.txt", ModelFormat::Text);
+    std::vector<std::string> files = GetCacheFiles();
+    ASSERT_EQ(1u, files.size());
+
+    {
+        std::ofstream stream((m_root / "save" / "cache" / "models" / files[0]).string(),
+                             std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        stream << "CBMX";
+    }
+
+    CModel model = ModelCache::Load("models/test.txt", ModelFormat::Text);
+    ASSERT_NE(nullptr, model.GetMesh("main"));
+    EXPECT_EQ(2, model.GetMesh("main")->GetTriangleCount());
+}
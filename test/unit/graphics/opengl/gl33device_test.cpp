@@ -0,0 +1,230 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "graphics/opengl/gl33device.h"
+
+#include "common/make_unique.h"
+#include "common/resources/resourcemanager.h"
+
+#include "graphics/core/light.h"
+
+#include "math/geometry.h"
+
+#include <gtest/gtest.h>
+
+using namespace Gfx;
+
+/*
+ * Renders through CGL33Device into an offscreen framebuffer.
+ * The context is made current by main() of colobot_gl_ut.
+ */
+class CGL33DeviceUT : public testing::Test
+{
+protected:
+    CGL33DeviceUT()
+        : m_resourceManager(nullptr)
+    {}
+
+    void SetUp() override;
+    void TearDown() override;
+
+    //! Draws a unit square, centered on the origin, with each transform
+    void DrawInstanced(const std::vector<Math::Matrix>& transforms);
+    //! Draws the same squares one by one, as done without instancing
+    void DrawSingle(const std::vector<Math::Matrix>& transforms);
+
+    //! Returns the RGBA value of pixel (x, y), counted from the bottom left
+    unsigned int GetPixel(int x, int y);
+    void ReadPixels();
+
+    static const int SIZE = 64;
+
+    CResourceManager m_resourceManager;
+    std::unique_ptr<CGL33Device> m_device;
+    unsigned int m_square = 0;
+    std::unique_ptr<CFrameBufferPixels> m_pixels;
+};
+
+void CGL33DeviceUT::SetUp()
+{
+    // Shaders are read from the source tree
+    CResourceManager::AddLocation(UT_SHADER_DIR);
+
+    DeviceConfig config;
+    config.size = Math::IntPoint(SIZE, SIZE);
+
+    m_device = MakeUnique<CGL33Device>(config);
+    ASSERT_TRUE(m_device->Create());
+
+    FramebufferParams params;
+    params.width = SIZE;
+    params.height = SIZE;
+    CFramebuffer* framebuffer = m_device->CreateFramebuffer("test", params);
+    ASSERT_NE(nullptr, framebuffer);
+    framebuffer->Bind();
+
+    m_device->SetRenderMode(RENDER_MODE_NORMAL);
+    m_device->SetRenderState(RENDER_STATE_DEPTH_TEST, false);
+    m_device->SetRenderState(RENDER_STATE_CULLING, false);
+    m_device->SetRenderState(RENDER_STATE_FOG, false);
+
+    // One unit is 8 pixels
+    Math::Matrix projection;
+    Math::LoadOrthoProjectionMatrix(projection, 0.0f, 8.0f, 0.0f, 8.0f, -10.0f, 10.0f);
+    m_device->SetTransform(TRANSFORM_PROJECTION, projection);
+    m_device->SetTransform(TRANSFORM_VIEW, Math::Matrix());
+
+    Vertex square[6] =
+    {
+        Vertex(Math::Vector(-0.5f, -0.5f, 0.0f), Math::Vector(0.0f, 0.0f, 1.0f)),
+        Vertex(Math::Vector( 0.5f, -0.5f, 0.0f), Math::Vector(0.0f, 0.0f, 1.0f)),
+        Vertex(Math::Vector( 0.5f,  0.5f, 0.0f), Math::Vector(0.0f, 0.0f, 1.0f)),
+        Vertex(Math::Vector(-0.5f, -0.5f, 0.0f), Math::Vector(0.0f, 0.0f, 1.0f)),
+        Vertex(Math::Vector( 0.5f,  0.5f, 0.0f), Math::Vector(0.0f, 0.0f, 1.0f)),
+        Vertex(Math::Vector(-0.5f,  0.5f, 0.0f), Math::Vector(0.0f, 0.0f, 1.0f)),
+    };
+    m_square = m_device->CreateStaticBuffer(PRIMITIVE_TRIANGLES, square, 6);
+}
+
+void CGL33DeviceUT::TearDown()
+{
+    if (m_device != nullptr)
+    {
+        m_device->DestroyStaticBuffer(m_square);
+        m_device->Destroy();
+        m_device.reset();
+    }
+}
+
+void CGL33DeviceUT::DrawInstanced(const std::vector<Math::Matrix>& transforms)
+{
+    m_device->Clear();
+    m_device->DrawStaticBufferInstanced(m_square, transforms.data(), transforms.size());
+    ReadPixels();
+}
+
+void CGL33DeviceUT::DrawSingle(const std::vector<Math::Matrix>& transforms)
+{
+    m_device->Clear();
+    for (const Math::Matrix& transform : transforms)
+    {
+        m_device->SetTransform(TRANSFORM_WORLD, transform);
+        m_device->DrawStaticBuffer(m_square);
+    }
+    ReadPixels();
+}
+
+void CGL33DeviceUT::ReadPixels()
+{
+    m_pixels = m_device->GetFrameBufferPixels();
+}
+
+unsigned int CGL33DeviceUT::GetPixel(int x, int y)
+{
+    return static_cast<unsigned int*>(m_pixels->GetPixelsData())[y * SIZE + x];
+}
+
+TEST_F(CGL33DeviceUT, DrawsEveryInstance)
+{
+    m_device->SetRenderState(RENDER_STATE_LIGHTING, false);
+
+    // Squares of 8x8 pixels on every other cell of a 4x4 grid
+    std::vector<Math::Matrix> transforms;
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 4; x++)
+        {
+            Math::Matrix transform;
+            Math::LoadTranslationMatrix(transform, Math::Vector(2.0f * x + 1.0f, 2.0f * y + 1.0f, 0.0f));
+            transforms.push_back(transform);
+        }
+    }
+
+    DrawInstanced(transforms);
+
+    int covered = 0;
+    for (int y = 0; y < SIZE; y++)
+    {
+        for (int x = 0; x < SIZE; x++)
+        {
+            bool inside = (x % 16) >= 4 && (x % 16) < 12 && (y % 16) >= 4 && (y % 16) < 12;
+            bool drawn = (GetPixel(x, y) & 0x00FFFFFF) != 0;
+            EXPECT_EQ(inside, drawn) << "pixel " << x << ", " << y;
+            if (drawn) covered++;
+        }
+    }
+
+    EXPECT_EQ(16 * 8 * 8, covered);
+}
+
+TEST_F(CGL33DeviceUT, InstancedLightingMatchesSingleDraws)
+{
+    Material material;
+    material.ambient = Color(0.0f, 0.0f, 0.0f, 1.0f);
+    material.diffuse = Color(1.0f, 1.0f, 1.0f, 1.0f);
+    material.specular = Color(0.0f, 0.0f, 0.0f, 1.0f);
+    m_device->SetMaterial(material);
+
+    Light light;
+    light.type = LIGHT_DIRECTIONAL;
+    light.ambient = Color(0.0f, 0.0f, 0.0f, 1.0f);
+    light.diffuse = Color(1.0f, 1.0f, 1.0f, 1.0f);
+    light.specular = Color(0.0f, 0.0f, 0.0f, 1.0f);
+    light.direction = Math::Normalize(Math::Vector(0.0f, -1.0f, -1.0f));
+    m_device->SetLight(0, light);
+    m_device->SetLightEnabled(0, true);
+    m_device->SetRenderState(RENDER_STATE_LIGHTING, true);
+
+    // Tilted and non-uniformly scaled squares, so each is lit differently
+    // and the normal matrix is not the rotation part of the world matrix
+    std::vector<Math::Matrix> transforms;
+    for (int i = 0; i < 16; i++)
+    {
+        Math::Matrix translation, scale, rotation;
+        Math::LoadTranslationMatrix(translation, Math::Vector(2.0f * (i % 4) + 1.0f, 2.0f * (i / 4) + 1.0f, 0.0f));
+        Math::LoadScaleMatrix(scale, Math::Vector(1.5f, 3.0f, 0.5f));
+        Math::LoadRotationXMatrix(rotation, -0.7f + 0.1f * i);
+        transforms.push_back(Math::MultiplyMatrices(translation, Math::MultiplyMatrices(scale, rotation)));
+    }
+
+    DrawSingle(transforms);
+    std::vector<unsigned int> expected(SIZE * SIZE);
+    for (int i = 0; i < SIZE * SIZE; i++)
+        expected[i] = GetPixel(i % SIZE, i / SIZE);
+
+    DrawInstanced(transforms);
+
+    int lit = 0;
+    for (int i = 0; i < SIZE * SIZE; i++)
+    {
+        unsigned int actual = GetPixel(i % SIZE, i / SIZE);
+        for (int channel = 0; channel < 3; channel++)
+        {
+            int a = (actual >> (8 * channel)) & 0xFF;
+            int e = (expected[i] >> (8 * channel)) & 0xFF;
+            EXPECT_NEAR(e, a, 1) << "pixel " << i % SIZE << ", " << i / SIZE;
+        }
+
+        if ((expected[i] & 0x00FFFFFF) != 0) lit++;
+    }
+
+    // Make sure the comparison is not between two empty images
+    EXPECT_GT(lit, 16 * 8);
+}
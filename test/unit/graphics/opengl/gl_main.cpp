@@ -0,0 +1,102 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/*
+ * Main of colobot_gl_ut, the unit tests that render with OpenGL.
+ *
+ * They run in a surfaceless EGL context, so no window is needed, e.g. on
+ * Mesa's llvmpipe. When no OpenGL 3.3 context can be made, no test is run
+ * and SKIP_RETURN_CODE is returned, so CTest reports them as skipped.
+ */
+
+#include "common/logger.h"
+
+#include "graphics/opengl/glutil.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+namespace
+{
+
+const int SKIP_RETURN_CODE = 77;
+
+bool CreateContext(EGLDisplay& display, EGLContext& context)
+{
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay == nullptr)
+        return false;
+
+    display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+    if (display == nullptr || !eglInitialize(display, nullptr, nullptr))
+        return false;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+        return false;
+
+    const EGLint attributes[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+        EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_NONE
+    };
+
+    context = eglCreateContext(display, nullptr, nullptr, attributes);
+    if (context == nullptr)
+        return false;
+
+    return eglMakeCurrent(display, nullptr, nullptr, context);
+#else
+    return false;
+#endif
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    CLogger logger;
+
+    ::testing::InitGoogleTest(&argc, argv);
+
+    EGLDisplay display = nullptr;
+    EGLContext context = nullptr;
+    if (!CreateContext(display, context) || !Gfx::InitializeGLEW(true))
+    {
+        std::cerr << "No offscreen OpenGL 3.3 context, OpenGL tests skipped" << std::endl;
+        if (display != nullptr)
+            eglTerminate(display);
+        return SKIP_RETURN_CODE;
+    }
+
+    int result = RUN_ALL_TESTS();
+
+    eglMakeCurrent(display, nullptr, nullptr, nullptr);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+
+    return result;
+}
@@ -0,0 +1,408 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/grid_path_finder.h"
+#include "object/beam_path_finder.h"
+#include "object/nav_grid.h"
+
+#include "math/geometry.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <vector>
+#include <gtest/gtest.h>
+
+class CGridPathFinderTest : public testing::Test
+{
+protected:
+    //! Generates a perfect maze with corridors of given width, and optionally removes some walls
+    void GenerateMaze(int cells, int corridor, int openings)
+    {
+        int step = corridor+1;
+        m_size = cells*step+1;
+        m_blocked.assign(m_size*m_size, true);
+
+        std::vector<bool> visited(cells*cells, false);
+        std::vector<int> stack;
+        stack.push_back(0);
+        visited[0] = true;
+        Carve(0, 0, step, corridor);
+        while (!stack.empty())
+        {
+            int cell = stack.back();
+            int cx = cell%cells, cy = cell/cells;
+
+            std::vector<int> next;
+            const int dx[4] = { 1, -1, 0, 0 };
+            const int dy[4] = { 0, 0, 1, -1 };
+            for (int d = 0; d < 4; d++)
+            {
+                int nx = cx+dx[d], ny = cy+dy[d];
+                if (nx < 0 || ny < 0 || nx >= cells || ny >= cells) continue;
+                if (visited[nx+ny*cells]) continue;
+                next.push_back(d);
+            }
+            if (next.empty())
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            int d = next[std::rand()%next.size()];
+            int nx = cx+dx[d], ny = cy+dy[d];
+            visited[nx+ny*cells] = true;
+            Carve(nx, ny, step, corridor);
+            // Opens the wall between both cells
+            for (int i = 0; i < corridor; i++)
+            {
+                int wx = 1+std::max(cx, nx)*step-1, wy = 1+cy*step+i;
+                if (dy[d] != 0)
+                {
+                    wx = 1+cx*step+i;
+                    wy = 1+std::max(cy, ny)*step-1;
+                }
+                m_blocked[wx+wy*m_size] = false;
+            }
+            stack.push_back(nx+ny*cells);
+        }
+
+        for (int i = 0; i < openings; i++)
+        {
+            int x = 1+std::rand()%(m_size-2), y = 1+std::rand()%(m_size-2);
+            m_blocked[x+y*m_size] = false;
+        }
+    }
+
+    //! Generates an open field with rectangular obstacles, keeping the corners free
+    void GenerateField(int size, int obstacles)
+    {
+        m_size = size;
+        m_blocked.assign(m_size*m_size, false);
+        for (int i = 0; i < obstacles; i++)
+        {
+            int w = 2+std::rand()%(size/10), h = 2+std::rand()%(size/10);
+            int x0 = std::rand()%(size-w), y0 = std::rand()%(size-h);
+            for (int y = y0; y < y0+h; y++)
+                for (int x = x0; x < x0+w; x++)
+                    m_blocked[x+y*m_size] = true;
+        }
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                m_blocked[x+y*m_size] = false;
+                m_blocked[(m_size-1-x)+(m_size-1-y)*m_size] = false;
+            }
+        }
+    }
+
+    void Carve(int cx, int cy, int step, int corridor)
+    {
+        for (int y = 0; y < corridor; y++)
+            for (int x = 0; x < corridor; x++)
+                m_blocked[(1+cx*step+x)+(1+cy*step+y)*m_size] = false;
+    }
+
+    bool IsBlocked(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= m_size || y >= m_size) return true;
+        return m_blocked[x+y*m_size];
+    }
+
+    CGridPathFinder::BlockedFunction Blocked()
+    {
+        return [this](int x, int y) { return IsBlocked(x, y); };
+    }
+
+    //! Checks that the path is made of allowed moves and returns its length
+    float CheckPath(const std::vector<Math::IntPoint>& path)
+    {
+        float length = 0.0f;
+        for (std::size_t i = 0; i < path.size(); i++)
+        {
+            EXPECT_FALSE(IsBlocked(path[i].x, path[i].y));
+            if (i == 0) continue;
+            int dx = path[i].x-path[i-1].x, dy = path[i].y-path[i-1].y;
+            EXPECT_TRUE(std::abs(dx) <= 1 && std::abs(dy) <= 1 && (dx != 0 || dy != 0));
+            if (dx != 0 && dy != 0)
+            {
+                EXPECT_FALSE(IsBlocked(path[i-1].x+dx, path[i-1].y));
+                EXPECT_FALSE(IsBlocked(path[i-1].x, path[i-1].y+dy));
+                length += sqrtf(2.0f);
+            }
+            else
+            {
+                length += 1.0f;
+            }
+        }
+        return length;
+    }
+
+    //! Length of the shortest path computed with Dijkstra, or -1 if there is none
+    float ShortestPath(Math::IntPoint start, Math::IntPoint goal)
+    {
+        std::vector<float> cost(m_size*m_size, 1e30f);
+        typedef std::pair<float, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        cost[start.x+start.y*m_size] = 0.0f;
+        open.push(Entry(0.0f, start.x+start.y*m_size));
+        while (!open.empty())
+        {
+            Entry e = open.top();
+            open.pop();
+            if (e.first > cost[e.second]) continue;
+            int x = e.second%m_size, y = e.second/m_size;
+            if (x == goal.x && y == goal.y) return e.first;
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (dx == 0 && dy == 0) continue;
+                    if (IsBlocked(x+dx, y+dy)) continue;
+                    float c = 1.0f;
+                    if (dx != 0 && dy != 0)
+                    {
+                        if (IsBlocked(x+dx, y) || IsBlocked(x, y+dy)) continue;
+                        c = sqrtf(2.0f);
+                    }
+                    int n = (x+dx)+(y+dy)*m_size;
+                    if (e.first+c < cost[n])
+                    {
+                        cost[n] = e.first+c;
+                        open.push(Entry(cost[n], n));
+                    }
+                }
+            }
+        }
+        return -1.0f;
+    }
+
+    //! Position in the world of the center of a cell, for CBeamPathFinder with cells of NAV_CELL_SIZE
+    Math::Vector CellToPos(Math::IntPoint cell) const
+    {
+        return Math::Vector((cell.x+0.5f-m_size/2.0f)*NAV_CELL_SIZE, 0.0f,
+                            (cell.y+0.5f-m_size/2.0f)*NAV_CELL_SIZE);
+    }
+
+    //! Runs the beam search like goto() does, frame after frame, and returns its result
+    Error BeamSearch(CBeamPathFinder& finder, Math::IntPoint start, Math::IntPoint goal, int& frames)
+    {
+        finder.Init(m_size, NAV_CELL_SIZE, Blocked());
+        finder.Start();
+        Error ret = ERR_CONTINUE;
+        for (frames = 0; ret == ERR_CONTINUE && frames < 100000; frames++)
+        {
+            ret = finder.Continue(CellToPos(start), CellToPos(goal), 0.0f);
+        }
+        return ret;
+    }
+
+    //! Checks that the lines between the points of the beam search are free and returns their length in cells
+    float CheckBeamPath(CBeamPathFinder& finder)
+    {
+        float length = 0.0f;
+        for (int i = 1; i <= finder.GetTotal(); i++)
+        {
+            EXPECT_TRUE(finder.TestLine(finder.GetPoints()[i-1], finder.GetPoints()[i]));
+            length += Math::DistanceProjected(finder.GetPoints()[i-1], finder.GetPoints()[i]);
+        }
+        return length/NAV_CELL_SIZE;
+    }
+
+    int m_size = 0;
+    std::vector<bool> m_blocked;
+};
+
+TEST_F(CGridPathFinderTest, StraightLine)
+{
+    m_size = 50;
+    m_blocked.assign(m_size*m_size, false);
+
+    CGridPathFinder finder;
+    finder.Start(m_size, Math::IntPoint(5, 10), Math::IntPoint(40, 10), 0.0f, Blocked());
+    ASSERT_EQ(ERR_OK, finder.Continue(100000));
+
+    const auto& path = finder.GetPath();
+    ASSERT_EQ(36u, path.size());
+    EXPECT_EQ(Math::IntPoint(5, 10), path.front());
+    EXPECT_EQ(Math::IntPoint(40, 10), path.back());
+    EXPECT_FLOAT_EQ(35.0f, CheckPath(path));
+}
+
+TEST_F(CGridPathFinderTest, Impossible)
+{
+    m_size = 50;
+    m_blocked.assign(m_size*m_size, false);
+    for (int y = 0; y < m_size; y++)
+        m_blocked[25+y*m_size] = true;
+
+    CGridPathFinder finder;
+    finder.Start(m_size, Math::IntPoint(5, 10), Math::IntPoint(40, 10), 0.0f, Blocked());
+    EXPECT_EQ(ERR_GOTO_IMPOSSIBLE, finder.Continue(100000));
+}
+
+TEST_F(CGridPathFinderTest, TooManyVisited)
+{
+    m_size = 200;
+    m_blocked.assign(m_size*m_size, false);
+    for (int y = 0; y < m_size; y++)
+        m_blocked[100+y*m_size] = true;
+
+    CGridPathFinder finder;
+    finder.Start(m_size, Math::IntPoint(5, 10), Math::IntPoint(190, 10), 0.0f, Blocked(), 1000);
+    EXPECT_EQ(ERR_GOTO_ITER, finder.Continue(100000));
+}
+
+TEST_F(CGridPathFinderTest, GoalRadius)
+{
+    m_size = 50;
+    m_blocked.assign(m_size*m_size, false);
+    m_blocked[40+10*m_size] = true;  // the goal itself is occupied
+
+    CGridPathFinder finder;
+    finder.Start(m_size, Math::IntPoint(5, 10), Math::IntPoint(40, 10), 3.0f, Blocked());
+    ASSERT_EQ(ERR_OK, finder.Continue(100000));
+
+    Math::IntPoint end = finder.GetPath().back();
+    EXPECT_LE(Math::IntPoint(end.x-40, end.y-10).Length(), 3.0f);
+    EXPECT_FLOAT_EQ(32.0f, CheckPath(finder.GetPath()));
+}
+
+TEST_F(CGridPathFinderTest, ShortestPathInMazes)
+{
+    std::srand(1234);
+    for (int i = 0; i < 10; i++)
+    {
+        GenerateMaze(15, 1+i%3, i*20);
+        Math::IntPoint start(1, 1), goal(m_size-2, m_size-2);
+
+        CGridPathFinder finder;
+        finder.Start(m_size, start, goal, 0.0f, Blocked());
+        ASSERT_EQ(ERR_OK, finder.Continue(1000000));
+        EXPECT_EQ(start, finder.GetPath().front());
+        EXPECT_EQ(goal, finder.GetPath().back());
+        EXPECT_NEAR(ShortestPath(start, goal), CheckPath(finder.GetPath()), 1e-2f);
+    }
+}
+
+TEST_F(CGridPathFinderTest, SlicedSearchGivesSameResult)
+{
+    std::srand(4321);
+    GenerateMaze(20, 2, 50);
+    Math::IntPoint start(1, 1), goal(m_size-2, m_size-2);
+
+    CGridPathFinder whole;
+    whole.Start(m_size, start, goal, 0.0f, Blocked());
+    ASSERT_EQ(ERR_OK, whole.Continue(1000000));
+
+    CGridPathFinder sliced;
+    sliced.Start(m_size, start, goal, 0.0f, Blocked());
+    Error ret = ERR_CONTINUE;
+    int calls = 0;
+    while (ret == ERR_CONTINUE)
+    {
+        ret = sliced.Continue(7);
+        calls++;
+    }
+    ASSERT_EQ(ERR_OK, ret);
+    EXPECT_GT(calls, 1);
+    EXPECT_EQ(whole.GetExpandedCount(), sliced.GetExpandedCount());
+    ASSERT_EQ(whole.GetPath().size(), sliced.GetPath().size());
+    for (std::size_t i = 0; i < whole.GetPath().size(); i++)
+        EXPECT_EQ(whole.GetPath()[i], sliced.GetPath()[i]);
+}
+
+TEST_F(CGridPathFinderTest, BeamSearchAroundWall)
+{
+    m_size = 100;
+    m_blocked.assign(m_size*m_size, false);
+    for (int y = 20; y < 80; y++)
+        m_blocked[50+y*m_size] = true;
+    Math::IntPoint start(30, 50), goal(70, 50);
+
+    CBeamPathFinder beam;
+    int frames = 0;
+    ASSERT_EQ(ERR_OK, BeamSearch(beam, start, goal, frames));
+    EXPECT_FLOAT_EQ(CellToPos(start).x, beam.GetPoints()[0].x);
+    EXPECT_FLOAT_EQ(CellToPos(start).z, beam.GetPoints()[0].z);
+    EXPECT_FLOAT_EQ(CellToPos(goal).x, beam.GetPoints()[beam.GetTotal()].x);
+    EXPECT_FLOAT_EQ(CellToPos(goal).z, beam.GetPoints()[beam.GetTotal()].z);
+    EXPECT_GE(CheckBeamPath(beam), ShortestPath(start, goal)-1.0f);
+
+    // The same wall, closed on both sides, can't be crossed
+    for (int y = 0; y < m_size; y++)
+        m_blocked[50+y*m_size] = true;
+    EXPECT_NE(ERR_OK, BeamSearch(beam, start, goal, frames));
+}
+
+// Run with --gtest_also_run_disabled_tests to print the figures.
+// Both searches are run on the same maps, the beam search with the budget used by goto().
+TEST_F(CGridPathFinderTest, DISABLED_Benchmark)
+{
+    const int SLICE = 64;
+    std::srand(42);
+    for (int i = 0; i < 10; i++)
+    {
+        const char* kind = i < 5 ? "field" : "maze";
+        if (i < 5)
+            GenerateField(120+i*60, 20+i*10);
+        else
+            GenerateMaze(40+(i-5)*20, 2, 200);
+        Math::IntPoint start(1, 1), goal(m_size-2, m_size-2);
+
+        CGridPathFinder finder;
+        auto begin = std::chrono::steady_clock::now();
+        finder.Start(m_size, start, goal, 0.0f, Blocked());
+        Error ret = ERR_CONTINUE;
+        int slices = 0;
+        while (ret == ERR_CONTINUE)
+        {
+            ret = finder.Continue(SLICE);
+            slices++;
+        }
+        auto end = std::chrono::steady_clock::now();
+        ASSERT_EQ(ERR_OK, ret);
+
+        float ms = std::chrono::duration<float, std::milli>(end-begin).count();
+        std::printf("%s %dx%d: A*   length %.1f, %d cells expanded, %d slices of %d, %.2f ms\n",
+                    kind, m_size, m_size, CheckPath(finder.GetPath()), finder.GetExpandedCount(),
+                    slices, SLICE, ms);
+
+        CBeamPathFinder beam;
+        int frames = 0;
+        begin = std::chrono::steady_clock::now();
+        ret = BeamSearch(beam, start, goal, frames);
+        end = std::chrono::steady_clock::now();
+
+        ms = std::chrono::duration<float, std::milli>(end-begin).count();
+        if (ret == ERR_OK)
+        {
+            std::printf("%s %dx%d: beam length %.1f, %d points, %d frames, %.2f ms\n",
+                        kind, m_size, m_size, CheckBeamPath(beam), beam.GetTotal()+1, frames, ms);
+        }
+        else
+        {
+            std::printf("%s %dx%d: beam failed with code %d, %d frames, %.2f ms\n",
+                        kind, m_size, m_size, ret, frames, ms);
+        }
+    }
+}
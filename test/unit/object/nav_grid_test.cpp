@@ -0,0 +1,257 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/nav_grid.h"
+
+#include "math/func.h"
+
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <gtest/gtest.h>
+
+class CNavGridTest : public testing::Test
+{
+protected:
+    struct TestObject
+    {
+        Math::Vector position;
+        float angle = 0.0f;
+        float radius = 2.0f;
+    };
+
+    CNavGridTest()
+        : m_grid(nullptr, nullptr, [this](CNavGrid& grid) { UpdateObjects(grid); })
+    {}
+
+    float Random(float min, float max)
+    {
+        return min + (max - min) * (std::rand() / static_cast<float>(RAND_MAX));
+    }
+
+    void UpdateObjects(CNavGrid& grid)
+    {
+        m_updateCount ++;
+        for (const auto& it : m_objects)
+        {
+            const TestObject& object = it.second;
+            grid.SetObstacle(it.first, nullptr, OBJECT_MOBILEwa, object.position, object.angle,
+                             [this, &object](std::vector<Math::Sphere>& spheres)
+                             {
+                                 m_spheresCount ++;
+                                 spheres.push_back(Math::Sphere(object.position, object.radius));
+                             });
+        }
+    }
+
+    //! Returns IDs of the obstacles given for the cells around \a pos
+    std::set<int> GetObstaclesAround(const Math::Vector& pos, int cells = 0, float margin = 0.0f)
+    {
+        std::vector<const NavObstacle*> obstacles;
+        int x = CNavGrid::PosToCell(pos.x);
+        int y = CNavGrid::PosToCell(pos.z);
+        m_grid.GetObstacles(x-cells, y-cells, x+cells, y+cells, margin, obstacles);
+
+        std::set<int> ids;
+        for (const NavObstacle* obstacle : obstacles)
+        {
+            EXPECT_EQ(0u, ids.count(obstacle->id)) << "obstacle " << obstacle->id << " given twice";
+            ids.insert(obstacle->id);
+        }
+        return ids;
+    }
+
+    int GetTileRevisionAt(const Math::Vector& pos)
+    {
+        return m_grid.GetTileRevision(CNavGrid::PosToCell(pos.x)/NAV_TILE_SIZE,
+                                      CNavGrid::PosToCell(pos.z)/NAV_TILE_SIZE);
+    }
+
+    //! Reference implementation: objects whose sphere touches the rectangle of cells
+    std::set<int> BruteForce(int minX, int minY, int maxX, int maxY, float margin)
+    {
+        std::set<int> ids;
+        for (const auto& it : m_objects)
+        {
+            const TestObject& object = it.second;
+            float x = Math::Clamp(object.position.x, CNavGrid::CellToPos(minX), CNavGrid::CellToPos(maxX+1));
+            float z = Math::Clamp(object.position.z, CNavGrid::CellToPos(minY), CNavGrid::CellToPos(maxY+1));
+            float dx = object.position.x - x;
+            float dz = object.position.z - z;
+            if (dx*dx + dz*dz < (object.radius+margin)*(object.radius+margin))
+                ids.insert(it.first);
+        }
+        return ids;
+    }
+
+    std::map<int, TestObject> m_objects;
+    CNavGrid m_grid;
+    int m_updateCount = 0;
+    int m_spheresCount = 0;
+};
+
+TEST_F(CNavGridTest, ObjectIsFoundInItsCells)
+{
+    m_objects[1].position = Math::Vector(100.0f, 0.0f, 100.0f);
+    m_objects[2].position = Math::Vector(-500.0f, 0.0f, 300.0f);
+
+    EXPECT_EQ(std::set<int>{1}, GetObstaclesAround(Math::Vector(100.0f, 0.0f, 100.0f)));
+    EXPECT_EQ(std::set<int>{2}, GetObstaclesAround(Math::Vector(-500.0f, 0.0f, 300.0f)));
+    EXPECT_TRUE(GetObstaclesAround(Math::Vector(1000.0f, 0.0f, -1000.0f)).empty());
+}
+
+TEST_F(CNavGridTest, MovedObjectBlocksItsNewCells)
+{
+    Math::Vector oldPos(100.0f, 0.0f, 100.0f);
+    Math::Vector newPos(400.0f, 0.0f, -200.0f);
+    Math::Vector farPos(-1000.0f, 0.0f, -1000.0f);
+    m_objects[1].position = oldPos;
+
+    EXPECT_EQ(std::set<int>{1}, GetObstaclesAround(oldPos));
+    int oldRevision = GetTileRevisionAt(oldPos);
+    int newRevision = GetTileRevisionAt(newPos);
+    int farRevision = GetTileRevisionAt(farPos);
+
+    // Nothing is read again until the objects are said to have changed
+    m_objects[1].position = newPos;
+    EXPECT_EQ(std::set<int>{1}, GetObstaclesAround(oldPos));
+    EXPECT_EQ(oldRevision, GetTileRevisionAt(oldPos));
+
+    m_grid.SetObjectsChanged();
+    EXPECT_TRUE(GetObstaclesAround(oldPos).empty());
+    EXPECT_EQ(std::set<int>{1}, GetObstaclesAround(newPos));
+
+    EXPECT_NE(oldRevision, GetTileRevisionAt(oldPos));
+    EXPECT_NE(newRevision, GetTileRevisionAt(newPos));
+    EXPECT_EQ(farRevision, GetTileRevisionAt(farPos));
+}
+
+TEST_F(CNavGridTest, RotatedObjectIsIndexedAgain)
+{
+    m_objects[1].position = Math::Vector(100.0f, 0.0f, 100.0f);
+    GetObstaclesAround(m_objects[1].position);
+    EXPECT_EQ(1, m_spheresCount);
+
+    m_objects[1].angle = 1.0f;
+    m_grid.SetObjectsChanged();
+    GetObstaclesAround(m_objects[1].position);
+    EXPECT_EQ(2, m_spheresCount);
+}
+
+TEST_F(CNavGridTest, UnchangedObjectsAreNotIndexedAgain)
+{
+    for (int id = 0; id < 10; ++id)
+    {
+        m_objects[id].position = Math::Vector(id * 50.0f, 0.0f, 0.0f);
+    }
+    GetObstaclesAround(Math::Vector(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(1, m_updateCount);
+    EXPECT_EQ(10, m_spheresCount);
+    int revision = GetTileRevisionAt(Math::Vector(0.0f, 0.0f, 0.0f));
+
+    m_grid.SetObjectsChanged();
+    GetObstaclesAround(Math::Vector(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(2, m_updateCount);
+    EXPECT_EQ(10, m_spheresCount);
+    EXPECT_EQ(revision, GetTileRevisionAt(Math::Vector(0.0f, 0.0f, 0.0f)));
+}
+
+TEST_F(CNavGridTest, RemovedObjectIsForgotten)
+{
+    Math::Vector pos(100.0f, 0.0f, 100.0f);
+    m_objects[1].position = pos;
+    m_objects[2].position = pos;
+    EXPECT_EQ((std::set<int>{1, 2}), GetObstaclesAround(pos));
+
+    m_objects.erase(1);
+    m_grid.SetObjectsChanged();
+    EXPECT_EQ(std::set<int>{2}, GetObstaclesAround(pos));
+}
+
+TEST_F(CNavGridTest, ResetReadsObjectsAgain)
+{
+    Math::Vector pos(100.0f, 0.0f, 100.0f);
+    m_objects[1].position = pos;
+    EXPECT_EQ(std::set<int>{1}, GetObstaclesAround(pos));
+
+    m_grid.Reset();
+    EXPECT_EQ(std::set<int>{1}, GetObstaclesAround(pos));
+    EXPECT_EQ(2, m_spheresCount);
+}
+
+TEST_F(CNavGridTest, MatchesBruteForce)
+{
+    std::srand(1234);
+    for (int id = 0; id < 300; ++id)
+    {
+        m_objects[id].position = Math::Vector(Random(-1500.0f, 1500.0f), 0.0f, Random(-1500.0f, 1500.0f));
+        m_objects[id].radius = Random(0.5f, 20.0f);
+    }
+
+    int found = 0;
+    for (int step = 0; step < 5; ++step)
+    {
+        // Moves some objects between the checks
+        for (int i = 0; i < 50; ++i)
+        {
+            TestObject& object = m_objects[std::rand() % 300];
+            object.position = Math::Vector(Random(-1500.0f, 1500.0f), 0.0f, Random(-1500.0f, 1500.0f));
+        }
+        m_grid.SetObjectsChanged();
+
+        for (int i = 0; i < 500; ++i)
+        {
+            int minX = std::rand() % NAV_GRID_SIZE;
+            int minY = std::rand() % NAV_GRID_SIZE;
+            int maxX = Math::Min(minX + std::rand() % 40, NAV_GRID_SIZE-1);
+            int maxY = Math::Min(minY + std::rand() % 40, NAV_GRID_SIZE-1);
+            float margin = Random(0.0f, 10.0f);
+
+            std::vector<const NavObstacle*> obstacles;
+            m_grid.GetObstacles(minX, minY, maxX, maxY, margin, obstacles);
+            std::set<int> ids;
+            for (const NavObstacle* obstacle : obstacles)
+            {
+                ids.insert(obstacle->id);
+                ASSERT_EQ(1u, obstacle->spheres.size());
+                EXPECT_EQ(m_objects[obstacle->id].position.x, obstacle->spheres[0].pos.x);
+            }
+
+            // The grid may give more candidates, but must not miss any
+            for (int id : BruteForce(minX, minY, maxX, maxY, margin))
+            {
+                EXPECT_EQ(1u, ids.count(id)) << "object " << id << " missed";
+                found ++;
+            }
+        }
+    }
+
+    // Make sure the rectangles are not all empty
+    EXPECT_GT(found, 100);
+}
+
+TEST_F(CNavGridTest, TerrainIsFreeWithoutTerrain)
+{
+    int layer = m_grid.GetTerrainLayer(0.5f, false, false);
+    EXPECT_EQ(layer, m_grid.GetTerrainLayer(0.5f, false, false));
+    EXPECT_NE(layer, m_grid.GetTerrainLayer(0.5f, true, false));
+
+    EXPECT_TRUE(m_grid.IsTerrainTileFree(layer, 10, 10));
+    EXPECT_FALSE(m_grid.TestTerrain(layer, 200, 200));
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/object_id_map.h"
+
+#include <cstdlib>
+#include <unordered_map>
+#include <gtest/gtest.h>
+
+class CObjectIdMapTest : public testing::Test
+{
+protected:
+    void ExpectSameContents()
+    {
+        EXPECT_EQ(m_reference.size(), m_map.GetSize());
+        for (const auto& entry : m_reference)
+        {
+            EXPECT_EQ(entry.second, m_map.Find(entry.first));
+        }
+    }
+
+protected:
+    CObjectIdMap m_map;
+    std::unordered_map<int, int> m_reference;
+};
+
+TEST_F(CObjectIdMapTest, EmptyMap)
+{
+    EXPECT_EQ(0u, m_map.GetSize());
+    EXPECT_EQ(-1, m_map.Find(0));
+    EXPECT_EQ(-1, m_map.Find(-5));
+    m_map.Erase(3);
+    EXPECT_EQ(0u, m_map.GetSize());
+}
+
+TEST_F(CObjectIdMapTest, InsertFindErase)
+{
+    m_map.Insert(7, 1);
+    m_map.Insert(8, 2);
+    EXPECT_EQ(1, m_map.Find(7));
+    EXPECT_EQ(2, m_map.Find(8));
+    EXPECT_EQ(-1, m_map.Find(9));
+
+    m_map.Insert(7, 5);
+    EXPECT_EQ(5, m_map.Find(7));
+    EXPECT_EQ(2u, m_map.GetSize());
+
+    m_map.Erase(7);
+    EXPECT_EQ(-1, m_map.Find(7));
+    EXPECT_EQ(2, m_map.Find(8));
+    EXPECT_EQ(1u, m_map.GetSize());
+}
+
+TEST_F(CObjectIdMapTest, HugeIdsDoNotGrowTable)
+{
+    // Ids read from save files are not trusted to be small
+    m_map.Insert(2000000000, 0);
+    m_map.Insert(2147483646, 1);
+    EXPECT_EQ(0, m_map.Find(2000000000));
+    EXPECT_EQ(1, m_map.Find(2147483646));
+    EXPECT_EQ(2u, m_map.GetSize());
+}
+
+TEST_F(CObjectIdMapTest, Clear)
+{
+    for (int id = 0; id < 100; id++)
+    {
+        m_map.Insert(id, id);
+    }
+    m_map.Clear();
+    EXPECT_EQ(0u, m_map.GetSize());
+    EXPECT_EQ(-1, m_map.Find(50));
+
+    m_map.Insert(50, 3);
+    EXPECT_EQ(3, m_map.Find(50));
+}
+
+TEST_F(CObjectIdMapTest, MatchesUnorderedMap)
+{
+    std::srand(7);
+    for (int i = 0; i < 20000; i++)
+    {
+        // Mostly consecutive ids like in a scene, with a few large ones like in saves
+        int id = (std::rand() % 10 == 0) ? std::rand() : std::rand() % 500;
+        if (std::rand() % 3 == 0)
+        {
+            m_map.Erase(id);
+            m_reference.erase(id);
+        }
+        else
+        {
+            m_map.Insert(id, i);
+            m_reference[id] = i;
+        }
+
+        if (i % 1000 == 0)
+            ExpectSameContents();
+    }
+    ExpectSameContents();
+
+    for (int id = 0; id < 500; id++)
+    {
+        EXPECT_EQ(m_reference.count(id) != 0, m_map.Find(id) != -1);
+    }
+}
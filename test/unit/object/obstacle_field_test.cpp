@@ -0,0 +1,187 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/obstacle_field.h"
+
+#include "math/func.h"
+
+#include <cstdlib>
+#include <map>
+#include <gtest/gtest.h>
+
+class CObstacleFieldTest : public testing::Test
+{
+protected:
+    float Random(float min, float max)
+    {
+        return min + (max - min) * (std::rand() / static_cast<float>(RAND_MAX));
+    }
+
+    ObstacleShape RandomShape()
+    {
+        ObstacleShape shape;
+        Math::Vector center(Random(-300.0f, 300.0f), Random(0.0f, 20.0f), Random(-300.0f, 300.0f));
+        if (std::rand() % 10 == 0)
+        {
+            shape.hideInner = true;
+            shape.spheres.push_back(Math::Sphere(center, 80.0f));
+        }
+        int count = 1 + std::rand() % 4;
+        for (int i = 0; i < count; ++i)
+        {
+            Math::Vector offset(Random(-5.0f, 5.0f), Random(-2.0f, 8.0f), Random(-5.0f, 5.0f));
+            shape.spheres.push_back(Math::Sphere(center + offset, Random(0.5f, 6.0f)));
+        }
+        return shape;
+    }
+
+    void Update()
+    {
+        m_field.BeginUpdate();
+        for (const auto& it : m_shapes)
+        {
+            m_field.SetObstacle(it.first, it.second);
+        }
+        m_field.EndUpdate();
+    }
+
+    //! Reference implementation, like the former scan of CRobotMain::FreeSpace()
+    float BruteForce(const Math::Vector& center, int excludeId)
+    {
+        float min = OBSTACLE_NONE_DISTANCE;
+        for (const auto& it : m_shapes)
+        {
+            if (it.first == excludeId) continue;
+
+            const ObstacleShape& shape = it.second;
+            std::size_t first = 0;
+            if (shape.hideInner)
+            {
+                if (shape.spheres[0].pos.x != center.x ||
+                    shape.spheres[0].pos.z != center.z)
+                {
+                    min = Math::Min(min, Math::Max(Math::DistanceToSphere(center, shape.spheres[0]), 0.0f));
+                    continue;
+                }
+                first = 1;
+            }
+            for (std::size_t i = first; i < shape.spheres.size(); ++i)
+            {
+                min = Math::Min(min, Math::Max(Math::DistanceToSphere(center, shape.spheres[i]), 0.0f));
+            }
+        }
+        return min;
+    }
+
+    void CheckQueries(int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Math::Vector center(Random(-400.0f, 400.0f), Random(0.0f, 10.0f), Random(-400.0f, 400.0f));
+            int excludeId = std::rand() % 4 == 0 ? std::rand() % 200 : -1;
+            float expected = BruteForce(center, excludeId);
+
+            EXPECT_EQ(expected, m_field.GetDistance(center, excludeId));
+            EXPECT_LE(m_field.GetLowerBound(center.x, center.z), expected);
+
+            float below = Random(0.0f, 30.0f);
+            float dist = m_field.GetDistance(center, excludeId, below);
+            if (expected < below)
+                EXPECT_LT(dist, below);
+            else
+                EXPECT_EQ(expected, dist);
+        }
+    }
+
+    CObstacleField m_field;
+    std::map<int, ObstacleShape> m_shapes;
+};
+
+TEST_F(CObstacleFieldTest, Empty)
+{
+    Update();
+    EXPECT_EQ(OBSTACLE_NONE_DISTANCE, m_field.GetDistance(Math::Vector(0.0f, 0.0f, 0.0f), -1));
+    EXPECT_EQ(OBSTACLE_MAX_DISTANCE, m_field.GetLowerBound(0.0f, 0.0f));
+}
+
+TEST_F(CObstacleFieldTest, MatchesBruteForce)
+{
+    std::srand(1234);
+    for (int id = 0; id < 200; ++id)
+    {
+        m_shapes[id] = RandomShape();
+    }
+    Update();
+    CheckQueries(2000);
+}
+
+TEST_F(CObstacleFieldTest, IncrementalUpdates)
+{
+    std::srand(4321);
+    for (int id = 0; id < 200; ++id)
+    {
+        m_shapes[id] = RandomShape();
+    }
+    Update();
+
+    for (int step = 0; step < 10; ++step)
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            int id = std::rand() % 250;
+            if (std::rand() % 3 == 0)
+                m_shapes.erase(id);
+            else
+                m_shapes[id] = RandomShape();
+        }
+        Update();
+        CheckQueries(300);
+    }
+
+    // The field updated around changes must match a field computed at once
+    CObstacleField fresh;
+    fresh.BeginUpdate();
+    for (const auto& it : m_shapes)
+    {
+        fresh.SetObstacle(it.first, it.second);
+    }
+    fresh.EndUpdate();
+    for (float z = -400.0f; z < 400.0f; z += OBSTACLE_CELL_SIZE)
+    {
+        for (float x = -400.0f; x < 400.0f; x += OBSTACLE_CELL_SIZE)
+        {
+            EXPECT_EQ(fresh.GetLowerBound(x, z), m_field.GetLowerBound(x, z));
+        }
+    }
+}
+
+TEST_F(CObstacleFieldTest, BaseCenter)
+{
+    ObstacleShape base;
+    base.hideInner = true;
+    base.spheres.push_back(Math::Sphere(Math::Vector(100.0f, 0.0f, 100.0f), 80.0f));
+    base.spheres.push_back(Math::Sphere(Math::Vector(110.0f, 0.0f, 100.0f), 5.0f));
+    m_shapes[1] = base;
+    Update();
+
+    // Exactly at the center, only the inner spheres count
+    EXPECT_FLOAT_EQ(5.0f, m_field.GetDistance(Math::Vector(100.0f, 0.0f, 100.0f), -1));
+    EXPECT_EQ(0.0f, m_field.GetDistance(Math::Vector(101.0f, 0.0f, 100.0f), -1));
+    EXPECT_FLOAT_EQ(20.0f, m_field.GetDistance(Math::Vector(200.0f, 0.0f, 100.0f), -1));
+}
@@ -0,0 +1,181 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/part_transform_pool.h"
+
+#include "common/thread/thread_pool.h"
+
+#include "math/geometry.h"
+
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+
+const float TEST_TOLERANCE = 1e-4f;
+
+struct TestPart
+{
+    int slot = -1;
+    int parent = -1;
+    Math::Vector position;
+    Math::Vector angle;
+    Math::Vector zoom{1.0f, 1.0f, 1.0f};
+};
+
+class CPartTransformPoolTest : public testing::Test
+{
+protected:
+    float Random(float min, float max)
+    {
+        return min + (max - min) * (std::rand() / static_cast<float>(RAND_MAX));
+    }
+
+    void RandomizePart(TestPart& part)
+    {
+        part.position = Math::Vector(Random(-10.0f, 10.0f), Random(-10.0f, 10.0f), Random(-10.0f, 10.0f));
+        part.angle = Math::Vector(Random(-3.0f, 3.0f), Random(-3.0f, 3.0f), Random(-3.0f, 3.0f));
+        if (std::rand() % 2 == 0)
+            part.zoom = Math::Vector(Random(0.5f, 2.0f), Random(0.5f, 2.0f), Random(0.5f, 2.0f));
+        else
+            part.zoom = Math::Vector(1.0f, 1.0f, 1.0f);
+        m_pool.SetLocal(part.slot, part.position, part.angle, part.zoom);
+    }
+
+    void CreateHierarchy(int count)
+    {
+        std::srand(1234);
+        for (int i = 0; i < count; ++i)
+        {
+            TestPart part;
+            part.slot = m_pool.AddPart();
+            // Parents are always created first, like in COldObject
+            part.parent = (i == 0 || std::rand() % 5 == 0) ? -1 : std::rand() % i;
+            m_pool.SetParent(part.slot, part.parent == -1 ? -1 : m_parts[part.parent].slot);
+            m_parts.push_back(part);
+            RandomizePart(m_parts.back());
+        }
+    }
+
+    //! Same computation as COldObject::UpdateTransformObject()
+    Math::Matrix ScalarWorld(int index)
+    {
+        const TestPart& part = m_parts[index];
+
+        Math::Matrix translate;
+        translate.Set(1, 4, part.position.x);
+        translate.Set(2, 4, part.position.y);
+        translate.Set(3, 4, part.position.z);
+
+        Math::Matrix rotate;
+        Math::LoadRotationZXYMatrix(rotate, part.angle);
+
+        Math::Matrix zoom;
+        zoom.Set(1, 1, part.zoom.x);
+        zoom.Set(2, 2, part.zoom.y);
+        zoom.Set(3, 3, part.zoom.z);
+
+        Math::Matrix transform = Math::MultiplyMatrices(translate, Math::MultiplyMatrices(rotate, zoom));
+        if (part.parent == -1)
+            return transform;
+
+        return Math::MultiplyMatrices(ScalarWorld(part.parent), transform);
+    }
+
+    void CheckAll()
+    {
+        for (int i = 0; i < static_cast<int>(m_parts.size()); ++i)
+        {
+            Math::Matrix expected = ScalarWorld(i);
+            Math::Matrix actual = m_pool.GetWorld(m_parts[i].slot);
+            for (int j = 0; j < 16; ++j)
+            {
+                ASSERT_NEAR(expected.m[j], actual.m[j], TEST_TOLERANCE) << "part " << i << ", element " << j;
+            }
+        }
+    }
+
+    CPartTransformPool m_pool;
+    std::vector<TestPart> m_parts;
+};
+
+TEST_F(CPartTransformPoolTest, MatchesScalarPath)
+{
+    CreateHierarchy(103);
+    m_pool.Update();
+    EXPECT_EQ(103, m_pool.GetUpdatedCount());
+    CheckAll();
+}
+
+TEST_F(CPartTransformPoolTest, OnlyDirtyPartsAndDescendantsUpdated)
+{
+    CreateHierarchy(50);
+    m_pool.Update();
+
+    m_pool.Update();
+    EXPECT_EQ(0, m_pool.GetUpdatedCount());
+
+    RandomizePart(m_parts[0]);
+    m_pool.Update();
+    EXPECT_TRUE(m_pool.IsUpdated(m_parts[0].slot));
+    for (int i = 1; i < 50; ++i)
+    {
+        bool descendant = false;
+        for (int p = m_parts[i].parent; p != -1; p = m_parts[p].parent)
+            descendant = descendant || p == 0;
+        EXPECT_EQ(descendant, m_pool.IsUpdated(m_parts[i].slot)) << "part " << i;
+    }
+    CheckAll();
+}
+
+TEST_F(CPartTransformPoolTest, RemovedParentDetachesChildren)
+{
+    CreateHierarchy(20);
+    m_pool.Update();
+
+    int removed = m_parts[3].slot;
+    m_pool.RemovePart(removed);
+    for (auto& part : m_parts)
+    {
+        if (part.parent == 3)
+        {
+            EXPECT_EQ(-1, m_pool.GetParent(part.slot));
+            part.parent = -1;
+            RandomizePart(part);
+        }
+    }
+    m_parts[3].parent = -1;
+    m_parts[3].slot = m_pool.AddPart();
+    RandomizePart(m_parts[3]);
+
+    m_pool.Update();
+    CheckAll();
+}
+
+TEST_F(CPartTransformPoolTest, ThreadedUpdateMatchesScalarPath)
+{
+    CThreadPool threadPool(3);
+    CreateHierarchy(1000);
+    m_pool.Update(&threadPool);
+    CheckAll();
+
+    for (int i = 0; i < 1000; i += 7)
+        RandomizePart(m_parts[i]);
+    m_pool.Update(&threadPool);
+    CheckAll();
+}
@@ -0,0 +1,245 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/path_cache.h"
+
+#include "object/nav_grid.h"
+
+#include <map>
+#include <gtest/gtest.h>
+
+class CPathCacheTest : public testing::Test
+{
+protected:
+    CPathCacheTest()
+        : m_grid(nullptr, nullptr, [this](CNavGrid& grid) { UpdateObjects(grid); }),
+          m_cache(&m_grid)
+    {
+        m_path.push_back(Math::Vector(0.0f, 0.0f, 0.0f));
+        m_path.push_back(Math::Vector(200.0f, 0.0f, 0.0f));
+        m_path.push_back(Math::Vector(200.0f, 0.0f, 200.0f));
+        m_path.push_back(Math::Vector(400.0f, 0.0f, 200.0f));
+
+        m_key.startX = CNavGrid::PosToCell(0.0f)/PATH_CACHE_START_BUCKET;
+        m_key.startY = CNavGrid::PosToCell(0.0f)/PATH_CACHE_START_BUCKET;
+        m_key.goalX = CNavGrid::PosToCell(400.0f);
+        m_key.goalY = CNavGrid::PosToCell(200.0f);
+        m_key.radius = 20;
+    }
+
+    void UpdateObjects(CNavGrid& grid)
+    {
+        for (const auto& it : m_objects)
+        {
+            const Math::Vector& position = it.second;
+            grid.SetObstacle(it.first, nullptr, OBJECT_STONE, position, 0.0f,
+                             [&position](std::vector<Math::Sphere>& spheres)
+                             {
+                                 spheres.push_back(Math::Sphere(position, 5.0f));
+                             });
+        }
+    }
+
+    //! Looks for m_path from \a start, counting the segments tested
+    PathCacheResult Find(int ownerId, const Math::Vector& start, std::vector<Math::Vector>& points,
+                         const PathCacheKey& key)
+    {
+        m_tested.clear();
+        return m_cache.Find(key, ownerId, start, m_path.back(), true,
+                            [this](const Math::Vector& a, const Math::Vector& b)
+                            {
+                                m_tested.push_back(std::make_pair(a, b));
+                                return !m_blocked;
+                            },
+                            points);
+    }
+
+    PathCacheResult Find(int ownerId, std::vector<Math::Vector>& points)
+    {
+        return Find(ownerId, Math::Vector(1.0f, 0.0f, 1.0f), points, m_key);
+    }
+
+    //! Stores m_path after a miss of \a ownerId
+    void Store(int ownerId)
+    {
+        m_cache.Store(m_key, ownerId, m_path, 1000);
+    }
+
+    std::map<int, Math::Vector> m_objects;
+    CNavGrid m_grid;
+    CPathCache m_cache;
+
+    std::vector<Math::Vector> m_path;
+    PathCacheKey m_key;
+    //! Segments checked by the last Find()
+    std::vector<std::pair<Math::Vector, Math::Vector>> m_tested;
+    //! Makes every segment blocked
+    bool m_blocked = false;
+};
+
+TEST_F(CPathCacheTest, MissThenHit)
+{
+    std::vector<Math::Vector> points;
+    EXPECT_EQ(PathCacheResult::Miss, Find(1, points));
+    Store(1);
+
+    ASSERT_EQ(PathCacheResult::Hit, Find(1, points));
+    ASSERT_EQ(m_path.size(), points.size());
+    EXPECT_EQ(1.0f, points.front().x);  // starts at the actual position
+    EXPECT_EQ(m_path[1].x, points[1].x);
+    EXPECT_EQ(m_path.back().z, points.back().z);
+
+    EXPECT_EQ(2, m_cache.GetLookupCount());
+    EXPECT_EQ(1, m_cache.GetHitCount());
+    EXPECT_EQ(1000, m_cache.GetSavedTime());
+}
+
+TEST_F(CPathCacheTest, OtherKeyMisses)
+{
+    std::vector<Math::Vector> points;
+    Find(1, points);
+    Store(1);
+
+    PathCacheKey other = m_key;
+    other.goalX ++;
+    EXPECT_EQ(PathCacheResult::Miss, Find(1, Math::Vector(), points, other));
+
+    other = m_key;
+    other.layer = 1;
+    EXPECT_EQ(PathCacheResult::Miss, Find(2, Math::Vector(), points, other));
+}
+
+TEST_F(CPathCacheTest, UnchangedTilesOnlyCheckEnds)
+{
+    std::vector<Math::Vector> points;
+    Find(1, points);
+    Store(1);
+
+    // Something moves far from the path
+    m_objects[1] = Math::Vector(-1000.0f, 0.0f, -1000.0f);
+    m_grid.SetObjectsChanged();
+
+    ASSERT_EQ(PathCacheResult::Hit, Find(2, points));
+    ASSERT_EQ(2u, m_tested.size());
+    EXPECT_EQ(1.0f, m_tested[0].first.x);  // first segment, from the requester
+    EXPECT_EQ(m_path[2].x, m_tested[1].first.x);  // last segment, to the exact goal
+}
+
+TEST_F(CPathCacheTest, ObjectOnPathChecksWholePath)
+{
+    std::vector<Math::Vector> points;
+    Find(1, points);
+    Store(1);
+
+    m_objects[1] = Math::Vector(200.0f, 0.0f, 100.0f);
+    m_grid.SetObjectsChanged();
+
+    // The ends, then the segments after the first one
+    ASSERT_EQ(PathCacheResult::Hit, Find(2, points));
+    ASSERT_EQ(m_path.size(), m_tested.size());
+    EXPECT_EQ(m_path[1].x, m_tested[2].first.x);
+    EXPECT_EQ(m_path[2].x, m_tested[3].first.x);
+
+    // Checked again with the new tile revisions, so it's only the ends next time
+    ASSERT_EQ(PathCacheResult::Hit, Find(2, points));
+    EXPECT_EQ(2u, m_tested.size());
+}
+
+TEST_F(CPathCacheTest, BlockedPathIsDropped)
+{
+    std::vector<Math::Vector> points;
+    Find(1, points);
+    Store(1);
+
+    m_objects[1] = Math::Vector(200.0f, 0.0f, 100.0f);
+    m_grid.SetObjectsChanged();
+    m_blocked = true;
+    EXPECT_EQ(PathCacheResult::Miss, Find(2, points));
+
+    // The path is gone, even if the obstacle goes away
+    m_blocked = false;
+    m_objects.erase(1);
+    m_grid.SetObjectsChanged();
+    m_cache.Cancel(2);
+    EXPECT_EQ(PathCacheResult::Miss, Find(2, points));
+    EXPECT_EQ(0, m_cache.GetHitCount());
+}
+
+TEST_F(CPathCacheTest, ClearForgetsPaths)
+{
+    std::vector<Math::Vector> points;
+    Find(1, points);
+    Store(1);
+
+    m_cache.Clear();
+    EXPECT_EQ(0, m_cache.GetLookupCount());
+    EXPECT_EQ(PathCacheResult::Miss, Find(1, points));
+}
+
+TEST_F(CPathCacheTest, SameRequestsWaitForTheSearch)
+{
+    std::vector<Math::Vector> points;
+    EXPECT_EQ(PathCacheResult::Miss, Find(1, points));
+    EXPECT_EQ(PathCacheResult::Pending, Find(2, points));
+    EXPECT_EQ(PathCacheResult::Pending, Find(2, points));
+    EXPECT_EQ(PathCacheResult::Pending, Find(3, points));
+    EXPECT_EQ(2, m_cache.GetCoalescedCount());
+    EXPECT_EQ(1, m_cache.GetLookupCount());
+
+    Store(1);
+    EXPECT_EQ(PathCacheResult::Hit, Find(2, points));
+    EXPECT_EQ(PathCacheResult::Hit, Find(3, points));
+}
+
+TEST_F(CPathCacheTest, CancelledSearchIsTakenOver)
+{
+    std::vector<Math::Vector> points;
+    EXPECT_EQ(PathCacheResult::Miss, Find(1, points));
+    EXPECT_EQ(PathCacheResult::Pending, Find(2, points));
+
+    m_cache.Cancel(1);
+    EXPECT_EQ(PathCacheResult::Miss, Find(2, points));
+    EXPECT_EQ(PathCacheResult::Pending, Find(1, points));
+}
+
+TEST_F(CPathCacheTest, LeastRecentlyUsedIsReplaced)
+{
+    std::vector<Math::Vector> points;
+    Find(1, points);
+    Store(1);
+
+    // Many other paths, while the first one stays in use
+    for (int i = 0; i < 40; ++i)
+    {
+        PathCacheKey key = m_key;
+        key.goalX = 1000 + i;
+        m_cache.Store(key, 1, m_path, 1000);
+
+        EXPECT_EQ(PathCacheResult::Hit, Find(1, points)) << "after " << i << " paths";
+    }
+
+    PathCacheKey oldest = m_key;
+    oldest.goalX = 1000;
+    EXPECT_EQ(PathCacheResult::Miss, Find(1, Math::Vector(), points, oldest));
+
+    PathCacheKey newest = m_key;
+    newest.goalX = 1039;
+    m_cache.Cancel(1);
+    EXPECT_EQ(PathCacheResult::Hit, Find(1, Math::Vector(), points, newest));
+}
@@ -0,0 +1,425 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2018, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "object/world_query.h"
+
+#include "math/func.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <gtest/gtest.h>
+
+const float TEST_TOLERANCE = 1e-3f;
+//! Grazing hits lose precision in the square root
+const float DISTANCE_TOLERANCE = 0.05f;
+
+class CWorldQueryTest : public testing::Test
+{
+protected:
+    struct TestObject
+    {
+        Math::Vector position;
+        std::vector<Math::Sphere> spheres;
+        Math::Sphere cameraSphere;
+    };
+
+    CWorldQueryTest()
+        : m_query([this](CWorldQuery& query) { UpdateObjects(query); })
+    {}
+
+    float Random(float min, float max)
+    {
+        return min + (max - min) * (std::rand() / static_cast<float>(RAND_MAX));
+    }
+
+    Math::Vector RandomPosition(float range)
+    {
+        return Math::Vector(Random(-range, range), Random(0.0f, 30.0f), Random(-range, range));
+    }
+
+    TestObject RandomObject(float range)
+    {
+        TestObject object;
+        object.position = RandomPosition(range);
+        int count = std::rand() % 4;
+        for (int i = 0; i < count; i++)
+        {
+            Math::Vector offset(Random(-6.0f, 6.0f), Random(-2.0f, 8.0f), Random(-6.0f, 6.0f));
+            object.spheres.push_back(Math::Sphere(object.position + offset, Random(0.5f, 8.0f)));
+        }
+        if (std::rand() % 2 == 0)
+            object.cameraSphere = Math::Sphere(object.position, Random(1.0f, 15.0f));
+        return object;
+    }
+
+    void CreateObjects(int count, float range)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            m_objects[i] = RandomObject(range);
+        }
+        m_query.SetObjectsChanged();
+    }
+
+    void UpdateObjects(CWorldQuery& query)
+    {
+        for (const auto& it : m_objects)
+        {
+            const TestObject& object = it.second;
+            query.SetObject(it.first, nullptr, object.position,
+                            [&object](std::vector<Math::Sphere>& spheres)
+                            {
+                                spheres.insert(spheres.end(), object.spheres.begin(), object.spheres.end());
+                            },
+                            object.cameraSphere);
+        }
+    }
+
+    //! Reference distance along the segment to the sphere, solving |p1 + t*(p2-p1) - center| = radius
+    static bool BruteForceSphere(const Math::Vector& p1, const Math::Vector& p2, const Math::Sphere& sphere, float& distance)
+    {
+        if (Math::Distance(p1, sphere.pos) < sphere.radius)
+        {
+            distance = 0.0f;
+            return true;
+        }
+
+        Math::Vector d = p2 - p1;
+        Math::Vector m = p1 - sphere.pos;
+        float a = Math::DotProduct(d, d);
+        float b = 2.0f * Math::DotProduct(m, d);
+        float c = Math::DotProduct(m, m) - sphere.radius * sphere.radius;
+        float discriminant = b*b - 4.0f*a*c;
+        if (a == 0.0f || discriminant < 0.0f) return false;
+
+        float t = (-b - std::sqrt(discriminant)) / (2.0f * a);
+        if (t < 0.0f || t > 1.0f) return false;
+        distance = t * std::sqrt(a);
+        return true;
+    }
+
+    //! Distance to the nearest sphere of the object crossed by the segment, -1 if none
+    float BruteForceObject(const TestObject& object, const Math::Vector& p1, const Math::Vector& p2, WorldQuerySpheres spheres)
+    {
+        float best = -1.0f;
+        std::vector<Math::Sphere> tested = object.spheres;
+        if (spheres == WorldQuerySpheres::Camera)
+        {
+            tested.clear();
+            if (object.cameraSphere.radius > 0.0f)
+                tested.push_back(object.cameraSphere);
+        }
+        for (const Math::Sphere& sphere : tested)
+        {
+            float distance = 0.0f;
+            if (BruteForceSphere(p1, p2, sphere, distance) && (best < 0.0f || distance < best))
+                best = distance;
+        }
+        return best;
+    }
+
+    //! Reference implementation, scanning all objects like the former callers
+    bool BruteForce(const Math::Vector& p1, const Math::Vector& p2, WorldQuerySpheres spheres, int& id, float& distance)
+    {
+        id = -1;
+        for (const auto& it : m_objects)
+        {
+            float objectDistance = BruteForceObject(it.second, p1, p2, spheres);
+            if (objectDistance < 0.0f) continue;
+            if (id == -1 || objectDistance < distance)
+            {
+                id = it.first;
+                distance = objectDistance;
+            }
+        }
+        return id != -1;
+    }
+
+    //! Terrain made of two triangles per cell, split by the diagonal from (x+1, y) to (x, y+1)
+    float GetTerrainLevel(const Math::Vector& pos)
+    {
+        float fx = pos.x / TERRAIN_CELL_SIZE + TERRAIN_SIZE/2;
+        float fy = pos.z / TERRAIN_CELL_SIZE + TERRAIN_SIZE/2;
+        int x = Math::Clamp(static_cast<int>(std::floor(fx)), 0, TERRAIN_SIZE-1);
+        int y = Math::Clamp(static_cast<int>(std::floor(fy)), 0, TERRAIN_SIZE-1);
+        float u = fx - x;
+        float v = fy - y;
+
+        float h1 = m_heights[x+0 + (y+0)*(TERRAIN_SIZE+1)];
+        float h2 = m_heights[x+1 + (y+0)*(TERRAIN_SIZE+1)];
+        float h3 = m_heights[x+0 + (y+1)*(TERRAIN_SIZE+1)];
+        float h4 = m_heights[x+1 + (y+1)*(TERRAIN_SIZE+1)];
+        if (u + v < 1.0f)
+            return h1 + (h2 - h1) * u + (h3 - h1) * v;
+        return h4 + (h3 - h4) * (1.0f - u) + (h2 - h4) * (1.0f - v);
+    }
+
+    void CreateTerrain()
+    {
+        m_heights.resize((TERRAIN_SIZE+1)*(TERRAIN_SIZE+1));
+        for (float& height : m_heights)
+        {
+            height = Random(0.0f, 20.0f);
+        }
+        m_query.SetTerrain(TERRAIN_CELL_SIZE, [this](const Math::Vector& pos) { return GetTerrainLevel(pos); });
+    }
+
+protected:
+    static const int TERRAIN_SIZE = 32;
+    static constexpr float TERRAIN_CELL_SIZE = 8.0f;
+
+    CWorldQuery m_query;
+    std::map<int, TestObject> m_objects;
+    std::vector<float> m_heights;
+};
+
+constexpr float CWorldQueryTest::TERRAIN_CELL_SIZE;
+
+TEST_F(CWorldQueryTest, NoObjects)
+{
+    WorldQueryHit hit;
+    EXPECT_FALSE(m_query.IntersectSegment(Math::Vector(-100.0f, 5.0f, 0.0f), Math::Vector(100.0f, 5.0f, 0.0f),
+                                          WorldQuerySpheres::Crash, hit));
+
+    std::vector<WorldQueryHit> hits;
+    m_query.GetSegmentHits(Math::Vector(-100.0f, 5.0f, 0.0f), Math::Vector(100.0f, 5.0f, 0.0f),
+                           WorldQuerySpheres::Camera, hits);
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST_F(CWorldQueryTest, FirstHitAlongSegment)
+{
+    m_objects[0].spheres.push_back(Math::Sphere(Math::Vector(50.0f, 0.0f, 0.0f), 5.0f));
+    m_objects[1].spheres.push_back(Math::Sphere(Math::Vector(20.0f, 0.0f, 0.0f), 2.0f));
+    m_objects[2].spheres.push_back(Math::Sphere(Math::Vector(30.0f, 10.0f, 0.0f), 2.0f));
+
+    WorldQueryHit hit;
+    ASSERT_TRUE(m_query.IntersectSegment(Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(100.0f, 0.0f, 0.0f),
+                                         WorldQuerySpheres::Crash, hit));
+    EXPECT_EQ(1, hit.id);
+    EXPECT_NEAR(18.0f, hit.distance, TEST_TOLERANCE);
+    EXPECT_NEAR(2.0f, hit.sphere.radius, TEST_TOLERANCE);
+
+    // Stops before the first sphere
+    EXPECT_FALSE(m_query.IntersectSegment(Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(17.0f, 0.0f, 0.0f),
+                                          WorldQuerySpheres::Crash, hit));
+
+    // Starts inside
+    ASSERT_TRUE(m_query.IntersectSegment(Math::Vector(50.0f, 0.0f, 1.0f), Math::Vector(0.0f, 0.0f, 0.0f),
+                                         WorldQuerySpheres::Crash, hit));
+    EXPECT_EQ(0, hit.id);
+    EXPECT_EQ(0.0f, hit.distance);
+
+    // Filtered objects are ignored
+    EXPECT_FALSE(m_query.IntersectSegment(Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(100.0f, 0.0f, 0.0f),
+                                          WorldQuerySpheres::Crash, hit, [](CObject*) { return false; }));
+}
+
+TEST_F(CWorldQueryTest, IntersectSegmentMatchesBruteForce)
+{
+    std::srand(1);
+    CreateObjects(300, 400.0f);
+
+    for (int i = 0; i < 2000; i++)
+    {
+        Math::Vector p1 = RandomPosition(450.0f);
+        Math::Vector p2 = p1 + Math::Vector(Random(-200.0f, 200.0f), Random(-20.0f, 20.0f), Random(-200.0f, 200.0f));
+        WorldQuerySpheres spheres = i % 2 == 0 ? WorldQuerySpheres::Crash : WorldQuerySpheres::Camera;
+
+        int expectedId = -1;
+        float expectedDistance = 0.0f;
+        bool expected = BruteForce(p1, p2, spheres, expectedId, expectedDistance);
+
+        WorldQueryHit hit;
+        bool found = m_query.IntersectSegment(p1, p2, spheres, hit);
+        ASSERT_EQ(expected, found) << "segment " << i;
+        if (!found) continue;
+
+        EXPECT_NEAR(expectedDistance, hit.distance, DISTANCE_TOLERANCE) << "segment " << i;
+        if (hit.id != expectedId)
+        {
+            // Only a sphere at the same distance may be given instead
+            float distance = BruteForceObject(m_objects[hit.id], p1, p2, spheres);
+            EXPECT_NEAR(expectedDistance, distance, DISTANCE_TOLERANCE) << "segment " << i;
+        }
+    }
+}
+
+TEST_F(CWorldQueryTest, SegmentHitsMatchBruteForce)
+{
+    std::srand(2);
+    CreateObjects(300, 400.0f);
+
+    std::vector<WorldQueryHit> hits;
+    for (int i = 0; i < 1000; i++)
+    {
+        Math::Vector p1 = RandomPosition(450.0f);
+        Math::Vector p2 = p1 + Math::Vector(Random(-300.0f, 300.0f), Random(-20.0f, 20.0f), Random(-300.0f, 300.0f));
+        WorldQuerySpheres spheres = i % 2 == 0 ? WorldQuerySpheres::Crash : WorldQuerySpheres::Camera;
+
+        std::set<int> expected;
+        for (const auto& it : m_objects)
+        {
+            if (BruteForceObject(it.second, p1, p2, spheres) >= 0.0f)
+                expected.insert(it.first);
+        }
+
+        m_query.GetSegmentHits(p1, p2, spheres, hits);
+        std::set<int> found;
+        for (std::size_t j = 0; j < hits.size(); j++)
+        {
+            EXPECT_EQ(0u, found.count(hits[j].id)) << "object " << hits[j].id << " given twice";
+            found.insert(hits[j].id);
+            EXPECT_NEAR(BruteForceObject(m_objects[hits[j].id], p1, p2, spheres), hits[j].distance, DISTANCE_TOLERANCE);
+            if (j > 0)
+            {
+                EXPECT_LE(hits[j-1].distance, hits[j].distance);
+            }
+        }
+        EXPECT_EQ(expected, found) << "segment " << i;
+    }
+}
+
+TEST_F(CWorldQueryTest, ObjectsMovedAndDeleted)
+{
+    m_objects[0].spheres.push_back(Math::Sphere(Math::Vector(50.0f, 0.0f, 0.0f), 5.0f));
+    m_objects[1].spheres.push_back(Math::Sphere(Math::Vector(80.0f, 0.0f, 0.0f), 5.0f));
+
+    Math::Vector p1(0.0f, 0.0f, 0.0f);
+    Math::Vector p2(100.0f, 0.0f, 0.0f);
+    WorldQueryHit hit;
+    ASSERT_TRUE(m_query.IntersectSegment(p1, p2, WorldQuerySpheres::Crash, hit));
+    EXPECT_EQ(0, hit.id);
+
+    // Not seen until notified
+    m_objects[0].position = Math::Vector(50.0f, 0.0f, 300.0f);
+    m_objects[0].spheres[0].pos = m_objects[0].position;
+    ASSERT_TRUE(m_query.IntersectSegment(p1, p2, WorldQuerySpheres::Crash, hit));
+    EXPECT_EQ(0, hit.id);
+
+    m_query.SetObjectsChanged();
+    ASSERT_TRUE(m_query.IntersectSegment(p1, p2, WorldQuerySpheres::Crash, hit));
+    EXPECT_EQ(1, hit.id);
+
+    m_objects.erase(1);
+    m_query.SetObjectsChanged();
+    EXPECT_FALSE(m_query.IntersectSegment(p1, p2, WorldQuerySpheres::Crash, hit));
+
+    m_query.Reset();
+    ASSERT_TRUE(m_query.IntersectSegment(Math::Vector(50.0f, 0.0f, 250.0f), Math::Vector(50.0f, 0.0f, 350.0f),
+                                         WorldQuerySpheres::Crash, hit));
+    EXPECT_EQ(0, hit.id);
+}
+
+TEST_F(CWorldQueryTest, TraverseCellsVisitsCrossedCells)
+{
+    std::srand(3);
+    for (int i = 0; i < 500; i++)
+    {
+        Math::Vector p1 = RandomPosition(100.0f);
+        Math::Vector p2 = i % 10 == 0 ? p1 : RandomPosition(100.0f);
+
+        std::vector<std::pair<int, int>> cells;
+        float lastExit = 0.0f;
+        CWorldQuery::TraverseCells(p1, p2, 8.0f, 0.0f, [&](int x, int y, float tEnter, float tExit)
+        {
+            EXPECT_NEAR(lastExit, tEnter, TEST_TOLERANCE);
+            EXPECT_LE(tEnter, tExit);
+            lastExit = tExit;
+            cells.push_back(std::make_pair(x, y));
+            return true;
+        });
+        EXPECT_NEAR(1.0f, lastExit, TEST_TOLERANCE);
+
+        ASSERT_FALSE(cells.empty());
+        EXPECT_EQ(static_cast<int>(std::floor(p1.x/8.0f)), cells.front().first);
+        EXPECT_EQ(static_cast<int>(std::floor(p1.z/8.0f)), cells.front().second);
+        EXPECT_EQ(static_cast<int>(std::floor(p2.x/8.0f)), cells.back().first);
+        EXPECT_EQ(static_cast<int>(std::floor(p2.z/8.0f)), cells.back().second);
+        for (std::size_t j = 1; j < cells.size(); j++)
+        {
+            EXPECT_EQ(1, std::abs(cells[j].first - cells[j-1].first) + std::abs(cells[j].second - cells[j-1].second));
+        }
+
+        // Every sampled point of the segment is in a visited cell
+        std::set<std::pair<int, int>> visited(cells.begin(), cells.end());
+        EXPECT_EQ(cells.size(), visited.size());
+        for (int j = 1; j < 200; j++)
+        {
+            Math::Vector p = p1 + (p2 - p1) * (j / 200.0f);
+            auto cell = std::make_pair(static_cast<int>(std::floor(p.x/8.0f)), static_cast<int>(std::floor(p.z/8.0f)));
+            EXPECT_EQ(1u, visited.count(cell)) << "segment " << i;
+        }
+    }
+}
+
+TEST_F(CWorldQueryTest, IntersectTerrainMatchesSampling)
+{
+    std::srand(4);
+    Math::Vector hit;
+    EXPECT_FALSE(m_query.IntersectTerrain(Math::Vector(0.0f, -10.0f, 0.0f), Math::Vector(1.0f, -10.0f, 0.0f), hit));
+
+    CreateTerrain();
+    float range = TERRAIN_SIZE*TERRAIN_CELL_SIZE/2.0f - 1.0f;
+    for (int i = 0; i < 1000; i++)
+    {
+        Math::Vector p1(Random(-range, range), Random(0.0f, 30.0f), Random(-range, range));
+        Math::Vector p2(Random(-range, range), Random(0.0f, 30.0f), Random(-range, range));
+
+        // Reference: first sample under the terrain, with small steps
+        const int steps = 20000;
+        int first = -1;
+        for (int j = 0; j <= steps; j++)
+        {
+            Math::Vector p = p1 + (p2 - p1) * (static_cast<float>(j) / steps);
+            if (p.y < GetTerrainLevel(p))
+            {
+                first = j;
+                break;
+            }
+        }
+
+        bool found = m_query.IntersectTerrain(p1, p2, hit);
+        float step = Math::Distance(p1, p2) / steps;
+        if (first == -1)
+        {
+            // Only a graze shorter than one step may be missed by the reference
+            if (found)
+            {
+                EXPECT_NEAR(GetTerrainLevel(hit), hit.y, TEST_TOLERANCE) << "segment " << i;
+            }
+            continue;
+        }
+
+        ASSERT_TRUE(found) << "segment " << i;
+        if (first == 0)
+        {
+            // Starts under the terrain
+            EXPECT_TRUE(Math::VectorsEqual(p1, hit)) << "segment " << i;
+            continue;
+        }
+
+        Math::Vector expected = p1 + (p2 - p1) * (static_cast<float>(first) / steps);
+        EXPECT_LE(Math::Distance(p1, hit), Math::Distance(p1, expected) + TEST_TOLERANCE) << "segment " << i;
+        EXPECT_GE(Math::Distance(p1, hit), Math::Distance(p1, expected) - 2.0f*step - TEST_TOLERANCE) << "segment " << i;
+        EXPECT_NEAR(GetTerrainLevel(hit), hit.y, 0.01f) << "segment " << i;
+    }
+}